@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/external
+# Build directory: /root/repo/build/external
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("miniupnpc")
+subdirs("gtest")
@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/external/gtest
+# Build directory: /root/repo/build/external/gtest
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
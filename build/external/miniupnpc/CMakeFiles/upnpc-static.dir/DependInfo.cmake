@@ -0,0 +1,31 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/external/miniupnpc/connecthostport.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/connecthostport.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/connecthostport.c.o.d"
+  "/root/repo/external/miniupnpc/igd_desc_parse.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/igd_desc_parse.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/igd_desc_parse.c.o.d"
+  "/root/repo/external/miniupnpc/minisoap.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/minisoap.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/minisoap.c.o.d"
+  "/root/repo/external/miniupnpc/minissdpc.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/minissdpc.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/minissdpc.c.o.d"
+  "/root/repo/external/miniupnpc/miniupnpc.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/miniupnpc.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/miniupnpc.c.o.d"
+  "/root/repo/external/miniupnpc/miniwget.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/miniwget.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/miniwget.c.o.d"
+  "/root/repo/external/miniupnpc/minixml.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/minixml.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/minixml.c.o.d"
+  "/root/repo/external/miniupnpc/portlistingparse.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/portlistingparse.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/portlistingparse.c.o.d"
+  "/root/repo/external/miniupnpc/receivedata.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/receivedata.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/receivedata.c.o.d"
+  "/root/repo/external/miniupnpc/upnpc.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/upnpc.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/upnpc.c.o.d"
+  "/root/repo/external/miniupnpc/upnpcommands.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/upnpcommands.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/upnpcommands.c.o.d"
+  "/root/repo/external/miniupnpc/upnperrors.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/upnperrors.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/upnperrors.c.o.d"
+  "/root/repo/external/miniupnpc/upnpreplyparse.c" "external/miniupnpc/CMakeFiles/upnpc-static.dir/upnpreplyparse.c.o" "gcc" "external/miniupnpc/CMakeFiles/upnpc-static.dir/upnpreplyparse.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
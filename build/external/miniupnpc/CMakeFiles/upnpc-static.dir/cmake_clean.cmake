@@ -0,0 +1,35 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/upnpc-static.dir/connecthostport.c.o"
+  "CMakeFiles/upnpc-static.dir/connecthostport.c.o.d"
+  "CMakeFiles/upnpc-static.dir/igd_desc_parse.c.o"
+  "CMakeFiles/upnpc-static.dir/igd_desc_parse.c.o.d"
+  "CMakeFiles/upnpc-static.dir/minisoap.c.o"
+  "CMakeFiles/upnpc-static.dir/minisoap.c.o.d"
+  "CMakeFiles/upnpc-static.dir/minissdpc.c.o"
+  "CMakeFiles/upnpc-static.dir/minissdpc.c.o.d"
+  "CMakeFiles/upnpc-static.dir/miniupnpc.c.o"
+  "CMakeFiles/upnpc-static.dir/miniupnpc.c.o.d"
+  "CMakeFiles/upnpc-static.dir/miniwget.c.o"
+  "CMakeFiles/upnpc-static.dir/miniwget.c.o.d"
+  "CMakeFiles/upnpc-static.dir/minixml.c.o"
+  "CMakeFiles/upnpc-static.dir/minixml.c.o.d"
+  "CMakeFiles/upnpc-static.dir/portlistingparse.c.o"
+  "CMakeFiles/upnpc-static.dir/portlistingparse.c.o.d"
+  "CMakeFiles/upnpc-static.dir/receivedata.c.o"
+  "CMakeFiles/upnpc-static.dir/receivedata.c.o.d"
+  "CMakeFiles/upnpc-static.dir/upnpc.c.o"
+  "CMakeFiles/upnpc-static.dir/upnpc.c.o.d"
+  "CMakeFiles/upnpc-static.dir/upnpcommands.c.o"
+  "CMakeFiles/upnpc-static.dir/upnpcommands.c.o.d"
+  "CMakeFiles/upnpc-static.dir/upnperrors.c.o"
+  "CMakeFiles/upnpc-static.dir/upnperrors.c.o.d"
+  "CMakeFiles/upnpc-static.dir/upnpreplyparse.c.o"
+  "CMakeFiles/upnpc-static.dir/upnpreplyparse.c.o.d"
+  "libminiupnpc.a"
+  "libminiupnpc.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/upnpc-static.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
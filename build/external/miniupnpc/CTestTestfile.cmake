@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/external/miniupnpc
+# Build directory: /root/repo/build/external/miniupnpc
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
@@ -0,0 +1,7 @@
+#ifndef MINIUPNPCSTRINGS_H_INCLUDED
+#define MINIUPNPCSTRINGS_H_INCLUDED
+
+#define OS_STRING "Linux"
+#define MINIUPNPC_VERSION_STRING "1.9"
+
+#endif
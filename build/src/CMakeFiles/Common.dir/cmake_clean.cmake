@@ -0,0 +1,53 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Common.dir/Common/Base58.cpp.o"
+  "CMakeFiles/Common.dir/Common/Base58.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/BlockingQueue.cpp.o"
+  "CMakeFiles/Common.dir/Common/BlockingQueue.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/CommandLine.cpp.o"
+  "CMakeFiles/Common.dir/Common/CommandLine.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/ConsoleHandler.cpp.o"
+  "CMakeFiles/Common.dir/Common/ConsoleHandler.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/ConsoleTools.cpp.o"
+  "CMakeFiles/Common.dir/Common/ConsoleTools.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/IInputStream.cpp.o"
+  "CMakeFiles/Common.dir/Common/IInputStream.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/IOutputStream.cpp.o"
+  "CMakeFiles/Common.dir/Common/IOutputStream.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/JsonValue.cpp.o"
+  "CMakeFiles/Common.dir/Common/JsonValue.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/Math.cpp.o"
+  "CMakeFiles/Common.dir/Common/Math.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/MemoryInputStream.cpp.o"
+  "CMakeFiles/Common.dir/Common/MemoryInputStream.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/PathTools.cpp.o"
+  "CMakeFiles/Common.dir/Common/PathTools.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/ScopeExit.cpp.o"
+  "CMakeFiles/Common.dir/Common/ScopeExit.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/SignalHandler.cpp.o"
+  "CMakeFiles/Common.dir/Common/SignalHandler.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/StdInputStream.cpp.o"
+  "CMakeFiles/Common.dir/Common/StdInputStream.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/StdOutputStream.cpp.o"
+  "CMakeFiles/Common.dir/Common/StdOutputStream.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/StreamTools.cpp.o"
+  "CMakeFiles/Common.dir/Common/StreamTools.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/StringInputStream.cpp.o"
+  "CMakeFiles/Common.dir/Common/StringInputStream.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/StringOutputStream.cpp.o"
+  "CMakeFiles/Common.dir/Common/StringOutputStream.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/StringTools.cpp.o"
+  "CMakeFiles/Common.dir/Common/StringTools.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/StringView.cpp.o"
+  "CMakeFiles/Common.dir/Common/StringView.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/Util.cpp.o"
+  "CMakeFiles/Common.dir/Common/Util.cpp.o.d"
+  "CMakeFiles/Common.dir/Common/VectorOutputStream.cpp.o"
+  "CMakeFiles/Common.dir/Common/VectorOutputStream.cpp.o.d"
+  "libCommon.a"
+  "libCommon.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Common.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
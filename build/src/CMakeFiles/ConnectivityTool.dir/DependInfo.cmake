@@ -0,0 +1,28 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/ConnectivityTool/ConnectivityTool.cpp" "src/CMakeFiles/ConnectivityTool.dir/ConnectivityTool/ConnectivityTool.cpp.o" "gcc" "src/CMakeFiles/ConnectivityTool.dir/ConnectivityTool/ConnectivityTool.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/build/src/CMakeFiles/CryptoNoteCore.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Common.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Logging.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Crypto.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/P2P.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Rpc.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Http.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Serialization.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/System.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,37 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/crypto/blake256.c" "src/CMakeFiles/Crypto.dir/crypto/blake256.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/blake256.c.o.d"
+  "/root/repo/src/crypto/chacha8.c" "src/CMakeFiles/Crypto.dir/crypto/chacha8.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/chacha8.c.o.d"
+  "/root/repo/src/crypto/crypto-ops-data.c" "src/CMakeFiles/Crypto.dir/crypto/crypto-ops-data.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/crypto-ops-data.c.o.d"
+  "/root/repo/src/crypto/crypto-ops.c" "src/CMakeFiles/Crypto.dir/crypto/crypto-ops.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/crypto-ops.c.o.d"
+  "/root/repo/src/crypto/groestl.c" "src/CMakeFiles/Crypto.dir/crypto/groestl.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/groestl.c.o.d"
+  "/root/repo/src/crypto/hash-extra-blake.c" "src/CMakeFiles/Crypto.dir/crypto/hash-extra-blake.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/hash-extra-blake.c.o.d"
+  "/root/repo/src/crypto/hash-extra-groestl.c" "src/CMakeFiles/Crypto.dir/crypto/hash-extra-groestl.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/hash-extra-groestl.c.o.d"
+  "/root/repo/src/crypto/hash-extra-jh.c" "src/CMakeFiles/Crypto.dir/crypto/hash-extra-jh.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/hash-extra-jh.c.o.d"
+  "/root/repo/src/crypto/hash-extra-skein.c" "src/CMakeFiles/Crypto.dir/crypto/hash-extra-skein.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/hash-extra-skein.c.o.d"
+  "/root/repo/src/crypto/hash.c" "src/CMakeFiles/Crypto.dir/crypto/hash.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/hash.c.o.d"
+  "/root/repo/src/crypto/jh.c" "src/CMakeFiles/Crypto.dir/crypto/jh.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/jh.c.o.d"
+  "/root/repo/src/crypto/keccak.c" "src/CMakeFiles/Crypto.dir/crypto/keccak.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/keccak.c.o.d"
+  "/root/repo/src/crypto/oaes_lib.c" "src/CMakeFiles/Crypto.dir/crypto/oaes_lib.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/oaes_lib.c.o.d"
+  "/root/repo/src/crypto/random.c" "src/CMakeFiles/Crypto.dir/crypto/random.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/random.c.o.d"
+  "/root/repo/src/crypto/skein.c" "src/CMakeFiles/Crypto.dir/crypto/skein.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/skein.c.o.d"
+  "/root/repo/src/crypto/slow-hash.c" "src/CMakeFiles/Crypto.dir/crypto/slow-hash.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/slow-hash.c.o.d"
+  "/root/repo/src/crypto/tree-hash.c" "src/CMakeFiles/Crypto.dir/crypto/tree-hash.c.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/tree-hash.c.o.d"
+  "/root/repo/src/crypto/crypto.cpp" "src/CMakeFiles/Crypto.dir/crypto/crypto.cpp.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/crypto.cpp.o.d"
+  "/root/repo/src/crypto/slow-hash.cpp" "src/CMakeFiles/Crypto.dir/crypto/slow-hash.cpp.o" "gcc" "src/CMakeFiles/Crypto.dir/crypto/slow-hash.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Crypto.dir/crypto/blake256.c.o"
+  "CMakeFiles/Crypto.dir/crypto/blake256.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/chacha8.c.o"
+  "CMakeFiles/Crypto.dir/crypto/chacha8.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/crypto-ops-data.c.o"
+  "CMakeFiles/Crypto.dir/crypto/crypto-ops-data.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/crypto-ops.c.o"
+  "CMakeFiles/Crypto.dir/crypto/crypto-ops.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/crypto.cpp.o"
+  "CMakeFiles/Crypto.dir/crypto/crypto.cpp.o.d"
+  "CMakeFiles/Crypto.dir/crypto/groestl.c.o"
+  "CMakeFiles/Crypto.dir/crypto/groestl.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/hash-extra-blake.c.o"
+  "CMakeFiles/Crypto.dir/crypto/hash-extra-blake.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/hash-extra-groestl.c.o"
+  "CMakeFiles/Crypto.dir/crypto/hash-extra-groestl.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/hash-extra-jh.c.o"
+  "CMakeFiles/Crypto.dir/crypto/hash-extra-jh.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/hash-extra-skein.c.o"
+  "CMakeFiles/Crypto.dir/crypto/hash-extra-skein.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/hash.c.o"
+  "CMakeFiles/Crypto.dir/crypto/hash.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/jh.c.o"
+  "CMakeFiles/Crypto.dir/crypto/jh.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/keccak.c.o"
+  "CMakeFiles/Crypto.dir/crypto/keccak.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/oaes_lib.c.o"
+  "CMakeFiles/Crypto.dir/crypto/oaes_lib.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/random.c.o"
+  "CMakeFiles/Crypto.dir/crypto/random.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/skein.c.o"
+  "CMakeFiles/Crypto.dir/crypto/skein.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/slow-hash.c.o"
+  "CMakeFiles/Crypto.dir/crypto/slow-hash.c.o.d"
+  "CMakeFiles/Crypto.dir/crypto/slow-hash.cpp.o"
+  "CMakeFiles/Crypto.dir/crypto/slow-hash.cpp.o.d"
+  "CMakeFiles/Crypto.dir/crypto/tree-hash.c.o"
+  "CMakeFiles/Crypto.dir/crypto/tree-hash.c.o.d"
+  "libCrypto.a"
+  "libCrypto.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C CXX)
+  include(CMakeFiles/Crypto.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
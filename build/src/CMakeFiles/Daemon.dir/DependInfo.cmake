@@ -0,0 +1,31 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/Daemon/Daemon.cpp" "src/CMakeFiles/Daemon.dir/Daemon/Daemon.cpp.o" "gcc" "src/CMakeFiles/Daemon.dir/Daemon/Daemon.cpp.o.d"
+  "/root/repo/src/Daemon/DaemonCommandsHandler.cpp" "src/CMakeFiles/Daemon.dir/Daemon/DaemonCommandsHandler.cpp.o" "gcc" "src/CMakeFiles/Daemon.dir/Daemon/DaemonCommandsHandler.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/build/src/CMakeFiles/CryptoNoteCore.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/P2P.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Rpc.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Serialization.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/System.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Http.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Logging.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Common.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Crypto.dir/DependInfo.cmake"
+  "/root/repo/build/external/miniupnpc/CMakeFiles/upnpc-static.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/BlockchainExplorer.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Daemon.dir/Daemon/Daemon.cpp.o"
+  "CMakeFiles/Daemon.dir/Daemon/Daemon.cpp.o.d"
+  "CMakeFiles/Daemon.dir/Daemon/DaemonCommandsHandler.cpp.o"
+  "CMakeFiles/Daemon.dir/Daemon/DaemonCommandsHandler.cpp.o.d"
+  "RUB"
+  "RUB.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Daemon.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/HTTP/HttpParser.cpp" "src/CMakeFiles/Http.dir/HTTP/HttpParser.cpp.o" "gcc" "src/CMakeFiles/Http.dir/HTTP/HttpParser.cpp.o.d"
+  "/root/repo/src/HTTP/HttpParserErrorCodes.cpp" "src/CMakeFiles/Http.dir/HTTP/HttpParserErrorCodes.cpp.o" "gcc" "src/CMakeFiles/Http.dir/HTTP/HttpParserErrorCodes.cpp.o.d"
+  "/root/repo/src/HTTP/HttpRequest.cpp" "src/CMakeFiles/Http.dir/HTTP/HttpRequest.cpp.o" "gcc" "src/CMakeFiles/Http.dir/HTTP/HttpRequest.cpp.o.d"
+  "/root/repo/src/HTTP/HttpResponse.cpp" "src/CMakeFiles/Http.dir/HTTP/HttpResponse.cpp.o" "gcc" "src/CMakeFiles/Http.dir/HTTP/HttpResponse.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/JsonRpcServer.dir/JsonRpcServer/JsonRpcServer.cpp.o"
+  "CMakeFiles/JsonRpcServer.dir/JsonRpcServer/JsonRpcServer.cpp.o.d"
+  "libJsonRpcServer.a"
+  "libJsonRpcServer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/JsonRpcServer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
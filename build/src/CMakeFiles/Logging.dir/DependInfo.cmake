@@ -0,0 +1,27 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/Logging/CommonLogger.cpp" "src/CMakeFiles/Logging.dir/Logging/CommonLogger.cpp.o" "gcc" "src/CMakeFiles/Logging.dir/Logging/CommonLogger.cpp.o.d"
+  "/root/repo/src/Logging/ConsoleLogger.cpp" "src/CMakeFiles/Logging.dir/Logging/ConsoleLogger.cpp.o" "gcc" "src/CMakeFiles/Logging.dir/Logging/ConsoleLogger.cpp.o.d"
+  "/root/repo/src/Logging/FileLogger.cpp" "src/CMakeFiles/Logging.dir/Logging/FileLogger.cpp.o" "gcc" "src/CMakeFiles/Logging.dir/Logging/FileLogger.cpp.o.d"
+  "/root/repo/src/Logging/ILogger.cpp" "src/CMakeFiles/Logging.dir/Logging/ILogger.cpp.o" "gcc" "src/CMakeFiles/Logging.dir/Logging/ILogger.cpp.o.d"
+  "/root/repo/src/Logging/LoggerGroup.cpp" "src/CMakeFiles/Logging.dir/Logging/LoggerGroup.cpp.o" "gcc" "src/CMakeFiles/Logging.dir/Logging/LoggerGroup.cpp.o.d"
+  "/root/repo/src/Logging/LoggerManager.cpp" "src/CMakeFiles/Logging.dir/Logging/LoggerManager.cpp.o" "gcc" "src/CMakeFiles/Logging.dir/Logging/LoggerManager.cpp.o.d"
+  "/root/repo/src/Logging/LoggerMessage.cpp" "src/CMakeFiles/Logging.dir/Logging/LoggerMessage.cpp.o" "gcc" "src/CMakeFiles/Logging.dir/Logging/LoggerMessage.cpp.o.d"
+  "/root/repo/src/Logging/LoggerRef.cpp" "src/CMakeFiles/Logging.dir/Logging/LoggerRef.cpp.o" "gcc" "src/CMakeFiles/Logging.dir/Logging/LoggerRef.cpp.o.d"
+  "/root/repo/src/Logging/StreamLogger.cpp" "src/CMakeFiles/Logging.dir/Logging/StreamLogger.cpp.o" "gcc" "src/CMakeFiles/Logging.dir/Logging/StreamLogger.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Miner.dir/Miner/BlockchainMonitor.cpp.o"
+  "CMakeFiles/Miner.dir/Miner/BlockchainMonitor.cpp.o.d"
+  "CMakeFiles/Miner.dir/Miner/Miner.cpp.o"
+  "CMakeFiles/Miner.dir/Miner/Miner.cpp.o.d"
+  "CMakeFiles/Miner.dir/Miner/MinerManager.cpp.o"
+  "CMakeFiles/Miner.dir/Miner/MinerManager.cpp.o.d"
+  "CMakeFiles/Miner.dir/Miner/MiningConfig.cpp.o"
+  "CMakeFiles/Miner.dir/Miner/MiningConfig.cpp.o.d"
+  "CMakeFiles/Miner.dir/Miner/main.cpp.o"
+  "CMakeFiles/Miner.dir/Miner/main.cpp.o.d"
+  "RUB"
+  "RUB.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Miner.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,33 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/P2P.dir/CryptoNoteProtocol/CryptoNoteProtocolHandler.cpp.o"
+  "CMakeFiles/P2P.dir/CryptoNoteProtocol/CryptoNoteProtocolHandler.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/IP2pNodeInternal.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/IP2pNodeInternal.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/LevinProtocol.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/LevinProtocol.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/NetNode.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/NetNode.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/NetNodeConfig.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/NetNodeConfig.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/P2pConnectionProxy.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/P2pConnectionProxy.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/P2pContext.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/P2pContext.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/P2pContextOwner.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/P2pContextOwner.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/P2pInterfaces.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/P2pInterfaces.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/P2pNode.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/P2pNode.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/P2pNodeConfig.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/P2pNodeConfig.cpp.o.d"
+  "CMakeFiles/P2P.dir/P2p/PeerListManager.cpp.o"
+  "CMakeFiles/P2P.dir/P2p/PeerListManager.cpp.o.d"
+  "libP2P.a"
+  "libP2P.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/P2P.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/PaymentGate/NodeFactory.cpp" "src/CMakeFiles/PaymentGate.dir/PaymentGate/NodeFactory.cpp.o" "gcc" "src/CMakeFiles/PaymentGate.dir/PaymentGate/NodeFactory.cpp.o.d"
+  "/root/repo/src/PaymentGate/PaymentServiceJsonRpcMessages.cpp" "src/CMakeFiles/PaymentGate.dir/PaymentGate/PaymentServiceJsonRpcMessages.cpp.o" "gcc" "src/CMakeFiles/PaymentGate.dir/PaymentGate/PaymentServiceJsonRpcMessages.cpp.o.d"
+  "/root/repo/src/PaymentGate/PaymentServiceJsonRpcServer.cpp" "src/CMakeFiles/PaymentGate.dir/PaymentGate/PaymentServiceJsonRpcServer.cpp.o" "gcc" "src/CMakeFiles/PaymentGate.dir/PaymentGate/PaymentServiceJsonRpcServer.cpp.o.d"
+  "/root/repo/src/PaymentGate/WalletFactory.cpp" "src/CMakeFiles/PaymentGate.dir/PaymentGate/WalletFactory.cpp.o" "gcc" "src/CMakeFiles/PaymentGate.dir/PaymentGate/WalletFactory.cpp.o.d"
+  "/root/repo/src/PaymentGate/WalletService.cpp" "src/CMakeFiles/PaymentGate.dir/PaymentGate/WalletService.cpp.o" "gcc" "src/CMakeFiles/PaymentGate.dir/PaymentGate/WalletService.cpp.o.d"
+  "/root/repo/src/PaymentGate/WalletServiceErrorCategory.cpp" "src/CMakeFiles/PaymentGate.dir/PaymentGate/WalletServiceErrorCategory.cpp.o" "gcc" "src/CMakeFiles/PaymentGate.dir/PaymentGate/WalletServiceErrorCategory.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,21 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/PaymentGate.dir/PaymentGate/NodeFactory.cpp.o"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/NodeFactory.cpp.o.d"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/PaymentServiceJsonRpcMessages.cpp.o"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/PaymentServiceJsonRpcMessages.cpp.o.d"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/PaymentServiceJsonRpcServer.cpp.o"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/PaymentServiceJsonRpcServer.cpp.o.d"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/WalletFactory.cpp.o"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/WalletFactory.cpp.o.d"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/WalletService.cpp.o"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/WalletService.cpp.o.d"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/WalletServiceErrorCategory.cpp.o"
+  "CMakeFiles/PaymentGate.dir/PaymentGate/WalletServiceErrorCategory.cpp.o.d"
+  "libPaymentGate.a"
+  "libPaymentGate.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/PaymentGate.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
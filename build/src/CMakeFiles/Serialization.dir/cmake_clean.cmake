@@ -0,0 +1,27 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Serialization.dir/Serialization/BinaryInputStreamSerializer.cpp.o"
+  "CMakeFiles/Serialization.dir/Serialization/BinaryInputStreamSerializer.cpp.o.d"
+  "CMakeFiles/Serialization.dir/Serialization/BinaryOutputStreamSerializer.cpp.o"
+  "CMakeFiles/Serialization.dir/Serialization/BinaryOutputStreamSerializer.cpp.o.d"
+  "CMakeFiles/Serialization.dir/Serialization/JsonInputStreamSerializer.cpp.o"
+  "CMakeFiles/Serialization.dir/Serialization/JsonInputStreamSerializer.cpp.o.d"
+  "CMakeFiles/Serialization.dir/Serialization/JsonInputValueSerializer.cpp.o"
+  "CMakeFiles/Serialization.dir/Serialization/JsonInputValueSerializer.cpp.o.d"
+  "CMakeFiles/Serialization.dir/Serialization/JsonOutputStreamSerializer.cpp.o"
+  "CMakeFiles/Serialization.dir/Serialization/JsonOutputStreamSerializer.cpp.o.d"
+  "CMakeFiles/Serialization.dir/Serialization/KVBinaryInputStreamSerializer.cpp.o"
+  "CMakeFiles/Serialization.dir/Serialization/KVBinaryInputStreamSerializer.cpp.o.d"
+  "CMakeFiles/Serialization.dir/Serialization/KVBinaryOutputStreamSerializer.cpp.o"
+  "CMakeFiles/Serialization.dir/Serialization/KVBinaryOutputStreamSerializer.cpp.o.d"
+  "CMakeFiles/Serialization.dir/Serialization/MemoryStream.cpp.o"
+  "CMakeFiles/Serialization.dir/Serialization/MemoryStream.cpp.o.d"
+  "CMakeFiles/Serialization.dir/Serialization/SerializationOverloads.cpp.o"
+  "CMakeFiles/Serialization.dir/Serialization/SerializationOverloads.cpp.o.d"
+  "libSerialization.a"
+  "libSerialization.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Serialization.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/SimpleWallet.dir/SimpleWallet/PasswordContainer.cpp.o"
+  "CMakeFiles/SimpleWallet.dir/SimpleWallet/PasswordContainer.cpp.o.d"
+  "CMakeFiles/SimpleWallet.dir/SimpleWallet/SimpleWallet.cpp.o"
+  "CMakeFiles/SimpleWallet.dir/SimpleWallet/SimpleWallet.cpp.o.d"
+  "simplewallet"
+  "simplewallet.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/SimpleWallet.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/Transfers/BlockchainSynchronizer.cpp" "src/CMakeFiles/Transfers.dir/Transfers/BlockchainSynchronizer.cpp.o" "gcc" "src/CMakeFiles/Transfers.dir/Transfers/BlockchainSynchronizer.cpp.o.d"
+  "/root/repo/src/Transfers/SynchronizationState.cpp" "src/CMakeFiles/Transfers.dir/Transfers/SynchronizationState.cpp.o" "gcc" "src/CMakeFiles/Transfers.dir/Transfers/SynchronizationState.cpp.o.d"
+  "/root/repo/src/Transfers/TransfersConsumer.cpp" "src/CMakeFiles/Transfers.dir/Transfers/TransfersConsumer.cpp.o" "gcc" "src/CMakeFiles/Transfers.dir/Transfers/TransfersConsumer.cpp.o.d"
+  "/root/repo/src/Transfers/TransfersContainer.cpp" "src/CMakeFiles/Transfers.dir/Transfers/TransfersContainer.cpp.o" "gcc" "src/CMakeFiles/Transfers.dir/Transfers/TransfersContainer.cpp.o.d"
+  "/root/repo/src/Transfers/TransfersSubscription.cpp" "src/CMakeFiles/Transfers.dir/Transfers/TransfersSubscription.cpp.o" "gcc" "src/CMakeFiles/Transfers.dir/Transfers/TransfersSubscription.cpp.o.d"
+  "/root/repo/src/Transfers/TransfersSynchronizer.cpp" "src/CMakeFiles/Transfers.dir/Transfers/TransfersSynchronizer.cpp.o" "gcc" "src/CMakeFiles/Transfers.dir/Transfers/TransfersSynchronizer.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,39 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Wallet.dir/Wallet/LegacyKeysImporter.cpp.o"
+  "CMakeFiles/Wallet.dir/Wallet/LegacyKeysImporter.cpp.o.d"
+  "CMakeFiles/Wallet.dir/Wallet/WalletAsyncContextCounter.cpp.o"
+  "CMakeFiles/Wallet.dir/Wallet/WalletAsyncContextCounter.cpp.o.d"
+  "CMakeFiles/Wallet.dir/Wallet/WalletErrors.cpp.o"
+  "CMakeFiles/Wallet.dir/Wallet/WalletErrors.cpp.o.d"
+  "CMakeFiles/Wallet.dir/Wallet/WalletGreen.cpp.o"
+  "CMakeFiles/Wallet.dir/Wallet/WalletGreen.cpp.o.d"
+  "CMakeFiles/Wallet.dir/Wallet/WalletRpcServer.cpp.o"
+  "CMakeFiles/Wallet.dir/Wallet/WalletRpcServer.cpp.o.d"
+  "CMakeFiles/Wallet.dir/Wallet/WalletSerialization.cpp.o"
+  "CMakeFiles/Wallet.dir/Wallet/WalletSerialization.cpp.o.d"
+  "CMakeFiles/Wallet.dir/Wallet/WalletUtils.cpp.o"
+  "CMakeFiles/Wallet.dir/Wallet/WalletUtils.cpp.o.d"
+  "CMakeFiles/Wallet.dir/WalletLegacy/KeysStorage.cpp.o"
+  "CMakeFiles/Wallet.dir/WalletLegacy/KeysStorage.cpp.o.d"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletHelper.cpp.o"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletHelper.cpp.o.d"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletLegacy.cpp.o"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletLegacy.cpp.o.d"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletLegacySerialization.cpp.o"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletLegacySerialization.cpp.o.d"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletLegacySerializer.cpp.o"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletLegacySerializer.cpp.o.d"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletTransactionSender.cpp.o"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletTransactionSender.cpp.o.d"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletUnconfirmedTransactions.cpp.o"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletUnconfirmedTransactions.cpp.o.d"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletUserTransactionsCache.cpp.o"
+  "CMakeFiles/Wallet.dir/WalletLegacy/WalletUserTransactionsCache.cpp.o.d"
+  "libWallet.a"
+  "libWallet.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Wallet.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DifficultyTests.dir/Difficulty/Difficulty.cpp.o"
+  "CMakeFiles/DifficultyTests.dir/Difficulty/Difficulty.cpp.o.d"
+  "difficulty_tests"
+  "difficulty_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DifficultyTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
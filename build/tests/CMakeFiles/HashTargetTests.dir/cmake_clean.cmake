@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/HashTargetTests.dir/HashTarget.cpp.o"
+  "CMakeFiles/HashTargetTests.dir/HashTarget.cpp.o.d"
+  "hash_target_tests"
+  "hash_target_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/HashTargetTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
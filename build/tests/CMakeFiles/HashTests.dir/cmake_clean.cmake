@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/HashTests.dir/Hash/main.cpp.o"
+  "CMakeFiles/HashTests.dir/Hash/main.cpp.o.d"
+  "hash_tests"
+  "hash_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/HashTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
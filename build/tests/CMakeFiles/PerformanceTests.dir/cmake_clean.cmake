@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/PerformanceTests.dir/PerformanceTests/main.cpp.o"
+  "CMakeFiles/PerformanceTests.dir/PerformanceTests/main.cpp.o.d"
+  "performance_tests"
+  "performance_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/PerformanceTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,41 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/SystemTests.dir/System/ContextGroupTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/ContextGroupTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/ContextGroupTimeoutTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/ContextGroupTimeoutTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/ContextTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/ContextTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/DispatcherTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/DispatcherTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/ErrorMessageTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/ErrorMessageTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/EventLockTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/EventLockTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/EventTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/EventTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/Ipv4AddressTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/Ipv4AddressTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/Ipv4ResolverTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/Ipv4ResolverTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/OperationTimeoutTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/OperationTimeoutTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/RemoteContextTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/RemoteContextTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/TcpConnectionTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/TcpConnectionTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/TcpConnectorTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/TcpConnectorTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/TcpListenerTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/TcpListenerTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/TimerTests.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/TimerTests.cpp.o.d"
+  "CMakeFiles/SystemTests.dir/System/main.cpp.o"
+  "CMakeFiles/SystemTests.dir/System/main.cpp.o.d"
+  "system_tests"
+  "system_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/SystemTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
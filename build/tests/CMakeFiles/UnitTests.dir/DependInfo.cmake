@@ -0,0 +1,79 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/UnitTests/ArrayRefTests.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/ArrayRefTests.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/ArrayRefTests.cpp.o.d"
+  "/root/repo/tests/UnitTests/ArrayViewTests.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/ArrayViewTests.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/ArrayViewTests.cpp.o.d"
+  "/root/repo/tests/UnitTests/Base58.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/Base58.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/Base58.cpp.o.d"
+  "/root/repo/tests/UnitTests/BlockReward.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/BlockReward.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/BlockReward.cpp.o.d"
+  "/root/repo/tests/UnitTests/BlockingQueue.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/BlockingQueue.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/BlockingQueue.cpp.o.d"
+  "/root/repo/tests/UnitTests/Chacha8.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/Chacha8.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/Chacha8.cpp.o.d"
+  "/root/repo/tests/UnitTests/Checkpoints.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/Checkpoints.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/Checkpoints.cpp.o.d"
+  "/root/repo/tests/UnitTests/DecomposeAmountIntoDigits.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/DecomposeAmountIntoDigits.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/DecomposeAmountIntoDigits.cpp.o.d"
+  "/root/repo/tests/UnitTests/EventWaiter.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/EventWaiter.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/EventWaiter.cpp.o.d"
+  "/root/repo/tests/UnitTests/ICoreStub.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/ICoreStub.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/ICoreStub.cpp.o.d"
+  "/root/repo/tests/UnitTests/ICryptoNoteProtocolQueryStub.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/ICryptoNoteProtocolQueryStub.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/ICryptoNoteProtocolQueryStub.cpp.o.d"
+  "/root/repo/tests/UnitTests/INodeStubs.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/INodeStubs.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/INodeStubs.cpp.o.d"
+  "/root/repo/tests/UnitTests/MulDiv.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/MulDiv.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/MulDiv.cpp.o.d"
+  "/root/repo/tests/UnitTests/ParseAmount.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/ParseAmount.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/ParseAmount.cpp.o.d"
+  "/root/repo/tests/UnitTests/PaymentGateTests.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/PaymentGateTests.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/PaymentGateTests.cpp.o.d"
+  "/root/repo/tests/UnitTests/Serialization.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/Serialization.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/Serialization.cpp.o.d"
+  "/root/repo/tests/UnitTests/SerializationKV.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/SerializationKV.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/SerializationKV.cpp.o.d"
+  "/root/repo/tests/UnitTests/Shuffle.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/Shuffle.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/Shuffle.cpp.o.d"
+  "/root/repo/tests/UnitTests/StringBufferTests.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/StringBufferTests.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/StringBufferTests.cpp.o.d"
+  "/root/repo/tests/UnitTests/StringViewTests.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/StringViewTests.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/StringViewTests.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestBcS.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestBcS.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestBcS.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestBlockchainExplorer.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestBlockchainExplorer.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestBlockchainExplorer.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestBlockchainGenerator.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestBlockchainGenerator.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestBlockchainGenerator.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestCurrency.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestCurrency.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestCurrency.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestFormatUtils.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestFormatUtils.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestFormatUtils.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestInprocessNode.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestInprocessNode.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestInprocessNode.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestJsonValue.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestJsonValue.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestJsonValue.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestMessageQueue.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestMessageQueue.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestMessageQueue.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestPath.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestPath.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestPath.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestPeerlist.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestPeerlist.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestPeerlist.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestProtocolPack.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestProtocolPack.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestProtocolPack.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestTransactionPoolDetach.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransactionPoolDetach.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransactionPoolDetach.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestTransfers.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransfers.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransfers.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestTransfersConsumer.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransfersConsumer.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransfersConsumer.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestTransfersContainer.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransfersContainer.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransfersContainer.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestTransfersContainerKeyImage.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransfersContainerKeyImage.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransfersContainerKeyImage.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestTransfersSubscription.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransfersSubscription.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestTransfersSubscription.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestWallet.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestWallet.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestWallet.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestWalletLegacy.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestWalletLegacy.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestWalletLegacy.cpp.o.d"
+  "/root/repo/tests/UnitTests/TestWalletService.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestWalletService.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TestWalletService.cpp.o.d"
+  "/root/repo/tests/UnitTests/TransactionApi.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TransactionApi.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TransactionApi.cpp.o.d"
+  "/root/repo/tests/UnitTests/TransactionApiHelpers.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TransactionApiHelpers.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TransactionApiHelpers.cpp.o.d"
+  "/root/repo/tests/UnitTests/TransactionPool.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/TransactionPool.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/TransactionPool.cpp.o.d"
+  "/root/repo/tests/UnitTests/main.cpp" "tests/CMakeFiles/UnitTests.dir/UnitTests/main.cpp.o" "gcc" "tests/CMakeFiles/UnitTests.dir/UnitTests/main.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/build/external/gtest/CMakeFiles/gtest_main.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/PaymentGate.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Wallet.dir/DependInfo.cmake"
+  "/root/repo/build/tests/CMakeFiles/TestGenerator.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/InProcessNode.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/NodeRpcProxy.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Rpc.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Http.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Transfers.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Serialization.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/System.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Logging.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/BlockchainExplorer.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Common.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/CryptoNoteCore.dir/DependInfo.cmake"
+  "/root/repo/build/src/CMakeFiles/Crypto.dir/DependInfo.cmake"
+  "/root/repo/build/external/gtest/CMakeFiles/gtest.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
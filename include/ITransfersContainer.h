@@ -45,13 +45,14 @@ struct TransactionOutputInformation {
     Crypto::PublicKey outputKey;         // Type: Key 
     uint32_t requiredSignatures; // Type: Multisignature
   };
+
+  Crypto::KeyImage keyImage;  //!< \attention Used only for TransactionTypes::OutputType::Key, computed when the output is received
 };
 
 struct TransactionSpentOutputInformation: public TransactionOutputInformation {
   uint32_t spendingBlockHeight;
   uint64_t timestamp;
   Crypto::Hash spendingTransactionHash;
-  Crypto::KeyImage keyImage;  //!< \attention Used only for TransactionTypes::OutputType::Key
   uint32_t inputInTransaction;
 };
 
@@ -0,0 +1,264 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "MemoryMappedFile.h"
+
+#include <cassert>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Common {
+
+namespace {
+
+std::string lastError() {
+#ifdef _WIN32
+  return std::system_category().message(static_cast<int>(GetLastError()));
+#else
+  return std::system_category().message(errno);
+#endif
+}
+
+}
+
+#ifdef _WIN32
+
+MemoryMappedFile::MemoryMappedFile() : m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr), m_data(nullptr), m_size(0) {
+}
+
+#else
+
+MemoryMappedFile::MemoryMappedFile() : m_file(-1), m_data(nullptr), m_size(0) {
+}
+
+#endif
+
+MemoryMappedFile::~MemoryMappedFile() {
+  close();
+}
+
+bool MemoryMappedFile::isOpened() const {
+#ifdef _WIN32
+  return m_file != INVALID_HANDLE_VALUE;
+#else
+  return m_file != -1;
+#endif
+}
+
+const std::string& MemoryMappedFile::path() const {
+  return m_path;
+}
+
+uint64_t MemoryMappedFile::size() const {
+  return m_size;
+}
+
+uint8_t* MemoryMappedFile::data() {
+  return m_data;
+}
+
+const uint8_t* MemoryMappedFile::data() const {
+  return m_data;
+}
+
+#ifdef _WIN32
+
+void MemoryMappedFile::open(const std::string& path, bool create) {
+  assert(!isOpened());
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, create ? OPEN_ALWAYS : OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("MemoryMappedFile::open, CreateFile failed, " + lastError());
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize)) {
+    std::string message = lastError();
+    CloseHandle(file);
+    throw std::runtime_error("MemoryMappedFile::open, GetFileSizeEx failed, " + message);
+  }
+
+  m_file = file;
+  m_path = path;
+  m_size = static_cast<uint64_t>(fileSize.QuadPart);
+  try {
+    map();
+  } catch (std::exception&) {
+    close();
+    throw;
+  }
+}
+
+void MemoryMappedFile::close() {
+  if (!isOpened()) {
+    return;
+  }
+
+  unmap();
+  CloseHandle(m_file);
+  m_file = INVALID_HANDLE_VALUE;
+  m_size = 0;
+  m_path.clear();
+}
+
+void MemoryMappedFile::resize(uint64_t size) {
+  assert(isOpened());
+  unmap();
+
+  LARGE_INTEGER distance;
+  distance.QuadPart = static_cast<LONGLONG>(size);
+  if (!SetFilePointerEx(m_file, distance, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file)) {
+    throw std::runtime_error("MemoryMappedFile::resize, SetEndOfFile failed, " + lastError());
+  }
+
+  m_size = size;
+  map();
+}
+
+void MemoryMappedFile::flush(uint64_t offset, uint64_t size) {
+  assert(offset + size <= m_size);
+  if (size == 0) {
+    return;
+  }
+
+  if (!FlushViewOfFile(m_data + offset, static_cast<SIZE_T>(size)) || !FlushFileBuffers(m_file)) {
+    throw std::runtime_error("MemoryMappedFile::flush, " + lastError());
+  }
+}
+
+void MemoryMappedFile::map() {
+  if (m_size == 0) {
+    return;
+  }
+
+  HANDLE mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, static_cast<DWORD>(m_size >> 32), static_cast<DWORD>(m_size), nullptr);
+  if (mapping == nullptr) {
+    throw std::runtime_error("MemoryMappedFile::map, CreateFileMapping failed, " + lastError());
+  }
+
+  void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<SIZE_T>(m_size));
+  if (data == nullptr) {
+    std::string message = lastError();
+    CloseHandle(mapping);
+    throw std::runtime_error("MemoryMappedFile::map, MapViewOfFile failed, " + message);
+  }
+
+  m_mapping = mapping;
+  m_data = static_cast<uint8_t*>(data);
+}
+
+void MemoryMappedFile::unmap() {
+  if (m_data != nullptr) {
+    UnmapViewOfFile(m_data);
+    m_data = nullptr;
+  }
+
+  if (m_mapping != nullptr) {
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+  }
+}
+
+#else
+
+void MemoryMappedFile::open(const std::string& path, bool create) {
+  assert(!isOpened());
+  int file = ::open(path.c_str(), O_RDWR | (create ? O_CREAT : 0), 0644);
+  if (file == -1) {
+    throw std::runtime_error("MemoryMappedFile::open, open failed, " + lastError());
+  }
+
+  struct stat fileStat;
+  if (fstat(file, &fileStat) != 0) {
+    std::string message = lastError();
+    ::close(file);
+    throw std::runtime_error("MemoryMappedFile::open, fstat failed, " + message);
+  }
+
+  m_file = file;
+  m_path = path;
+  m_size = static_cast<uint64_t>(fileStat.st_size);
+  try {
+    map();
+  } catch (std::exception&) {
+    close();
+    throw;
+  }
+}
+
+void MemoryMappedFile::close() {
+  if (!isOpened()) {
+    return;
+  }
+
+  unmap();
+  ::close(m_file);
+  m_file = -1;
+  m_size = 0;
+  m_path.clear();
+}
+
+void MemoryMappedFile::resize(uint64_t size) {
+  assert(isOpened());
+  unmap();
+  if (ftruncate(m_file, static_cast<off_t>(size)) != 0) {
+    std::string message = lastError();
+    map();
+    throw std::runtime_error("MemoryMappedFile::resize, ftruncate failed, " + message);
+  }
+
+  m_size = size;
+  map();
+}
+
+void MemoryMappedFile::flush(uint64_t offset, uint64_t size) {
+  assert(offset + size <= m_size);
+  if (size == 0) {
+    return;
+  }
+
+  // msync requires a page aligned address
+  uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  uint64_t alignedOffset = offset - offset % pageSize;
+  if (msync(m_data + alignedOffset, static_cast<size_t>(size + offset - alignedOffset), MS_SYNC) != 0) {
+    throw std::runtime_error("MemoryMappedFile::flush, msync failed, " + lastError());
+  }
+}
+
+void MemoryMappedFile::map() {
+  if (m_size == 0) {
+    return;
+  }
+
+  void* data = mmap(nullptr, static_cast<size_t>(m_size), PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("MemoryMappedFile::map, mmap failed, " + lastError());
+  }
+
+  m_data = static_cast<uint8_t*>(data);
+}
+
+void MemoryMappedFile::unmap() {
+  if (m_data != nullptr) {
+    munmap(m_data, static_cast<size_t>(m_size));
+    m_data = nullptr;
+  }
+}
+
+#endif
+
+}
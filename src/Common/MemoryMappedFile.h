@@ -0,0 +1,52 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Common {
+
+// Shared read-write mapping of a whole file.
+// Pointers returned by data() are invalidated by resize() and close().
+class MemoryMappedFile {
+public:
+  MemoryMappedFile();
+  ~MemoryMappedFile();
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+  // Opens an existing file, or creates an empty one if create is set. Throws std::runtime_error on failure.
+  void open(const std::string& path, bool create);
+  void close();
+
+  bool isOpened() const;
+  const std::string& path() const;
+  uint64_t size() const;
+  uint8_t* data();
+  const uint8_t* data() const;
+
+  // Changes the file size and remaps it.
+  void resize(uint64_t size);
+  // Writes dirty pages of the given range back to the file and waits for completion.
+  void flush(uint64_t offset, uint64_t size);
+
+private:
+#ifdef _WIN32
+  void* m_file;
+  void* m_mapping;
+#else
+  int m_file;
+#endif
+  std::string m_path;
+  uint8_t* m_data;
+  uint64_t m_size;
+
+  void map();
+  void unmap();
+};
+
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "ReadWriteLock.h"
+
+#include <cassert>
+#include <chrono>
+#include <stdexcept>
+
+namespace Common {
+
+namespace {
+
+uint64_t elapsedMicroseconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+ReadWriteLock::ReadWriteLock() : m_writerRecursion(0), m_waitingWriters(0), m_statistics() {
+}
+
+void ReadWriteLock::lock() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::thread::id self = std::this_thread::get_id();
+  if (m_readers.count(self) != 0) {
+    throw std::logic_error("ReadWriteLock::lock, shared lock cannot be upgraded");
+  }
+
+  ++m_statistics.exclusiveLocks;
+  if (m_writerRecursion != 0 && m_writer == self) {
+    ++m_writerRecursion;
+    return;
+  }
+
+  if (m_writerRecursion != 0 || !m_readers.empty()) {
+    ++m_statistics.contendedExclusiveLocks;
+    auto waitStart = std::chrono::steady_clock::now();
+    ++m_waitingWriters;
+    m_writersCondition.wait(lock, [this] { return m_writerRecursion == 0 && m_readers.empty(); });
+    --m_waitingWriters;
+    m_statistics.exclusiveWaitMicroseconds += elapsedMicroseconds(waitStart);
+  }
+
+  m_writer = self;
+  m_writerRecursion = 1;
+  if (m_exclusiveLockHandler) {
+    m_exclusiveLockHandler();
+  }
+}
+
+void ReadWriteLock::unlock() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  assert(m_writerRecursion != 0 && m_writer == std::this_thread::get_id());
+  if (--m_writerRecursion != 0) {
+    return;
+  }
+
+  m_writer = std::thread::id();
+  if (m_waitingWriters != 0) {
+    m_writersCondition.notify_one();
+  } else {
+    m_readersCondition.notify_all();
+  }
+}
+
+void ReadWriteLock::lock_shared() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::thread::id self = std::this_thread::get_id();
+  ++m_statistics.sharedLocks;
+  if (m_writerRecursion != 0 && m_writer == self) {
+    ++m_writerRecursion;
+    return;
+  }
+
+  auto reader = m_readers.find(self);
+  if (reader != m_readers.end()) {
+    ++reader->second;
+    return;
+  }
+
+  if (m_writerRecursion != 0 || m_waitingWriters != 0) {
+    ++m_statistics.contendedSharedLocks;
+    auto waitStart = std::chrono::steady_clock::now();
+    m_readersCondition.wait(lock, [this] { return m_writerRecursion == 0 && m_waitingWriters == 0; });
+    m_statistics.sharedWaitMicroseconds += elapsedMicroseconds(waitStart);
+  }
+
+  m_readers.emplace(self, 1);
+}
+
+void ReadWriteLock::unlock_shared() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::thread::id self = std::this_thread::get_id();
+  if (m_writerRecursion != 0 && m_writer == self) {
+    --m_writerRecursion;
+    return;
+  }
+
+  auto reader = m_readers.find(self);
+  assert(reader != m_readers.end());
+  if (--reader->second != 0) {
+    return;
+  }
+
+  m_readers.erase(reader);
+  if (m_readers.empty() && m_waitingWriters != 0) {
+    m_writersCondition.notify_one();
+  }
+}
+
+void ReadWriteLock::setExclusiveLockHandler(std::function<void()>&& handler) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_exclusiveLockHandler = std::move(handler);
+}
+
+ReadWriteLockStatistics ReadWriteLock::getStatistics() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_statistics;
+}
+
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace Common {
+
+struct ReadWriteLockStatistics {
+  uint64_t sharedLocks;
+  uint64_t exclusiveLocks;
+  // acquisitions that had to wait for another thread
+  uint64_t contendedSharedLocks;
+  uint64_t contendedExclusiveLocks;
+  uint64_t sharedWaitMicroseconds;
+  uint64_t exclusiveWaitMicroseconds;
+};
+
+// Reader/writer lock, recursive for both modes.
+// A thread that holds the exclusive lock may take the shared one, the opposite is not supported and throws std::logic_error.
+// Waiting writers block new readers, but a thread that already holds the shared lock can always take it again.
+class ReadWriteLock {
+public:
+  ReadWriteLock();
+  ReadWriteLock(const ReadWriteLock&) = delete;
+  ReadWriteLock& operator=(const ReadWriteLock&) = delete;
+
+  void lock();
+  void unlock();
+  void lock_shared();
+  void unlock_shared();
+
+  // Handler is called right after a thread takes the exclusive lock that no other thread holds, so nothing else
+  // is inside the lock at that moment. It runs with the internal state locked and must not use this lock.
+  void setExclusiveLockHandler(std::function<void()>&& handler);
+  ReadWriteLockStatistics getStatistics() const;
+
+private:
+  mutable std::mutex m_mutex;
+  std::condition_variable m_readersCondition;
+  std::condition_variable m_writersCondition;
+  std::thread::id m_writer;
+  size_t m_writerRecursion;
+  size_t m_waitingWriters;
+  std::unordered_map<std::thread::id, size_t> m_readers;
+  std::function<void()> m_exclusiveLockHandler;
+  ReadWriteLockStatistics m_statistics;
+};
+
+class SharedLockGuard {
+public:
+  explicit SharedLockGuard(ReadWriteLock& lock) : m_lock(lock) {
+    m_lock.lock_shared();
+  }
+
+  ~SharedLockGuard() {
+    m_lock.unlock_shared();
+  }
+
+  SharedLockGuard(const SharedLockGuard&) = delete;
+  SharedLockGuard& operator=(const SharedLockGuard&) = delete;
+
+private:
+  ReadWriteLock& m_lock;
+};
+
+}
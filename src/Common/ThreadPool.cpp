@@ -0,0 +1,115 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "ThreadPool.h"
+
+namespace Common {
+
+ThreadPool::ThreadPool(size_t workerCount) : m_job(nullptr), m_count(0), m_jobNumber(0), m_busyWorkers(0), m_stopped(false), m_nextIndex(0), m_failed(false) {
+  m_workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; ++i) {
+    m_workers.emplace_back(&ThreadPool::workerProcedure, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+
+  m_jobCondition.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::workerCount() const {
+  return m_workers.size();
+}
+
+bool ThreadPool::runAll(size_t count, const std::function<bool(size_t)>& job) {
+  std::lock_guard<std::mutex> runLock(m_runMutex);
+  m_nextIndex = 0;
+  m_failed = false;
+  m_exception = nullptr;
+
+  if (!m_workers.empty() && count > 1) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_job = &job;
+      m_count = count;
+      ++m_jobNumber;
+    }
+
+    m_jobCondition.notify_all();
+    runIterations(job, count);
+
+    // workers that have not picked the job up yet will find it removed
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_busyWorkers == 0; });
+    m_job = nullptr;
+    m_count = 0;
+  } else {
+    runIterations(job, count);
+  }
+
+  if (m_exception) {
+    std::rethrow_exception(m_exception);
+  }
+
+  return !m_failed;
+}
+
+void ThreadPool::workerProcedure() {
+  uint64_t lastJobNumber = 0;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_jobCondition.wait(lock, [&] { return m_stopped || m_jobNumber != lastJobNumber; });
+    if (m_stopped) {
+      break;
+    }
+
+    lastJobNumber = m_jobNumber;
+    if (m_job == nullptr) {
+      continue;
+    }
+
+    const std::function<bool(size_t)>& job = *m_job;
+    size_t count = m_count;
+    ++m_busyWorkers;
+    lock.unlock();
+
+    runIterations(job, count);
+
+    lock.lock();
+    if (--m_busyWorkers == 0) {
+      m_doneCondition.notify_all();
+    }
+  }
+}
+
+void ThreadPool::runIterations(const std::function<bool(size_t)>& job, size_t count) {
+  while (!m_failed) {
+    size_t index = m_nextIndex++;
+    if (index >= count) {
+      break;
+    }
+
+    try {
+      if (!job(index)) {
+        m_failed = true;
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_exception) {
+        m_exception = std::current_exception();
+      }
+
+      m_failed = true;
+    }
+  }
+}
+
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Common {
+
+// Fixed set of worker threads that run the iterations of a job together with the calling thread.
+class ThreadPool {
+public:
+  // Pool with no workers runs jobs on the calling thread only
+  explicit ThreadPool(size_t workerCount);
+  ThreadPool(const ThreadPool&) = delete;
+  ~ThreadPool();
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t workerCount() const;
+
+  // Calls job(index) for every index in [0, count) in no particular order and returns true if all calls returned true.
+  // As soon as a call returns false or throws, iterations that have not started yet are skipped.
+  // Exception thrown by the job is rethrown in the calling thread.
+  bool runAll(size_t count, const std::function<bool(size_t)>& job);
+
+private:
+  void workerProcedure();
+  void runIterations(const std::function<bool(size_t)>& job, size_t count);
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_runMutex;
+  std::mutex m_mutex;
+  std::condition_variable m_jobCondition;
+  std::condition_variable m_doneCondition;
+  const std::function<bool(size_t)>* m_job;
+  size_t m_count;
+  uint64_t m_jobNumber;
+  size_t m_busyWorkers;
+  bool m_stopped;
+  std::atomic<size_t> m_nextIndex;
+  std::atomic<bool> m_failed;
+  std::exception_ptr m_exception;
+};
+
+}
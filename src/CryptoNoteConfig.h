@@ -66,6 +66,8 @@ const size_t   FUSION_TX_MIN_IN_OUT_COUNT_RATIO              = 4;
 const char     CRYPTONOTE_BLOCKS_FILENAME[]                  = "blocks.dat";
 const char     CRYPTONOTE_BLOCKINDEXES_FILENAME[]            = "blockindexes.dat";
 const char     CRYPTONOTE_BLOCKSCACHE_FILENAME[]             = "blockscache.dat";
+const char     CRYPTONOTE_BLOCKSCACHE_JOURNAL_FILENAME[]     = "blockscachejournal.dat";
+const char     CRYPTONOTE_BLOCKSCACHE_JOURNAL_INDEXES_FILENAME[] = "blockscachejournalindexes.dat";
 const char     CRYPTONOTE_POOLDATA_FILENAME[]                = "poolstate.bin";
 const char     P2P_NET_DATA_FILENAME[]                       = "p2pstate.bin";
 const char     CRYPTONOTE_BLOCKCHAIN_INDICES_FILENAME[]      = "blockchainindices.dat";
@@ -82,6 +84,8 @@ const uint8_t  BLOCK_MINOR_VERSION_0                         =  0;
 
 const size_t   BLOCKS_IDS_SYNCHRONIZING_DEFAULT_COUNT        =  20000;  //by default, blocks ids count in synchronizing
 const size_t   BLOCKS_SYNCHRONIZING_DEFAULT_COUNT            =  200;    //by default, blocks count in blocks downloading
+const size_t   BLOCKS_SYNCHRONIZING_MAX_SPAN_COUNT           =  16;     //spans of blocks downloaded or waiting for processing at once
+const uint32_t BLOCKS_SYNCHRONIZING_SPAN_TIMEOUT             =  30;     //seconds before a span is requested from one more peer
 const size_t   COMMAND_RPC_GET_BLOCKS_FAST_MAX_COUNT         =  500;
 
 //TODO This port will be used by the daemon to establish connections with p2p network
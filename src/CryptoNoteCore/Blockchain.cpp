@@ -6,6 +6,8 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <future>
+#include <thread>
 #include <boost/foreach.hpp>
 #include "Common/Math.h"
 #include "Common/ShuffleGenerator.h"
@@ -20,6 +22,21 @@ using namespace Common;
 
 namespace {
 
+const uint32_t INDEX_JOURNAL_SEGMENT_SIZE = 1000;
+// blocks hashed at once while the cache is rebuilt, the most cn_fast_hash_batch hashes together
+const uint32_t REBUILD_HASHING_BATCH_SIZE = 8;
+// about 2.5 KB per key
+const size_t RING_MEMBER_CACHE_SIZE = 4096;
+const size_t RING_SIGNATURES_PER_BATCH = 8;
+// about 100 bytes per input
+const size_t SIGNATURE_CACHE_SIZE = 65536;
+// about 150 bytes per block
+const size_t PROOF_OF_WORK_CACHE_SIZE = 4096;
+
+uint64_t toMilliseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+}
+
 std::string appendPath(const std::string& path, const std::string& fileName) {
   std::string result = path;
   if (!result.empty()) {
@@ -174,20 +191,27 @@ public:
       s(m_lastBlockHash, "last_block");
     }
 
-    logger(INFO) << operation << "block index...";
+    auto sectionStart = std::chrono::steady_clock::now();
+    auto sectionDone = [&](const char* section) {
+      auto now = std::chrono::steady_clock::now();
+      logger(INFO) << operation << section << ": " << std::chrono::duration_cast<std::chrono::milliseconds>(now - sectionStart).count() << "ms";
+      sectionStart = now;
+    };
+
     s(m_bs.m_blockIndex, "block_index");
+    sectionDone("block index");
 
-    logger(INFO) << operation << "transaction map...";
     s(m_bs.m_transactionMap, "transactions");
+    sectionDone("transaction map");
 
-    logger(INFO) << operation << "spent keys...";
     s(m_bs.m_spent_keys, "spent_keys");
+    sectionDone("spent keys");
 
-    logger(INFO) << operation << "outputs...";
     s(m_bs.m_outputs, "outputs");
+    sectionDone("outputs");
 
-    logger(INFO) << operation << "multi-signature outputs...";
     s(m_bs.m_multisignatureOutputs, "multisig_outputs");
+    sectionDone("multi-signature outputs");
 
     auto dur = std::chrono::steady_clock::now() - start;
 
@@ -306,11 +330,18 @@ m_currency(currency),
 m_tx_pool(tx_pool),
 m_current_block_cumul_sz_limit(0),
 m_is_in_checkpoint_zone(false),
+m_trustCheckpoints(false),
+m_rebuildThreads(0),
+m_ringMemberCache(RING_MEMBER_CACHE_SIZE),
+m_signatureCache(SIGNATURE_CACHE_SIZE),
+m_proofOfWorkCache(PROOF_OF_WORK_CACHE_SIZE),
 m_checkpoints(logger) {
 
   m_outputs.set_deleted_key(0);
   Crypto::KeyImage nullImage = boost::value_initialized<decltype(nullImage)>();
   m_spent_keys.set_deleted_key(nullImage);
+  // readers are gone once the exclusive lock is taken, their block caches are not needed any more
+  m_blockchain_lock.setExclusiveLockHandler([this] { m_blocks.releaseThreadCaches(); });
 }
 
 bool Blockchain::addObserver(IBlockchainStorageObserver* observer) {
@@ -380,18 +411,22 @@ bool Blockchain::checkTransactionSize(size_t blobSize) {
   return true;
 }
 
+bool Blockchain::isInTrustedCheckpointZone() {
+  return m_trustCheckpoints && m_checkpoints.is_in_checkpoint_zone(getCurrentBlockchainHeight());
+}
+
 bool Blockchain::haveTransaction(const Crypto::Hash &id) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return m_transactionMap.find(id) != m_transactionMap.end();
 }
 
 bool Blockchain::have_tx_keyimg_as_spent(const Crypto::KeyImage &key_im) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return  m_spent_keys.find(key_im) != m_spent_keys.end();
 }
 
 uint32_t Blockchain::getCurrentBlockchainHeight() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return static_cast<uint32_t>(m_blocks.size());
 }
 
@@ -408,12 +443,21 @@ bool Blockchain::init(const std::string& config_folder, bool load_existing) {
     return false;
   }
 
+  // segments are read once in order, so there is nothing to cache
+  if (!m_indexJournal.open(appendPath(config_folder, m_currency.blocksCacheJournalFileName()), appendPath(config_folder, m_currency.blocksCacheJournalIndexesFileName()), 1)) {
+    return false;
+  }
+
+  m_pendingIndexDeltas.clear();
   if (load_existing && !m_blocks.empty()) {
     logger(INFO, BRIGHT_WHITE) << "Loading blockchain...";
+    validateIndexJournal();
     BlockCacheSerializer loader(*this, get_block_hash(m_blocks.back().bl), logger.getLogger());
     loader.load(appendPath(config_folder, m_currency.blocksCacheFileName()));
 
-    if (!loader.loaded()) {
+    if (loader.loaded()) {
+      loadPendingIndexDeltas();
+    } else {
       logger(WARNING, BRIGHT_YELLOW) << "No actual blockchain cache found, rebuilding internal structures...";
       rebuildCache();
     }
@@ -421,13 +465,14 @@ bool Blockchain::init(const std::string& config_folder, bool load_existing) {
     loadBlockchainIndices();
   } else {
     m_blocks.clear();
+    clearIndexJournal();
   }
 
   if (m_blocks.empty()) {
     logger(INFO, BRIGHT_WHITE)
       << "Blockchain not loaded, generating genesis block.";
     block_verification_context bvc = boost::value_initialized<block_verification_context>();
-    pushBlock(m_currency.genesisBlock(), bvc);
+    pushBlock(CachedBlock(m_currency.genesisBlock()), bvc);
     if (bvc.m_verifivation_failed) {
       logger(ERROR, BRIGHT_RED) << "Failed to add genesis block to blockchain";
       return false;
@@ -459,53 +504,252 @@ bool Blockchain::init(const std::string& config_folder, bool load_existing) {
 
 void Blockchain::rebuildCache() {
   std::chrono::steady_clock::time_point timePoint = std::chrono::steady_clock::now();
+  IndexRebuildTimings timings = {};
   m_blockIndex.clear();
   m_transactionMap.clear();
   m_spent_keys.clear();
   m_outputs.clear();
   m_multisignatureOutputs.clear();
-  for (uint32_t b = 0; b < m_blocks.size(); ++b) {
-    if (b % 1000 == 0) {
-      logger(INFO, BRIGHT_WHITE) << "Height " << b << " of " << m_blocks.size();
+
+  uint64_t journalSegments = m_indexJournal.size();
+  for (uint64_t i = 0; i < journalSegments; ++i) {
+    auto readingStart = std::chrono::steady_clock::now();
+    // the journal has a single cache slot, copy the segment before the next access evicts it
+    IndexJournalSegment segment = m_indexJournal[i];
+    timings.journalReading += std::chrono::steady_clock::now() - readingStart;
+
+    if (i % 10 == 0) {
+      logger(INFO, BRIGHT_WHITE) << "Height " << segment.startHeight << " of " << m_blocks.size();
+    }
+
+    applyIndexDeltas(segment.blocks, segment.startHeight, timings);
+  }
+
+  uint32_t tailStart = static_cast<uint32_t>(journalSegments * INDEX_JOURNAL_SEGMENT_SIZE);
+  if (tailStart < m_blocks.size()) {
+    logger(INFO, BRIGHT_WHITE) << "Replaying " << m_blocks.size() - tailStart << " blocks that are not in the index journal";
+  }
+
+  size_t threadCount = m_rebuildThreads;
+  if (threadCount == 0) {
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  // Workers hash and extract deltas of disjoint height ranges, then the batch is applied in height order,
+  // so global output indexes do not depend on the thread count.
+  const uint32_t batchSize = static_cast<uint32_t>(threadCount * INDEX_JOURNAL_SEGMENT_SIZE);
+  std::vector<BlockIndexDelta> deltas;
+  for (uint32_t batchStart = tailStart; batchStart < m_blocks.size(); batchStart += batchSize) {
+    logger(INFO, BRIGHT_WHITE) << "Height " << batchStart << " of " << m_blocks.size();
+
+    auto hashingStart = std::chrono::steady_clock::now();
+    uint32_t batchEnd = static_cast<uint32_t>(std::min<uint64_t>(m_blocks.size(), static_cast<uint64_t>(batchStart) + batchSize));
+    deltas.clear();
+    deltas.resize(batchEnd - batchStart);
+
+    auto processRange = [&](uint32_t rangeStart, uint32_t rangeEnd) {
+      std::vector<BlockEntry> blocks(REBUILD_HASHING_BATCH_SIZE);
+      std::vector<const Block*> hashedBlocks;
+      std::vector<Crypto::Hash> blockHashes;
+      for (uint32_t b = rangeStart; b < rangeEnd; b += REBUILD_HASHING_BATCH_SIZE) {
+        uint32_t count = std::min(rangeEnd - b, REBUILD_HASHING_BATCH_SIZE);
+        hashedBlocks.clear();
+        for (uint32_t i = 0; i < count; ++i) {
+          m_blocks.load(b + i, blocks[i]);
+          hashedBlocks.push_back(&blocks[i].bl);
+        }
+
+        get_block_hashes(hashedBlocks, blockHashes);
+        for (uint32_t i = 0; i < count; ++i) {
+          deltas[b + i - batchStart] = makeIndexDelta(blocks[i], blockHashes[i]);
+        }
+      }
+    };
+
+    uint32_t rangeSize = static_cast<uint32_t>((deltas.size() + threadCount - 1) / threadCount);
+    std::vector<std::future<void>> workers;
+    for (uint32_t rangeStart = batchStart + rangeSize; rangeStart < batchEnd; rangeStart += rangeSize) {
+      workers.push_back(std::async(std::launch::async, processRange, rangeStart, std::min(batchEnd, rangeStart + rangeSize)));
     }
+
+    processRange(batchStart, std::min(batchEnd, batchStart + rangeSize));
+    for (auto& worker : workers) {
+      worker.get();
+    }
+
+    timings.blockHashing += std::chrono::steady_clock::now() - hashingStart;
+
+    applyIndexDeltas(deltas, batchStart, timings);
+    for (auto& delta : deltas) {
+      appendIndexDelta(std::move(delta));
+    }
+  }
+
+  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - timePoint;
+  logger(INFO, BRIGHT_WHITE) << "Rebuilding internal structures took: " << duration.count();
+  logger(INFO) << "- reading index journal (" << journalSegments << " segments): " << toMilliseconds(timings.journalReading) << "ms";
+  logger(INFO) << "- hashing blocks (" << m_blocks.size() - tailStart << " blocks, " << threadCount << " threads): " << toMilliseconds(timings.blockHashing) << "ms";
+  logger(INFO) << "- block index: " << toMilliseconds(timings.blockIndex) << "ms";
+  logger(INFO) << "- transaction map: " << toMilliseconds(timings.transactionMap) << "ms";
+  logger(INFO) << "- spent keys: " << toMilliseconds(timings.spentKeys) << "ms";
+  logger(INFO) << "- outputs: " << toMilliseconds(timings.outputs) << "ms";
+  logger(INFO) << "- multi-signature outputs: " << toMilliseconds(timings.multisignatureOutputs) << "ms";
+}
+
+void Blockchain::validateIndexJournal() {
+  // Segments are appended only after their blocks are stored, so after a crash the journal may be ahead
+  // of m_blocks only if a pop was interrupted. Drop every segment that does not match the stored chain.
+  while (!m_indexJournal.empty()) {
+    uint64_t segmentCount = m_indexJournal.size();
+    const IndexJournalSegment& segment = m_indexJournal.back();
+    uint64_t segmentEnd = static_cast<uint64_t>(segment.startHeight) + segment.blocks.size();
+    if (segment.startHeight == (segmentCount - 1) * INDEX_JOURNAL_SEGMENT_SIZE && segment.blocks.size() == INDEX_JOURNAL_SEGMENT_SIZE &&
+      segmentEnd <= m_blocks.size() && segment.blocks.back().hash == get_block_hash(m_blocks[segmentEnd - 1].bl)) {
+      break;
+    }
+
+    logger(WARNING, BRIGHT_YELLOW) << "Index journal segment at height " << segment.startHeight << " does not match the blockchain, discarding it";
+    m_indexJournal.pop_back();
+  }
+}
+
+void Blockchain::loadPendingIndexDeltas() {
+  m_pendingIndexDeltas.clear();
+  for (uint32_t b = static_cast<uint32_t>(m_indexJournal.size() * INDEX_JOURNAL_SEGMENT_SIZE); b < m_blocks.size(); ++b) {
     const BlockEntry& block = m_blocks[b];
-    Crypto::Hash blockHash = get_block_hash(block.bl);
-    m_blockIndex.push(blockHash);
-    for (uint16_t t = 0; t < block.transactions.size(); ++t) {
-      const TransactionEntry& transaction = block.transactions[t];
-      Crypto::Hash transactionHash = getObjectHash(transaction.tx);
-      TransactionIndex transactionIndex = { b, t };
-      m_transactionMap.insert(std::make_pair(transactionHash, transactionIndex));
-
-      // process inputs
-      for (auto& i : transaction.tx.inputs) {
-        if (i.type() == typeid(KeyInput)) {
-          m_spent_keys.insert(::boost::get<KeyInput>(i).keyImage);
-        } else if (i.type() == typeid(MultisignatureInput)) {
-          auto out = ::boost::get<MultisignatureInput>(i);
-          m_multisignatureOutputs[out.amount][out.outputIndex].isUsed = true;
+    m_pendingIndexDeltas.push_back(makeIndexDelta(block, get_block_hash(block.bl)));
+  }
+}
+
+void Blockchain::clearIndexJournal() {
+  m_indexJournal.clear();
+  m_pendingIndexDeltas.clear();
+}
+
+void Blockchain::appendIndexDelta(BlockIndexDelta&& delta) {
+  m_pendingIndexDeltas.push_back(std::move(delta));
+  if (m_pendingIndexDeltas.size() == INDEX_JOURNAL_SEGMENT_SIZE) {
+    IndexJournalSegment segment;
+    segment.startHeight = static_cast<uint32_t>(m_indexJournal.size() * INDEX_JOURNAL_SEGMENT_SIZE);
+    segment.blocks.swap(m_pendingIndexDeltas);
+    m_indexJournal.push_back(segment);
+  }
+}
+
+void Blockchain::popIndexDelta() {
+  if (m_pendingIndexDeltas.empty() && !m_indexJournal.empty()) {
+    m_pendingIndexDeltas = m_indexJournal.back().blocks;
+    m_indexJournal.pop_back();
+  }
+
+  assert(!m_pendingIndexDeltas.empty());
+  m_pendingIndexDeltas.pop_back();
+}
+
+Blockchain::BlockIndexDelta Blockchain::makeIndexDelta(const BlockEntry& block, const Crypto::Hash& blockHash) {
+  BlockIndexDelta delta;
+  delta.hash = blockHash;
+  delta.transactions.resize(block.transactions.size());
+  for (size_t t = 0; t < block.transactions.size(); ++t) {
+    const FlatTransaction& transaction = block.transactions[t].tx;
+    TransactionIndexDelta& transactionDelta = delta.transactions[t];
+    transactionDelta.hash = t == 0 ? getObjectHash(block.bl.baseTransaction) : block.bl.transactionHashes[t - 1];
+
+    for (size_t i = 0; i < transaction.getInputCount(); ++i) {
+      if (transaction.getInputType(i) == TransactionTypes::InputType::Key) {
+        transactionDelta.keyImages.push_back(transaction.getKeyImage(i));
+      } else if (transaction.getInputType(i) == TransactionTypes::InputType::Multisignature) {
+        MultisignatureInput in;
+        transaction.getInput(i, in);
+        transactionDelta.multisignatureInputs.push_back({ in.amount, in.outputIndex });
+      }
+    }
+
+    transactionDelta.outputs.reserve(transaction.getOutputCount());
+    for (size_t i = 0; i < transaction.getOutputCount(); ++i) {
+      OutputDelta outputDelta = { transaction.getOutputAmount(i), OUTPUT_DELTA_OTHER };
+      if (transaction.getOutputType(i) == TransactionTypes::OutputType::Key) {
+        outputDelta.type = OUTPUT_DELTA_KEY;
+      } else if (transaction.getOutputType(i) == TransactionTypes::OutputType::Multisignature) {
+        outputDelta.type = OUTPUT_DELTA_MULTISIGNATURE;
+      }
+
+      transactionDelta.outputs.push_back(outputDelta);
+    }
+  }
+
+  return delta;
+}
+
+void Blockchain::applyIndexDeltas(const std::vector<BlockIndexDelta>& deltas, uint32_t startHeight, IndexRebuildTimings& timings) {
+  // Each index is filled in its own pass so that the startup report can attribute time per index.
+  auto phaseStart = std::chrono::steady_clock::now();
+  auto phaseDone = [&phaseStart](std::chrono::steady_clock::duration& total) {
+    auto now = std::chrono::steady_clock::now();
+    total += now - phaseStart;
+    phaseStart = now;
+  };
+
+  for (const auto& block : deltas) {
+    m_blockIndex.push(block.hash);
+  }
+
+  phaseDone(timings.blockIndex);
+
+  for (uint32_t b = 0; b < deltas.size(); ++b) {
+    for (uint16_t t = 0; t < deltas[b].transactions.size(); ++t) {
+      TransactionIndex transactionIndex = { startHeight + b, t };
+      m_transactionMap.insert(std::make_pair(deltas[b].transactions[t].hash, transactionIndex));
+    }
+  }
+
+  phaseDone(timings.transactionMap);
+
+  for (const auto& block : deltas) {
+    for (const auto& transaction : block.transactions) {
+      m_spent_keys.insert(transaction.keyImages.begin(), transaction.keyImages.end());
+    }
+  }
+
+  phaseDone(timings.spentKeys);
+
+  for (uint32_t b = 0; b < deltas.size(); ++b) {
+    for (uint16_t t = 0; t < deltas[b].transactions.size(); ++t) {
+      TransactionIndex transactionIndex = { startHeight + b, t };
+      const auto& outputs = deltas[b].transactions[t].outputs;
+      for (uint16_t o = 0; o < outputs.size(); ++o) {
+        if (outputs[o].type == OUTPUT_DELTA_KEY) {
+          m_outputs[outputs[o].amount].push_back(std::make_pair<>(transactionIndex, o));
         }
       }
+    }
+  }
 
-      // process outputs
-      for (uint16_t o = 0; o < transaction.tx.outputs.size(); ++o) {
-        const auto& out = transaction.tx.outputs[o];
-        if (out.target.type() == typeid(KeyOutput)) {
-          m_outputs[out.amount].push_back(std::make_pair<>(transactionIndex, o));
-        } else if (out.target.type() == typeid(MultisignatureOutput)) {
+  phaseDone(timings.outputs);
+
+  // inputs may refer to outputs created earlier in the same batch, so keep transaction order here
+  for (uint32_t b = 0; b < deltas.size(); ++b) {
+    for (uint16_t t = 0; t < deltas[b].transactions.size(); ++t) {
+      const TransactionIndexDelta& transaction = deltas[b].transactions[t];
+      for (const auto& in : transaction.multisignatureInputs) {
+        m_multisignatureOutputs[in.amount][in.outputIndex].isUsed = true;
+      }
+
+      TransactionIndex transactionIndex = { startHeight + b, t };
+      for (uint16_t o = 0; o < transaction.outputs.size(); ++o) {
+        if (transaction.outputs[o].type == OUTPUT_DELTA_MULTISIGNATURE) {
           MultisignatureOutputUsage usage = { transactionIndex, o, false };
-          m_multisignatureOutputs[out.amount].push_back(usage);
+          m_multisignatureOutputs[transaction.outputs[o].amount].push_back(usage);
         }
       }
     }
   }
 
-  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - timePoint;
-  logger(INFO, BRIGHT_WHITE) << "Rebuilding internal structures took: " << duration.count();
+  phaseDone(timings.multisignatureOutputs);
 }
 
 bool Blockchain::storeCache() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
 
   logger(INFO, BRIGHT_WHITE) << "Saving blockchain...";
   BlockCacheSerializer ser(*this, getTailId(), logger.getLogger());
@@ -520,6 +764,7 @@ bool Blockchain::storeCache() {
 bool Blockchain::deinit() {
   storeCache();
   storeBlockchainIndices();
+  logger(DEBUGGING) << "Block cache hits: " << m_blocks.cacheHits() << ", misses: " << m_blocks.cacheMisses();
   assert(m_messageQueueList.empty());
   return true;
 }
@@ -527,6 +772,7 @@ bool Blockchain::deinit() {
 bool Blockchain::resetAndSetGenesisBlock(const Block& b) {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   m_blocks.clear();
+  clearIndexJournal();
   m_blockIndex.clear();
   m_transactionMap.clear();
 
@@ -538,6 +784,8 @@ bool Blockchain::resetAndSetGenesisBlock(const Block& b) {
   m_timestampIndex.clear();
   m_generatedTransactionsIndex.clear();
   m_orthanBlocksIndex.clear();
+  m_signatureCache.clear();
+  m_proofOfWorkCache.clear();
 
   block_verification_context bvc = boost::value_initialized<block_verification_context>();
   addNewBlock(b, bvc);
@@ -546,24 +794,24 @@ bool Blockchain::resetAndSetGenesisBlock(const Block& b) {
 
 Crypto::Hash Blockchain::getTailId(uint32_t& height) {
   assert(!m_blocks.empty());
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   height = getCurrentBlockchainHeight() - 1;
   return getTailId();
 }
 
 Crypto::Hash Blockchain::getTailId() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return m_blocks.empty() ? NULL_HASH : m_blockIndex.getTailId();
 }
 
 std::vector<Crypto::Hash> Blockchain::buildSparseChain() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   assert(m_blockIndex.size() != 0);
   return doBuildSparseChain(m_blockIndex.getTailId());
 }
 
 std::vector<Crypto::Hash> Blockchain::buildSparseChain(const Crypto::Hash& startBlockId) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   assert(haveBlock(startBlockId));
   return doBuildSparseChain(startBlockId);
 }
@@ -600,13 +848,13 @@ std::vector<Crypto::Hash> Blockchain::doBuildSparseChain(const Crypto::Hash& sta
 }
 
 Crypto::Hash Blockchain::getBlockIdByHeight(uint32_t height) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   assert(height < m_blockIndex.size());
   return m_blockIndex.getBlockId(height);
 }
 
 bool Blockchain::getBlockByHash(const Crypto::Hash& blockHash, Block& b) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
 
   uint32_t height = 0;
 
@@ -627,12 +875,12 @@ bool Blockchain::getBlockByHash(const Crypto::Hash& blockHash, Block& b) {
 }
 
 bool Blockchain::getBlockHeight(const Crypto::Hash& blockId, uint32_t& blockHeight) {
-  std::lock_guard<decltype(m_blockchain_lock)> lock(m_blockchain_lock);
+  Common::SharedLockGuard lock(m_blockchain_lock);
   return m_blockIndex.getBlockHeight(blockId, blockHeight);
 }
 
 difficulty_type Blockchain::getDifficultyForNextBlock() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   std::vector<uint64_t> timestamps;
   std::vector<difficulty_type> commulative_difficulties;
   size_t offset = m_blocks.size() - std::min(m_blocks.size(), static_cast<uint64_t>(m_currency.difficultyBlocksCount()));
@@ -649,7 +897,7 @@ difficulty_type Blockchain::getDifficultyForNextBlock() {
 }
 
 uint64_t Blockchain::getCoinsInCirculation() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   if (m_blocks.empty()) {
     return 0;
   } else {
@@ -668,7 +916,7 @@ bool Blockchain::rollback_blockchain_switching(std::list<Block> &original_chain,
   for (auto &bl : original_chain) {
     block_verification_context bvc =
       boost::value_initialized<block_verification_context>();
-    bool r = pushBlock(bl, bvc);
+    bool r = pushBlock(CachedBlock(bl), bvc);
     if (!(r && bvc.m_added_to_main_chain)) {
       logger(ERROR, BRIGHT_RED) << "PANIC!!! failed to add (again) block while "
         "chain switching during the rollback!";
@@ -708,7 +956,7 @@ bool Blockchain::switch_to_alternative_blockchain(std::list<blocks_ext_by_hash::
   for (auto alt_ch_iter = alt_chain.begin(); alt_ch_iter != alt_chain.end(); alt_ch_iter++) {
     auto ch_ent = *alt_ch_iter;
     block_verification_context bvc = boost::value_initialized<block_verification_context>();
-    bool r = pushBlock(ch_ent->second.bl, bvc);
+    bool r = pushBlock(CachedBlock(ch_ent->second.bl), bvc);
     if (!r || !bvc.m_added_to_main_chain) {
       logger(INFO, BRIGHT_WHITE) << "Failed to switch to alternative blockchain";
       rollback_blockchain_switching(disconnected_chain, split_height);
@@ -762,7 +1010,7 @@ difficulty_type Blockchain::get_next_difficulty_for_alternative_chain(const std:
   std::vector<uint64_t> timestamps;
   std::vector<difficulty_type> commulative_difficulties;
   if (alt_chain.size() < m_currency.difficultyBlocksCount()) {
-    std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+    Common::SharedLockGuard lk(m_blockchain_lock);
     size_t main_chain_stop_offset = alt_chain.size() ? alt_chain.front()->second.height : bei.height;
     size_t main_chain_count = m_currency.difficultyBlocksCount() - std::min(m_currency.difficultyBlocksCount(), alt_chain.size());
     main_chain_count = std::min(main_chain_count, main_chain_stop_offset);
@@ -868,7 +1116,7 @@ bool Blockchain::validate_miner_transaction(const Block& b, uint32_t height, siz
 }
 
 bool Blockchain::getBackwardBlocksSize(size_t from_height, std::vector<size_t>& sz, size_t count) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   if (!(from_height < m_blocks.size())) {
     logger(ERROR, BRIGHT_RED)
       << "Internal error: get_backward_blocks_sizes called with from_height="
@@ -884,7 +1132,7 @@ bool Blockchain::getBackwardBlocksSize(size_t from_height, std::vector<size_t>&
 }
 
 bool Blockchain::get_last_n_blocks_sizes(std::vector<size_t>& sz, size_t count) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   if (!m_blocks.size()) {
     return true;
   }
@@ -900,7 +1148,7 @@ bool Blockchain::complete_timestamps_vector(uint64_t start_top_height, std::vect
   if (timestamps.size() >= m_currency.timestampCheckWindow())
     return true;
 
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   size_t need_elements = m_currency.timestampCheckWindow() - timestamps.size();
   if (!(start_top_height < m_blocks.size())) { logger(ERROR, BRIGHT_RED) << "internal error: passed start_height = " << start_top_height << " not less then m_blocks.size()=" << m_blocks.size(); return false; }
   size_t stop_offset = start_top_height > need_elements ? start_top_height - need_elements : 0;
@@ -1000,7 +1248,7 @@ bool Blockchain::handle_alternative_block(const Block& b, const Crypto::Hash& id
     difficulty_type current_diff = get_next_difficulty_for_alternative_chain(alt_chain, bei);
     if (!(current_diff)) { logger(ERROR, BRIGHT_RED) << "!!!!!!! DIFFICULTY OVERHEAD !!!!!!!"; return false; }
     Crypto::Hash proof_of_work = NULL_HASH;
-    if (!m_currency.checkProofOfWork(m_cn_context, bei.bl, current_diff, proof_of_work)) {
+    if (!checkProofOfWork(bei.bl, id, current_diff, proof_of_work)) {
       logger(INFO, BRIGHT_RED) <<
         "Block with id: " << id
         << ENDL << " for alternative chain, have not enough proof of work: " << proof_of_work
@@ -1080,7 +1328,7 @@ bool Blockchain::handle_alternative_block(const Block& b, const Crypto::Hash& id
 }
 
 bool Blockchain::getBlocks(uint32_t start_offset, uint32_t count, std::list<Block>& blocks, std::list<Transaction>& txs) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   if (start_offset >= m_blocks.size())
     return false;
   for (size_t i = start_offset; i < start_offset + count && i < m_blocks.size(); i++) {
@@ -1094,7 +1342,7 @@ bool Blockchain::getBlocks(uint32_t start_offset, uint32_t count, std::list<Bloc
 }
 
 bool Blockchain::getBlocks(uint32_t start_offset, uint32_t count, std::list<Block>& blocks) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   if (start_offset >= m_blocks.size()) {
     return false;
   }
@@ -1107,7 +1355,7 @@ bool Blockchain::getBlocks(uint32_t start_offset, uint32_t count, std::list<Bloc
 }
 
 bool Blockchain::handleGetObjects(NOTIFY_REQUEST_GET_OBJECTS::request& arg, NOTIFY_RESPONSE_GET_OBJECTS::request& rsp) { //Deprecated. Should be removed with CryptoNoteProtocolHandler.
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   rsp.current_blockchain_height = getCurrentBlockchainHeight();
   std::list<Block> blocks;
   getBlocks(arg.blocks, blocks, rsp.missed_ids);
@@ -1139,7 +1387,7 @@ bool Blockchain::handleGetObjects(NOTIFY_REQUEST_GET_OBJECTS::request& arg, NOTI
 }
 
 bool Blockchain::getAlternativeBlocks(std::list<Block>& blocks) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   for (auto& alt_bl : m_alternative_chains) {
     blocks.push_back(alt_bl.second.bl);
   }
@@ -1148,31 +1396,31 @@ bool Blockchain::getAlternativeBlocks(std::list<Block>& blocks) {
 }
 
 uint32_t Blockchain::getAlternativeBlocksCount() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return static_cast<uint32_t>(m_alternative_chains.size());
 }
 
 bool Blockchain::add_out_to_get_random_outs(std::vector<std::pair<TransactionIndex, uint16_t>>& amount_outs, COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount& result_outs, uint64_t amount, size_t i) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  const Transaction& tx = transactionByIndex(amount_outs[i].first).tx;
-  if (!(tx.outputs.size() > amount_outs[i].second)) {
+  Common::SharedLockGuard lk(m_blockchain_lock);
+  const FlatTransaction& tx = transactionByIndex(amount_outs[i].first).tx;
+  if (!(tx.getOutputCount() > amount_outs[i].second)) {
     logger(ERROR, BRIGHT_RED) << "internal error: in global outs index, transaction out index="
-      << amount_outs[i].second << " more than transaction outputs = " << tx.outputs.size() << ", for tx id = " << getObjectHash(tx); return false;
+      << amount_outs[i].second << " more than transaction outputs = " << tx.getOutputCount() << ", for tx id = " << getObjectHash(tx); return false;
   }
-  if (!(tx.outputs[amount_outs[i].second].target.type() == typeid(KeyOutput))) { logger(ERROR, BRIGHT_RED) << "unknown tx out type"; return false; }
+  if (!(tx.getOutputType(amount_outs[i].second) == TransactionTypes::OutputType::Key)) { logger(ERROR, BRIGHT_RED) << "unknown tx out type"; return false; }
 
   //check if transaction is unlocked
-  if (!is_tx_spendtime_unlocked(tx.unlockTime))
+  if (!is_tx_spendtime_unlocked(tx.getUnlockTime()))
     return false;
 
   COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::out_entry& oen = *result_outs.outs.insert(result_outs.outs.end(), COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::out_entry());
   oen.global_amount_index = static_cast<uint32_t>(i);
-  oen.out_key = boost::get<KeyOutput>(tx.outputs[amount_outs[i].second].target).key;
+  oen.out_key = tx.getOutputKey(amount_outs[i].second);
   return true;
 }
 
 size_t Blockchain::find_end_of_allowed_index(const std::vector<std::pair<TransactionIndex, uint16_t>>& amount_outs) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   if (amount_outs.empty()) {
     return 0;
   }
@@ -1189,7 +1437,7 @@ size_t Blockchain::find_end_of_allowed_index(const std::vector<std::pair<Transac
 }
 
 bool Blockchain::getRandomOutsByAmount(const COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::request& req, COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::response& res) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
 
   for (uint64_t amount : req.amounts) {
     COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount& result_outs = *res.outs.insert(res.outs.end(), COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount());
@@ -1221,7 +1469,7 @@ uint32_t Blockchain::findBlockchainSupplement(const std::vector<Crypto::Hash>& q
   assert(!qblock_ids.empty());
   assert(qblock_ids.back() == m_blockIndex.getBlockId(0));
 
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   uint32_t blockIndex;
   // assert above guarantees that method returns true
   m_blockIndex.findSupplement(qblock_ids, blockIndex);
@@ -1229,7 +1477,7 @@ uint32_t Blockchain::findBlockchainSupplement(const std::vector<Crypto::Hash>& q
 }
 
 uint64_t Blockchain::blockDifficulty(size_t i) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   if (!(i < m_blocks.size())) { logger(ERROR, BRIGHT_RED) << "wrong block index i = " << i << " at Blockchain::block_difficulty()"; return false; }
   if (i == 0)
     return m_blocks[i].cumulative_difficulty;
@@ -1239,7 +1487,7 @@ uint64_t Blockchain::blockDifficulty(size_t i) {
 
 void Blockchain::print_blockchain(uint64_t start_index, uint64_t end_index) {
   std::stringstream ss;
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   if (start_index >= m_blocks.size()) {
     logger(INFO, BRIGHT_WHITE) <<
       "Wrong starter index set: " << start_index << ", expected max index " << m_blocks.size() - 1;
@@ -1259,7 +1507,7 @@ void Blockchain::print_blockchain(uint64_t start_index, uint64_t end_index) {
 
 void Blockchain::print_blockchain_index() {
   std::stringstream ss;
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
 
   std::vector<Crypto::Hash> blockIds = m_blockIndex.getBlockIds(0, std::numeric_limits<uint32_t>::max());
   logger(INFO, BRIGHT_WHITE) << "Current blockchain index:";
@@ -1273,7 +1521,7 @@ void Blockchain::print_blockchain_index() {
 
 void Blockchain::print_blockchain_outs(const std::string& file) {
   std::stringstream ss;
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   for (const outputs_container::value_type& v : m_outputs) {
     const std::vector<std::pair<TransactionIndex, uint16_t>>& vals = v.second;
     if (!vals.empty()) {
@@ -1299,7 +1547,7 @@ std::vector<Crypto::Hash> Blockchain::findBlockchainSupplement(const std::vector
   assert(!remoteBlockIds.empty());
   assert(remoteBlockIds.back() == m_blockIndex.getBlockId(0));
 
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   totalBlockCount = getCurrentBlockchainHeight();
   startBlockIndex = findBlockchainSupplement(remoteBlockIds);
 
@@ -1307,7 +1555,7 @@ std::vector<Crypto::Hash> Blockchain::findBlockchainSupplement(const std::vector
 }
 
 bool Blockchain::haveBlock(const Crypto::Hash& id) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   if (m_blockIndex.hasBlock(id))
     return true;
 
@@ -1318,12 +1566,12 @@ bool Blockchain::haveBlock(const Crypto::Hash& id) {
 }
 
 size_t Blockchain::getTotalTransactions() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return m_transactionMap.size();
 }
 
 bool Blockchain::getTransactionOutputGlobalIndexes(const Crypto::Hash& tx_id, std::vector<uint32_t>& indexs) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   auto it = m_transactionMap.find(tx_id);
   if (it == m_transactionMap.end()) {
     logger(WARNING, YELLOW) << "warning: get_tx_outputs_gindexs failed to find transaction with id = " << tx_id;
@@ -1341,7 +1589,7 @@ bool Blockchain::getTransactionOutputGlobalIndexes(const Crypto::Hash& tx_id, st
 }
 
 bool Blockchain::get_out_by_msig_gindex(uint64_t amount, uint64_t gindex, MultisignatureOutput& out) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   auto it = m_multisignatureOutputs.find(amount);
   if (it == m_multisignatureOutputs.end()) {
     return false;
@@ -1352,19 +1600,19 @@ bool Blockchain::get_out_by_msig_gindex(uint64_t amount, uint64_t gindex, Multis
   }
 
   auto msigUsage = it->second[gindex];
-  auto& targetOut = transactionByIndex(msigUsage.transactionIndex).tx.outputs[msigUsage.outputIndex].target;
-  if (targetOut.type() != typeid(MultisignatureOutput)) {
+  const FlatTransaction& transaction = transactionByIndex(msigUsage.transactionIndex).tx;
+  if (transaction.getOutputType(msigUsage.outputIndex) != TransactionTypes::OutputType::Multisignature) {
     return false;
   }
 
-  out = boost::get<MultisignatureOutput>(targetOut);
+  transaction.getOutput(msigUsage.outputIndex, out);
   return true;
 }
 
 
 
 bool Blockchain::checkTransactionInputs(const Transaction& tx, uint32_t& max_used_block_height, Crypto::Hash& max_used_block_id, BlockInfo* tail) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
 
   if (tail)
     tail->id = getTailId(tail->height);
@@ -1388,12 +1636,117 @@ bool Blockchain::haveTransactionKeyImagesAsSpent(const Transaction &tx) {
   return false;
 }
 
+void Blockchain::preverifyTransactionSignatures(const std::vector<const Transaction*>& transactions) {
+  if (isInTrustedCheckpointZone()) {
+    return;
+  }
+
+  std::vector<RingSignatureCheck> checks;
+  {
+    Common::SharedLockGuard lk(m_blockchain_lock);
+    for (const Transaction* tx : transactions) {
+      Crypto::Hash prefixHash = getObjectHash(*static_cast<const TransactionPrefix*>(tx));
+      for (size_t i = 0; i < tx->inputs.size() && i < tx->signatures.size(); ++i) {
+        if (tx->inputs[i].type() != typeid(KeyInput)) {
+          continue;
+        }
+
+        // outputs of blocks that are not added yet can't be resolved here
+        const KeyInput& input = boost::get<KeyInput>(tx->inputs[i]);
+        auto outputs = m_outputs.find(input.amount);
+        if (outputs == m_outputs.end() || input.outputIndexes.empty() ||
+          relative_output_offsets_to_absolute(input.outputIndexes).back() >= outputs->second.size()) {
+          continue;
+        }
+
+        std::vector<const Crypto::PublicKey*> outputKeys;
+        uint32_t maxUsedBlockHeight = 0;
+        if (!getInputOutputKeys(input, tx->signatures[i], outputKeys, &maxUsedBlockHeight)) {
+          continue;
+        }
+
+        Crypto::Hash cacheKey = SignatureCache::getKey(prefixHash, input.keyImage, outputKeys, tx->signatures[i].data());
+        if (!m_signatureCache.contains(cacheKey)) {
+          RingSignatureCheck check;
+          check.cacheKey = cacheKey;
+          check.maxUsedBlockHeight = maxUsedBlockHeight;
+          check.prefixHash = prefixHash;
+          check.keyImage = input.keyImage;
+          check.outputKeys.reserve(outputKeys.size());
+          for (auto key : outputKeys) {
+            check.outputKeys.push_back(*key);
+          }
+
+          check.signatures = tx->signatures[i].data();
+          checks.push_back(std::move(check));
+        }
+      }
+    }
+  }
+
+  // the lock is not held here, blocks may be added meanwhile
+  checkRingSignatures(checks);
+}
+
+void Blockchain::preverifyProofsOfWork(const std::vector<const Block*>& blocks) {
+  // blocks below the last checkpoint are checked against the checkpoints instead
+  std::vector<const Block*> pendingBlocks;
+  for (const Block* block : blocks) {
+    if (block->baseTransaction.inputs.size() != 1 || block->baseTransaction.inputs[0].type() != typeid(BaseInput) ||
+      !m_checkpoints.is_in_checkpoint_zone(boost::get<BaseInput>(block->baseTransaction.inputs[0]).blockIndex)) {
+      pendingBlocks.push_back(block);
+    }
+  }
+
+  std::vector<Crypto::Hash> blockHashes;
+  if (pendingBlocks.empty() || !get_block_hashes(pendingBlocks, blockHashes)) {
+    return;
+  }
+
+  getVerificationPool().runAll(pendingBlocks.size(), [this, &pendingBlocks, &blockHashes](size_t index) {
+    std::unique_ptr<Crypto::cn_context> context;
+    {
+      std::lock_guard<std::mutex> lock(m_proofOfWorkContextsMutex);
+      if (!m_proofOfWorkContexts.empty()) {
+        context = std::move(m_proofOfWorkContexts.back());
+        m_proofOfWorkContexts.pop_back();
+      }
+    }
+
+    if (!context) {
+      context.reset(new Crypto::cn_context());
+    }
+
+    Crypto::Hash proofOfWork;
+    if (get_block_longhash(*context, *pendingBlocks[index], proofOfWork)) {
+      m_proofOfWorkCache.add(blockHashes[index], proofOfWork);
+    }
+
+    std::lock_guard<std::mutex> lock(m_proofOfWorkContextsMutex);
+    m_proofOfWorkContexts.push_back(std::move(context));
+    return true;
+  });
+}
+
+bool Blockchain::checkProofOfWork(const Block& block, const Crypto::Hash& blockHash, difficulty_type currentDifficulty, Crypto::Hash& proofOfWork) {
+  if (m_proofOfWorkCache.take(blockHash, proofOfWork)) {
+    return check_hash(proofOfWork, currentDifficulty);
+  }
+
+  return m_currency.checkProofOfWork(m_cn_context, block, currentDifficulty, proofOfWork);
+}
+
 bool Blockchain::checkTransactionInputs(const Transaction& tx, uint32_t* pmax_used_block_height) {
   Crypto::Hash tx_prefix_hash = getObjectHash(*static_cast<const TransactionPrefix*>(&tx));
   return checkTransactionInputs(tx, tx_prefix_hash, pmax_used_block_height);
 }
 
 bool Blockchain::checkTransactionInputs(const Transaction& tx, const Crypto::Hash& tx_prefix_hash, uint32_t* pmax_used_block_height) {
+  return checkTransactionInputs(tx, tx_prefix_hash, pmax_used_block_height, nullptr);
+}
+
+bool Blockchain::checkTransactionInputs(const Transaction& tx, const Crypto::Hash& tx_prefix_hash, uint32_t* pmax_used_block_height,
+  std::vector<RingSignatureCheck>* ringSignatureChecks) {
   size_t inputIndex = 0;
   if (pmax_used_block_height) {
     *pmax_used_block_height = 0;
@@ -1412,10 +1765,43 @@ bool Blockchain::checkTransactionInputs(const Transaction& tx, const Crypto::Has
         return false;
       }
 
-      if (!check_tx_input(in_to_key, tx_prefix_hash, tx.signatures[inputIndex], pmax_used_block_height)) {
-        logger(INFO, BRIGHT_WHITE) <<
-          "Failed to check ring signature for tx " << transactionHash;
-        return false;
+      if (ringSignatureChecks == nullptr) {
+        if (!check_tx_input(in_to_key, tx_prefix_hash, tx.signatures[inputIndex], pmax_used_block_height)) {
+          logger(INFO, BRIGHT_WHITE) <<
+            "Failed to check ring signature for tx " << transactionHash;
+          return false;
+        }
+      } else {
+        std::vector<const Crypto::PublicKey*> outputKeys;
+        uint32_t maxUsedBlockHeight = 0;
+        if (!getInputOutputKeys(in_to_key, tx.signatures[inputIndex], outputKeys, &maxUsedBlockHeight)) {
+          logger(INFO, BRIGHT_WHITE) <<
+            "Failed to check ring signature for tx " << transactionHash;
+          return false;
+        }
+
+        if (pmax_used_block_height != nullptr && *pmax_used_block_height < maxUsedBlockHeight) {
+          *pmax_used_block_height = maxUsedBlockHeight;
+        }
+
+        if (!m_is_in_checkpoint_zone) {
+          Crypto::Hash cacheKey = SignatureCache::getKey(tx_prefix_hash, in_to_key.keyImage, outputKeys, tx.signatures[inputIndex].data());
+          // signatures verified on pool admission are not checked again
+          if (!m_signatureCache.contains(cacheKey)) {
+            RingSignatureCheck check;
+            check.cacheKey = cacheKey;
+            check.maxUsedBlockHeight = maxUsedBlockHeight;
+            check.prefixHash = tx_prefix_hash;
+            check.keyImage = in_to_key.keyImage;
+            check.outputKeys.reserve(outputKeys.size());
+            for (auto key : outputKeys) {
+              check.outputKeys.push_back(*key);
+            }
+
+            check.signatures = tx.signatures[inputIndex].data();
+            ringSignatureChecks->push_back(std::move(check));
+          }
+        }
       }
 
       ++inputIndex;
@@ -1455,7 +1841,37 @@ bool Blockchain::is_tx_spendtime_unlocked(uint64_t unlock_time) {
 }
 
 bool Blockchain::check_tx_input(const KeyInput& txin, const Crypto::Hash& tx_prefix_hash, const std::vector<Crypto::Signature>& sig, uint32_t* pmax_related_block_height) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
+
+  std::vector<const Crypto::PublicKey *> output_keys;
+  uint32_t maxUsedBlockHeight = 0;
+  if (!getInputOutputKeys(txin, sig, output_keys, &maxUsedBlockHeight)) {
+    return false;
+  }
+
+  if (pmax_related_block_height != nullptr && *pmax_related_block_height < maxUsedBlockHeight) {
+    *pmax_related_block_height = maxUsedBlockHeight;
+  }
+
+  if (m_is_in_checkpoint_zone) {
+    return true;
+  }
+
+  Crypto::Hash cacheKey = SignatureCache::getKey(tx_prefix_hash, txin.keyImage, output_keys, sig.data());
+  if (m_signatureCache.contains(cacheKey)) {
+    return true;
+  }
+
+  if (!Crypto::check_ring_signature(tx_prefix_hash, txin.keyImage, output_keys, sig.data())) {
+    return false;
+  }
+
+  m_signatureCache.add(cacheKey, maxUsedBlockHeight);
+  return true;
+}
+
+bool Blockchain::getInputOutputKeys(const KeyInput& txin, const std::vector<Crypto::Signature>& sig, std::vector<const Crypto::PublicKey *>& output_keys, uint32_t* pmax_related_block_height) {
+  Common::SharedLockGuard lk(m_blockchain_lock);
 
   struct outputs_visitor {
     std::vector<const Crypto::PublicKey *>& m_results_collector;
@@ -1464,27 +1880,25 @@ bool Blockchain::check_tx_input(const KeyInput& txin, const Crypto::Hash& tx_pre
     outputs_visitor(std::vector<const Crypto::PublicKey *>& results_collector, Blockchain& bch, ILogger& logger) :m_results_collector(results_collector), m_bch(bch), logger(logger, "outputs_visitor") {
     }
 
-    bool handle_output(const Transaction& tx, const TransactionOutput& out, size_t transactionOutputIndex) {
+    bool handle_output(const FlatTransaction& tx, size_t transactionOutputIndex) {
       //check tx unlock time
-      if (!m_bch.is_tx_spendtime_unlocked(tx.unlockTime)) {
+      if (!m_bch.is_tx_spendtime_unlocked(tx.getUnlockTime())) {
         logger(INFO, BRIGHT_WHITE) <<
-          "One of outputs for one of inputs have wrong tx.unlockTime = " << tx.unlockTime;
+          "One of outputs for one of inputs have wrong tx.unlockTime = " << tx.getUnlockTime();
         return false;
       }
 
-      if (out.target.type() != typeid(KeyOutput)) {
+      if (tx.getOutputType(transactionOutputIndex) != TransactionTypes::OutputType::Key) {
         logger(INFO, BRIGHT_WHITE) <<
-          "Output have wrong type id, which=" << out.target.which();
+          "Output have wrong type id, which=" << static_cast<int>(tx.getOutputType(transactionOutputIndex));
         return false;
       }
 
-      m_results_collector.push_back(&boost::get<KeyOutput>(out.target).key);
+      m_results_collector.push_back(&tx.getOutputKey(transactionOutputIndex));
       return true;
     }
   };
 
-  //check ring signature
-  std::vector<const Crypto::PublicKey *> output_keys;
   outputs_visitor vi(output_keys, *this, logger.getLogger());
   if (!scanOutputKeysForIndexes(txin, vi, pmax_related_block_height)) {
     logger(INFO, BRIGHT_WHITE) <<
@@ -1500,11 +1914,50 @@ bool Blockchain::check_tx_input(const KeyInput& txin, const Crypto::Hash& tx_pre
   }
 
   if (!(sig.size() == output_keys.size())) { logger(ERROR, BRIGHT_RED) << "internal error: tx signatures count=" << sig.size() << " mismatch with outputs keys count for inputs=" << output_keys.size(); return false; }
-  if (m_is_in_checkpoint_zone) {
-    return true;
-  }
+  return true;
+}
+
+Common::ThreadPool& Blockchain::getVerificationPool() {
+  std::call_once(m_verificationPoolCreated, [this] {
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    m_verificationPool.reset(new Common::ThreadPool(threadCount > 1 ? threadCount - 1 : 0));
+  });
+
+  return *m_verificationPool;
+}
+
+bool Blockchain::checkRingSignatures(const std::vector<RingSignatureCheck>& checks) {
+  size_t batchCount = (checks.size() + RING_SIGNATURES_PER_BATCH - 1) / RING_SIGNATURES_PER_BATCH;
+  return getVerificationPool().runAll(batchCount, [this, &checks](size_t batchIndex) {
+    size_t begin = batchIndex * RING_SIGNATURES_PER_BATCH;
+    size_t end = std::min(begin + RING_SIGNATURES_PER_BATCH, checks.size());
+
+    std::vector<const Crypto::PublicKey*> outputKeys;
+    for (size_t i = begin; i < end; ++i) {
+      for (const auto& key : checks[i].outputKeys) {
+        outputKeys.push_back(&key);
+      }
+    }
+
+    std::vector<Crypto::RingSignatureBatchEntry> entries;
+    entries.reserve(end - begin);
+    size_t keyOffset = 0;
+    for (size_t i = begin; i < end; ++i) {
+      const RingSignatureCheck& check = checks[i];
+      entries.push_back({ &check.prefixHash, &check.keyImage, outputKeys.data() + keyOffset, check.outputKeys.size(), check.signatures });
+      keyOffset += check.outputKeys.size();
+    }
+
+    if (!Crypto::check_ring_signatures(entries.data(), entries.size(), &m_ringMemberCache)) {
+      return false;
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+      m_signatureCache.add(checks[i].cacheKey, checks[i].maxUsedBlockHeight);
+    }
 
-  return Crypto::check_ring_signature(tx_prefix_hash, txin.keyImage, output_keys, sig.data());
+    return true;
+  });
 }
 
 uint64_t Blockchain::get_adjusted_time() {
@@ -1588,8 +2041,11 @@ bool Blockchain::update_next_comulative_size_limit() {
 bool Blockchain::addNewBlock(const Block& bl_, block_verification_context& bvc) {
   //copy block here to let modify block.target
   Block bl = bl_;
+  CachedBlock cachedBlock(bl);
   Crypto::Hash id;
-  if (!get_block_hash(bl, id)) {
+  try {
+    id = cachedBlock.getBlockHash();
+  } catch (std::exception&) {
     logger(ERROR, BRIGHT_RED) <<
       "Failed to get block hash, possible block has invalid format";
     bvc.m_verifivation_failed = true;
@@ -1614,7 +2070,7 @@ bool Blockchain::addNewBlock(const Block& bl_, block_verification_context& bvc)
       bvc.m_added_to_main_chain = false;
       add_result = handle_alternative_block(bl, id, bvc);
     } else {
-      add_result = pushBlock(bl, bvc);
+      add_result = pushBlock(cachedBlock, bvc);
       if (add_result) {
         sendMessage(BlockchainMessage(NewBlockMessage(id)));
       }
@@ -1632,14 +2088,14 @@ const Blockchain::TransactionEntry& Blockchain::transactionByIndex(TransactionIn
   return m_blocks[index.block].transactions[index.transaction];
 }
 
-bool Blockchain::pushBlock(const Block& blockData, block_verification_context& bvc) {
-  std::vector<Transaction> transactions;
-  if (!loadTransactions(blockData, transactions)) {
+bool Blockchain::pushBlock(const CachedBlock& cachedBlock, block_verification_context& bvc) {
+  std::vector<CachedTransaction> transactions;
+  if (!loadTransactions(cachedBlock.getBlock(), transactions)) {
     bvc.m_verifivation_failed = true;
     return false;
   }
 
-  if (!pushBlock(blockData, transactions, bvc)) {
+  if (!pushBlock(cachedBlock, transactions, bvc)) {
     saveTransactions(transactions);
     return false;
   }
@@ -1647,12 +2103,13 @@ bool Blockchain::pushBlock(const Block& blockData, block_verification_context& b
   return true;
 }
 
-bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction>& transactions, block_verification_context& bvc) {
+bool Blockchain::pushBlock(const CachedBlock& cachedBlock, const std::vector<CachedTransaction>& transactions, block_verification_context& bvc) {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   auto blockProcessingStart = std::chrono::steady_clock::now();
 
-  Crypto::Hash blockHash = get_block_hash(blockData);
+  const Block& blockData = cachedBlock.getBlock();
+  const Crypto::Hash& blockHash = cachedBlock.getBlockHash();
 
   if (m_blockIndex.hasBlock(blockHash)) {
     logger(ERROR, BRIGHT_RED) <<
@@ -1695,7 +2152,7 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
       return false;
     }
   } else {
-    if (!m_currency.checkProofOfWork(m_cn_context, blockData, currentDifficulty, proof_of_work)) {
+    if (!checkProofOfWork(blockData, blockHash, currentDifficulty, proof_of_work)) {
       logger(INFO, BRIGHT_WHITE) <<
         "Block " << blockHash << ", has too weak proof of work: " << proof_of_work << ", expected difficulty: " << currentDifficulty;
       bvc.m_verifivation_failed = true;
@@ -1712,31 +2169,47 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
     return false;
   }
 
-  Crypto::Hash minerTransactionHash = getObjectHash(blockData.baseTransaction);
+  const Crypto::Hash& minerTransactionHash = cachedBlock.getBaseTransactionHash();
 
   BlockEntry block;
   block.bl = blockData;
   block.transactions.resize(1);
-  block.transactions[0].tx = blockData.baseTransaction;
+  block.transactions[0].tx = FlatTransaction(blockData.baseTransaction);
   TransactionIndex transactionIndex = { static_cast<uint32_t>(m_blocks.size()), static_cast<uint16_t>(0) };
   pushTransaction(block, minerTransactionHash, transactionIndex);
 
-  size_t coinbase_blob_size = getObjectBinarySize(blockData.baseTransaction);
+  size_t coinbase_blob_size = cachedBlock.getBaseTransactionBinarySize();
   size_t cumulative_block_size = coinbase_blob_size;
   uint64_t fee_summary = 0;
+  // inputs are checked in order, ring signatures of the whole block are verified in parallel afterwards
+  std::vector<RingSignatureCheck> ringSignatureChecks;
+  // contents of a block below a trusted checkpoint are bound by its hash, so its ring signatures are not collected,
+  // inputs still have to be resolved to build the indices
+  m_is_in_checkpoint_zone = m_trustCheckpoints && m_checkpoints.is_in_checkpoint_zone(getCurrentBlockchainHeight());
+  std::vector<const TransactionPrefix*> transactionPrefixes;
+  transactionPrefixes.reserve(transactions.size());
+  for (const CachedTransaction& transaction : transactions) {
+    transactionPrefixes.push_back(&transaction.getTransaction());
+  }
+
+  std::vector<Crypto::Hash> transactionPrefixHashes;
+  getObjectHashes(transactionPrefixes, transactionPrefixHashes);
   for (size_t i = 0; i < transactions.size(); ++i) {
     const Crypto::Hash& tx_id = blockData.transactionHashes[i];
     block.transactions.resize(block.transactions.size() + 1);
     size_t blob_size = 0;
     uint64_t fee = 0;
-    block.transactions.back().tx = transactions[i];
+    block.transactions.back().tx = FlatTransaction(transactions[i].getTransaction());
 
-    blob_size = toBinaryArray(block.transactions.back().tx).size();
-    fee = getInputAmount(block.transactions.back().tx) - getOutputAmount(block.transactions.back().tx);
-    if (!checkTransactionInputs(block.transactions.back().tx)) {
+    // ring signature checks point into the cached transaction, which outlives them
+    const Transaction& transaction = transactions[i].getTransaction();
+    blob_size = transactions[i].getTransactionBinarySize();
+    fee = getInputAmount(transaction) - getOutputAmount(transaction);
+    if (!checkTransactionInputs(transaction, transactionPrefixHashes[i], nullptr, &ringSignatureChecks)) {
       logger(INFO, BRIGHT_WHITE) <<
         "Block " << blockHash << " has at least one transaction with wrong inputs: " << tx_id;
       bvc.m_verifivation_failed = true;
+      m_is_in_checkpoint_zone = false;
 
       block.transactions.pop_back();
       popTransactions(block, minerTransactionHash);
@@ -1750,6 +2223,8 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
     fee_summary += fee;
   }
 
+  m_is_in_checkpoint_zone = false;
+
   if (!checkCumulativeBlockSize(blockHash, cumulative_block_size, m_blocks.size())) {
     bvc.m_verifivation_failed = true;
     return false;
@@ -1765,6 +2240,16 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
     return false;
   }
 
+  auto signatureCheckStart = std::chrono::steady_clock::now();
+  if (!checkRingSignatures(ringSignatureChecks)) {
+    logger(INFO, BRIGHT_WHITE) << "Block " << blockHash << " has at least one transaction with invalid ring signature";
+    bvc.m_verifivation_failed = true;
+    popTransactions(block, minerTransactionHash);
+    return false;
+  }
+
+  auto signature_checking_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - signatureCheckStart).count();
+
   block.height = static_cast<uint32_t>(m_blocks.size());
   block.block_cumulative_size = cumulative_block_size;
   block.cumulative_difficulty = currentDifficulty;
@@ -1773,7 +2258,7 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
     block.cumulative_difficulty += m_blocks.back().cumulative_difficulty;
   }
 
-  pushBlock(block);
+  pushBlock(block, blockHash);
 
   auto block_processing_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - blockProcessingStart).count();
 
@@ -1783,7 +2268,7 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
     << ENDL << "HEIGHT " << block.height << ", difficulty:\t" << currentDifficulty
     << ENDL << "block reward: " << m_currency.formatAmount(reward) << ", fee = " << m_currency.formatAmount(fee_summary)
     << ", coinbase_blob_size: " << coinbase_blob_size << ", cumulative size: " << cumulative_block_size
-    << ", " << block_processing_time << "(" << target_calculating_time << "/" << longhash_calculating_time << ")ms";
+    << ", " << block_processing_time << "(" << target_calculating_time << "/" << longhash_calculating_time << "/" << signature_checking_time << ")ms";
 
   bvc.m_added_to_main_chain = true;
 
@@ -1792,11 +2277,10 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
   return true;
 }
 
-bool Blockchain::pushBlock(BlockEntry& block) {
-  Crypto::Hash blockHash = get_block_hash(block.bl);
-
+bool Blockchain::pushBlock(BlockEntry& block, const Crypto::Hash& blockHash) {
   m_blocks.push_back(block);
   m_blockIndex.push(blockHash);
+  appendIndexDelta(makeIndexDelta(block, blockHash));
 
   m_timestampIndex.add(block.bl.timestamp, blockHash);
   m_generatedTransactionsIndex.add(block.bl);
@@ -1813,9 +2297,11 @@ void Blockchain::popBlock(const Crypto::Hash& blockHash) {
     return;
   }
 
-  std::vector<Transaction> transactions(m_blocks.back().transactions.size() - 1);
+  // the pool gets the hashes along with the transactions, so they are not computed again
+  std::vector<CachedTransaction> transactions;
+  transactions.reserve(m_blocks.back().transactions.size() - 1);
   for (size_t i = 0; i < m_blocks.back().transactions.size() - 1; ++i) {
-    transactions[i] = m_blocks.back().transactions[1 + i].tx;
+    transactions.emplace_back(m_blocks.back().transactions[1 + i].tx.getTransaction(), m_blocks.back().bl.transactionHashes[i]);
   }
 
   saveTransactions(transactions);
@@ -1825,8 +2311,10 @@ void Blockchain::popBlock(const Crypto::Hash& blockHash) {
   m_timestampIndex.remove(m_blocks.back().bl.timestamp, blockHash);
   m_generatedTransactionsIndex.remove(m_blocks.back().bl);
 
+  popIndexDelta();
   m_blocks.pop_back();
   m_blockIndex.pop();
+  m_signatureCache.removeFromHeight(static_cast<uint32_t>(m_blocks.size()));
 
   assert(m_blockIndex.size() == m_blocks.size());
 }
@@ -1848,14 +2336,16 @@ bool Blockchain::pushTransaction(BlockEntry& block, const Crypto::Hash& transact
     return false;
   }
 
-  for (size_t i = 0; i < transaction.tx.inputs.size(); ++i) {
-    if (transaction.tx.inputs[i].type() == typeid(KeyInput)) {
-      auto result = m_spent_keys.insert(::boost::get<KeyInput>(transaction.tx.inputs[i]).keyImage);
+  for (size_t i = 0; i < transaction.tx.getInputCount(); ++i) {
+    if (transaction.tx.getInputType(i) == TransactionTypes::InputType::Key) {
+      auto result = m_spent_keys.insert(transaction.tx.getKeyImage(i));
       if (!result.second) {
         logger(ERROR, BRIGHT_RED) <<
           "Double spending transaction was pushed to blockchain.";
         for (size_t j = 0; j < i; ++j) {
-          m_spent_keys.erase(::boost::get<KeyInput>(transaction.tx.inputs[i - 1 - j]).keyImage);
+          if (transaction.tx.getInputType(i - 1 - j) == TransactionTypes::InputType::Key) {
+            m_spent_keys.erase(transaction.tx.getKeyImage(i - 1 - j));
+          }
         }
 
         m_transactionMap.erase(transactionHash);
@@ -1864,39 +2354,42 @@ bool Blockchain::pushTransaction(BlockEntry& block, const Crypto::Hash& transact
     }
   }
 
-  for (const auto& inv : transaction.tx.inputs) {
-    if (inv.type() == typeid(MultisignatureInput)) {
-      const MultisignatureInput& in = ::boost::get<MultisignatureInput>(inv);
+  for (size_t i = 0; i < transaction.tx.getInputCount(); ++i) {
+    if (transaction.tx.getInputType(i) == TransactionTypes::InputType::Multisignature) {
+      MultisignatureInput in;
+      transaction.tx.getInput(i, in);
       auto& amountOutputs = m_multisignatureOutputs[in.amount];
       amountOutputs[in.outputIndex].isUsed = true;
     }
   }
 
-  transaction.m_global_output_indexes.resize(transaction.tx.outputs.size());
-  for (uint16_t output = 0; output < transaction.tx.outputs.size(); ++output) {
-    if (transaction.tx.outputs[output].target.type() == typeid(KeyOutput)) {
-      auto& amountOutputs = m_outputs[transaction.tx.outputs[output].amount];
+  transaction.m_global_output_indexes.resize(transaction.tx.getOutputCount());
+  for (uint16_t output = 0; output < transaction.tx.getOutputCount(); ++output) {
+    if (transaction.tx.getOutputType(output) == TransactionTypes::OutputType::Key) {
+      auto& amountOutputs = m_outputs[transaction.tx.getOutputAmount(output)];
       transaction.m_global_output_indexes[output] = static_cast<uint32_t>(amountOutputs.size());
       amountOutputs.push_back(std::make_pair<>(transactionIndex, output));
-    } else if (transaction.tx.outputs[output].target.type() == typeid(MultisignatureOutput)) {
-      auto& amountOutputs = m_multisignatureOutputs[transaction.tx.outputs[output].amount];
+    } else if (transaction.tx.getOutputType(output) == TransactionTypes::OutputType::Multisignature) {
+      auto& amountOutputs = m_multisignatureOutputs[transaction.tx.getOutputAmount(output)];
       transaction.m_global_output_indexes[output] = static_cast<uint32_t>(amountOutputs.size());
       MultisignatureOutputUsage outputUsage = { transactionIndex, output, false };
       amountOutputs.push_back(outputUsage);
     }
   }
 
-  m_paymentIdIndex.add(transaction.tx);
+  Common::ArrayView<uint8_t> extra = transaction.tx.getExtra();
+  m_paymentIdIndex.add(transactionHash, std::vector<uint8_t>(extra.begin(), extra.end()));
 
   return true;
 }
 
-void Blockchain::popTransaction(const Transaction& transaction, const Crypto::Hash& transactionHash) {
+void Blockchain::popTransaction(const FlatTransaction& transaction, const Crypto::Hash& transactionHash) {
   TransactionIndex transactionIndex = m_transactionMap.at(transactionHash);
-  for (size_t outputIndex = 0; outputIndex < transaction.outputs.size(); ++outputIndex) {
-    const TransactionOutput& output = transaction.outputs[transaction.outputs.size() - 1 - outputIndex];
-    if (output.target.type() == typeid(KeyOutput)) {
-      auto amountOutputs = m_outputs.find(output.amount);
+  for (size_t outputIndex = 0; outputIndex < transaction.getOutputCount(); ++outputIndex) {
+    size_t output = transaction.getOutputCount() - 1 - outputIndex;
+    uint64_t amount = transaction.getOutputAmount(output);
+    if (transaction.getOutputType(output) == TransactionTypes::OutputType::Key) {
+      auto amountOutputs = m_outputs.find(amount);
       if (amountOutputs == m_outputs.end()) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - cannot find specific amount in outputs map.";
@@ -1915,7 +2408,7 @@ void Blockchain::popTransaction(const Transaction& transaction, const Crypto::Ha
         continue;
       }
 
-      if (amountOutputs->second.back().second != transaction.outputs.size() - 1 - outputIndex) {
+      if (amountOutputs->second.back().second != output) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - invalid output index.";
         continue;
@@ -1925,8 +2418,8 @@ void Blockchain::popTransaction(const Transaction& transaction, const Crypto::Ha
       if (amountOutputs->second.empty()) {
         m_outputs.erase(amountOutputs);
       }
-    } else if (output.target.type() == typeid(MultisignatureOutput)) {
-      auto amountOutputs = m_multisignatureOutputs.find(output.amount);
+    } else if (transaction.getOutputType(output) == TransactionTypes::OutputType::Multisignature) {
+      auto amountOutputs = m_multisignatureOutputs.find(amount);
       if (amountOutputs == m_multisignatureOutputs.end()) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - cannot find specific amount in outputs map.";
@@ -1951,7 +2444,7 @@ void Blockchain::popTransaction(const Transaction& transaction, const Crypto::Ha
         continue;
       }
 
-      if (amountOutputs->second.back().outputIndex != transaction.outputs.size() - 1 - outputIndex) {
+      if (amountOutputs->second.back().outputIndex != output) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - invalid output index.";
         continue;
@@ -1964,15 +2457,16 @@ void Blockchain::popTransaction(const Transaction& transaction, const Crypto::Ha
     }
   }
 
-  for (auto& input : transaction.inputs) {
-    if (input.type() == typeid(KeyInput)) {
-      size_t count = m_spent_keys.erase(::boost::get<KeyInput>(input).keyImage);
+  for (size_t i = 0; i < transaction.getInputCount(); ++i) {
+    if (transaction.getInputType(i) == TransactionTypes::InputType::Key) {
+      size_t count = m_spent_keys.erase(transaction.getKeyImage(i));
       if (count != 1) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - cannot find spent key.";
       }
-    } else if (input.type() == typeid(MultisignatureInput)) {
-      const MultisignatureInput& in = ::boost::get<MultisignatureInput>(input);
+    } else if (transaction.getInputType(i) == TransactionTypes::InputType::Multisignature) {
+      MultisignatureInput in;
+      transaction.getInput(i, in);
       auto& amountOutputs = m_multisignatureOutputs[in.amount];
       if (!amountOutputs[in.outputIndex].isUsed) {
         logger(ERROR, BRIGHT_RED) <<
@@ -1983,7 +2477,8 @@ void Blockchain::popTransaction(const Transaction& transaction, const Crypto::Ha
     }
   }
 
-  m_paymentIdIndex.remove(transaction);
+  Common::ArrayView<uint8_t> extra = transaction.getExtra();
+  m_paymentIdIndex.remove(transactionHash, std::vector<uint8_t>(extra.begin(), extra.end()));
 
   size_t count = m_transactionMap.erase(transactionHash);
   if (count != 1) {
@@ -1997,7 +2492,7 @@ void Blockchain::popTransactions(const BlockEntry& block, const Crypto::Hash& mi
     popTransaction(block.transactions[block.transactions.size() - 1 - i].tx, block.bl.transactionHashes[block.transactions.size() - 2 - i]);
   }
 
-  popTransaction(block.bl.baseTransaction, minerTransactionHash);
+  popTransaction(block.transactions[0].tx, minerTransactionHash);
 }
 
 bool Blockchain::validateInput(const MultisignatureInput& input, const Crypto::Hash& transactionHash, const Crypto::Hash& transactionPrefixHash, const std::vector<Crypto::Signature>& transactionSignatures) {
@@ -2022,32 +2517,36 @@ bool Blockchain::validateInput(const MultisignatureInput& input, const Crypto::H
     return false;
   }
 
-  const Transaction& outputTransaction = m_blocks[outputIndex.transactionIndex.block].transactions[outputIndex.transactionIndex.transaction].tx;
-  if (!is_tx_spendtime_unlocked(outputTransaction.unlockTime)) {
+  const FlatTransaction& outputTransaction = m_blocks[outputIndex.transactionIndex.block].transactions[outputIndex.transactionIndex.transaction].tx;
+  if (!is_tx_spendtime_unlocked(outputTransaction.getUnlockTime())) {
     logger(DEBUGGING) <<
       "Transaction << " << transactionHash << " contains multisignature input which points to a locked transaction.";
     return false;
   }
 
-  assert(outputTransaction.outputs[outputIndex.outputIndex].amount == input.amount);
-  assert(outputTransaction.outputs[outputIndex.outputIndex].target.type() == typeid(MultisignatureOutput));
-  const MultisignatureOutput& output = ::boost::get<MultisignatureOutput>(outputTransaction.outputs[outputIndex.outputIndex].target);
-  if (input.signatureCount != output.requiredSignatureCount) {
+  assert(outputTransaction.getOutputAmount(outputIndex.outputIndex) == input.amount);
+  assert(outputTransaction.getOutputType(outputIndex.outputIndex) == TransactionTypes::OutputType::Multisignature);
+  Common::ArrayView<Crypto::PublicKey> outputKeys = outputTransaction.getOutputKeys(outputIndex.outputIndex);
+  if (input.signatureCount != outputTransaction.getRequiredSignatureCount(outputIndex.outputIndex)) {
     logger(DEBUGGING) <<
       "Transaction << " << transactionHash << " contains multisignature input with invalid signature count.";
     return false;
   }
 
+  if (m_is_in_checkpoint_zone) {
+    return true;
+  }
+
   size_t inputSignatureIndex = 0;
   size_t outputKeyIndex = 0;
   while (inputSignatureIndex < input.signatureCount) {
-    if (outputKeyIndex == output.keys.size()) {
+    if (outputKeyIndex == outputKeys.getSize()) {
       logger(DEBUGGING) <<
         "Transaction << " << transactionHash << " contains multisignature input with invalid signatures.";
       return false;
     }
 
-    if (Crypto::check_signature(transactionPrefixHash, output.keys[outputKeyIndex], transactionSignatures[inputSignatureIndex])) {
+    if (Crypto::check_signature(transactionPrefixHash, outputKeys[outputKeyIndex], transactionSignatures[inputSignatureIndex])) {
       ++inputSignatureIndex;
     }
 
@@ -2058,7 +2557,7 @@ bool Blockchain::validateInput(const MultisignatureInput& input, const Crypto::H
 }
 
 bool Blockchain::getLowerBound(uint64_t timestamp, uint64_t startOffset, uint32_t& height) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
 
   assert(startOffset < m_blocks.size());
 
@@ -2074,12 +2573,12 @@ bool Blockchain::getLowerBound(uint64_t timestamp, uint64_t startOffset, uint32_
 }
 
 std::vector<Crypto::Hash> Blockchain::getBlockIds(uint32_t startHeight, uint32_t maxCount) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return m_blockIndex.getBlockIds(startHeight, maxCount);
 }
 
 bool Blockchain::getBlockContainingTransaction(const Crypto::Hash& txId, Crypto::Hash& blockId, uint32_t& blockHeight) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   auto it = m_transactionMap.find(txId);
   if (it == m_transactionMap.end()) {
     return false;
@@ -2091,7 +2590,7 @@ bool Blockchain::getBlockContainingTransaction(const Crypto::Hash& txId, Crypto:
 }
 
 bool Blockchain::getAlreadyGeneratedCoins(const Crypto::Hash& hash, uint64_t& generatedCoins) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
 
   // try to find block in main chain
   uint32_t height = 0;
@@ -2112,7 +2611,7 @@ bool Blockchain::getAlreadyGeneratedCoins(const Crypto::Hash& hash, uint64_t& ge
 }
 
 bool Blockchain::getBlockSize(const Crypto::Hash& hash, size_t& size) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
 
   // try to find block in main chain
   uint32_t height = 0;
@@ -2133,7 +2632,7 @@ bool Blockchain::getBlockSize(const Crypto::Hash& hash, size_t& size) {
 }
 
 bool Blockchain::getMultisigOutputReference(const MultisignatureInput& txInMultisig, std::pair<Crypto::Hash, size_t>& outputReference) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   MultisignatureOutputsContainer::const_iterator amountIter = m_multisignatureOutputs.find(txInMultisig.amount);
   if (amountIter == m_multisignatureOutputs.end()) {
     logger(DEBUGGING) << "Transaction contains multisignature input with invalid amount.";
@@ -2144,14 +2643,15 @@ bool Blockchain::getMultisigOutputReference(const MultisignatureInput& txInMulti
     return false;
   }
   const MultisignatureOutputUsage& outputIndex = amountIter->second[txInMultisig.outputIndex];
-  const Transaction& outputTransaction = m_blocks[outputIndex.transactionIndex.block].transactions[outputIndex.transactionIndex.transaction].tx;
-  outputReference.first = getObjectHash(outputTransaction);
+  const BlockEntry& block = m_blocks[outputIndex.transactionIndex.block];
+  outputReference.first = outputIndex.transactionIndex.transaction == 0 ? getObjectHash(block.bl.baseTransaction) :
+    block.bl.transactionHashes[outputIndex.transactionIndex.transaction - 1];
   outputReference.second = outputIndex.outputIndex;
   return true;
 }
 
 bool Blockchain::storeBlockchainIndices() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
 
   logger(INFO, BRIGHT_WHITE) << "Saving blockchain indices...";
   BlockchainIndicesSerializer ser(*this, getTailId(), logger.getLogger());
@@ -2189,7 +2689,9 @@ bool Blockchain::loadBlockchainIndices() {
       m_generatedTransactionsIndex.add(block.bl);
       for (uint16_t t = 0; t < block.transactions.size(); ++t) {
         const TransactionEntry& transaction = block.transactions[t];
-        m_paymentIdIndex.add(transaction.tx);
+        Common::ArrayView<uint8_t> extra = transaction.tx.getExtra();
+        m_paymentIdIndex.add(t == 0 ? getObjectHash(block.bl.baseTransaction) : block.bl.transactionHashes[t - 1],
+          std::vector<uint8_t>(extra.begin(), extra.end()));
       }
     }
 
@@ -2200,31 +2702,33 @@ bool Blockchain::loadBlockchainIndices() {
 }
 
 bool Blockchain::getGeneratedTransactionsNumber(uint32_t height, uint64_t& generatedTransactions) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return m_generatedTransactionsIndex.find(height, generatedTransactions);
 }
 
 bool Blockchain::getOrphanBlockIdsByHeight(uint32_t height, std::vector<Crypto::Hash>& blockHashes) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return m_orthanBlocksIndex.find(height, blockHashes);
 }
 
 bool Blockchain::getBlockIdsByTimestamp(uint64_t timestampBegin, uint64_t timestampEnd, uint32_t blocksNumberLimit, std::vector<Crypto::Hash>& hashes, uint32_t& blocksNumberWithinTimestamps) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return m_timestampIndex.find(timestampBegin, timestampEnd, blocksNumberLimit, hashes, blocksNumberWithinTimestamps);
 }
 
 bool Blockchain::getTransactionIdsByPaymentId(const Crypto::Hash& paymentId, std::vector<Crypto::Hash>& transactionHashes) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Common::SharedLockGuard lk(m_blockchain_lock);
   return m_paymentIdIndex.find(paymentId, transactionHashes);
 }
 
-bool Blockchain::loadTransactions(const Block& block, std::vector<Transaction>& transactions) {
-  transactions.resize(block.transactionHashes.size());
+bool Blockchain::loadTransactions(const Block& block, std::vector<CachedTransaction>& transactions) {
+  transactions.clear();
+  transactions.reserve(block.transactionHashes.size());
   size_t transactionSize;
   uint64_t fee;
   for (size_t i = 0; i < block.transactionHashes.size(); ++i) {
-    if (!m_tx_pool.take_tx(block.transactionHashes[i], transactions[i], transactionSize, fee)) {
+    Transaction transaction;
+    if (!m_tx_pool.take_tx(block.transactionHashes[i], transaction, transactionSize, fee)) {
       tx_verification_context context;
       for (size_t j = 0; j < i; ++j) {
         if (!m_tx_pool.add_tx(transactions[i - 1 - j], context, true)) {
@@ -2234,12 +2738,14 @@ bool Blockchain::loadTransactions(const Block& block, std::vector<Transaction>&
 
       return false;
     }
+
+    transactions.emplace_back(std::move(transaction), block.transactionHashes[i], transactionSize);
   }
 
   return true;
 }
 
-void Blockchain::saveTransactions(const std::vector<Transaction>& transactions) {
+void Blockchain::saveTransactions(const std::vector<CachedTransaction>& transactions) {
   tx_verification_context context;
   for (size_t i = 0; i < transactions.size(); ++i) {
     if (!m_tx_pool.add_tx(transactions[transactions.size() - 1 - i], context, true)) {
@@ -5,18 +5,28 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 
 #include "google/sparse_hash_set"
 #include "google/sparse_hash_map"
 
 #include "Common/ObserverManager.h"
+#include "Common/ReadWriteLock.h"
+#include "Common/ThreadPool.h"
 #include "Common/Util.h"
 #include "CryptoNoteCore/BlockIndex.h"
+#include "CryptoNoteCore/CachedBlock.h"
+#include "CryptoNoteCore/CachedTransaction.h"
 #include "CryptoNoteCore/Checkpoints.h"
 #include "CryptoNoteCore/Currency.h"
+#include "CryptoNoteCore/FlatTransaction.h"
 #include "CryptoNoteCore/IBlockchainStorageObserver.h"
 #include "CryptoNoteCore/ITransactionValidator.h"
-#include "CryptoNoteCore/SwappedVector.h"
+#include "CryptoNoteCore/MappedVector.h"
+#include "CryptoNoteCore/ProofOfWorkCache.h"
+#include "CryptoNoteCore/SignatureCache.h"
 #include "CryptoNoteCore/CryptoNoteFormatUtils.h"
 #include "CryptoNoteCore/TransactionPool.h"
 #include "CryptoNoteCore/BlockchainIndices.h"
@@ -49,6 +59,7 @@ namespace CryptoNote {
     virtual bool checkTransactionInputs(const CryptoNote::Transaction& tx, BlockInfo& maxUsedBlock, BlockInfo& lastFailed) override;
     virtual bool haveSpentKeyImages(const CryptoNote::Transaction& tx) override;
     virtual bool checkTransactionSize(size_t blobSize) override;
+    virtual bool isInTrustedCheckpointZone() override;
 
     bool init() { return init(Tools::getDefaultDataDirectory(), true); }
     bool init(const std::string& config_folder, bool load_existing);
@@ -58,6 +69,12 @@ namespace CryptoNote {
     std::vector<Crypto::Hash> getBlockIds(uint32_t startHeight, uint32_t maxCount);
 
     void setCheckpoints(Checkpoints&& chk_pts) { m_checkpoints = chk_pts; }
+    // 0 means one thread per hardware core
+    void setRebuildThreads(uint32_t threads) { m_rebuildThreads = threads; }
+    // Ring signatures of blocks below the last checkpoint are not checked
+    void setTrustCheckpoints(bool trust) { m_trustCheckpoints = trust; }
+    Common::ReadWriteLockStatistics getLockStatistics() const { return m_blockchain_lock.getStatistics(); }
+    SignatureCacheStatistics getSignatureCacheStatistics() const { return m_signatureCache.getStatistics(); }
     bool getBlocks(uint32_t start_offset, uint32_t count, std::list<Block>& blocks, std::list<Transaction>& txs);
     bool getBlocks(uint32_t start_offset, uint32_t count, std::list<Block>& blocks);
     bool getAlternativeBlocks(std::list<Block>& blocks);
@@ -70,6 +87,11 @@ namespace CryptoNote {
 
     bool haveTransaction(const Crypto::Hash &id);
     bool haveTransactionKeyImagesAsSpent(const Transaction &tx);
+    // Checks ring signatures that refer to existing outputs and remembers the valid ones, failures are left for addNewBlock
+    void preverifyTransactionSignatures(const std::vector<const Transaction*>& transactions);
+    // Computes long hashes of blocks above the checkpoints on all cores and remembers them, so addNewBlock
+    // only compares them with the difficulty
+    void preverifyProofsOfWork(const std::vector<const Block*>& blocks);
 
     uint32_t getCurrentBlockchainHeight(); //TODO rename to getCurrentBlockchainSize
     Crypto::Hash getTailId();
@@ -110,7 +132,7 @@ namespace CryptoNote {
 
     template<class t_ids_container, class t_blocks_container, class t_missed_container>
     bool getBlocks(const t_ids_container& block_ids, t_blocks_container& blocks, t_missed_container& missed_bs) {
-      std::lock_guard<std::recursive_mutex> lk(m_blockchain_lock);
+      Common::SharedLockGuard lk(m_blockchain_lock);
 
       for (const auto& bl_id : block_ids) {
         uint32_t height = 0;
@@ -128,14 +150,14 @@ namespace CryptoNote {
 
     template<class t_ids_container, class t_tx_container, class t_missed_container>
     void getBlockchainTransactions(const t_ids_container& txs_ids, t_tx_container& txs, t_missed_container& missed_txs) {
-      std::lock_guard<decltype(m_blockchain_lock)> bcLock(m_blockchain_lock);
+      Common::SharedLockGuard bcLock(m_blockchain_lock);
 
       for (const auto& tx_id : txs_ids) {
         auto it = m_transactionMap.find(tx_id);
         if (it == m_transactionMap.end()) {
           missed_txs.push_back(tx_id);
         } else {
-          txs.push_back(transactionByIndex(it->second).tx);
+          txs.push_back(transactionByIndex(it->second).tx.getTransaction());
         }
       }
     }
@@ -186,7 +208,7 @@ namespace CryptoNote {
     };
 
     struct TransactionEntry {
-      Transaction tx;
+      FlatTransaction tx;
       std::vector<uint32_t> m_global_output_indexes;
 
       void serialize(ISerializer& s) {
@@ -213,6 +235,87 @@ namespace CryptoNote {
       }
     };
 
+    // Index journal records hold what rebuildCache() would otherwise recompute by hashing every block and transaction
+    struct MultisignatureInputDelta {
+      uint64_t amount;
+      uint32_t outputIndex;
+
+      void serialize(ISerializer& s) {
+        s(amount, "amount");
+        s(outputIndex, "outindex");
+      }
+    };
+
+    enum OutputDeltaType : uint8_t {
+      OUTPUT_DELTA_KEY = 0,
+      OUTPUT_DELTA_MULTISIGNATURE = 1,
+      OUTPUT_DELTA_OTHER = 2
+    };
+
+    struct OutputDelta {
+      uint64_t amount;
+      uint8_t type;
+
+      void serialize(ISerializer& s) {
+        s(amount, "amount");
+        s(type, "type");
+      }
+    };
+
+    struct TransactionIndexDelta {
+      Crypto::Hash hash;
+      std::vector<Crypto::KeyImage> keyImages;
+      std::vector<MultisignatureInputDelta> multisignatureInputs;
+      std::vector<OutputDelta> outputs;
+
+      void serialize(ISerializer& s) {
+        s(hash, "hash");
+        s(keyImages, "key_images");
+        s(multisignatureInputs, "multisig_inputs");
+        s(outputs, "outputs");
+      }
+    };
+
+    struct BlockIndexDelta {
+      Crypto::Hash hash;
+      std::vector<TransactionIndexDelta> transactions;
+
+      void serialize(ISerializer& s) {
+        s(hash, "hash");
+        s(transactions, "transactions");
+      }
+    };
+
+    struct IndexJournalSegment {
+      uint32_t startHeight;
+      std::vector<BlockIndexDelta> blocks;
+
+      void serialize(ISerializer& s) {
+        s(startHeight, "start_height");
+        s(blocks, "blocks");
+      }
+    };
+
+    struct IndexRebuildTimings {
+      std::chrono::steady_clock::duration journalReading;
+      std::chrono::steady_clock::duration blockHashing;
+      std::chrono::steady_clock::duration blockIndex;
+      std::chrono::steady_clock::duration transactionMap;
+      std::chrono::steady_clock::duration spentKeys;
+      std::chrono::steady_clock::duration outputs;
+      std::chrono::steady_clock::duration multisignatureOutputs;
+    };
+
+    // Ring signature check postponed until the rest of a block is validated, signatures belong to the block transactions
+    struct RingSignatureCheck {
+      Crypto::Hash cacheKey;
+      uint32_t maxUsedBlockHeight;
+      Crypto::Hash prefixHash;
+      Crypto::KeyImage keyImage;
+      std::vector<Crypto::PublicKey> outputKeys;
+      const Crypto::Signature* signatures;
+    };
+
     typedef google::sparse_hash_set<Crypto::KeyImage> key_images_container;
     typedef std::unordered_map<Crypto::Hash, BlockEntry> blocks_ext_by_hash;
     typedef google::sparse_hash_map<uint64_t, std::vector<std::pair<TransactionIndex, uint16_t>>> outputs_container; //Crypto::Hash - tx hash, size_t - index of out in transaction
@@ -220,7 +323,8 @@ namespace CryptoNote {
 
     const Currency& m_currency;
     tx_memory_pool& m_tx_pool;
-    std::recursive_mutex m_blockchain_lock; // TODO: add here reader/writer lock
+    // Readers take the lock shared, methods that modify the chain take it exclusive
+    Common::ReadWriteLock m_blockchain_lock;
     Crypto::cn_context m_cn_context;
     Tools::ObserverManager<IBlockchainStorageObserver> m_observerManager;
 
@@ -232,8 +336,19 @@ namespace CryptoNote {
     std::string m_config_folder;
     Checkpoints m_checkpoints;
     std::atomic<bool> m_is_in_checkpoint_zone;
-
-    typedef SwappedVector<BlockEntry> Blocks;
+    bool m_trustCheckpoints;
+    uint32_t m_rebuildThreads;
+    std::once_flag m_verificationPoolCreated;
+    std::unique_ptr<Common::ThreadPool> m_verificationPool;
+    // contexts of the verification threads that are not computing a long hash at the moment
+    std::mutex m_proofOfWorkContextsMutex;
+    std::vector<std::unique_ptr<Crypto::cn_context>> m_proofOfWorkContexts;
+    ProofOfWorkCache m_proofOfWorkCache;
+    Crypto::RingMemberCache m_ringMemberCache;
+    SignatureCache m_signatureCache;
+
+    typedef MappedVector<BlockEntry> Blocks;
+    typedef MappedVector<IndexJournalSegment> IndexJournal;
     typedef std::unordered_map<Crypto::Hash, uint32_t> BlockMap;
     typedef std::unordered_map<Crypto::Hash, TransactionIndex> TransactionMap;
 
@@ -241,6 +356,10 @@ namespace CryptoNote {
     friend class BlockchainIndicesSerializer;
 
     Blocks m_blocks;
+    // Index deltas of completed segments of m_blocks, each holding exactly INDEX_JOURNAL_SEGMENT_SIZE blocks
+    IndexJournal m_indexJournal;
+    // Index deltas of blocks that follow the last journal segment
+    std::vector<BlockIndexDelta> m_pendingIndexDeltas;
     CryptoNote::BlockIndex m_blockIndex;
     TransactionMap m_transactionMap;
     MultisignatureOutputsContainer m_multisignatureOutputs;
@@ -255,6 +374,13 @@ namespace CryptoNote {
     Logging::LoggerRef logger;
 
     void rebuildCache();
+    void validateIndexJournal();
+    void loadPendingIndexDeltas();
+    void clearIndexJournal();
+    void appendIndexDelta(BlockIndexDelta&& delta);
+    void popIndexDelta();
+    BlockIndexDelta makeIndexDelta(const BlockEntry& block, const Crypto::Hash& blockHash);
+    void applyIndexDeltas(const std::vector<BlockIndexDelta>& deltas, uint32_t startHeight, IndexRebuildTimings& timings);
     bool storeCache();
     bool switch_to_alternative_blockchain(std::list<blocks_ext_by_hash::iterator>& alt_chain, bool discard_disconnected_chain);
     bool handle_alternative_block(const Block& b, const Crypto::Hash& id, block_verification_context& bvc, bool sendNewAlternativeBlockMessage = true);
@@ -275,24 +401,31 @@ namespace CryptoNote {
     bool getBlockCumulativeSize(const Block& block, size_t& cumulativeSize);
     bool update_next_comulative_size_limit();
     bool check_tx_input(const KeyInput& txin, const Crypto::Hash& tx_prefix_hash, const std::vector<Crypto::Signature>& sig, uint32_t* pmax_related_block_height = NULL);
+    bool getInputOutputKeys(const KeyInput& txin, const std::vector<Crypto::Signature>& sig, std::vector<const Crypto::PublicKey *>& output_keys, uint32_t* pmax_related_block_height);
+    Common::ThreadPool& getVerificationPool();
+    bool checkRingSignatures(const std::vector<RingSignatureCheck>& checks);
+    // Takes the long hash computed by preverifyProofsOfWork if there is one, otherwise computes it
+    bool checkProofOfWork(const Block& block, const Crypto::Hash& blockHash, difficulty_type currentDifficulty, Crypto::Hash& proofOfWork);
     bool checkTransactionInputs(const Transaction& tx, const Crypto::Hash& tx_prefix_hash, uint32_t* pmax_used_block_height = NULL);
+    // Appends ring signature checks to ringSignatureChecks instead of verifying signatures, unless it is null
+    bool checkTransactionInputs(const Transaction& tx, const Crypto::Hash& tx_prefix_hash, uint32_t* pmax_used_block_height, std::vector<RingSignatureCheck>* ringSignatureChecks);
     bool checkTransactionInputs(const Transaction& tx, uint32_t* pmax_used_block_height = NULL);
     bool have_tx_keyimg_as_spent(const Crypto::KeyImage &key_im);
     const TransactionEntry& transactionByIndex(TransactionIndex index);
-    bool pushBlock(const Block& blockData, block_verification_context& bvc);
-    bool pushBlock(const Block& blockData, const std::vector<Transaction>& transactions, block_verification_context& bvc);
-    bool pushBlock(BlockEntry& block);
+    bool pushBlock(const CachedBlock& cachedBlock, block_verification_context& bvc);
+    bool pushBlock(const CachedBlock& cachedBlock, const std::vector<CachedTransaction>& transactions, block_verification_context& bvc);
+    bool pushBlock(BlockEntry& block, const Crypto::Hash& blockHash);
     void popBlock(const Crypto::Hash& blockHash);
     bool pushTransaction(BlockEntry& block, const Crypto::Hash& transactionHash, TransactionIndex transactionIndex);
-    void popTransaction(const Transaction& transaction, const Crypto::Hash& transactionHash);
+    void popTransaction(const FlatTransaction& transaction, const Crypto::Hash& transactionHash);
     void popTransactions(const BlockEntry& block, const Crypto::Hash& minerTransactionHash);
     bool validateInput(const MultisignatureInput& input, const Crypto::Hash& transactionHash, const Crypto::Hash& transactionPrefixHash, const std::vector<Crypto::Signature>& transactionSignatures);
 
     bool storeBlockchainIndices();
     bool loadBlockchainIndices();
 
-    bool loadTransactions(const Block& block, std::vector<Transaction>& transactions);
-    void saveTransactions(const std::vector<Transaction>& transactions);
+    bool loadTransactions(const Block& block, std::vector<CachedTransaction>& transactions);
+    void saveTransactions(const std::vector<CachedTransaction>& transactions);
 
     void sendMessage(const BlockchainMessage& message);
 
@@ -312,11 +445,11 @@ namespace CryptoNote {
   private:
 
     Blockchain& m_bc;
-    std::lock_guard<std::recursive_mutex> m_lock;
+    std::lock_guard<Common::ReadWriteLock> m_lock;
   };
 
   template<class visitor_t> bool Blockchain::scanOutputKeysForIndexes(const KeyInput& tx_in_to_key, visitor_t& vis, uint32_t* pmax_related_block_height) {
-    std::lock_guard<std::recursive_mutex> lk(m_blockchain_lock);
+    Common::SharedLockGuard lk(m_blockchain_lock);
     auto it = m_outputs.find(tx_in_to_key.amount);
     if (it == m_outputs.end() || !tx_in_to_key.outputIndexes.size())
       return false;
@@ -335,15 +468,15 @@ namespace CryptoNote {
 
       const TransactionEntry& tx = transactionByIndex(amount_outs_vec[i].first);
 
-      if (!(amount_outs_vec[i].second < tx.tx.outputs.size())) {
+      if (!(amount_outs_vec[i].second < tx.tx.getOutputCount())) {
         logger(Logging::ERROR, Logging::BRIGHT_RED)
             << "Wrong index in transaction outputs: "
             << amount_outs_vec[i].second << ", expected less then "
-            << tx.tx.outputs.size();
+            << tx.tx.getOutputCount();
         return false;
       }
 
-      if (!vis.handle_output(tx.tx, tx.tx.outputs[amount_outs_vec[i].second], amount_outs_vec[i].second)) {
+      if (!vis.handle_output(tx.tx, amount_outs_vec[i].second)) {
         logger(Logging::INFO) << "Failed to handle_output for output no = " << count << ", with absolute offset " << i;
         return false;
       }
@@ -7,15 +7,34 @@
 #include "Common/StringTools.h"
 #include "CryptoNoteCore/CryptoNoteTools.h"
 #include "CryptoNoteCore/CryptoNoteFormatUtils.h"
-#include "BlockchainExplorer/BlockchainExplorerDataBuilder.h"
+#include "CryptoNoteCore/TransactionExtra.h"
 #include "CryptoNoteBasicImpl.h"
 
 namespace CryptoNote {
 
+namespace {
+
+// Same as BlockchainExplorerDataBuilder::getPaymentId, for callers that only have the extra
+bool getPaymentId(const std::vector<uint8_t>& extra, Crypto::Hash& paymentId) {
+  std::vector<TransactionExtraField> txExtraFields;
+  parseTransactionExtra(extra, txExtraFields);
+  TransactionExtraNonce extraNonce;
+  if (!findTransactionExtraFieldByType(txExtraFields, extraNonce)) {
+    return false;
+  }
+
+  return getPaymentIdFromTransactionExtraNonce(extraNonce.nonce, paymentId);
+}
+
+}
+
 bool PaymentIdIndex::add(const Transaction& transaction) {
+  return add(getObjectHash(transaction), transaction.extra);
+}
+
+bool PaymentIdIndex::add(const Crypto::Hash& transactionHash, const std::vector<uint8_t>& extra) {
   Crypto::Hash paymentId;
-  Crypto::Hash transactionHash = getObjectHash(transaction);
-  if (!BlockchainExplorerDataBuilder::getPaymentId(transaction, paymentId)) {
+  if (!getPaymentId(extra, paymentId)) {
     return false;
   }
 
@@ -25,9 +44,12 @@ bool PaymentIdIndex::add(const Transaction& transaction) {
 }
 
 bool PaymentIdIndex::remove(const Transaction& transaction) {
+  return remove(getObjectHash(transaction), transaction.extra);
+}
+
+bool PaymentIdIndex::remove(const Crypto::Hash& transactionHash, const std::vector<uint8_t>& extra) {
   Crypto::Hash paymentId;
-  Crypto::Hash transactionHash = getObjectHash(transaction);
-  if (!BlockchainExplorerDataBuilder::getPaymentId(transaction, paymentId)) {
+  if (!getPaymentId(extra, paymentId)) {
     return false;
   }
 
@@ -20,7 +20,9 @@ public:
   PaymentIdIndex() = default;
 
   bool add(const Transaction& transaction);
+  bool add(const Crypto::Hash& transactionHash, const std::vector<uint8_t>& extra);
   bool remove(const Transaction& transaction);
+  bool remove(const Crypto::Hash& transactionHash, const std::vector<uint8_t>& extra);
   bool find(const Crypto::Hash& paymentId, std::vector<Crypto::Hash>& transactionHashes);
   void clear();
 
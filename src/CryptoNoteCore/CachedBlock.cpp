@@ -0,0 +1,73 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "CachedBlock.h"
+
+#include <stdexcept>
+
+#include "CryptoNoteFormatUtils.h"
+#include "CryptoNoteTools.h"
+
+namespace CryptoNote {
+
+CachedBlock::CachedBlock(const Block& block) : m_block(block) {
+}
+
+const Block& CachedBlock::getBlock() const {
+  return m_block;
+}
+
+const Crypto::Hash& CachedBlock::getBlockHash() const {
+  if (!m_blockHash) {
+    // like in get_block_hash, the hashing blob is hashed serialized as a string
+    BinaryArray binaryArray;
+    if (!toBinaryArray(getBlockHashingBinaryArray(), binaryArray)) {
+      throw std::runtime_error("CachedBlock: failed to serialize block hashing blob");
+    }
+
+    m_blockHash = getBinaryArrayHash(binaryArray);
+  }
+
+  return *m_blockHash;
+}
+
+const BinaryArray& CachedBlock::getBlockHashingBinaryArray() const {
+  if (!m_blockHashingBinaryArray) {
+    BinaryArray binaryArray;
+    if (!get_block_hashing_blob(m_block, getBaseTransactionHash(), binaryArray)) {
+      throw std::runtime_error("CachedBlock: failed to serialize block header");
+    }
+
+    m_blockHashingBinaryArray = std::move(binaryArray);
+  }
+
+  return *m_blockHashingBinaryArray;
+}
+
+const Crypto::Hash& CachedBlock::getBaseTransactionHash() const {
+  if (!m_baseTransactionHash) {
+    m_baseTransactionHash = getBinaryArrayHash(getBaseTransactionBinaryArray());
+  }
+
+  return *m_baseTransactionHash;
+}
+
+size_t CachedBlock::getBaseTransactionBinarySize() const {
+  return getBaseTransactionBinaryArray().size();
+}
+
+const BinaryArray& CachedBlock::getBaseTransactionBinaryArray() const {
+  if (!m_baseTransactionBinaryArray) {
+    BinaryArray binaryArray;
+    if (!toBinaryArray(m_block.baseTransaction, binaryArray)) {
+      throw std::runtime_error("CachedBlock: failed to serialize base transaction");
+    }
+
+    m_baseTransactionBinaryArray = std::move(binaryArray);
+  }
+
+  return *m_baseTransactionBinaryArray;
+}
+
+}
@@ -0,0 +1,35 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "CryptoNoteBasic.h"
+
+namespace CryptoNote {
+
+// Block with its hash and the hash and size of its base transaction, each computed on first use and remembered.
+// Refers to the block, which must outlive it.
+class CachedBlock {
+public:
+  explicit CachedBlock(const Block& block);
+
+  const Block& getBlock() const;
+  const Crypto::Hash& getBlockHash() const;
+  const BinaryArray& getBlockHashingBinaryArray() const;
+  const Crypto::Hash& getBaseTransactionHash() const;
+  size_t getBaseTransactionBinarySize() const;
+
+private:
+  const Block& m_block;
+  mutable boost::optional<BinaryArray> m_baseTransactionBinaryArray;
+  mutable boost::optional<Crypto::Hash> m_baseTransactionHash;
+  mutable boost::optional<BinaryArray> m_blockHashingBinaryArray;
+  mutable boost::optional<Crypto::Hash> m_blockHash;
+
+  const BinaryArray& getBaseTransactionBinaryArray() const;
+};
+
+}
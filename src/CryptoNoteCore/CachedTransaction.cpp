@@ -0,0 +1,82 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "CachedTransaction.h"
+
+#include <stdexcept>
+
+#include "CryptoNoteTools.h"
+
+namespace CryptoNote {
+
+CachedTransaction::CachedTransaction(Transaction transaction) : m_transaction(std::move(transaction)) {
+}
+
+CachedTransaction::CachedTransaction(Transaction transaction, const Crypto::Hash& transactionHash) :
+  m_transaction(std::move(transaction)), m_transactionHash(transactionHash) {
+}
+
+CachedTransaction::CachedTransaction(Transaction transaction, const Crypto::Hash& transactionHash, size_t transactionBinarySize) :
+  m_transaction(std::move(transaction)), m_transactionHash(transactionHash), m_transactionBinarySize(transactionBinarySize) {
+}
+
+CachedTransaction::CachedTransaction(BinaryArray transactionBinaryArray) {
+  if (!fromBinaryArray(m_transaction, transactionBinaryArray)) {
+    throw std::runtime_error("CachedTransaction: failed to parse transaction");
+  }
+
+  m_transactionBinaryArray = std::move(transactionBinaryArray);
+}
+
+const Transaction& CachedTransaction::getTransaction() const {
+  return m_transaction;
+}
+
+const Crypto::Hash& CachedTransaction::getTransactionHash() const {
+  if (!m_transactionHash) {
+    m_transactionHash = getBinaryArrayHash(getTransactionBinaryArray());
+  }
+
+  return *m_transactionHash;
+}
+
+const Crypto::Hash& CachedTransaction::getTransactionPrefixHash() const {
+  if (!m_transactionPrefixHash) {
+    // signatures are serialized after the prefix as bare pods, without any sizes
+    size_t signaturesSize = 0;
+    for (const auto& signatures : m_transaction.signatures) {
+      signaturesSize += signatures.size() * sizeof(Crypto::Signature);
+    }
+
+    const BinaryArray& binaryArray = getTransactionBinaryArray();
+    Crypto::Hash prefixHash;
+    Crypto::cn_fast_hash(binaryArray.data(), binaryArray.size() - signaturesSize, prefixHash);
+    m_transactionPrefixHash = prefixHash;
+  }
+
+  return *m_transactionPrefixHash;
+}
+
+const BinaryArray& CachedTransaction::getTransactionBinaryArray() const {
+  if (!m_transactionBinaryArray) {
+    BinaryArray binaryArray;
+    if (!toBinaryArray(m_transaction, binaryArray)) {
+      throw std::runtime_error("CachedTransaction: failed to serialize transaction");
+    }
+
+    m_transactionBinaryArray = std::move(binaryArray);
+  }
+
+  return *m_transactionBinaryArray;
+}
+
+size_t CachedTransaction::getTransactionBinarySize() const {
+  if (!m_transactionBinarySize) {
+    m_transactionBinarySize = getTransactionBinaryArray().size();
+  }
+
+  return *m_transactionBinarySize;
+}
+
+}
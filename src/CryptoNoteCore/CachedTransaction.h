@@ -0,0 +1,38 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "CryptoNoteBasic.h"
+
+namespace CryptoNote {
+
+// Transaction along with its binary array, hashes and size, each computed on first use and remembered,
+// so a transaction passed from the network to the pool and into a block is serialized and hashed once
+class CachedTransaction {
+public:
+  explicit CachedTransaction(Transaction transaction);
+  // Hash and size already known to the caller, e.g. kept by the pool or the block the transaction comes from
+  CachedTransaction(Transaction transaction, const Crypto::Hash& transactionHash);
+  CachedTransaction(Transaction transaction, const Crypto::Hash& transactionHash, size_t transactionBinarySize);
+  // Parses the transaction, throws std::runtime_error if the binary array is not a valid transaction
+  explicit CachedTransaction(BinaryArray transactionBinaryArray);
+
+  const Transaction& getTransaction() const;
+  const Crypto::Hash& getTransactionHash() const;
+  const Crypto::Hash& getTransactionPrefixHash() const;
+  const BinaryArray& getTransactionBinaryArray() const;
+  size_t getTransactionBinarySize() const;
+
+private:
+  Transaction m_transaction;
+  mutable boost::optional<BinaryArray> m_transactionBinaryArray;
+  mutable boost::optional<Crypto::Hash> m_transactionHash;
+  mutable boost::optional<Crypto::Hash> m_transactionPrefixHash;
+  mutable boost::optional<size_t> m_transactionBinarySize;
+};
+
+}
@@ -14,6 +14,7 @@
 #include "../CryptoNoteProtocol/CryptoNoteProtocolDefinitions.h"
 #include "../Logging/LoggerRef.h"
 #include "../Rpc/CoreRpcServerCommandsDefinitions.h"
+#include "CachedTransaction.h"
 #include "CryptoNoteFormatUtils.h"
 #include "CryptoNoteTools.h"
 #include "CryptoNoteStatInfo.h"
@@ -119,6 +120,8 @@ size_t core::get_alternative_blocks_count() {
     bool r = m_mempool.init(m_config_folder);
   if (!(r)) { logger(ERROR, BRIGHT_RED) << "Failed to initialize memory pool"; return false; }
 
+  m_blockchain.setRebuildThreads(config.rebuildThreads);
+  m_blockchain.setTrustCheckpoints(config.trustCheckpoints);
   r = m_blockchain.init(m_config_folder, load_existing);
   if (!(r)) { logger(ERROR, BRIGHT_RED) << "Failed to initialize blockchain storage"; return false; }
 
@@ -193,18 +196,18 @@ bool core::handle_incoming_tx(const BinaryArray& tx_blob, tx_verification_contex
     return false;
   }
 
-  Crypto::Hash tx_hash = NULL_HASH;
-  Crypto::Hash tx_prefixt_hash = NULL_HASH;
-  Transaction tx;
-
-  if (!parse_tx_from_blob(tx, tx_hash, tx_prefixt_hash, tx_blob)) {
+  std::unique_ptr<CachedTransaction> cachedTransaction;
+  try {
+    cachedTransaction.reset(new CachedTransaction(tx_blob));
+  } catch (std::exception&) {
     logger(INFO) << "WRONG TRANSACTION BLOB, Failed to parse, rejected";
     tvc.m_verifivation_failed = true;
     return false;
   }
-  //std::cout << "!"<< tx.inputs.size() << std::endl;
 
-  return handleIncomingTransaction(tx, tx_hash, tx_blob.size(), tvc, keeped_by_block);
+  // the hash is taken from the blob as received, the transaction is not serialized again
+  return handleIncomingTransaction(cachedTransaction->getTransaction(), cachedTransaction->getTransactionHash(),
+    cachedTransaction->getTransactionBinarySize(), tvc, keeped_by_block);
 }
 
 bool core::get_stat_info(core_stat_info& st_inf) {
@@ -217,25 +220,25 @@ bool core::get_stat_info(core_stat_info& st_inf) {
 }
 
 
-bool core::check_tx_semantic(const Transaction& tx, bool keeped_by_block) {
+bool core::check_tx_semantic(const Transaction& tx, const Crypto::Hash& txHash, bool keeped_by_block) {
   if (!tx.inputs.size()) {
-    logger(ERROR) << "tx with empty inputs, rejected for tx id= " << getObjectHash(tx);
+    logger(ERROR) << "tx with empty inputs, rejected for tx id= " << txHash;
     return false;
   }
 
   if (!check_inputs_types_supported(tx)) {
-    logger(ERROR) << "unsupported input types for tx id= " << getObjectHash(tx);
+    logger(ERROR) << "unsupported input types for tx id= " << txHash;
     return false;
   }
 
   std::string errmsg;
   if (!check_outs_valid(tx, &errmsg)) {
-    logger(ERROR) << "tx with invalid outputs, rejected for tx id= " << getObjectHash(tx) << ": " << errmsg;
+    logger(ERROR) << "tx with invalid outputs, rejected for tx id= " << txHash << ": " << errmsg;
     return false;
   }
 
   if (!check_money_overflow(tx)) {
-    logger(ERROR) << "tx have money overflow, rejected for tx id= " << getObjectHash(tx);
+    logger(ERROR) << "tx have money overflow, rejected for tx id= " << txHash;
     return false;
   }
 
@@ -244,7 +247,7 @@ bool core::check_tx_semantic(const Transaction& tx, bool keeped_by_block) {
   uint64_t amount_out = get_outs_money_amount(tx);
 
   if (amount_in < amount_out) {
-    logger(ERROR) << "tx with wrong amounts: ins " << amount_in << ", outs " << amount_out << ", rejected for tx id= " << getObjectHash(tx);
+    logger(ERROR) << "tx with wrong amounts: ins " << amount_in << ", outs " << amount_out << ", rejected for tx id= " << txHash;
     return false;
   }
 
@@ -277,6 +280,14 @@ size_t core::get_blockchain_total_transactions() {
   return m_blockchain.getTotalTransactions();
 }
 
+Common::ReadWriteLockStatistics core::getBlockchainLockStatistics() const {
+  return m_blockchain.getLockStatistics();
+}
+
+SignatureCacheStatistics core::getSignatureCacheStatistics() const {
+  return m_blockchain.getSignatureCacheStatistics();
+}
+
 //bool core::get_outs(uint64_t amount, std::list<Crypto::PublicKey>& pkeys)
 //{
 //  return m_blockchain.get_outs(amount, pkeys);
@@ -486,6 +497,14 @@ bool core::handle_incoming_block_blob(const BinaryArray& block_blob, block_verif
   return handle_incoming_block(b, bvc, control_miner, relay_block);
 }
 
+void core::preverifyTransactions(const std::vector<const Transaction*>& transactions) {
+  m_blockchain.preverifyTransactionSignatures(transactions);
+}
+
+void core::preverifyBlocks(const std::vector<const Block*>& blocks) {
+  m_blockchain.preverifyProofsOfWork(blocks);
+}
+
 bool core::handle_incoming_block(const Block& b, block_verification_context& bvc, bool control_miner, bool relay_block) {
   if (control_miner) {
     pause_mining();
@@ -539,10 +558,6 @@ bool core::have_block(const Crypto::Hash& id) {
   return m_blockchain.haveBlock(id);
 }
 
-bool core::parse_tx_from_blob(Transaction& tx, Crypto::Hash& tx_hash, Crypto::Hash& tx_prefix_hash, const BinaryArray& blob) {
-  return parseAndValidateTransactionFromBinaryArray(blob, tx, tx_hash, tx_prefix_hash);
-}
-
 bool core::check_tx_syntax(const Transaction& tx) {
   return true;
 }
@@ -813,7 +828,7 @@ bool core::scanOutputkeysForIndices(const KeyInput& txInToKey, std::list<std::pa
   {
     std::list<std::pair<Crypto::Hash, size_t>>& m_resultsCollector;
     outputs_visitor(std::list<std::pair<Crypto::Hash, size_t>>& resultsCollector):m_resultsCollector(resultsCollector){}
-    bool handle_output(const Transaction& tx, const TransactionOutput& out, size_t transactionOutputIndex)
+    bool handle_output(const FlatTransaction& tx, size_t transactionOutputIndex)
     {
       m_resultsCollector.push_back(std::make_pair(getObjectHash(tx), transactionOutputIndex));
       return true;
@@ -933,7 +948,7 @@ bool core::handleIncomingTransaction(const Transaction& tx, const Crypto::Hash&
     return false;
   }
 
-  if (!check_tx_semantic(tx, keptByBlock)) {
+  if (!check_tx_semantic(tx, txHash, keptByBlock)) {
     logger(INFO) << "WRONG TRANSACTION BLOB, Failed to check tx " << txHash << " semantic, rejected";
     tvc.m_verifivation_failed = true;
     return false;
@@ -9,8 +9,15 @@
 
 namespace CryptoNote {
 
+namespace {
+const command_line::arg_descriptor<uint32_t> arg_rebuild_threads = {"rebuild-threads", "Specify number of threads used to rebuild blockchain cache, 0 - use all cores", 0, true};
+const command_line::arg_descriptor<bool> arg_trust_checkpoints = {"trust-checkpoints", "Skip ring signature checks of blocks below the last checkpoint, their contents are bound by the checkpointed block hashes"};
+}
+
 CoreConfig::CoreConfig() {
   configFolder = Tools::getDefaultDataDirectory();
+  rebuildThreads = 0;
+  trustCheckpoints = false;
 }
 
 void CoreConfig::init(const boost::program_options::variables_map& options) {
@@ -18,8 +25,18 @@ void CoreConfig::init(const boost::program_options::variables_map& options) {
     configFolder = command_line::get_arg(options, command_line::arg_data_dir);
     configFolderDefaulted = options[command_line::arg_data_dir.name].defaulted();
   }
+
+  if (command_line::has_arg(options, arg_rebuild_threads)) {
+    rebuildThreads = command_line::get_arg(options, arg_rebuild_threads);
+  }
+
+  if (command_line::has_arg(options, arg_trust_checkpoints)) {
+    trustCheckpoints = true;
+  }
 }
 
 void CoreConfig::initOptions(boost::program_options::options_description& desc) {
+  command_line::add_arg(desc, arg_rebuild_threads);
+  command_line::add_arg(desc, arg_trust_checkpoints);
 }
 } //namespace CryptoNote
@@ -19,6 +19,8 @@ public:
 
   std::string configFolder;
   bool configFolderDefaulted = true;
+  uint32_t rebuildThreads;
+  bool trustCheckpoints;
 };
 
 } //namespace CryptoNote
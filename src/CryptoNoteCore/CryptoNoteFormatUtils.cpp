@@ -16,6 +16,7 @@
 #include "CryptoNoteSerialization.h"
 #include "TransactionExtra.h"
 #include "CryptoNoteTools.h"
+#include "FlatTransaction.h"
 
 #include "CryptoNoteConfig.h"
 
@@ -330,6 +331,20 @@ bool checkMultisignatureInputsDiff(const TransactionPrefix& tx) {
   return true;
 }
 
+bool checkMultisignatureInputsDiff(const FlatTransaction& tx) {
+  std::set<std::pair<uint64_t, uint32_t>> inputsUsage;
+  for (size_t i = 0; i < tx.getInputCount(); ++i) {
+    if (tx.getInputType(i) == TransactionTypes::InputType::Multisignature) {
+      MultisignatureInput in;
+      tx.getInput(i, in);
+      if (!inputsUsage.insert(std::make_pair(in.amount, in.outputIndex)).second) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 bool check_money_overflow(const TransactionPrefix &tx) {
   return check_inputs_overflow(tx) && check_outs_overflow(tx);
 }
@@ -428,18 +443,38 @@ bool lookup_acc_outs(const AccountKeys& acc, const Transaction& tx, const Public
   return true;
 }
 
-bool get_block_hashing_blob(const Block& b, BinaryArray& ba) {
+namespace {
+
+Hash getTransactionTreeHash(const Block& b, const Hash& baseTransactionHash) {
+  std::vector<Hash> transactionHashes;
+  transactionHashes.reserve(b.transactionHashes.size() + 1);
+  transactionHashes.push_back(baseTransactionHash);
+  transactionHashes.insert(transactionHashes.end(), b.transactionHashes.begin(), b.transactionHashes.end());
+  return get_tx_tree_hash(transactionHashes);
+}
+
+bool getBlockHashingBlob(const Block& b, const Hash& baseTransactionHash, BinaryArray& ba) {
   if (!toBinaryArray(static_cast<const BlockHeader&>(b), ba)) {
     return false;
   }
 
-  Hash treeRootHash = get_tx_tree_hash(b);
+  Hash treeRootHash = getTransactionTreeHash(b, baseTransactionHash);
   ba.insert(ba.end(), treeRootHash.data, treeRootHash.data + 32);
   auto transactionCount = asBinaryArray(Tools::get_varint_data(b.transactionHashes.size() + 1));
   ba.insert(ba.end(), transactionCount.begin(), transactionCount.end());
   return true;
 }
 
+}
+
+bool get_block_hashing_blob(const Block& b, BinaryArray& ba) {
+  return getBlockHashingBlob(b, getObjectHash(b.baseTransaction), ba);
+}
+
+bool get_block_hashing_blob(const Block& b, const Hash& baseTransactionHash, BinaryArray& ba) {
+  return getBlockHashingBlob(b, baseTransactionHash, ba);
+}
+
 bool get_block_hash(const Block& b, Hash& res) {
   BinaryArray ba;
   if (!get_block_hashing_blob(b, ba)) {
@@ -455,6 +490,33 @@ Hash get_block_hash(const Block& b) {
   return p;
 }
 
+bool get_block_hashes(const std::vector<const Block*>& blocks, std::vector<Hash>& res) {
+  std::vector<const Transaction*> baseTransactions;
+  baseTransactions.reserve(blocks.size());
+  for (const Block* block : blocks) {
+    baseTransactions.push_back(&block->baseTransaction);
+  }
+
+  std::vector<Hash> baseTransactionHashes;
+  if (!getObjectHashes(baseTransactions, baseTransactionHashes)) {
+    res.assign(blocks.size(), NULL_HASH);
+    return false;
+  }
+
+  // like in get_block_hash, a block hash is taken over its hashing blob serialized as a string
+  std::vector<BinaryArray> blobs(blocks.size());
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    BinaryArray hashingBlob;
+    if (!getBlockHashingBlob(*blocks[i], baseTransactionHashes[i], hashingBlob) || !toBinaryArray(hashingBlob, blobs[i])) {
+      res.assign(blocks.size(), NULL_HASH);
+      return false;
+    }
+  }
+
+  getBinaryArrayHashes(blobs, res);
+  return true;
+}
+
 bool get_aux_block_header_hash(const Block& b, Hash& res) {
   BinaryArray blob;
   if (!get_block_hashing_blob(b, blob)) {
@@ -474,6 +536,26 @@ bool get_block_longhash(cn_context &context, const Block& b, Hash& res) {
   return true;
 }
 
+bool get_block_longhashes(cn_context &context, const Block& b, uint32_t nonceStep, size_t count, Hash* res) {
+  if (count == 0) {
+    return true;
+  }
+
+  // the nonce is serialized as a fixed size field, so all the blobs have the same length
+  Block block = b;
+  BinaryArray blobs;
+  for (size_t i = 0; i < count; ++i) {
+    if (!get_block_hashing_blob(block, blobs)) {
+      return false;
+    }
+
+    block.nonce += nonceStep;
+  }
+
+  cn_slow_hash_multi(context, blobs.data(), blobs.size() / count, res, count);
+  return true;
+}
+
 std::vector<uint32_t> relative_output_offsets_to_absolute(const std::vector<uint32_t>& off) {
   std::vector<uint32_t> res = off;
   for (size_t i = 1; i < res.size(); i++)
@@ -503,14 +585,7 @@ Hash get_tx_tree_hash(const std::vector<Hash>& tx_hashes) {
 }
 
 Hash get_tx_tree_hash(const Block& b) {
-  std::vector<Hash> txs_ids;
-  Hash h = NULL_HASH;
-  getObjectHash(b.baseTransaction, h);
-  txs_ids.push_back(h);
-  for (auto& th : b.transactionHashes) {
-    txs_ids.push_back(th);
-  }
-  return get_tx_tree_hash(txs_ids);
+  return getTransactionTreeHash(b, getObjectHash(b.baseTransaction));
 }
 
 }
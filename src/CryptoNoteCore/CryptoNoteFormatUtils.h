@@ -18,6 +18,8 @@ class ILogger;
 
 namespace CryptoNote {
 
+class FlatTransaction;
+
 bool parseAndValidateTransactionFromBinaryArray(const BinaryArray& transactionBinaryArray, Transaction& transaction, Crypto::Hash& transactionHash, Crypto::Hash& transactionPrefixHash);
 
 struct TransactionSourceEntry {
@@ -56,15 +58,21 @@ bool generate_key_image_helper(const AccountKeys& ack, const Crypto::PublicKey&
 std::string short_hash_str(const Crypto::Hash& h);
 
 bool get_block_hashing_blob(const Block& b, BinaryArray& blob);
+bool get_block_hashing_blob(const Block& b, const Crypto::Hash& baseTransactionHash, BinaryArray& blob);
 bool get_aux_block_header_hash(const Block& b, Crypto::Hash& res);
 bool get_block_hash(const Block& b, Crypto::Hash& res);
 Crypto::Hash get_block_hash(const Block& b);
+// Hashes all the blocks, several of them at once when the CPU allows
+bool get_block_hashes(const std::vector<const Block*>& blocks, std::vector<Crypto::Hash>& res);
 bool get_block_longhash(Crypto::cn_context &context, const Block& b, Crypto::Hash& res);
+// Computes long hashes of count blocks that differ from b in nonce only: b.nonce, b.nonce + nonceStep and so on
+bool get_block_longhashes(Crypto::cn_context &context, const Block& b, uint32_t nonceStep, size_t count, Crypto::Hash* res);
 bool get_inputs_money_amount(const Transaction& tx, uint64_t& money);
 uint64_t get_outs_money_amount(const Transaction& tx);
 bool check_inputs_types_supported(const TransactionPrefix& tx);
 bool check_outs_valid(const TransactionPrefix& tx, std::string* error = 0);
 bool checkMultisignatureInputsDiff(const TransactionPrefix& tx);
+bool checkMultisignatureInputsDiff(const FlatTransaction& tx);
 
 bool check_money_overflow(const TransactionPrefix& tx);
 bool check_outs_overflow(const TransactionPrefix& tx);
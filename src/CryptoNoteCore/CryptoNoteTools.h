@@ -16,6 +16,8 @@ namespace CryptoNote {
 
 void getBinaryArrayHash(const BinaryArray& binaryArray, Crypto::Hash& hash);
 Crypto::Hash getBinaryArrayHash(const BinaryArray& binaryArray);
+// Hashes all the arrays, several of them at once when the CPU allows
+void getBinaryArrayHashes(const std::vector<BinaryArray>& binaryArrays, std::vector<Crypto::Hash>& hashes);
 
 template<class T>
 bool toBinaryArray(const T& object, BinaryArray& binaryArray) {
@@ -106,6 +108,20 @@ Crypto::Hash getObjectHash(const T& object) {
   return hash;
 }
 
+template<class T>
+bool getObjectHashes(const std::vector<const T*>& objects, std::vector<Crypto::Hash>& hashes) {
+  std::vector<BinaryArray> binaryArrays(objects.size());
+  for (size_t i = 0; i < objects.size(); ++i) {
+    if (!toBinaryArray(*objects[i], binaryArrays[i])) {
+      hashes.assign(objects.size(), NULL_HASH);
+      return false;
+    }
+  }
+
+  getBinaryArrayHashes(binaryArrays, hashes);
+  return true;
+}
+
 uint64_t getInputAmount(const Transaction& transaction);
 std::vector<uint64_t> getInputsAmounts(const Transaction& transaction);
 uint64_t getOutputAmount(const Transaction& transaction);
@@ -60,6 +60,8 @@ bool Currency::init() {
   if (isTestnet()) {
     m_blocksFileName = "testnet_" + m_blocksFileName;
     m_blocksCacheFileName = "testnet_" + m_blocksCacheFileName;
+    m_blocksCacheJournalFileName = "testnet_" + m_blocksCacheJournalFileName;
+    m_blocksCacheJournalIndexesFileName = "testnet_" + m_blocksCacheJournalIndexesFileName;
     m_blockIndexesFileName = "testnet_" + m_blockIndexesFileName;
     m_txPoolFileName = "testnet_" + m_txPoolFileName;
     m_blockchinIndicesFileName = "testnet_" + m_blockchinIndicesFileName;
@@ -474,6 +476,8 @@ CurrencyBuilder::CurrencyBuilder(Logging::ILogger& log) : m_currency(log) {
 
   blocksFileName(parameters::CRYPTONOTE_BLOCKS_FILENAME);
   blocksCacheFileName(parameters::CRYPTONOTE_BLOCKSCACHE_FILENAME);
+  blocksCacheJournalFileName(parameters::CRYPTONOTE_BLOCKSCACHE_JOURNAL_FILENAME);
+  blocksCacheJournalIndexesFileName(parameters::CRYPTONOTE_BLOCKSCACHE_JOURNAL_INDEXES_FILENAME);
   blockIndexesFileName(parameters::CRYPTONOTE_BLOCKINDEXES_FILENAME);
   txPoolFileName(parameters::CRYPTONOTE_POOLDATA_FILENAME);
   blockchinIndicesFileName(parameters::CRYPTONOTE_BLOCKCHAIN_INDICES_FILENAME);
@@ -65,6 +65,8 @@ public:
 
   const std::string& blocksFileName() const { return m_blocksFileName; }
   const std::string& blocksCacheFileName() const { return m_blocksCacheFileName; }
+  const std::string& blocksCacheJournalFileName() const { return m_blocksCacheJournalFileName; }
+  const std::string& blocksCacheJournalIndexesFileName() const { return m_blocksCacheJournalIndexesFileName; }
   const std::string& blockIndexesFileName() const { return m_blockIndexesFileName; }
   const std::string& txPoolFileName() const { return m_txPoolFileName; }
   const std::string& blockchinIndicesFileName() const { return m_blockchinIndicesFileName; }
@@ -154,6 +156,8 @@ private:
 
   std::string m_blocksFileName;
   std::string m_blocksCacheFileName;
+  std::string m_blocksCacheJournalFileName;
+  std::string m_blocksCacheJournalIndexesFileName;
   std::string m_blockIndexesFileName;
   std::string m_txPoolFileName;
   std::string m_blockchinIndicesFileName;
@@ -226,6 +230,8 @@ public:
 
   CurrencyBuilder& blocksFileName(const std::string& val) { m_currency.m_blocksFileName = val; return *this; }
   CurrencyBuilder& blocksCacheFileName(const std::string& val) { m_currency.m_blocksCacheFileName = val; return *this; }
+  CurrencyBuilder& blocksCacheJournalFileName(const std::string& val) { m_currency.m_blocksCacheJournalFileName = val; return *this; }
+  CurrencyBuilder& blocksCacheJournalIndexesFileName(const std::string& val) { m_currency.m_blocksCacheJournalIndexesFileName = val; return *this; }
   CurrencyBuilder& blockIndexesFileName(const std::string& val) { m_currency.m_blockIndexesFileName = val; return *this; }
   CurrencyBuilder& txPoolFileName(const std::string& val) { m_currency.m_txPoolFileName = val; return *this; }
   CurrencyBuilder& blockchinIndicesFileName(const std::string& val) { m_currency.m_blockchinIndicesFileName = val; return *this; }
@@ -0,0 +1,598 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "FlatTransaction.h"
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "CryptoNoteConfig.h"
+#include "Serialization/ISerializer.h"
+
+namespace CryptoNote {
+
+namespace {
+
+// variant tags written by the serialization of Transaction
+const uint8_t BASE_INPUT_TAG = 0xff;
+const uint8_t KEY_TAG = 0x2;
+const uint8_t MULTISIGNATURE_TAG = 0x3;
+
+// Room for a transaction with a couple of inputs and outputs, the buffer is trimmed once the transaction is read
+const size_t INITIAL_CAPACITY = 1024;
+
+}
+
+FlatTransaction::FlatTransaction() {
+}
+
+FlatTransaction::FlatTransaction(const Transaction& transaction) {
+  if (!transaction.signatures.empty() && transaction.signatures.size() != transaction.inputs.size()) {
+    throw std::runtime_error("FlatTransaction: unexpected signatures size");
+  }
+
+  // one reservation covering the records, the arrays and their alignment, so the buffer is allocated once
+  size_t capacity = sizeof(Header) + transaction.inputs.size() * sizeof(Input) + sizeof(uint64_t) +
+    transaction.outputs.size() * sizeof(Output) + transaction.extra.size();
+  for (const auto& in : transaction.inputs) {
+    if (in.type() == typeid(KeyInput)) {
+      capacity += boost::get<KeyInput>(in).outputIndexes.size() * sizeof(uint32_t) + sizeof(uint32_t);
+    }
+  }
+
+  for (const auto& out : transaction.outputs) {
+    if (out.target.type() == typeid(MultisignatureOutput)) {
+      capacity += boost::get<MultisignatureOutput>(out.target).keys.size() * sizeof(Crypto::PublicKey);
+    }
+  }
+
+  for (const auto& signatures : transaction.signatures) {
+    capacity += signatures.size() * sizeof(Crypto::Signature);
+  }
+
+  m_data.reserve(capacity);
+  allocate(sizeof(Header), alignof(Header));
+  header().version = transaction.version;
+  header().unlockTime = transaction.unlockTime;
+  header().inputCount = static_cast<uint32_t>(transaction.inputs.size());
+  header().outputCount = static_cast<uint32_t>(transaction.outputs.size());
+  header().hasSignatures = !transaction.signatures.empty();
+
+  allocate(transaction.inputs.size() * sizeof(Input), alignof(Input));
+  uint32_t signatureCount = 0;
+  for (size_t i = 0; i < transaction.inputs.size(); ++i) {
+    const TransactionInput& in = transaction.inputs[i];
+    if (in.type() == typeid(BaseInput)) {
+      input(i).type = TransactionTypes::InputType::Generating;
+      input(i).outputIndex = boost::get<BaseInput>(in).blockIndex;
+    } else if (in.type() == typeid(KeyInput)) {
+      const KeyInput& keyInput = boost::get<KeyInput>(in);
+      uint32_t offset = allocate(keyInput.outputIndexes.size() * sizeof(uint32_t), alignof(uint32_t));
+      if (!keyInput.outputIndexes.empty()) {
+        memcpy(at<uint32_t>(offset), keyInput.outputIndexes.data(), keyInput.outputIndexes.size() * sizeof(uint32_t));
+      }
+
+      input(i).type = TransactionTypes::InputType::Key;
+      input(i).amount = keyInput.amount;
+      input(i).outputIndexesOffset = offset;
+      input(i).outputIndexCount = static_cast<uint32_t>(keyInput.outputIndexes.size());
+      input(i).keyImage = keyInput.keyImage;
+    } else {
+      const MultisignatureInput& multisignatureInput = boost::get<MultisignatureInput>(in);
+      input(i).type = TransactionTypes::InputType::Multisignature;
+      input(i).amount = multisignatureInput.amount;
+      input(i).signatureCount = multisignatureInput.signatureCount;
+      input(i).outputIndex = multisignatureInput.outputIndex;
+    }
+
+    input(i).firstSignature = signatureCount;
+    signatureCount += static_cast<uint32_t>(getSignatureCount(input(i)));
+  }
+
+  header().outputsOffset = allocate(transaction.outputs.size() * sizeof(Output), alignof(Output));
+  for (size_t i = 0; i < transaction.outputs.size(); ++i) {
+    const TransactionOutput& out = transaction.outputs[i];
+    output(i).amount = out.amount;
+    if (out.target.type() == typeid(KeyOutput)) {
+      output(i).type = TransactionTypes::OutputType::Key;
+      output(i).key = boost::get<KeyOutput>(out.target).key;
+    } else {
+      const MultisignatureOutput& multisignatureOutput = boost::get<MultisignatureOutput>(out.target);
+      uint32_t offset = allocate(multisignatureOutput.keys.size() * sizeof(Crypto::PublicKey), alignof(Crypto::PublicKey));
+      if (!multisignatureOutput.keys.empty()) {
+        memcpy(at<Crypto::PublicKey>(offset), multisignatureOutput.keys.data(), multisignatureOutput.keys.size() * sizeof(Crypto::PublicKey));
+      }
+
+      output(i).type = TransactionTypes::OutputType::Multisignature;
+      output(i).keysOffset = offset;
+      output(i).keyCount = static_cast<uint32_t>(multisignatureOutput.keys.size());
+      output(i).requiredSignatureCount = multisignatureOutput.requiredSignatureCount;
+    }
+  }
+
+  header().extraOffset = allocate(transaction.extra.size(), 1);
+  header().extraSize = static_cast<uint32_t>(transaction.extra.size());
+  if (!transaction.extra.empty()) {
+    memcpy(m_data.data() + header().extraOffset, transaction.extra.data(), transaction.extra.size());
+  }
+
+  if (header().hasSignatures) {
+    header().signaturesOffset = allocate(signatureCount * sizeof(Crypto::Signature), alignof(Crypto::Signature));
+    for (size_t i = 0; i < transaction.inputs.size(); ++i) {
+      const std::vector<Crypto::Signature>& signatures = transaction.signatures[i];
+      if (signatures.size() != getSignatureCount(input(i))) {
+        throw std::runtime_error("FlatTransaction: unexpected signatures size");
+      }
+
+      if (!signatures.empty()) {
+        memcpy(at<Crypto::Signature>(header().signaturesOffset) + input(i).firstSignature, signatures.data(), signatures.size() * sizeof(Crypto::Signature));
+      }
+    }
+  }
+}
+
+Transaction FlatTransaction::getTransaction() const {
+  Transaction transaction;
+  transaction.version = getVersion();
+  transaction.unlockTime = getUnlockTime();
+
+  transaction.inputs.reserve(getInputCount());
+  for (size_t i = 0; i < getInputCount(); ++i) {
+    switch (getInputType(i)) {
+    case TransactionTypes::InputType::Generating: {
+      BaseInput in;
+      getInput(i, in);
+      transaction.inputs.emplace_back(in);
+      break;
+    }
+    case TransactionTypes::InputType::Key: {
+      KeyInput in;
+      getInput(i, in);
+      transaction.inputs.emplace_back(std::move(in));
+      break;
+    }
+    default: {
+      MultisignatureInput in;
+      getInput(i, in);
+      transaction.inputs.emplace_back(in);
+      break;
+    }
+    }
+  }
+
+  transaction.outputs.resize(getOutputCount());
+  for (size_t i = 0; i < getOutputCount(); ++i) {
+    transaction.outputs[i].amount = getOutputAmount(i);
+    if (getOutputType(i) == TransactionTypes::OutputType::Key) {
+      transaction.outputs[i].target = KeyOutput{ getOutputKey(i) };
+    } else {
+      MultisignatureOutput out;
+      getOutput(i, out);
+      transaction.outputs[i].target = std::move(out);
+    }
+  }
+
+  Common::ArrayView<uint8_t> extra = getExtra();
+  transaction.extra.assign(extra.begin(), extra.end());
+
+  if (header().hasSignatures) {
+    transaction.signatures.resize(getInputCount());
+    for (size_t i = 0; i < getInputCount(); ++i) {
+      Common::ArrayView<Crypto::Signature> signatures = getSignatures(i);
+      transaction.signatures[i].assign(signatures.begin(), signatures.end());
+    }
+  }
+
+  return transaction;
+}
+
+uint8_t FlatTransaction::getVersion() const {
+  return header().version;
+}
+
+uint64_t FlatTransaction::getUnlockTime() const {
+  return header().unlockTime;
+}
+
+Common::ArrayView<uint8_t> FlatTransaction::getExtra() const {
+  return Common::ArrayView<uint8_t>(at<uint8_t>(header().extraOffset), header().extraSize);
+}
+
+size_t FlatTransaction::getInputCount() const {
+  return header().inputCount;
+}
+
+TransactionTypes::InputType FlatTransaction::getInputType(size_t index) const {
+  return input(index).type;
+}
+
+uint64_t FlatTransaction::getInputAmount(size_t index) const {
+  return input(index).amount;
+}
+
+const Crypto::KeyImage& FlatTransaction::getKeyImage(size_t index) const {
+  assert(getInputType(index) == TransactionTypes::InputType::Key);
+  return input(index).keyImage;
+}
+
+Common::ArrayView<uint32_t> FlatTransaction::getOutputIndexes(size_t index) const {
+  assert(getInputType(index) == TransactionTypes::InputType::Key);
+  const Input& in = input(index);
+  return Common::ArrayView<uint32_t>(at<uint32_t>(in.outputIndexesOffset), in.outputIndexCount);
+}
+
+void FlatTransaction::getInput(size_t index, BaseInput& result) const {
+  assert(getInputType(index) == TransactionTypes::InputType::Generating);
+  result.blockIndex = input(index).outputIndex;
+}
+
+void FlatTransaction::getInput(size_t index, KeyInput& result) const {
+  Common::ArrayView<uint32_t> outputIndexes = getOutputIndexes(index);
+  result.amount = input(index).amount;
+  result.outputIndexes.assign(outputIndexes.begin(), outputIndexes.end());
+  result.keyImage = input(index).keyImage;
+}
+
+void FlatTransaction::getInput(size_t index, MultisignatureInput& result) const {
+  assert(getInputType(index) == TransactionTypes::InputType::Multisignature);
+  const Input& in = input(index);
+  result.amount = in.amount;
+  result.signatureCount = in.signatureCount;
+  result.outputIndex = in.outputIndex;
+}
+
+Common::ArrayView<Crypto::Signature> FlatTransaction::getSignatures(size_t index) const {
+  if (!header().hasSignatures) {
+    return Common::ArrayView<Crypto::Signature>();
+  }
+
+  const Input& in = input(index);
+  return Common::ArrayView<Crypto::Signature>(at<Crypto::Signature>(header().signaturesOffset) + in.firstSignature, getSignatureCount(in));
+}
+
+size_t FlatTransaction::getOutputCount() const {
+  return header().outputCount;
+}
+
+TransactionTypes::OutputType FlatTransaction::getOutputType(size_t index) const {
+  return output(index).type;
+}
+
+uint64_t FlatTransaction::getOutputAmount(size_t index) const {
+  return output(index).amount;
+}
+
+const Crypto::PublicKey& FlatTransaction::getOutputKey(size_t index) const {
+  assert(getOutputType(index) == TransactionTypes::OutputType::Key);
+  return output(index).key;
+}
+
+Common::ArrayView<Crypto::PublicKey> FlatTransaction::getOutputKeys(size_t index) const {
+  assert(getOutputType(index) == TransactionTypes::OutputType::Multisignature);
+  const Output& out = output(index);
+  return Common::ArrayView<Crypto::PublicKey>(at<Crypto::PublicKey>(out.keysOffset), out.keyCount);
+}
+
+uint8_t FlatTransaction::getRequiredSignatureCount(size_t index) const {
+  assert(getOutputType(index) == TransactionTypes::OutputType::Multisignature);
+  return output(index).requiredSignatureCount;
+}
+
+void FlatTransaction::getOutput(size_t index, MultisignatureOutput& result) const {
+  Common::ArrayView<Crypto::PublicKey> keys = getOutputKeys(index);
+  result.keys.assign(keys.begin(), keys.end());
+  result.requiredSignatureCount = output(index).requiredSignatureCount;
+}
+
+void FlatTransaction::serialize(ISerializer& serializer) {
+  if (serializer.type() == ISerializer::INPUT) {
+    load(serializer);
+  } else {
+    store(serializer);
+  }
+}
+
+const FlatTransaction::Header& FlatTransaction::header() const {
+  static const Header EMPTY_HEADER = {};
+  return m_data.empty() ? EMPTY_HEADER : *at<Header>(0);
+}
+
+FlatTransaction::Header& FlatTransaction::header() {
+  assert(!m_data.empty());
+  return *at<Header>(0);
+}
+
+// inputs follow the header
+const FlatTransaction::Input& FlatTransaction::input(size_t index) const {
+  assert(index < header().inputCount);
+  return at<Input>(sizeof(Header))[index];
+}
+
+FlatTransaction::Input& FlatTransaction::input(size_t index) {
+  return at<Input>(sizeof(Header))[index];
+}
+
+const FlatTransaction::Output& FlatTransaction::output(size_t index) const {
+  assert(index < header().outputCount);
+  return at<Output>(header().outputsOffset)[index];
+}
+
+FlatTransaction::Output& FlatTransaction::output(size_t index) {
+  return at<Output>(header().outputsOffset)[index];
+}
+
+// Appends zeroed space to the buffer, references into the buffer are invalidated
+uint32_t FlatTransaction::allocate(size_t size, size_t alignment) {
+  size_t offset = (m_data.size() + alignment - 1) / alignment * alignment;
+  if (size > std::numeric_limits<uint32_t>::max() - offset) {
+    throw std::runtime_error("FlatTransaction: transaction is too large");
+  }
+
+  m_data.resize(offset + size);
+  return static_cast<uint32_t>(offset);
+}
+
+// Mirrors serialize(Transaction&, ISerializer&) call by call, so the format is the same for any serializer
+void FlatTransaction::load(ISerializer& serializer) {
+  m_data.clear();
+  m_data.reserve(INITIAL_CAPACITY);
+  allocate(sizeof(Header), alignof(Header));
+
+  uint8_t version = 0;
+  serializer(version, "version");
+  if (CURRENT_TRANSACTION_VERSION < version) {
+    throw std::runtime_error("Wrong transaction version");
+  }
+
+  uint64_t unlockTime = 0;
+  serializer(unlockTime, "unlock_time");
+  header().version = version;
+  header().unlockTime = unlockTime;
+
+  size_t inputCount = 0;
+  if (serializer.beginArray(inputCount, "vin")) {
+    allocate(inputCount * sizeof(Input), alignof(Input));
+    header().inputCount = static_cast<uint32_t>(inputCount);
+    for (size_t i = 0; i < inputCount; ++i) {
+      loadInput(serializer, i);
+    }
+
+    serializer.endArray();
+  }
+
+  size_t outputCount = 0;
+  if (serializer.beginArray(outputCount, "vout")) {
+    uint32_t outputsOffset = allocate(outputCount * sizeof(Output), alignof(Output));
+    header().outputsOffset = outputsOffset;
+    header().outputCount = static_cast<uint32_t>(outputCount);
+    for (size_t i = 0; i < outputCount; ++i) {
+      loadOutput(serializer, i);
+    }
+
+    serializer.endArray();
+  } else {
+    header().outputsOffset = static_cast<uint32_t>(m_data.size());
+  }
+
+  std::string extra;
+  serializer.binary(extra, "extra");
+  uint32_t extraOffset = allocate(extra.size(), 1);
+  memcpy(m_data.data() + extraOffset, extra.data(), extra.size());
+  header().extraOffset = extraOffset;
+  header().extraSize = static_cast<uint32_t>(extra.size());
+
+  uint32_t signatureCount = 0;
+  for (size_t i = 0; i < inputCount; ++i) {
+    input(i).firstSignature = signatureCount;
+    signatureCount += static_cast<uint32_t>(getSignatureCount(input(i)));
+  }
+
+  uint32_t signaturesOffset = allocate(signatureCount * sizeof(Crypto::Signature), alignof(Crypto::Signature));
+  header().signaturesOffset = signaturesOffset;
+  header().hasSignatures = true;
+  Crypto::Signature* signatures = at<Crypto::Signature>(signaturesOffset);
+  for (uint32_t i = 0; i < signatureCount; ++i) {
+    serializer.binary(&signatures[i], sizeof(signatures[i]), "");
+  }
+
+  m_data.shrink_to_fit();
+}
+
+void FlatTransaction::loadInput(ISerializer& serializer, size_t index) {
+  if (!serializer.beginObject("")) {
+    return;
+  }
+
+  uint8_t tag;
+  serializer.binary(&tag, sizeof(tag), "type");
+  if (tag != BASE_INPUT_TAG && tag != KEY_TAG && tag != MULTISIGNATURE_TAG) {
+    throw std::runtime_error("Unknown variant tag");
+  }
+
+  // fields are read into a copy of the record, reading output indexes may move the buffer
+  Input in = {};
+  if (serializer.beginObject("value")) {
+    if (tag == BASE_INPUT_TAG) {
+      in.type = TransactionTypes::InputType::Generating;
+      serializer(in.outputIndex, "height");
+    } else if (tag == KEY_TAG) {
+      in.type = TransactionTypes::InputType::Key;
+      serializer(in.amount, "amount");
+      size_t count = 0;
+      if (serializer.beginArray(count, "key_offsets")) {
+        in.outputIndexesOffset = allocate(count * sizeof(uint32_t), alignof(uint32_t));
+        in.outputIndexCount = static_cast<uint32_t>(count);
+        for (size_t i = 0; i < count; ++i) {
+          serializer(at<uint32_t>(in.outputIndexesOffset)[i], "");
+        }
+
+        serializer.endArray();
+      }
+
+      serializer.binary(&in.keyImage, sizeof(in.keyImage), "k_image");
+    } else {
+      in.type = TransactionTypes::InputType::Multisignature;
+      serializer(in.amount, "amount");
+      serializer(in.signatureCount, "signatures");
+      serializer(in.outputIndex, "outputIndex");
+    }
+
+    serializer.endObject();
+  }
+
+  input(index) = in;
+  serializer.endObject();
+}
+
+void FlatTransaction::loadOutput(ISerializer& serializer, size_t index) {
+  if (!serializer.beginObject("")) {
+    return;
+  }
+
+  Output out = {};
+  serializer(out.amount, "amount");
+  if (serializer.beginObject("target")) {
+    uint8_t tag;
+    serializer.binary(&tag, sizeof(tag), "type");
+    if (tag != KEY_TAG && tag != MULTISIGNATURE_TAG) {
+      throw std::runtime_error("Unknown variant tag");
+    }
+
+    if (serializer.beginObject("data")) {
+      if (tag == KEY_TAG) {
+        out.type = TransactionTypes::OutputType::Key;
+        serializer.binary(&out.key, sizeof(out.key), "key");
+      } else {
+        out.type = TransactionTypes::OutputType::Multisignature;
+        size_t count = 0;
+        if (serializer.beginArray(count, "keys")) {
+          out.keysOffset = allocate(count * sizeof(Crypto::PublicKey), alignof(Crypto::PublicKey));
+          out.keyCount = static_cast<uint32_t>(count);
+          for (size_t i = 0; i < count; ++i) {
+            serializer.binary(at<Crypto::PublicKey>(out.keysOffset) + i, sizeof(Crypto::PublicKey), "");
+          }
+
+          serializer.endArray();
+        }
+
+        serializer(out.requiredSignatureCount, "required_signatures");
+      }
+
+      serializer.endObject();
+    }
+
+    serializer.endObject();
+  }
+
+  output(index) = out;
+  serializer.endObject();
+}
+
+void FlatTransaction::store(ISerializer& serializer) const {
+  uint8_t version = getVersion();
+  serializer(version, "version");
+  if (CURRENT_TRANSACTION_VERSION < version) {
+    throw std::runtime_error("Wrong transaction version");
+  }
+
+  uint64_t unlockTime = getUnlockTime();
+  serializer(unlockTime, "unlock_time");
+
+  size_t inputCount = getInputCount();
+  serializer.beginArray(inputCount, "vin");
+  for (size_t i = 0; i < inputCount; ++i) {
+    Input in = input(i);
+    serializer.beginObject("");
+    uint8_t tag = in.type == TransactionTypes::InputType::Generating ? BASE_INPUT_TAG :
+      in.type == TransactionTypes::InputType::Key ? KEY_TAG : MULTISIGNATURE_TAG;
+    serializer.binary(&tag, sizeof(tag), "type");
+    serializer.beginObject("value");
+    if (tag == BASE_INPUT_TAG) {
+      serializer(in.outputIndex, "height");
+    } else if (tag == KEY_TAG) {
+      serializer(in.amount, "amount");
+      size_t count = in.outputIndexCount;
+      serializer.beginArray(count, "key_offsets");
+      for (size_t j = 0; j < count; ++j) {
+        uint32_t outputIndex = at<uint32_t>(in.outputIndexesOffset)[j];
+        serializer(outputIndex, "");
+      }
+
+      serializer.endArray();
+      serializer.binary(&in.keyImage, sizeof(in.keyImage), "k_image");
+    } else {
+      serializer(in.amount, "amount");
+      serializer(in.signatureCount, "signatures");
+      serializer(in.outputIndex, "outputIndex");
+    }
+
+    serializer.endObject();
+    serializer.endObject();
+  }
+
+  serializer.endArray();
+
+  size_t outputCount = getOutputCount();
+  serializer.beginArray(outputCount, "vout");
+  for (size_t i = 0; i < outputCount; ++i) {
+    Output out = output(i);
+    serializer.beginObject("");
+    serializer(out.amount, "amount");
+    serializer.beginObject("target");
+    uint8_t tag = out.type == TransactionTypes::OutputType::Key ? KEY_TAG : MULTISIGNATURE_TAG;
+    serializer.binary(&tag, sizeof(tag), "type");
+    serializer.beginObject("data");
+    if (tag == KEY_TAG) {
+      serializer.binary(&out.key, sizeof(out.key), "key");
+    } else {
+      size_t count = out.keyCount;
+      serializer.beginArray(count, "keys");
+      for (size_t j = 0; j < count; ++j) {
+        Crypto::PublicKey key = at<Crypto::PublicKey>(out.keysOffset)[j];
+        serializer.binary(&key, sizeof(key), "");
+      }
+
+      serializer.endArray();
+      serializer(out.requiredSignatureCount, "required_signatures");
+    }
+
+    serializer.endObject();
+    serializer.endObject();
+    serializer.endObject();
+  }
+
+  serializer.endArray();
+
+  std::string extra(reinterpret_cast<const char*>(getExtra().getData()), getExtra().getSize());
+  serializer.binary(extra, "extra");
+
+  for (size_t i = 0; i < inputCount; ++i) {
+    if (!header().hasSignatures) {
+      if (getSignatureCount(input(i)) != 0) {
+        throw std::runtime_error("Serialization error: signatures are not expected");
+      }
+
+      continue;
+    }
+
+    for (Crypto::Signature signature : getSignatures(i)) {
+      serializer.binary(&signature, sizeof(signature), "");
+    }
+  }
+}
+
+size_t FlatTransaction::getSignatureCount(const Input& in) const {
+  switch (in.type) {
+  case TransactionTypes::InputType::Key:
+    return in.outputIndexCount;
+  case TransactionTypes::InputType::Multisignature:
+    return in.signatureCount;
+  default:
+    return 0;
+  }
+}
+
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Common/ArrayView.h"
+#include "CryptoNoteCore/CryptoNoteBasic.h"
+#include "ITransaction.h"
+
+namespace CryptoNote {
+
+class ISerializer;
+
+// Transaction kept in a single buffer. Inputs and outputs are fixed size records, followed in the same buffer by
+// output indexes of key inputs, keys of multisignature outputs, extra and signatures. A Transaction allocates for
+// every key input, multisignature output and signature list, a FlatTransaction allocates once.
+// Serialized exactly like Transaction, so either of them may be read from the data written by the other.
+class FlatTransaction {
+public:
+  FlatTransaction();
+  explicit FlatTransaction(const Transaction& transaction);
+
+  Transaction getTransaction() const;
+
+  uint8_t getVersion() const;
+  uint64_t getUnlockTime() const;
+  Common::ArrayView<uint8_t> getExtra() const;
+
+  size_t getInputCount() const;
+  TransactionTypes::InputType getInputType(size_t index) const;
+  // Amount of a key or multisignature input
+  uint64_t getInputAmount(size_t index) const;
+  const Crypto::KeyImage& getKeyImage(size_t index) const;
+  Common::ArrayView<uint32_t> getOutputIndexes(size_t index) const;
+  void getInput(size_t index, BaseInput& input) const;
+  void getInput(size_t index, KeyInput& input) const;
+  void getInput(size_t index, MultisignatureInput& input) const;
+  // Empty for all inputs of a transaction without signatures
+  Common::ArrayView<Crypto::Signature> getSignatures(size_t index) const;
+
+  size_t getOutputCount() const;
+  TransactionTypes::OutputType getOutputType(size_t index) const;
+  uint64_t getOutputAmount(size_t index) const;
+  const Crypto::PublicKey& getOutputKey(size_t index) const;
+  Common::ArrayView<Crypto::PublicKey> getOutputKeys(size_t index) const;
+  uint8_t getRequiredSignatureCount(size_t index) const;
+  void getOutput(size_t index, MultisignatureOutput& output) const;
+
+  void serialize(ISerializer& serializer);
+
+private:
+  struct Header {
+    uint64_t unlockTime;
+    uint32_t inputCount;
+    uint32_t outputCount;
+    uint32_t outputsOffset;
+    uint32_t extraOffset;
+    uint32_t extraSize;
+    uint32_t signaturesOffset;
+    uint8_t version;
+    bool hasSignatures;
+  };
+
+  struct Input {
+    uint64_t amount;
+    // block index of a base input, output index of a multisignature input
+    uint32_t outputIndex;
+    uint32_t outputIndexesOffset;
+    uint32_t outputIndexCount;
+    uint32_t firstSignature;
+    TransactionTypes::InputType type;
+    uint8_t signatureCount;
+    Crypto::KeyImage keyImage;
+  };
+
+  struct Output {
+    uint64_t amount;
+    uint32_t keysOffset;
+    uint32_t keyCount;
+    TransactionTypes::OutputType type;
+    uint8_t requiredSignatureCount;
+    Crypto::PublicKey key;
+  };
+
+  std::vector<uint8_t> m_data;
+
+  const Header& header() const;
+  Header& header();
+  const Input& input(size_t index) const;
+  Input& input(size_t index);
+  const Output& output(size_t index) const;
+  Output& output(size_t index);
+  uint32_t allocate(size_t size, size_t alignment);
+
+  template<class T> const T* at(uint32_t offset) const {
+    return reinterpret_cast<const T*>(m_data.data() + offset);
+  }
+
+  template<class T> T* at(uint32_t offset) {
+    return reinterpret_cast<T*>(m_data.data() + offset);
+  }
+
+  void load(ISerializer& serializer);
+  void store(ISerializer& serializer) const;
+  void loadInput(ISerializer& serializer, size_t index);
+  void loadOutput(ISerializer& serializer, size_t index);
+  size_t getSignatureCount(const Input& input) const;
+};
+
+}
@@ -53,6 +53,11 @@ public:
   virtual void pause_mining() = 0;
   virtual void update_block_template_and_resume_mining() = 0;
   virtual bool handle_incoming_block_blob(const CryptoNote::BinaryArray& block_blob, CryptoNote::block_verification_context& bvc, bool control_miner, bool relay_block) = 0;
+  virtual bool handle_incoming_block(const Block& b, block_verification_context& bvc, bool control_miner, bool relay_block) = 0;
+  // Verifies ring signatures of transactions that are about to be added, so adding them later skips this work. Thread safe.
+  virtual void preverifyTransactions(const std::vector<const Transaction*>& transactions) = 0;
+  // Computes proofs of work of blocks that are about to be added on all cores, so adding them later skips this work. Thread safe.
+  virtual void preverifyBlocks(const std::vector<const Block*>& blocks) = 0;
   virtual bool handle_get_objects(NOTIFY_REQUEST_GET_OBJECTS_request& arg, NOTIFY_RESPONSE_GET_OBJECTS_request& rsp) = 0; //Deprecated. Should be removed with CryptoNoteProtocolHandler.
   virtual void on_synchronized() = 0;
   virtual size_t addChain(const std::vector<const IBlock*>& chain) = 0;
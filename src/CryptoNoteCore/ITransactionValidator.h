@@ -34,6 +34,8 @@ namespace CryptoNote {
     virtual bool checkTransactionInputs(const CryptoNote::Transaction& tx, BlockInfo& maxUsedBlock, BlockInfo& lastFailed) = 0;
     virtual bool haveSpentKeyImages(const CryptoNote::Transaction& tx) = 0;
     virtual bool checkTransactionSize(size_t blobSize) = 0;
+    // Blocks added next are below a trusted checkpoint, their ring signatures are not checked
+    virtual bool isInTrustedCheckpointZone() = 0;
   };
 
 }
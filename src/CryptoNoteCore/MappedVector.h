@@ -0,0 +1,543 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/MemoryInputStream.h"
+#include "Common/MemoryMappedFile.h"
+#include "Common/VectorOutputStream.h"
+#include "Serialization/BinaryInputStreamSerializer.h"
+#include "Serialization/BinaryOutputStreamSerializer.h"
+
+// Append-only vector stored in memory mapped files.
+//
+// On-disk format is the same as SwappedVector uses, so existing blocks.dat/blockindexes.dat are opened in place:
+//   items file   - serialized items, one after another;
+//   indexes file - uint64_t item count followed by uint32_t size of every item.
+//
+// Items are decoded directly from the mapped pages on access and kept in an LRU cache of poolSize entries.
+// Every thread has its own cache, so several threads may read the vector at once while it is not modified.
+// A reference returned by operator[] stays valid at least until the same thread decodes poolSize - 1 other items,
+// or until the vector is modified.
+//
+// The item count is the commit point: push_back writes the item and its size before incrementing the count and
+// pop_back decrements the count first. On open the count is clipped to the items that are fully present on disk,
+// so an append interrupted by a crash is discarded.
+template<class T> class MappedVector {
+public:
+  typedef T value_type;
+
+  class const_iterator {
+  public:
+    typedef ptrdiff_t difference_type;
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef const T* pointer;
+    typedef const T& reference;
+    typedef T value_type;
+
+    const_iterator() {
+    }
+
+    const_iterator(MappedVector* mappedVector, size_t index) : m_mappedVector(mappedVector), m_index(index) {
+    }
+
+    bool operator!=(const const_iterator& other) const {
+      return m_index != other.m_index;
+    }
+
+    bool operator<(const const_iterator& other) const {
+      return m_index < other.m_index;
+    }
+
+    bool operator<=(const const_iterator& other) const {
+      return m_index <= other.m_index;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return m_index == other.m_index;
+    }
+
+    bool operator>(const const_iterator& other) const {
+      return m_index > other.m_index;
+    }
+
+    bool operator>=(const const_iterator& other) const {
+      return m_index >= other.m_index;
+    }
+
+    const_iterator& operator++() {
+      ++m_index;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator i = *this;
+      ++m_index;
+      return i;
+    }
+
+    const_iterator& operator--() {
+      --m_index;
+      return *this;
+    }
+
+    const_iterator operator--(int) {
+      const_iterator i = *this;
+      --m_index;
+      return i;
+    }
+
+    const_iterator& operator+=(difference_type n) {
+      m_index += n;
+      return *this;
+    }
+
+    const_iterator& operator-=(difference_type n) {
+      m_index -= n;
+      return *this;
+    }
+
+    const_iterator operator+(difference_type n) const {
+      return const_iterator(m_mappedVector, m_index + n);
+    }
+
+    friend const_iterator operator+(difference_type n, const const_iterator& i) {
+      return const_iterator(i.m_mappedVector, n + i.m_index);
+    }
+
+    difference_type operator-(const const_iterator& other) const {
+      return m_index - other.m_index;
+    }
+
+    const_iterator operator-(difference_type n) const {
+      return const_iterator(m_mappedVector, m_index - n);
+    }
+
+    const T& operator*() const {
+      return (*m_mappedVector)[m_index];
+    }
+
+    const T* operator->() const {
+      return &(*m_mappedVector)[m_index];
+    }
+
+    const T& operator[](difference_type offset) const {
+      return (*m_mappedVector)[m_index + offset];
+    }
+
+    size_t index() const {
+      return m_index;
+    }
+
+  private:
+    MappedVector* m_mappedVector;
+    size_t m_index;
+  };
+
+  MappedVector();
+  MappedVector(const MappedVector&) = delete;
+  ~MappedVector();
+  MappedVector& operator=(const MappedVector&) = delete;
+
+  bool open(const std::string& itemFileName, const std::string& indexFileName, size_t poolSize);
+  void close();
+
+  bool empty() const;
+  uint64_t size() const;
+  const_iterator begin();
+  const_iterator end();
+  const T& operator[](uint64_t index);
+  // Decodes an item bypassing the cache. May be called from several threads while the vector is not modified.
+  void load(uint64_t index, T& item) const;
+  const T& front();
+  const T& back();
+  void clear();
+  void pop_back();
+  void push_back(const T& item);
+
+  uint64_t cacheHits() const;
+  uint64_t cacheMisses() const;
+  // Drops caches of all threads except the calling one. Other threads must not hold references to items.
+  void releaseThreadCaches();
+
+private:
+  static const uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+  static const uint64_t INDEXES_HEADER_SIZE = sizeof(uint64_t);
+  static const uint64_t INDEX_ENTRY_SIZE = sizeof(uint32_t);
+  static const uint64_t MIN_FILE_GROWTH = 1024 * 1024;
+
+  struct CacheSlot {
+    uint64_t index;
+    uint32_t prev;
+    uint32_t next;
+    T item;
+  };
+
+  Common::MemoryMappedFile m_itemsFile;
+  Common::MemoryMappedFile m_indexesFile;
+  std::vector<uint64_t> m_offsets;
+  uint64_t m_itemsFileSize;
+  std::vector<uint8_t> m_writeBuffer;
+
+  struct Cache {
+    std::vector<CacheSlot> slots;
+    std::unordered_map<uint64_t, uint32_t> slotsByIndex;
+    uint32_t lruHead;
+    uint32_t lruTail;
+  };
+
+  size_t m_poolSize;
+  std::mutex m_cachesMutex;
+  std::unordered_map<std::thread::id, std::unique_ptr<Cache>> m_caches;
+  std::atomic<uint64_t> m_cacheHits;
+  std::atomic<uint64_t> m_cacheMisses;
+
+  void writeCount(uint64_t count);
+  void reserve(Common::MemoryMappedFile& file, uint64_t size);
+  Cache& threadCache();
+  T& prepare(Cache& cache, uint64_t index);
+  void unlinkSlot(Cache& cache, uint32_t slot);
+  void linkSlotBack(Cache& cache, uint32_t slot);
+  void evict(Cache& cache, uint64_t index);
+  void clearCache();
+};
+
+template<class T> const uint32_t MappedVector<T>::NO_SLOT;
+template<class T> const uint64_t MappedVector<T>::INDEXES_HEADER_SIZE;
+template<class T> const uint64_t MappedVector<T>::INDEX_ENTRY_SIZE;
+template<class T> const uint64_t MappedVector<T>::MIN_FILE_GROWTH;
+
+template<class T> MappedVector<T>::MappedVector() : m_itemsFileSize(0), m_poolSize(0), m_cacheHits(0), m_cacheMisses(0) {
+}
+
+template<class T> MappedVector<T>::~MappedVector() {
+  close();
+}
+
+template<class T> bool MappedVector<T>::open(const std::string& itemFileName, const std::string& indexFileName, size_t poolSize) {
+  if (poolSize == 0 || poolSize >= NO_SLOT) {
+    return false;
+  }
+
+  close();
+
+  try {
+    m_itemsFile.open(itemFileName, true);
+    m_indexesFile.open(indexFileName, true);
+
+    uint64_t count = 0;
+    if (m_indexesFile.size() >= INDEXES_HEADER_SIZE) {
+      memcpy(&count, m_indexesFile.data(), sizeof count);
+    } else {
+      m_itemsFile.resize(0);
+      m_indexesFile.resize(INDEXES_HEADER_SIZE);
+      writeCount(0);
+    }
+
+    // discard entries of an interrupted append
+    uint64_t storedSizes = (m_indexesFile.size() - INDEXES_HEADER_SIZE) / INDEX_ENTRY_SIZE;
+    uint64_t validCount = std::min(count, storedSizes);
+
+    std::vector<uint64_t> offsets;
+    offsets.reserve(static_cast<size_t>(validCount));
+    uint64_t itemsFileSize = 0;
+    for (uint64_t i = 0; i < validCount; ++i) {
+      uint32_t itemSize;
+      memcpy(&itemSize, m_indexesFile.data() + INDEXES_HEADER_SIZE + INDEX_ENTRY_SIZE * i, sizeof itemSize);
+      if (itemsFileSize + itemSize > m_itemsFile.size()) {
+        validCount = i;
+        break;
+      }
+
+      offsets.push_back(itemsFileSize);
+      itemsFileSize += itemSize;
+    }
+
+    if (validCount != count) {
+      writeCount(validCount);
+    }
+
+    m_offsets.swap(offsets);
+    m_itemsFileSize = itemsFileSize;
+  } catch (std::exception&) {
+    m_itemsFile.close();
+    m_indexesFile.close();
+    return false;
+  }
+
+  m_poolSize = poolSize;
+  clearCache();
+  m_cacheHits = 0;
+  m_cacheMisses = 0;
+  return true;
+}
+
+template<class T> void MappedVector<T>::close() {
+  if (m_itemsFile.isOpened() && m_indexesFile.isOpened()) {
+    // drop preallocated space, leaving files exactly as SwappedVector writes them
+    try {
+      m_itemsFile.resize(m_itemsFileSize);
+      m_indexesFile.resize(INDEXES_HEADER_SIZE + INDEX_ENTRY_SIZE * m_offsets.size());
+    } catch (std::exception&) {
+    }
+  }
+
+  m_itemsFile.close();
+  m_indexesFile.close();
+  m_offsets.clear();
+  m_itemsFileSize = 0;
+  clearCache();
+}
+
+template<class T> bool MappedVector<T>::empty() const {
+  return m_offsets.empty();
+}
+
+template<class T> uint64_t MappedVector<T>::size() const {
+  return m_offsets.size();
+}
+
+template<class T> typename MappedVector<T>::const_iterator MappedVector<T>::begin() {
+  return const_iterator(this, 0);
+}
+
+template<class T> typename MappedVector<T>::const_iterator MappedVector<T>::end() {
+  return const_iterator(this, m_offsets.size());
+}
+
+template<class T> const T& MappedVector<T>::operator[](uint64_t index) {
+  Cache& cache = threadCache();
+  auto slotIter = cache.slotsByIndex.find(index);
+  if (slotIter != cache.slotsByIndex.end()) {
+    uint32_t slot = slotIter->second;
+    if (slot != cache.lruTail) {
+      unlinkSlot(cache, slot);
+      linkSlotBack(cache, slot);
+    }
+
+    ++m_cacheHits;
+    return cache.slots[slot].item;
+  }
+
+  T tempItem;
+  load(index, tempItem);
+
+  T& item = prepare(cache, index);
+  std::swap(tempItem, item);
+  ++m_cacheMisses;
+  return item;
+}
+
+template<class T> void MappedVector<T>::load(uint64_t index, T& item) const {
+  if (index >= m_offsets.size()) {
+    throw std::runtime_error("MappedVector::load");
+  }
+
+  uint64_t itemOffset = m_offsets[static_cast<size_t>(index)];
+  uint64_t itemEnd = index + 1 < m_offsets.size() ? m_offsets[static_cast<size_t>(index + 1)] : m_itemsFileSize;
+
+  Common::MemoryInputStream stream(m_itemsFile.data() + itemOffset, static_cast<size_t>(itemEnd - itemOffset));
+  CryptoNote::BinaryInputStreamSerializer archive(stream);
+  serialize(item, archive);
+}
+
+template<class T> const T& MappedVector<T>::front() {
+  return operator[](0);
+}
+
+template<class T> const T& MappedVector<T>::back() {
+  return operator[](m_offsets.size() - 1);
+}
+
+template<class T> void MappedVector<T>::clear() {
+  if (!m_indexesFile.isOpened()) {
+    throw std::runtime_error("MappedVector::clear");
+  }
+
+  writeCount(0);
+  m_offsets.clear();
+  m_itemsFileSize = 0;
+  clearCache();
+}
+
+template<class T> void MappedVector<T>::pop_back() {
+  if (!m_indexesFile.isOpened() || m_offsets.empty()) {
+    throw std::runtime_error("MappedVector::pop_back");
+  }
+
+  writeCount(m_offsets.size() - 1);
+  m_itemsFileSize = m_offsets.back();
+  m_offsets.pop_back();
+  std::lock_guard<std::mutex> lock(m_cachesMutex);
+  for (auto& cache : m_caches) {
+    evict(*cache.second, m_offsets.size());
+  }
+}
+
+template<class T> void MappedVector<T>::push_back(const T& item) {
+  if (!m_itemsFile.isOpened() || !m_indexesFile.isOpened()) {
+    throw std::runtime_error("MappedVector::push_back");
+  }
+
+  m_writeBuffer.clear();
+  {
+    Common::VectorOutputStream stream(m_writeBuffer);
+    CryptoNote::BinaryOutputStreamSerializer archive(stream);
+    serialize(const_cast<T&>(item), archive);
+  }
+
+  if (m_writeBuffer.size() > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("MappedVector::push_back, item is too big");
+  }
+
+  uint64_t count = m_offsets.size();
+  uint64_t indexEntryOffset = INDEXES_HEADER_SIZE + INDEX_ENTRY_SIZE * count;
+  reserve(m_itemsFile, m_itemsFileSize + m_writeBuffer.size());
+  reserve(m_indexesFile, indexEntryOffset + INDEX_ENTRY_SIZE);
+
+  if (!m_writeBuffer.empty()) {
+    memcpy(m_itemsFile.data() + m_itemsFileSize, m_writeBuffer.data(), m_writeBuffer.size());
+  }
+
+  uint32_t itemSize = static_cast<uint32_t>(m_writeBuffer.size());
+  memcpy(m_indexesFile.data() + indexEntryOffset, &itemSize, sizeof itemSize);
+  writeCount(count + 1);
+
+  m_offsets.push_back(m_itemsFileSize);
+  m_itemsFileSize += itemSize;
+
+  prepare(threadCache(), count) = item;
+}
+
+template<class T> uint64_t MappedVector<T>::cacheHits() const {
+  return m_cacheHits;
+}
+
+template<class T> uint64_t MappedVector<T>::cacheMisses() const {
+  return m_cacheMisses;
+}
+
+template<class T> void MappedVector<T>::releaseThreadCaches() {
+  std::lock_guard<std::mutex> lock(m_cachesMutex);
+  for (auto iter = m_caches.begin(); iter != m_caches.end();) {
+    if (iter->first != std::this_thread::get_id()) {
+      iter = m_caches.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+template<class T> void MappedVector<T>::writeCount(uint64_t count) {
+  memcpy(m_indexesFile.data(), &count, sizeof count);
+}
+
+template<class T> void MappedVector<T>::reserve(Common::MemoryMappedFile& file, uint64_t size) {
+  if (size > file.size()) {
+    file.resize(size + std::max(size / 8, MIN_FILE_GROWTH));
+  }
+}
+
+template<class T> typename MappedVector<T>::Cache& MappedVector<T>::threadCache() {
+  std::lock_guard<std::mutex> lock(m_cachesMutex);
+  std::unique_ptr<Cache>& cache = m_caches[std::this_thread::get_id()];
+  if (!cache) {
+    cache.reset(new Cache());
+    cache->lruHead = NO_SLOT;
+    cache->lruTail = NO_SLOT;
+    // slots must never be reallocated, references to cached items are handed out
+    cache->slots.reserve(m_poolSize);
+  }
+
+  return *cache;
+}
+
+template<class T> T& MappedVector<T>::prepare(Cache& cache, uint64_t index) {
+  uint32_t slot;
+  if (cache.slots.size() < m_poolSize) {
+    slot = static_cast<uint32_t>(cache.slots.size());
+    cache.slots.emplace_back();
+  } else {
+    slot = cache.lruHead;
+    unlinkSlot(cache, slot);
+    cache.slotsByIndex.erase(cache.slots[slot].index);
+  }
+
+  cache.slots[slot].index = index;
+  linkSlotBack(cache, slot);
+  cache.slotsByIndex[index] = slot;
+  return cache.slots[slot].item;
+}
+
+template<class T> void MappedVector<T>::unlinkSlot(Cache& cache, uint32_t slot) {
+  CacheSlot& entry = cache.slots[slot];
+  if (entry.prev != NO_SLOT) {
+    cache.slots[entry.prev].next = entry.next;
+  } else {
+    cache.lruHead = entry.next;
+  }
+
+  if (entry.next != NO_SLOT) {
+    cache.slots[entry.next].prev = entry.prev;
+  } else {
+    cache.lruTail = entry.prev;
+  }
+}
+
+template<class T> void MappedVector<T>::linkSlotBack(Cache& cache, uint32_t slot) {
+  CacheSlot& entry = cache.slots[slot];
+  entry.prev = cache.lruTail;
+  entry.next = NO_SLOT;
+  if (cache.lruTail != NO_SLOT) {
+    cache.slots[cache.lruTail].next = slot;
+  } else {
+    cache.lruHead = slot;
+  }
+
+  cache.lruTail = slot;
+}
+
+template<class T> void MappedVector<T>::evict(Cache& cache, uint64_t index) {
+  auto slotIter = cache.slotsByIndex.find(index);
+  if (slotIter == cache.slotsByIndex.end()) {
+    return;
+  }
+
+  // move the freed slot to the LRU head so it is reused first
+  uint32_t slot = slotIter->second;
+  cache.slotsByIndex.erase(slotIter);
+  unlinkSlot(cache, slot);
+  CacheSlot& entry = cache.slots[slot];
+  entry.item = T();
+  entry.index = std::numeric_limits<uint64_t>::max();
+  entry.prev = NO_SLOT;
+  entry.next = cache.lruHead;
+  if (cache.lruHead != NO_SLOT) {
+    cache.slots[cache.lruHead].prev = slot;
+  } else {
+    cache.lruTail = slot;
+  }
+
+  cache.lruHead = slot;
+}
+
+template<class T> void MappedVector<T>::clearCache() {
+  std::lock_guard<std::mutex> lock(m_cachesMutex);
+  m_caches.clear();
+}
@@ -337,12 +337,15 @@ namespace CryptoNote
   //-----------------------------------------------------------------------------------------------------
   bool miner::worker_thread(uint32_t th_local_index)
   {
-    logger(INFO) << "Miner thread was started ["<< th_local_index << "]";
+    // several nonces are hashed at once when the scratchpads of all the threads fit in L3 cache
+    Crypto::cn_context context(Crypto::cn_slow_hash_preferred_ways(m_threads_total));
+    logger(INFO) << "Miner thread was started ["<< th_local_index << "], hashing " << context.getWays() << " nonce(s) at once, scratchpads use " <<
+      Crypto::cn_page_mode_name(context.getPageMode());
     uint32_t nonce = m_starter_nonce + th_local_index;
     difficulty_type local_diff = 0;
     uint32_t local_template_ver = 0;
-    Crypto::cn_context context;
     Block b;
+    Crypto::Hash hashes[Crypto::SLOW_HASH_MAX_WAYS];
 
     while(!m_stop)
     {
@@ -370,29 +373,34 @@ namespace CryptoNote
       }
 
       b.nonce = nonce;
-      Crypto::Hash h;
-      if (!m_stop && !get_block_longhash(context, b, h)) {
+      if (!m_stop && !get_block_longhashes(context, b, m_threads_total, context.getWays(), hashes)) {
         logger(ERROR) << "Failed to get block long hash";
         m_stop = true;
       }
 
-      if (!m_stop && check_hash(h, local_diff))
-      {
+      for (size_t i = 0; !m_stop && i < context.getWays(); ++i) {
+        if (!check_hash(hashes[i], local_diff)) {
+          continue;
+        }
+
         //we lucky!
         ++m_config.current_extra_message_index;
 
         logger(INFO, GREEN) << "Found block for difficulty: " << local_diff;
 
+        b.nonce = nonce + static_cast<uint32_t>(i) * m_threads_total;
         if(!m_handler.handle_block_found(b)) {
           --m_config.current_extra_message_index;
         } else {
           //success update, lets update config
           Common::saveStringToFile(m_config_folder_path + "/" + CryptoNote::parameters::MINER_CONFIG_FILE_NAME, storeToJson(m_config));
         }
+
+        break;
       }
 
-      nonce += m_threads_total;
-      ++m_hashes;
+      nonce += static_cast<uint32_t>(context.getWays()) * m_threads_total;
+      m_hashes += context.getWays();
     }
     logger(INFO) << "Miner thread stopped ["<< th_local_index << "]";
     return true;
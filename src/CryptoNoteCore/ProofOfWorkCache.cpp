@@ -0,0 +1,57 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "ProofOfWorkCache.h"
+
+namespace CryptoNote {
+
+ProofOfWorkCache::ProofOfWorkCache(size_t capacity) : m_capacity(capacity), m_hits(0), m_misses(0) {
+}
+
+void ProofOfWorkCache::add(const Crypto::Hash& blockHash, const Crypto::Hash& proofOfWork) {
+  if (m_capacity == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_entryIndex.count(blockHash) != 0) {
+    return;
+  }
+
+  if (m_entries.size() == m_capacity) {
+    m_entryIndex.erase(m_entries.back().blockHash);
+    m_entries.pop_back();
+  }
+
+  m_entries.push_front({ blockHash, proofOfWork });
+  m_entryIndex.emplace(blockHash, m_entries.begin());
+}
+
+bool ProofOfWorkCache::take(const Crypto::Hash& blockHash, Crypto::Hash& proofOfWork) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entryIndex.find(blockHash);
+  if (it == m_entryIndex.end()) {
+    ++m_misses;
+    return false;
+  }
+
+  proofOfWork = it->second->proofOfWork;
+  m_entries.erase(it->second);
+  m_entryIndex.erase(it);
+  ++m_hits;
+  return true;
+}
+
+void ProofOfWorkCache::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entryIndex.clear();
+  m_entries.clear();
+}
+
+ProofOfWorkCacheStatistics ProofOfWorkCache::getStatistics() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return { m_hits, m_misses, m_entries.size() };
+}
+
+}
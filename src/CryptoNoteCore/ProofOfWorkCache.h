@@ -0,0 +1,52 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "crypto/hash.h"
+
+namespace CryptoNote {
+
+struct ProofOfWorkCacheStatistics {
+  uint64_t hits;
+  uint64_t misses;
+  size_t size;
+};
+
+// Bounded map from block hashes to the long hashes computed for them in advance, so adding a downloaded block
+// only compares its long hash with the difficulty. The long hash depends on the block alone, unlike the difficulty.
+// An entry is taken out when its block is checked, the oldest entries are dropped when the cache is full.
+class ProofOfWorkCache {
+public:
+  explicit ProofOfWorkCache(size_t capacity);
+
+  void add(const Crypto::Hash& blockHash, const Crypto::Hash& proofOfWork);
+  // Removes the entry of the block if there is one, counts a hit or a miss
+  bool take(const Crypto::Hash& blockHash, Crypto::Hash& proofOfWork);
+  void clear();
+
+  ProofOfWorkCacheStatistics getStatistics() const;
+
+private:
+  struct Entry {
+    Crypto::Hash blockHash;
+    Crypto::Hash proofOfWork;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  const size_t m_capacity;
+  mutable std::mutex m_mutex;
+  EntryList m_entries;
+  std::unordered_map<Crypto::Hash, EntryList::iterator> m_entryIndex;
+  uint64_t m_hits;
+  uint64_t m_misses;
+};
+
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "SignatureCache.h"
+
+#include <cstring>
+
+namespace CryptoNote {
+
+SignatureCache::SignatureCache(size_t capacity) : m_capacity(capacity), m_hits(0), m_misses(0) {
+}
+
+Crypto::Hash SignatureCache::getKey(const Crypto::Hash& prefixHash, const Crypto::KeyImage& keyImage,
+  const std::vector<const Crypto::PublicKey*>& outputKeys, const Crypto::Signature* signatures) {
+  // signatures are a part of the key, otherwise a transaction with the same prefix and forged signatures would be accepted
+  std::vector<uint8_t> data(sizeof(prefixHash) + sizeof(keyImage) + outputKeys.size() * (sizeof(Crypto::PublicKey) + sizeof(Crypto::Signature)));
+  uint8_t* position = data.data();
+  memcpy(position, &prefixHash, sizeof(prefixHash));
+  position += sizeof(prefixHash);
+  memcpy(position, &keyImage, sizeof(keyImage));
+  position += sizeof(keyImage);
+  for (auto key : outputKeys) {
+    memcpy(position, key, sizeof(*key));
+    position += sizeof(*key);
+  }
+
+  memcpy(position, signatures, outputKeys.size() * sizeof(Crypto::Signature));
+  return Crypto::cn_fast_hash(data.data(), data.size());
+}
+
+bool SignatureCache::contains(const Crypto::Hash& key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entryIndex.find(key);
+  if (it == m_entryIndex.end()) {
+    ++m_misses;
+    return false;
+  }
+
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  ++m_hits;
+  return true;
+}
+
+void SignatureCache::add(const Crypto::Hash& key, uint32_t maxUsedBlockHeight) {
+  if (m_capacity == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entryIndex.find(key);
+  if (it != m_entryIndex.end()) {
+    it->second->maxUsedBlockHeight = maxUsedBlockHeight;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return;
+  }
+
+  if (m_entries.size() == m_capacity) {
+    m_entryIndex.erase(m_entries.back().key);
+    m_entries.pop_back();
+  }
+
+  m_entries.push_front({ key, maxUsedBlockHeight });
+  m_entryIndex.emplace(key, m_entries.begin());
+}
+
+void SignatureCache::removeFromHeight(uint32_t height) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    if (it->maxUsedBlockHeight >= height) {
+      m_entryIndex.erase(it->key);
+      it = m_entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void SignatureCache::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entryIndex.clear();
+  m_entries.clear();
+}
+
+SignatureCacheStatistics SignatureCache::getStatistics() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return { m_hits, m_misses, m_entries.size() };
+}
+
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "crypto/crypto.h"
+#include "crypto/hash.h"
+
+namespace CryptoNote {
+
+struct SignatureCacheStatistics {
+  uint64_t hits;
+  uint64_t misses;
+  size_t size;
+};
+
+// Bounded set of ring signatures that have already been verified, so a transaction checked on pool admission
+// is not checked again when it arrives in a block. Every entry remembers the highest block its ring members
+// come from and is dropped when that block leaves the main chain.
+class SignatureCache {
+public:
+  explicit SignatureCache(size_t capacity);
+
+  // Identifies a signature of one input together with everything it is checked against
+  static Crypto::Hash getKey(const Crypto::Hash& prefixHash, const Crypto::KeyImage& keyImage,
+    const std::vector<const Crypto::PublicKey*>& outputKeys, const Crypto::Signature* signatures);
+
+  // Counts a hit or a miss
+  bool contains(const Crypto::Hash& key);
+  void add(const Crypto::Hash& key, uint32_t maxUsedBlockHeight);
+  // Drops entries with ring members from blocks at the height or above
+  void removeFromHeight(uint32_t height);
+  void clear();
+
+  SignatureCacheStatistics getStatistics() const;
+
+private:
+  struct Entry {
+    Crypto::Hash key;
+    uint32_t maxUsedBlockHeight;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  const size_t m_capacity;
+  mutable std::mutex m_mutex;
+  EntryList m_entries;
+  std::unordered_map<Crypto::Hash, EntryList::iterator> m_entryIndex;
+  uint64_t m_hits;
+  uint64_t m_misses;
+};
+
+}
@@ -87,6 +87,7 @@ namespace CryptoNote {
     virtual size_t addInput(const KeyInput& input) override;
     virtual size_t addInput(const MultisignatureInput& input) override;
     virtual size_t addInput(const AccountKeys& senderKeys, const TransactionTypes::InputKeyInfo& info, KeyPair& ephKeys) override;
+    virtual size_t addInput(const AccountKeys& senderKeys, const TransactionTypes::InputKeyInfo& info, const KeyImage& keyImage, KeyPair& ephKeys) override;
 
     virtual size_t addOutput(uint64_t amount, const AccountPublicAddress& to) override;
     virtual size_t addOutput(uint64_t amount, const std::vector<AccountPublicAddress>& to, uint32_t requiredSignatures) override;
@@ -105,6 +106,7 @@ namespace CryptoNote {
   private:
 
     void invalidateHash();
+    size_t addKeyInput(const TransactionTypes::InputKeyInfo& info, const KeyImage& keyImage);
 
     std::vector<Signature>& getSignatures(size_t input);
 
@@ -236,15 +238,36 @@ namespace CryptoNote {
 
   size_t TransactionImpl::addInput(const AccountKeys& senderKeys, const TransactionTypes::InputKeyInfo& info, KeyPair& ephKeys) {
     checkIfSigning();
-    KeyInput input;
-    input.amount = info.amount;
+    KeyImage keyImage;
 
     generate_key_image_helper(
       senderKeys,
       info.realOutput.transactionPublicKey,
       info.realOutput.outputInTransaction,
       ephKeys,
-      input.keyImage);
+      keyImage);
+
+    return addKeyInput(info, keyImage);
+  }
+
+  size_t TransactionImpl::addInput(const AccountKeys& senderKeys, const TransactionTypes::InputKeyInfo& info, const KeyImage& keyImage, KeyPair& ephKeys) {
+    checkIfSigning();
+    KeyDerivation derivation;
+    if (!generate_key_derivation(info.realOutput.transactionPublicKey, senderKeys.viewSecretKey, derivation)) {
+      throw std::runtime_error("Failed to generate key derivation");
+    }
+
+    // the ephemeral public key is the key of the output being spent, only the secret key has to be derived
+    ephKeys.publicKey = info.outputs.at(info.realOutput.transactionIndex).targetKey;
+    derive_secret_key(derivation, info.realOutput.outputInTransaction, senderKeys.spendSecretKey, ephKeys.secretKey);
+
+    return addKeyInput(info, keyImage);
+  }
+
+  size_t TransactionImpl::addKeyInput(const TransactionTypes::InputKeyInfo& info, const KeyImage& keyImage) {
+    KeyInput input;
+    input.amount = info.amount;
+    input.keyImage = keyImage;
 
     // fill outputs array and use relative offsets
     for (const auto& out : info.outputs) {
@@ -140,19 +140,23 @@ namespace CryptoNote {
     }
 
     BlockInfo maxUsedBlock;
+    bool inputsValid = false;
 
-    // check inputs
-    bool inputsValid = m_validator.checkTransactionInputs(tx, maxUsedBlock);
+    // inputs of a transaction from a block below a trusted checkpoint are checked when the block is added
+    if (!keptByBlock || !m_validator.isInTrustedCheckpointZone()) {
+      // check inputs
+      inputsValid = m_validator.checkTransactionInputs(tx, maxUsedBlock);
 
-    if (!inputsValid) {
-      if (!keptByBlock) {
-        logger(INFO) << "tx used wrong inputs, rejected";
-        tvc.m_verifivation_failed = true;
-        return false;
-      }
+      if (!inputsValid) {
+        if (!keptByBlock) {
+          logger(INFO) << "tx used wrong inputs, rejected";
+          tvc.m_verifivation_failed = true;
+          return false;
+        }
 
-      maxUsedBlock.clear();
-      tvc.m_verifivation_impossible = true;
+        maxUsedBlock.clear();
+        tvc.m_verifivation_impossible = true;
+      }
     }
 
     if (!keptByBlock) {
@@ -218,6 +222,10 @@ namespace CryptoNote {
     return add_tx(tx, h, blobSize, tvc, keeped_by_block);
   }
   //---------------------------------------------------------------------------------
+  bool tx_memory_pool::add_tx(const CachedTransaction& cachedTransaction, tx_verification_context& tvc, bool keeped_by_block) {
+    return add_tx(cachedTransaction.getTransaction(), cachedTransaction.getTransactionHash(), cachedTransaction.getTransactionBinarySize(), tvc, keeped_by_block);
+  }
+  //---------------------------------------------------------------------------------
   bool tx_memory_pool::take_tx(const Crypto::Hash &id, Transaction &tx, size_t& blobSize, uint64_t& fee) {
     std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
     auto it = m_transactions.find(id);
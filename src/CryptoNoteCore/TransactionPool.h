@@ -21,6 +21,7 @@
 #include "Common/ObserverManager.h"
 #include "crypto/hash.h"
 
+#include "CryptoNoteCore/CachedTransaction.h"
 #include "CryptoNoteCore/CryptoNoteBasic.h"
 #include "CryptoNoteCore/CryptoNoteBasicImpl.h"
 #include "CryptoNoteCore/Currency.h"
@@ -86,6 +87,7 @@ namespace CryptoNote {
     bool have_tx(const Crypto::Hash &id) const;
     bool add_tx(const Transaction &tx, const Crypto::Hash &id, size_t blobSize, tx_verification_context& tvc, bool keeped_by_block);
     bool add_tx(const Transaction &tx, tx_verification_context& tvc, bool keeped_by_block);
+    bool add_tx(const CachedTransaction& cachedTransaction, tx_verification_context& tvc, bool keeped_by_block);
     //gets tx and remove it from pool
     bool take_tx(const Crypto::Hash &id, Transaction &tx, size_t& blobSize, uint64_t& fee);
 
@@ -0,0 +1,178 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "BlockDownloadScheduler.h"
+
+#include <algorithm>
+
+#include "crypto/hash.h"
+
+namespace CryptoNote {
+
+BlockDownloadScheduler::BlockDownloadScheduler(size_t spanSize, size_t maxSpanCount, Clock::duration stallTimeout) :
+  m_spanSize(spanSize), m_maxSpanCount(maxSpanCount), m_stallTimeout(stallTimeout), m_startHeight(0), m_splitHeight(0) {
+}
+
+bool BlockDownloadScheduler::addBlockIds(const ConnectionId& connection, uint32_t startHeight, const std::vector<Crypto::Hash>& blockIds) {
+  if (startHeight > getKnownHeight()) {
+    if (!m_blockIds.empty()) {
+      return false;
+    }
+
+    // everything below is processed already
+    m_startHeight = startHeight;
+    m_splitHeight = startHeight;
+  }
+
+  uint32_t knownHeight = getKnownHeight();
+  uint32_t height = startHeight;
+  for (const Crypto::Hash& blockId : blockIds) {
+    if (height >= knownHeight) {
+      m_blockIds.push_back(blockId);
+    } else if (height >= m_startHeight && m_blockIds[height - m_startHeight] != blockId) {
+      return false;
+    }
+
+    ++height;
+  }
+
+  m_connectionHeights[connection] = height;
+  return true;
+}
+
+bool BlockDownloadScheduler::hasConnection(const ConnectionId& connection) const {
+  return m_connectionHeights.count(connection) != 0;
+}
+
+bool BlockDownloadScheduler::needsBlockIds(const ConnectionId& connection) const {
+  auto it = m_connectionHeights.find(connection);
+  return it == m_connectionHeights.end() || m_splitHeight >= it->second;
+}
+
+void BlockDownloadScheduler::removeConnection(const ConnectionId& connection) {
+  m_connectionHeights.erase(connection);
+  for (auto& entry : m_spans) {
+    auto& connections = entry.second.connections;
+    connections.erase(std::remove(connections.begin(), connections.end(), connection), connections.end());
+  }
+}
+
+bool BlockDownloadScheduler::takeSpan(const ConnectionId& connection, Clock::time_point now, std::vector<Crypto::Hash>& blockIds) {
+  auto heightIt = m_connectionHeights.find(connection);
+  if (heightIt == m_connectionHeights.end() || findAssignedSpan(connection) != m_spans.end()) {
+    return false;
+  }
+
+  uint32_t connectionHeight = heightIt->second;
+  Span* stalledSpan = nullptr;
+  for (auto& entry : m_spans) {
+    Span& span = entry.second;
+    if (span.received || entry.first + span.blockIds.size() > connectionHeight) {
+      continue;
+    }
+
+    if (span.connections.empty()) {
+      assignSpan(span, connection, now, blockIds);
+      return true;
+    }
+
+    if (stalledSpan == nullptr && now - span.requestTime >= m_stallTimeout) {
+      stalledSpan = &span;
+    }
+  }
+
+  if (stalledSpan != nullptr) {
+    assignSpan(*stalledSpan, connection, now, blockIds);
+    return true;
+  }
+
+  uint32_t endHeight = std::min(getKnownHeight(), connectionHeight);
+  if (m_spans.size() >= m_maxSpanCount || m_splitHeight >= endHeight) {
+    return false;
+  }
+
+  endHeight = std::min(endHeight, m_splitHeight + static_cast<uint32_t>(m_spanSize));
+  Span& span = m_spans[m_splitHeight];
+  span.blockIds.assign(m_blockIds.begin() + (m_splitHeight - m_startHeight), m_blockIds.begin() + (endHeight - m_startHeight));
+  span.received = false;
+  m_splitHeight = endHeight;
+  assignSpan(span, connection, now, blockIds);
+  return true;
+}
+
+bool BlockDownloadScheduler::completeSpan(const ConnectionId& connection, std::vector<PreparedBlock>&& blocks) {
+  auto it = findAssignedSpan(connection);
+  if (it == m_spans.end() || it->second.blockIds.size() != blocks.size()) {
+    return false;
+  }
+
+  // peers are free to send blocks in any order, they are processed in the order of heights
+  Span& span = it->second;
+  std::unordered_map<Crypto::Hash, size_t> positions;
+  for (size_t i = 0; i < span.blockIds.size(); ++i) {
+    positions.emplace(span.blockIds[i], i);
+  }
+
+  std::vector<PreparedBlock> orderedBlocks(blocks.size());
+  for (PreparedBlock& block : blocks) {
+    auto positionIt = positions.find(block.hash);
+    if (positionIt == positions.end()) {
+      return false;
+    }
+
+    orderedBlocks[positionIt->second] = std::move(block);
+  }
+
+  span.received = true;
+  span.source = connection;
+  span.blocks = std::move(orderedBlocks);
+  span.connections.clear();
+  return true;
+}
+
+bool BlockDownloadScheduler::popReadySpan(std::vector<PreparedBlock>& blocks, ConnectionId& source) {
+  auto it = m_spans.begin();
+  if (it == m_spans.end() || it->first != m_startHeight || !it->second.received) {
+    return false;
+  }
+
+  Span& span = it->second;
+  blocks = std::move(span.blocks);
+  source = span.source;
+  m_blockIds.erase(m_blockIds.begin(), m_blockIds.begin() + span.blockIds.size());
+  m_startHeight += static_cast<uint32_t>(span.blockIds.size());
+  m_spans.erase(it);
+  return true;
+}
+
+bool BlockDownloadScheduler::empty() const {
+  return m_blockIds.empty();
+}
+
+void BlockDownloadScheduler::clear() {
+  m_startHeight = 0;
+  m_blockIds.clear();
+  m_splitHeight = 0;
+  m_spans.clear();
+  m_connectionHeights.clear();
+}
+
+uint32_t BlockDownloadScheduler::getKnownHeight() const {
+  return m_startHeight + static_cast<uint32_t>(m_blockIds.size());
+}
+
+BlockDownloadScheduler::SpanMap::iterator BlockDownloadScheduler::findAssignedSpan(const ConnectionId& connection) {
+  return std::find_if(m_spans.begin(), m_spans.end(), [&connection](const SpanMap::value_type& entry) {
+    const Span& span = entry.second;
+    return !span.received && std::find(span.connections.begin(), span.connections.end(), connection) != span.connections.end();
+  });
+}
+
+void BlockDownloadScheduler::assignSpan(Span& span, const ConnectionId& connection, Clock::time_point now, std::vector<Crypto::Hash>& blockIds) {
+  span.connections.push_back(connection);
+  span.requestTime = now;
+  blockIds = span.blockIds;
+}
+
+}
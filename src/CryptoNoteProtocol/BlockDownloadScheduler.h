@@ -0,0 +1,96 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+#include "CryptoNote.h"
+
+namespace CryptoNote {
+
+struct PreparedTransaction {
+  Transaction tx;
+  Crypto::Hash hash;
+  size_t blobSize;
+  bool parsed;
+};
+
+// Block received from a peer, decoded outside of the dispatcher thread
+struct PreparedBlock {
+  Block block;
+  Crypto::Hash hash;
+  bool parsed;
+  std::vector<PreparedTransaction> transactions;
+};
+
+// Splits the chain being downloaded into spans of consecutive blocks, hands the spans out to connections
+// and gives the downloaded spans back in height order. A span that is not downloaded in time is handed out
+// to one more connection, the first response wins. Used on the dispatcher thread only.
+class BlockDownloadScheduler {
+public:
+  typedef boost::uuids::uuid ConnectionId;
+  typedef std::chrono::steady_clock Clock;
+
+  BlockDownloadScheduler(size_t spanSize, size_t maxSpanCount, Clock::duration stallTimeout);
+
+  // Appends ids of the blocks the connection announced starting from the height. Returns false if they contradict
+  // the ids announced before, the connection can't take spans then.
+  bool addBlockIds(const ConnectionId& connection, uint32_t startHeight, const std::vector<Crypto::Hash>& blockIds);
+  bool hasConnection(const ConnectionId& connection) const;
+  // True if all the blocks the connection announced are handed out, so more ids are needed from it
+  bool needsBlockIds(const ConnectionId& connection) const;
+  // Forgets the connection, its spans are handed out to other connections
+  void removeConnection(const ConnectionId& connection);
+
+  // Assigns the connection a span nobody downloads, a new span or a span stalled at another connection
+  bool takeSpan(const ConnectionId& connection, Clock::time_point now, std::vector<Crypto::Hash>& blockIds);
+  // Stores blocks of the span assigned to the connection, returns false if the span is downloaded already
+  bool completeSpan(const ConnectionId& connection, std::vector<PreparedBlock>&& blocks);
+  // Takes the downloaded span that continues the processed blocks
+  bool popReadySpan(std::vector<PreparedBlock>& blocks, ConnectionId& source);
+
+  // True if there are no blocks to download or to process
+  bool empty() const;
+  void clear();
+
+private:
+  struct Span {
+    std::vector<Crypto::Hash> blockIds;
+    std::vector<ConnectionId> connections;
+    Clock::time_point requestTime;
+    bool received;
+    ConnectionId source;
+    std::vector<PreparedBlock> blocks;
+  };
+
+  typedef std::map<uint32_t, Span> SpanMap;
+
+  uint32_t getKnownHeight() const;
+  SpanMap::iterator findAssignedSpan(const ConnectionId& connection);
+  void assignSpan(Span& span, const ConnectionId& connection, Clock::time_point now, std::vector<Crypto::Hash>& blockIds);
+
+  const size_t m_spanSize;
+  const size_t m_maxSpanCount;
+  const Clock::duration m_stallTimeout;
+
+  // ids of the blocks starting from m_startHeight that are not handed out for processing yet
+  uint32_t m_startHeight;
+  std::deque<Crypto::Hash> m_blockIds;
+  // blocks below are split into spans
+  uint32_t m_splitHeight;
+  SpanMap m_spans;
+  // height after the last block announced by the connection
+  std::unordered_map<ConnectionId, uint32_t, boost::hash<ConnectionId>> m_connectionHeights;
+};
+
+}
@@ -8,6 +8,7 @@
 #include <boost/scope_exit.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <System/Dispatcher.h>
+#include <System/RemoteContext.h>
 
 #include "CryptoNoteCore/CryptoNoteBasicImpl.h"
 #include "CryptoNoteCore/CryptoNoteFormatUtils.h"
@@ -44,6 +45,8 @@ CryptoNoteProtocolHandler::CryptoNoteProtocolHandler(const Currency& currency, S
   m_stop(false),
   m_observedHeight(0),
   m_peersCount(0),
+  m_downloadScheduler(BLOCKS_SYNCHRONIZING_DEFAULT_COUNT, BLOCKS_SYNCHRONIZING_MAX_SPAN_COUNT, std::chrono::seconds(BLOCKS_SYNCHRONIZING_SPAN_TIMEOUT)),
+  m_processingSpans(false),
   logger(log, "protocol") {
   
   if (!m_p2p) {
@@ -66,6 +69,8 @@ void CryptoNoteProtocolHandler::onConnectionOpened(CryptoNoteConnectionContext&
 }
 
 void CryptoNoteProtocolHandler::onConnectionClosed(CryptoNoteConnectionContext& context) {
+  m_downloadScheduler.removeConnection(context.m_connection_id);
+
   bool updated = false;
   {
     std::lock_guard<std::mutex> lock(m_observedHeightMutex);
@@ -95,13 +100,8 @@ bool CryptoNoteProtocolHandler::start_sync(CryptoNoteConnectionContext& context)
   logger(Logging::TRACE) << context << "Starting synchronization";
 
   if (context.m_state == CryptoNoteConnectionContext::state_synchronizing) {
-    assert(context.m_needed_objects.empty());
     assert(context.m_requested_objects.empty());
-
-    NOTIFY_REQUEST_CHAIN::request r = boost::value_initialized<NOTIFY_REQUEST_CHAIN::request>();
-    r.block_ids = m_core.buildSparseChain();
-    logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_CHAIN: m_block_ids.size()=" << r.block_ids.size();
-    post_notify<NOTIFY_REQUEST_CHAIN>(*m_p2p, r, context);
+    requestChain(context);
   }
 
   return true;
@@ -261,10 +261,7 @@ int CryptoNoteProtocolHandler::handle_notify_new_block(int command, NOTIFY_NEW_B
     }
   } else if (bvc.m_marked_as_orphaned) {
     context.m_state = CryptoNoteConnectionContext::state_synchronizing;
-    NOTIFY_REQUEST_CHAIN::request r = boost::value_initialized<NOTIFY_REQUEST_CHAIN::request>();
-    r.block_ids = m_core.buildSparseChain();
-    logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_CHAIN: m_block_ids.size()=" << r.block_ids.size();
-    post_notify<NOTIFY_REQUEST_CHAIN>(*m_p2p, r, context);
+    requestChain(context);
   }
 
   return 1;
@@ -312,6 +309,12 @@ int CryptoNoteProtocolHandler::handle_request_get_objects(int command, NOTIFY_RE
 int CryptoNoteProtocolHandler::handle_response_get_objects(int command, NOTIFY_RESPONSE_GET_OBJECTS::request& arg, CryptoNoteConnectionContext& context) {
   logger(Logging::TRACE) << context << "NOTIFY_RESPONSE_GET_OBJECTS";
 
+  if (context.m_state == CryptoNoteConnectionContext::state_idle) {
+    // response to the request sent ahead before the connection was set to idle state
+    logger(Logging::DEBUGGING) << context << "NOTIFY_RESPONSE_GET_OBJECTS ignored, connection is idle";
+    return 1;
+  }
+
   if (context.m_last_response_height > arg.current_blockchain_height) {
     logger(Logging::ERROR) << context << "sent wrong NOTIFY_HAVE_OBJECTS: arg.m_current_blockchain_height=" << arg.current_blockchain_height
       << " < m_last_response_height=" << context.m_last_response_height << ", dropping connection";
@@ -323,29 +326,24 @@ int CryptoNoteProtocolHandler::handle_response_get_objects(int command, NOTIFY_R
 
   context.m_remote_blockchain_height = arg.current_blockchain_height;
 
-  size_t count = 0;
-  for (const block_complete_entry& block_entry : arg.blocks) {
-    ++count;
-    Block b;
-    if (!fromBinaryArray(b, asBinaryArray(block_entry.block))) {
+  // decoding runs on another thread, the dispatcher keeps serving other connections meanwhile
+  std::vector<PreparedBlock> blocks;
+  {
+    System::RemoteContext<void> decoding(m_dispatcher, [this, &arg, &blocks] { decodeObjects(arg.blocks, blocks); });
+    decoding.get();
+  }
+
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    const block_complete_entry& block_entry = arg.blocks[i];
+    if (!blocks[i].parsed) {
       logger(Logging::ERROR) << context << "sent wrong block: failed to parse and validate block: \r\n"
         << toHex(asBinaryArray(block_entry.block)) << "\r\n dropping connection";
       context.m_state = CryptoNoteConnectionContext::state_shutdown;
       return 1;
     }
 
-    //to avoid concurrency in core between connections, suspend connections which delivered block later then first one
-    if (count == 2) {
-      if (m_core.have_block(get_block_hash(b))) {
-        context.m_state = CryptoNoteConnectionContext::state_idle;
-        context.m_needed_objects.clear();
-        context.m_requested_objects.clear();
-        logger(Logging::DEBUGGING) << context << "Connection set to idle state.";
-        return 1;
-      }
-    }
-
-    auto blockHash = get_block_hash(b);
+    const Block& b = blocks[i].block;
+    auto blockHash = blocks[i].hash;
     auto req_it = context.m_requested_objects.find(blockHash);
     if (req_it == context.m_requested_objects.end()) {
       logger(Logging::ERROR) << context << "sent wrong NOTIFY_RESPONSE_GET_OBJECTS: block with id=" << Common::podToHex(blockHash)
@@ -360,6 +358,15 @@ int CryptoNoteProtocolHandler::handle_response_get_objects(int command, NOTIFY_R
       return 1;
     }
 
+    for (size_t j = 0; j < blocks[i].transactions.size(); ++j) {
+      if (!blocks[i].transactions[j].parsed) {
+        logger(Logging::ERROR) << context << "transaction verification failed on NOTIFY_RESPONSE_GET_OBJECTS, \r\ntx_id = "
+          << Common::podToHex(getBinaryArrayHash(asBinaryArray(block_entry.txs[j]))) << ", dropping connection";
+        context.m_state = CryptoNoteConnectionContext::state_shutdown;
+        return 1;
+      }
+    }
+
     context.m_requested_objects.erase(req_it);
   }
 
@@ -371,77 +378,187 @@ int CryptoNoteProtocolHandler::handle_response_get_objects(int command, NOTIFY_R
     return 1;
   }
 
-  {
-    m_core.pause_mining();
+  if (!m_downloadScheduler.completeSpan(context.m_connection_id, std::move(blocks))) {
+    logger(Logging::DEBUGGING) << context << "NOTIFY_RESPONSE_GET_OBJECTS ignored, the span was downloaded from another connection";
+  }
+
+  // the connection downloads the next span while the received ones are processed
+  if (!m_stop && context.m_state == CryptoNoteConnectionContext::state_synchronizing) {
+    request_missing_objects(context);
+  }
 
-    BOOST_SCOPE_EXIT_ALL(this) { m_core.update_block_template_and_resume_mining(); };
+  processReadySpans();
+  return 1;
+}
 
-    int result = processObjects(context, arg.blocks);
-    if (result != 0) {
-      return result;
+void CryptoNoteProtocolHandler::decodeObjects(const std::vector<block_complete_entry>& entries, std::vector<PreparedBlock>& blocks) const {
+  // the hashes of the whole span are computed in batches, several of them at once
+  std::vector<const Block*> parsedBlocks;
+  std::vector<Crypto::Hash> blockHashes;
+  std::vector<PreparedTransaction*> parsedTransactions;
+  std::vector<BinaryArray> transactionBlobs;
+  std::vector<Crypto::Hash> transactionHashes;
+  blocks.resize(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    PreparedBlock& block = blocks[i];
+    BinaryArray blockBlob = asBinaryArray(entries[i].block);
+    block.parsed = blockBlob.size() <= m_currency.maxBlockBlobSize() && fromBinaryArray(block.block, blockBlob);
+    if (block.parsed) {
+      parsedBlocks.push_back(&block.block);
     }
-  }
 
-  uint32_t height;
-  Crypto::Hash top;
-  m_core.get_blockchain_top(height, top);
-  logger(DEBUGGING, BRIGHT_GREEN) << "Local blockchain updated, new height = " << height;
+    block.transactions.resize(entries[i].txs.size());
+    for (size_t j = 0; j < entries[i].txs.size(); ++j) {
+      PreparedTransaction& transaction = block.transactions[j];
+      BinaryArray transactionBlob = asBinaryArray(entries[i].txs[j]);
+      transaction.blobSize = transactionBlob.size();
+      transaction.parsed = transaction.blobSize <= m_currency.maxTxSize() && fromBinaryArray(transaction.tx, transactionBlob);
+      if (transaction.parsed) {
+        parsedTransactions.push_back(&transaction);
+        transactionBlobs.push_back(std::move(transactionBlob));
+      }
+    }
+  }
 
-  if (!m_stop && context.m_state == CryptoNoteConnectionContext::state_synchronizing) {
-    request_missing_objects(context, true);
+  get_block_hashes(parsedBlocks, blockHashes);
+  for (size_t i = 0, b = 0; i < blocks.size(); ++i) {
+    if (blocks[i].parsed) {
+      blocks[i].hash = blockHashes[b++];
+    }
   }
 
-  return 1;
+  getBinaryArrayHashes(transactionBlobs, transactionHashes);
+  for (size_t i = 0; i < parsedTransactions.size(); ++i) {
+    parsedTransactions[i]->hash = transactionHashes[i];
+  }
 }
 
-int CryptoNoteProtocolHandler::processObjects(CryptoNoteConnectionContext& context, const std::vector<block_complete_entry>& blocks) {
+int CryptoNoteProtocolHandler::processObjects(const std::vector<PreparedBlock>& blocks) {
+  std::vector<const Block*> downloadedBlocks;
+  std::vector<const Transaction*> transactions;
+  for (const PreparedBlock& block : blocks) {
+    downloadedBlocks.push_back(&block.block);
+    for (const PreparedTransaction& transaction : block.transactions) {
+      transactions.push_back(&transaction.tx);
+    }
+  }
+
+  // proofs of work and signatures are checked by a thread pool in advance, so the commit below finds them verified
+  {
+    System::RemoteContext<void> verification(m_dispatcher, [this, &downloadedBlocks, &transactions] {
+      m_core.preverifyBlocks(downloadedBlocks);
+      m_core.preverifyTransactions(transactions);
+    });
+
+    verification.get();
+  }
 
-  for (const block_complete_entry& block_entry : blocks) {
+  for (const PreparedBlock& block : blocks) {
     if (m_stop) {
       break;
     }
 
     //process transactions
-    for (auto& tx_blob : block_entry.txs) {
+    for (const PreparedTransaction& transaction : block.transactions) {
       tx_verification_context tvc = boost::value_initialized<decltype(tvc)>();
-      m_core.handle_incoming_tx(asBinaryArray(tx_blob), tvc, true);
+      m_core.handleIncomingTransaction(transaction.tx, transaction.hash, transaction.blobSize, tvc, true);
       if (tvc.m_verifivation_failed) {
-        logger(Logging::ERROR) << context << "transaction verification failed on NOTIFY_RESPONSE_GET_OBJECTS, \r\ntx_id = "
-          << Common::podToHex(getBinaryArrayHash(asBinaryArray(tx_blob))) << ", dropping connection";
-        context.m_state = CryptoNoteConnectionContext::state_shutdown;
+        logger(Logging::ERROR) << "transaction verification failed on NOTIFY_RESPONSE_GET_OBJECTS, \r\ntx_id = "
+          << Common::podToHex(transaction.hash);
         return 1;
       }
     }
 
     // process block
     block_verification_context bvc = boost::value_initialized<block_verification_context>();
-    m_core.handle_incoming_block_blob(asBinaryArray(block_entry.block), bvc, false, false);
+    m_core.handle_incoming_block(block.block, bvc, false, false);
 
     if (bvc.m_verifivation_failed) {
-      logger(Logging::DEBUGGING) << context << "Block verification failed, dropping connection";
-      context.m_state = CryptoNoteConnectionContext::state_shutdown;
+      logger(Logging::DEBUGGING) << "Block verification failed, id = " << Common::podToHex(block.hash);
       return 1;
     } else if (bvc.m_marked_as_orphaned) {
-      logger(Logging::INFO) << context << "Block received at sync phase was marked as orphaned, dropping connection";
-      context.m_state = CryptoNoteConnectionContext::state_shutdown;
+      logger(Logging::INFO) << "Block received at sync phase was marked as orphaned, id = " << Common::podToHex(block.hash);
       return 1;
     } else if (bvc.m_already_exists) {
-      logger(Logging::DEBUGGING) << context << "Block already exists, switching to idle state";
-      context.m_state = CryptoNoteConnectionContext::state_idle;
-      context.m_needed_objects.clear();
-      context.m_requested_objects.clear();
-      return 1;
+      // the block came with a new block notification meanwhile
+      logger(Logging::DEBUGGING) << "Block already exists, id = " << Common::podToHex(block.hash);
     }
 
     m_dispatcher.yield();
   }
 
   return 0;
+}
+
+void CryptoNoteProtocolHandler::processReadySpans() {
+  // spans received while a span is processed are picked up by the loop below
+  if (m_processingSpans) {
+    return;
+  }
 
+  bool updated = false;
+  {
+    m_processingSpans = true;
+    BOOST_SCOPE_EXIT_ALL(this) { m_processingSpans = false; };
+
+    std::vector<PreparedBlock> blocks;
+    BlockDownloadScheduler::ConnectionId source;
+    while (!m_stop && m_downloadScheduler.popReadySpan(blocks, source)) {
+      int result;
+      {
+        m_core.pause_mining();
+
+        BOOST_SCOPE_EXIT_ALL(this) { m_core.update_block_template_and_resume_mining(); };
+
+        result = processObjects(blocks);
+      }
+
+      if (result != 0) {
+        // the chain being downloaded is wrong, it is requested anew from the remaining connections
+        m_downloadScheduler.clear();
+        m_p2p->for_each_connection([this, &source](CryptoNoteConnectionContext& context, PeerIdType peerId) {
+          if (context.m_connection_id == source) {
+            logger(Logging::INFO) << context << "sent blocks that failed verification, dropping connection";
+            context.m_state = CryptoNoteConnectionContext::state_shutdown;
+          } else if (context.m_state == CryptoNoteConnectionContext::state_synchronizing && context.m_requested_objects.empty()) {
+            requestChain(context);
+          }
+        });
+
+        break;
+      }
+
+      updated = true;
+    }
+  }
+
+  if (updated) {
+    uint32_t height;
+    Crypto::Hash top;
+    m_core.get_blockchain_top(height, top);
+    logger(DEBUGGING, BRIGHT_GREEN) << "Local blockchain updated, new height = " << height;
+  }
+
+  scheduleRequests();
+}
+
+void CryptoNoteProtocolHandler::scheduleRequests() {
+  if (m_stop) {
+    return;
+  }
+
+  m_p2p->for_each_connection([this](CryptoNoteConnectionContext& context, PeerIdType peerId) {
+    if (context.m_state == CryptoNoteConnectionContext::state_synchronizing && context.m_requested_objects.empty() &&
+      m_downloadScheduler.hasConnection(context.m_connection_id)) {
+      request_missing_objects(context);
+    }
+  });
 }
 
 
 bool CryptoNoteProtocolHandler::on_idle() {
+  // spans stalled at slow connections are requested from the idle ones
+  scheduleRequests();
   return m_core.on_idle();
 }
 
@@ -468,53 +585,74 @@ int CryptoNoteProtocolHandler::handle_request_chain(int command, NOTIFY_REQUEST_
   return 1;
 }
 
-bool CryptoNoteProtocolHandler::request_missing_objects(CryptoNoteConnectionContext& context, bool check_having_blocks) {
-  if (context.m_needed_objects.size()) {
-    //we know objects that we need, request this objects
-    NOTIFY_REQUEST_GET_OBJECTS::request req;
-    size_t count = 0;
-    auto it = context.m_needed_objects.begin();
+bool CryptoNoteProtocolHandler::request_missing_objects(CryptoNoteConnectionContext& context) {
+  if (!context.m_requested_objects.empty()) {
+    return true;
+  }
 
-    while (it != context.m_needed_objects.end() && count < BLOCKS_SYNCHRONIZING_DEFAULT_COUNT) {
-      if (!(check_having_blocks && m_core.have_block(*it))) {
-        req.blocks.push_back(*it);
-        ++count;
-        context.m_requested_objects.insert(*it);
-      }
-      it = context.m_needed_objects.erase(it);
+  if (!m_downloadScheduler.hasConnection(context.m_connection_id)) {
+    requestChain(context);
+    return true;
+  }
+
+  if (requestSpan(context)) {
+    return true;
+  }
+
+  if (context.m_last_response_height < context.m_remote_blockchain_height - 1) {//we have to fetch more objects ids, request blockchain entry
+    if (m_downloadScheduler.needsBlockIds(context.m_connection_id)) {
+      requestChain(context);
     }
-    logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_GET_OBJECTS: blocks.size()=" << req.blocks.size() << ", txs.size()=" << req.txs.size();
-    post_notify<NOTIFY_REQUEST_GET_OBJECTS>(*m_p2p, req, context);
-  } else if (context.m_last_response_height < context.m_remote_blockchain_height - 1) {//we have to fetch more objects ids, request blockchain entry
-
-    NOTIFY_REQUEST_CHAIN::request r = boost::value_initialized<NOTIFY_REQUEST_CHAIN::request>();
-    r.block_ids = m_core.buildSparseChain();
-    logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_CHAIN: m_block_ids.size()=" << r.block_ids.size();
-    post_notify<NOTIFY_REQUEST_CHAIN>(*m_p2p, r, context);
-  } else {
-    if (!(context.m_last_response_height ==
-      context.m_remote_blockchain_height - 1 &&
-      !context.m_needed_objects.size() &&
-      !context.m_requested_objects.size())) {
+  } else if (m_downloadScheduler.empty() && !m_processingSpans) {
+    if (context.m_last_response_height != context.m_remote_blockchain_height - 1) {
       logger(Logging::ERROR, Logging::BRIGHT_RED)
         << "request_missing_blocks final condition failed!"
         << "\r\nm_last_response_height=" << context.m_last_response_height
         << "\r\nm_remote_blockchain_height=" << context.m_remote_blockchain_height
-        << "\r\nm_needed_objects.size()=" << context.m_needed_objects.size()
-        << "\r\nm_requested_objects.size()=" << context.m_requested_objects.size() 
         << "\r\non connection [" << context << "]";
+      requestChain(context);
       return false;
     }
 
+    m_downloadScheduler.removeConnection(context.m_connection_id);
     requestMissingPoolTransactions(context);
 
     context.m_state = CryptoNoteConnectionContext::state_normal;
     logger(Logging::INFO, Logging::BRIGHT_GREEN) << context << "SYNCHRONIZED OK";
     on_connection_synchronized();
   }
+  // otherwise the connection waits for spans of other connections to stall or for the downloaded blocks to be processed
+
+  return true;
+}
+
+bool CryptoNoteProtocolHandler::requestSpan(CryptoNoteConnectionContext& context) {
+  std::vector<Crypto::Hash> blockIds;
+  if (!m_downloadScheduler.takeSpan(context.m_connection_id, std::chrono::steady_clock::now(), blockIds)) {
+    return false;
+  }
+
+  NOTIFY_REQUEST_GET_OBJECTS::request req;
+  for (const Crypto::Hash& blockId : blockIds) {
+    req.blocks.push_back(blockId);
+    context.m_requested_objects.insert(blockId);
+  }
+
+  logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_GET_OBJECTS: blocks.size()=" << req.blocks.size() << ", txs.size()=" << req.txs.size();
+  post_notify<NOTIFY_REQUEST_GET_OBJECTS>(*m_p2p, req, context);
   return true;
 }
 
+void CryptoNoteProtocolHandler::requestChain(CryptoNoteConnectionContext& context) {
+  // the connection takes no spans until its chain entry arrives
+  m_downloadScheduler.removeConnection(context.m_connection_id);
+
+  NOTIFY_REQUEST_CHAIN::request r = boost::value_initialized<NOTIFY_REQUEST_CHAIN::request>();
+  r.block_ids = m_core.buildSparseChain();
+  logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_CHAIN: m_block_ids.size()=" << r.block_ids.size();
+  post_notify<NOTIFY_REQUEST_CHAIN>(*m_p2p, r, context);
+}
+
 bool CryptoNoteProtocolHandler::on_connection_synchronized() {
   bool val_expected = false;
   if (m_synchronized.compare_exchange_strong(val_expected, true)) {
@@ -567,12 +705,20 @@ int CryptoNoteProtocolHandler::handle_response_chain_entry(int command, NOTIFY_R
     context.m_state = CryptoNoteConnectionContext::state_shutdown;
   }
 
-  for (auto& bl_id : arg.m_block_ids) {
-    if (!m_core.have_block(bl_id))
-      context.m_needed_objects.push_back(bl_id);
+  // chain entry starts with a block we have, the blocks we don't have follow it
+  size_t knownCount = 0;
+  while (knownCount < arg.m_block_ids.size() && m_core.have_block(arg.m_block_ids[knownCount])) {
+    ++knownCount;
+  }
+
+  std::vector<Crypto::Hash> blockIds(arg.m_block_ids.begin() + knownCount, arg.m_block_ids.end());
+  if (!m_downloadScheduler.addBlockIds(context.m_connection_id, arg.start_height + static_cast<uint32_t>(knownCount), blockIds)) {
+    logger(Logging::DEBUGGING) << context << "sent chain entry that differs from the chain being downloaded, switching to idle state";
+    context.m_state = CryptoNoteConnectionContext::state_idle;
+    return 1;
   }
 
-  request_missing_objects(context, false);
+  request_missing_objects(context);
   return 1;
 }
 
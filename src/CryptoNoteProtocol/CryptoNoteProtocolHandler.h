@@ -10,6 +10,7 @@
 
 #include "CryptoNoteCore/ICore.h"
 
+#include "CryptoNoteProtocol/BlockDownloadScheduler.h"
 #include "CryptoNoteProtocol/CryptoNoteProtocolDefinitions.h"
 #include "CryptoNoteProtocol/CryptoNoteProtocolHandlerCommon.h"
 #include "CryptoNoteProtocol/ICryptoNoteProtocolObserver.h"
@@ -75,11 +76,16 @@ namespace CryptoNote
 
     //----------------------------------------------------------------------------------
     uint32_t get_current_blockchain_height();
-    bool request_missing_objects(CryptoNoteConnectionContext& context, bool check_having_blocks);
+    bool request_missing_objects(CryptoNoteConnectionContext& context);
+    bool requestSpan(CryptoNoteConnectionContext& context);
+    void requestChain(CryptoNoteConnectionContext& context);
+    void scheduleRequests();
+    void processReadySpans();
     bool on_connection_synchronized();
     void updateObservedHeight(uint32_t peerHeight, const CryptoNoteConnectionContext& context);
     void recalculateMaxObservedHeight(const CryptoNoteConnectionContext& context);
-    int processObjects(CryptoNoteConnectionContext& context, const std::vector<block_complete_entry>& blocks);
+    void decodeObjects(const std::vector<block_complete_entry>& entries, std::vector<PreparedBlock>& blocks) const;
+    int processObjects(const std::vector<PreparedBlock>& blocks);
     Logging::LoggerRef logger;
 
   private:
@@ -97,6 +103,8 @@ namespace CryptoNote
     uint32_t m_observedHeight;
 
     std::atomic<size_t> m_peersCount;
+    BlockDownloadScheduler m_downloadScheduler;
+    bool m_processingSpans;
     Tools::ObserverManager<ICryptoNoteProtocolObserver> m_observerManager;
   };
 }
@@ -86,30 +86,36 @@ void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threa
 void Miner::workerFunc(const Block& blockTemplate, difficulty_type difficulty, uint32_t nonceStep) {
   try {
     Block block = blockTemplate;
-    Crypto::cn_context cryptoContext;
+    // several nonces are hashed at once when the scratchpads of all the workers fit in L3 cache
+    Crypto::cn_context cryptoContext(Crypto::cn_slow_hash_preferred_ways(nonceStep));
+    Crypto::Hash hashes[Crypto::SLOW_HASH_MAX_WAYS];
+    uint32_t ways = static_cast<uint32_t>(cryptoContext.getWays());
+    m_logger(Logging::DEBUGGING) << "Worker hashes " << ways << " nonce(s) at once, scratchpads use " << Crypto::cn_page_mode_name(cryptoContext.getPageMode());
 
     while (m_state == MiningState::MINING_IN_PROGRESS) {
-      Crypto::Hash hash;
-      if (!get_block_longhash(cryptoContext, block, hash)) {
+      if (!get_block_longhashes(cryptoContext, block, nonceStep, ways, hashes)) {
         //error occured
         m_logger(Logging::DEBUGGING) << "calculating long hash error occured";
         m_state = MiningState::MINING_STOPPED;
         return;
       }
 
-      if (check_hash(hash, difficulty)) {
-        m_logger(Logging::INFO) << "Found block for difficulty " << difficulty;
+      for (uint32_t i = 0; i < ways; ++i) {
+        if (check_hash(hashes[i], difficulty)) {
+          m_logger(Logging::INFO) << "Found block for difficulty " << difficulty;
 
-        if (!setStateBlockFound()) {
-          m_logger(Logging::DEBUGGING) << "block is already found or mining stopped";
+          if (!setStateBlockFound()) {
+            m_logger(Logging::DEBUGGING) << "block is already found or mining stopped";
+            return;
+          }
+
+          m_block = block;
+          m_block.nonce += i * nonceStep;
           return;
         }
-
-        m_block = block;
-        return;
       }
 
-      block.nonce += nonceStep;
+      block.nonce += ways * nonceStep;
     }
   } catch (std::exception& e) {
     m_logger(Logging::ERROR) << "Miner got error: " << e.what();
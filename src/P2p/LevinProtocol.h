@@ -4,8 +4,9 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "CryptoNote.h"
-#include <Common/MemoryInputStream.h>
 #include <Common/VectorOutputStream.h>
 #include "Serialization/KVBinaryInputStreamSerializer.h"
 #include "Serialization/KVBinaryOutputStreamSerializer.h"
@@ -70,8 +71,7 @@ public:
   template <typename T>
   static bool decode(const BinaryArray& buf, T& value) {
     try {
-      Common::MemoryInputStream stream(buf.data(), buf.size());
-      KVBinaryInputStreamSerializer serializer(stream);
+      KVBinaryInputStreamSerializer serializer(Common::StringView(reinterpret_cast<const char*>(buf.data()), buf.size()));
       serialize(value, serializer);
     } catch (std::exception&) {
       return false;
@@ -82,11 +82,14 @@ public:
 
   template <typename T>
   static BinaryArray encode(const T& value) {
+    // messages of a type are mostly of similar size, so the size of the previous one is reserved
+    static std::atomic<size_t> previousSize(0);
+
     BinaryArray result;
-    KVBinaryOutputStreamSerializer serializer;
+    KVBinaryOutputStreamSerializer serializer(previousSize);
     serialize(const_cast<T&>(value), serializer);
-    Common::VectorOutputStream stream(result);
-    serializer.dump(stream);
+    serializer.dump(result);
+    previousSize = result.size();
     return result;
   }
 
@@ -265,6 +265,15 @@ struct COMMAND_RPC_GET_INFO {
     uint64_t white_peerlist_size;
     uint64_t grey_peerlist_size;
     uint32_t last_known_block_index;
+    uint64_t blockchain_shared_locks;
+    uint64_t blockchain_exclusive_locks;
+    uint64_t blockchain_contended_shared_locks;
+    uint64_t blockchain_contended_exclusive_locks;
+    uint64_t blockchain_shared_lock_wait_us;
+    uint64_t blockchain_exclusive_lock_wait_us;
+    uint64_t signature_cache_hits;
+    uint64_t signature_cache_misses;
+    uint64_t signature_cache_size;
 
     void serialize(ISerializer &s) {
       KV_MEMBER(status)
@@ -278,6 +287,15 @@ struct COMMAND_RPC_GET_INFO {
       KV_MEMBER(white_peerlist_size)
       KV_MEMBER(grey_peerlist_size)
       KV_MEMBER(last_known_block_index)
+      KV_MEMBER(blockchain_shared_locks)
+      KV_MEMBER(blockchain_exclusive_locks)
+      KV_MEMBER(blockchain_contended_shared_locks)
+      KV_MEMBER(blockchain_contended_exclusive_locks)
+      KV_MEMBER(blockchain_shared_lock_wait_us)
+      KV_MEMBER(blockchain_exclusive_lock_wait_us)
+      KV_MEMBER(signature_cache_hits)
+      KV_MEMBER(signature_cache_misses)
+      KV_MEMBER(signature_cache_size)
     }
   };
 };
@@ -321,6 +321,17 @@ bool RpcServer::on_get_info(const COMMAND_RPC_GET_INFO::request& req, COMMAND_RP
   res.white_peerlist_size = m_p2p.getPeerlistManager().get_white_peers_count();
   res.grey_peerlist_size = m_p2p.getPeerlistManager().get_gray_peers_count();
   res.last_known_block_index = std::max(static_cast<uint32_t>(1), m_protocolQuery.getObservedHeight()) - 1;
+  Common::ReadWriteLockStatistics lockStatistics = m_core.getBlockchainLockStatistics();
+  res.blockchain_shared_locks = lockStatistics.sharedLocks;
+  res.blockchain_exclusive_locks = lockStatistics.exclusiveLocks;
+  res.blockchain_contended_shared_locks = lockStatistics.contendedSharedLocks;
+  res.blockchain_contended_exclusive_locks = lockStatistics.contendedExclusiveLocks;
+  res.blockchain_shared_lock_wait_us = lockStatistics.sharedWaitMicroseconds;
+  res.blockchain_exclusive_lock_wait_us = lockStatistics.exclusiveWaitMicroseconds;
+  SignatureCacheStatistics signatureCacheStatistics = m_core.getSignatureCacheStatistics();
+  res.signature_cache_hits = signatureCacheStatistics.hits;
+  res.signature_cache_misses = signatureCacheStatistics.misses;
+  res.signature_cache_size = signatureCacheStatistics.size;
   res.status = CORE_RPC_STATUS_OK;
   return true;
 }
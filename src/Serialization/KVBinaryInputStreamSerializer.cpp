@@ -8,7 +8,6 @@
 #include <cassert>
 #include <cstring>
 #include <stdexcept>
-#include <Common/StreamTools.h>
 #include "KVBinaryCommon.h"
 
 using namespace Common;
@@ -16,27 +15,46 @@ using namespace CryptoNote;
 
 namespace {
 
-template <typename T>
-T readPod(Common::IInputStream& s) {
-  T v;
-  read(s, &v, sizeof(T));
-  return v;
+// Size of a value of the type, 0 for strings and objects
+size_t podSize(uint8_t type) {
+  switch (type) {
+  case BIN_KV_SERIALIZE_TYPE_INT64:  return sizeof(int64_t);
+  case BIN_KV_SERIALIZE_TYPE_INT32:  return sizeof(int32_t);
+  case BIN_KV_SERIALIZE_TYPE_INT16:  return sizeof(int16_t);
+  case BIN_KV_SERIALIZE_TYPE_INT8:   return sizeof(int8_t);
+  case BIN_KV_SERIALIZE_TYPE_UINT64: return sizeof(uint64_t);
+  case BIN_KV_SERIALIZE_TYPE_UINT32: return sizeof(uint32_t);
+  case BIN_KV_SERIALIZE_TYPE_UINT16: return sizeof(uint16_t);
+  case BIN_KV_SERIALIZE_TYPE_UINT8:  return sizeof(uint8_t);
+  case BIN_KV_SERIALIZE_TYPE_DOUBLE: return sizeof(double);
+  case BIN_KV_SERIALIZE_TYPE_BOOL:   return sizeof(uint8_t);
+  case BIN_KV_SERIALIZE_TYPE_STRING:
+  case BIN_KV_SERIALIZE_TYPE_OBJECT:
+    return 0;
+  default:
+    throw std::runtime_error("Unknown data type");
+  }
 }
 
-template <typename T, typename JsonT = T>
-JsonValue readPodJson(Common::IInputStream& s) {
-  JsonValue jv;
-  jv = static_cast<JsonT>(readPod<T>(s));
-  return jv;
+void skip(const char*& position, const char* end, size_t size) {
+  if (static_cast<size_t>(end - position) < size) {
+    throw std::runtime_error("Unexpected end of binary storage");
+  }
+
+  position += size;
 }
 
 template <typename T>
-JsonValue readIntegerJson(Common::IInputStream& s) {
-  return readPodJson<T, int64_t>(s);
+T readPod(const char*& position, const char* end) {
+  const char* data = position;
+  skip(position, end, sizeof(T));
+  T v;
+  memcpy(&v, data, sizeof(T));
+  return v;
 }
 
-size_t readVarint(Common::IInputStream& s) {
-  uint8_t b = read<uint8_t>(s);
+size_t readVarint(const char*& position, const char* end) {
+  uint8_t b = readPod<uint8_t>(position, end);
   uint8_t size_mask = b & PORTABLE_RAW_SIZE_MARK_MASK;
   size_t bytesLeft = 0;
 
@@ -58,7 +76,7 @@ size_t readVarint(Common::IInputStream& s) {
   size_t value = b;
 
   for (size_t i = 1; i <= bytesLeft; ++i) {
-    size_t n = read<uint8_t>(s);
+    size_t n = readPod<uint8_t>(position, end);
     value |= n << (i * 8);
   }
 
@@ -66,93 +84,241 @@ size_t readVarint(Common::IInputStream& s) {
   return value;
 }
 
-std::string readString(Common::IInputStream& s) {
-  auto size = readVarint(s);
-  std::string str;
-  str.resize(size);
-  if (size) {
-    read(s, &str[0], size);
+void skipSection(const char*& position, const char* end);
+
+void skipValues(const char*& position, const char* end, uint8_t type, size_t count) {
+  if (type == BIN_KV_SERIALIZE_TYPE_STRING) {
+    while (count--) {
+      skip(position, end, readVarint(position, end));
+    }
+  } else if (type == BIN_KV_SERIALIZE_TYPE_OBJECT) {
+    while (count--) {
+      skipSection(position, end);
+    }
+  } else {
+    size_t size = podSize(type);
+    if (count > static_cast<size_t>(end - position) / size) {
+      throw std::runtime_error("Unexpected end of binary storage");
+    }
+
+    position += count * size;
   }
-  return str;
 }
 
-JsonValue readStringJson(Common::IInputStream& s) {
-  return JsonValue(readString(s));
+void skipSection(const char*& position, const char* end) {
+  size_t count = readVarint(position, end);
+
+  while (count--) {
+    skip(position, end, readPod<uint8_t>(position, end));
+    uint8_t type = readPod<uint8_t>(position, end);
+    if (type & BIN_KV_SERIALIZE_FLAG_ARRAY) {
+      size_t itemCount = readVarint(position, end);
+      skipValues(position, end, type & ~BIN_KV_SERIALIZE_FLAG_ARRAY, itemCount);
+    } else {
+      skipValues(position, end, type, 1);
+    }
+  }
 }
 
-void readName(Common::IInputStream& s, std::string& name) {
-  uint8_t len = readPod<uint8_t>(s);
-  if (len) {
-    name.resize(len);
-    read(s, &name[0], len);
+}
+
+KVBinaryInputStreamSerializer::KVBinaryInputStreamSerializer(Common::IInputStream& strm) {
+  char chunk[4096];
+  size_t size;
+  while ((size = strm.readSome(chunk, sizeof(chunk))) != 0) {
+    m_buffer.append(chunk, size);
   }
+
+  m_end = m_buffer.data() + m_buffer.size();
+  parseRoot(m_buffer.data());
 }
 
-JsonValue loadValue(Common::IInputStream& stream, uint8_t type);
-JsonValue loadSection(Common::IInputStream& stream);
-JsonValue loadEntry(Common::IInputStream& stream);
-JsonValue loadArray(Common::IInputStream& stream, uint8_t itemType);
+KVBinaryInputStreamSerializer::KVBinaryInputStreamSerializer(Common::StringView data) : m_end(data.getData() + data.getSize()) {
+  parseRoot(data.getData());
+}
 
+ISerializer::SerializerType KVBinaryInputStreamSerializer::type() const {
+  return ISerializer::INPUT;
+}
 
-JsonValue loadSection(Common::IInputStream& stream) {
-  JsonValue sec(JsonValue::OBJECT);
-  size_t count = readVarint(stream);
-  std::string name;
+bool KVBinaryInputStreamSerializer::beginObject(Common::StringView name) {
+  Level& parent = m_stack.back();
 
-  while (count--) {
-    readName(stream, name);
-    sec.insert(name, loadEntry(stream));
+  if (parent.isArray) {
+    if (parent.itemType != BIN_KV_SERIALIZE_TYPE_OBJECT) {
+      throw std::runtime_error("Array item is not an object");
+    }
+
+    if (parent.itemIndex == parent.itemCount) {
+      throw std::runtime_error("Array index out of range");
+    }
+
+    ++parent.itemIndex;
+    const char* position = parent.position;
+    // parent is invalidated by pushObject
+    const char* next = pushObject(position);
+    m_stack[m_stack.size() - 2].position = next;
+    return true;
+  }
+
+  const Entry* entry = findEntry(name);
+  if (entry == nullptr) {
+    return false;
+  }
+
+  if (entry->type != BIN_KV_SERIALIZE_TYPE_OBJECT) {
+    throw std::runtime_error("Value is not an object");
   }
 
-  return sec;
+  pushObject(entry->value);
+  return true;
+}
+
+void KVBinaryInputStreamSerializer::endObject() {
+  assert(!m_stack.empty() && !m_stack.back().isArray);
+
+  m_entries.resize(m_stack.back().firstEntry);
+  m_stack.pop_back();
+}
+
+bool KVBinaryInputStreamSerializer::beginArray(size_t& size, Common::StringView name) {
+  if (m_stack.back().isArray) {
+    throw std::runtime_error("Nested arrays are not supported");
+  }
+
+  const Entry* entry = findEntry(name);
+  if (entry == nullptr) {
+    size = 0;
+    return false;
+  }
+
+  if ((entry->type & BIN_KV_SERIALIZE_FLAG_ARRAY) == 0) {
+    throw std::runtime_error("Value is not an array");
+  }
+
+  Level level;
+  level.isArray = true;
+  level.firstEntry = m_entries.size();
+  level.itemType = entry->type & ~BIN_KV_SERIALIZE_FLAG_ARRAY;
+  level.position = entry->value;
+  level.itemCount = readVarint(level.position, m_end);
+  level.itemIndex = 0;
+  m_stack.push_back(level);
+
+  size = level.itemCount;
+  return true;
 }
 
-JsonValue loadValue(Common::IInputStream& stream, uint8_t type) {
+void KVBinaryInputStreamSerializer::endArray() {
+  assert(!m_stack.empty() && m_stack.back().isArray);
+
+  m_stack.pop_back();
+}
+
+template <typename T>
+bool KVBinaryInputStreamSerializer::readNumber(Common::StringView name, T& value) {
+  uint8_t type;
+  const char* position = nextValue(name, type);
+  if (position == nullptr) {
+    return false;
+  }
+
   switch (type) {
-  case BIN_KV_SERIALIZE_TYPE_INT64:  return readIntegerJson<int64_t>(stream);
-  case BIN_KV_SERIALIZE_TYPE_INT32:  return readIntegerJson<int32_t>(stream);
-  case BIN_KV_SERIALIZE_TYPE_INT16:  return readIntegerJson<int16_t>(stream);
-  case BIN_KV_SERIALIZE_TYPE_INT8:   return readIntegerJson<int8_t>(stream);
-  case BIN_KV_SERIALIZE_TYPE_UINT64: return readIntegerJson<uint64_t>(stream);
-  case BIN_KV_SERIALIZE_TYPE_UINT32: return readIntegerJson<uint32_t>(stream);
-  case BIN_KV_SERIALIZE_TYPE_UINT16: return readIntegerJson<uint16_t>(stream);
-  case BIN_KV_SERIALIZE_TYPE_UINT8:  return readIntegerJson<uint8_t>(stream);
-  case BIN_KV_SERIALIZE_TYPE_DOUBLE: return readPodJson<double>(stream);
-  case BIN_KV_SERIALIZE_TYPE_BOOL:   return JsonValue(read<uint8_t>(stream) != 0);
-  case BIN_KV_SERIALIZE_TYPE_STRING: return readStringJson(stream);
-  case BIN_KV_SERIALIZE_TYPE_OBJECT: return loadSection(stream);
-  case BIN_KV_SERIALIZE_TYPE_ARRAY:  return loadArray(stream, type);
+  case BIN_KV_SERIALIZE_TYPE_INT64:  value = static_cast<T>(readPod<int64_t>(position, m_end)); break;
+  case BIN_KV_SERIALIZE_TYPE_INT32:  value = static_cast<T>(readPod<int32_t>(position, m_end)); break;
+  case BIN_KV_SERIALIZE_TYPE_INT16:  value = static_cast<T>(readPod<int16_t>(position, m_end)); break;
+  case BIN_KV_SERIALIZE_TYPE_INT8:   value = static_cast<T>(readPod<int8_t>(position, m_end)); break;
+  case BIN_KV_SERIALIZE_TYPE_UINT64: value = static_cast<T>(readPod<uint64_t>(position, m_end)); break;
+  case BIN_KV_SERIALIZE_TYPE_UINT32: value = static_cast<T>(readPod<uint32_t>(position, m_end)); break;
+  case BIN_KV_SERIALIZE_TYPE_UINT16: value = static_cast<T>(readPod<uint16_t>(position, m_end)); break;
+  case BIN_KV_SERIALIZE_TYPE_UINT8:  value = static_cast<T>(readPod<uint8_t>(position, m_end)); break;
+  case BIN_KV_SERIALIZE_TYPE_DOUBLE: value = static_cast<T>(readPod<double>(position, m_end)); break;
   default:
-    throw std::runtime_error("Unknown data type");
-    break;
+    throw std::runtime_error("Value is not a number");
   }
+
+  return true;
 }
 
-JsonValue loadEntry(Common::IInputStream& stream) {
-  uint8_t type = readPod<uint8_t>(stream);
+bool KVBinaryInputStreamSerializer::operator()(uint8_t& value, Common::StringView name) {
+  return readNumber(name, value);
+}
+
+bool KVBinaryInputStreamSerializer::operator()(int16_t& value, Common::StringView name) {
+  return readNumber(name, value);
+}
+
+bool KVBinaryInputStreamSerializer::operator()(uint16_t& value, Common::StringView name) {
+  return readNumber(name, value);
+}
+
+bool KVBinaryInputStreamSerializer::operator()(int32_t& value, Common::StringView name) {
+  return readNumber(name, value);
+}
 
-  if (type & BIN_KV_SERIALIZE_FLAG_ARRAY) {
-    type &= ~BIN_KV_SERIALIZE_FLAG_ARRAY;
-    return loadArray(stream, type);
+bool KVBinaryInputStreamSerializer::operator()(uint32_t& value, Common::StringView name) {
+  return readNumber(name, value);
+}
+
+bool KVBinaryInputStreamSerializer::operator()(int64_t& value, Common::StringView name) {
+  return readNumber(name, value);
+}
+
+bool KVBinaryInputStreamSerializer::operator()(uint64_t& value, Common::StringView name) {
+  return readNumber(name, value);
+}
+
+bool KVBinaryInputStreamSerializer::operator()(double& value, Common::StringView name) {
+  return readNumber(name, value);
+}
+
+bool KVBinaryInputStreamSerializer::operator()(bool& value, Common::StringView name) {
+  uint8_t type;
+  const char* position = nextValue(name, type);
+  if (position == nullptr) {
+    return false;
+  }
+
+  if (type != BIN_KV_SERIALIZE_TYPE_BOOL) {
+    throw std::runtime_error("Value is not a bool");
   }
 
-  return loadValue(stream, type);
+  value = readPod<uint8_t>(position, m_end) != 0;
+  return true;
 }
 
-JsonValue loadArray(Common::IInputStream& stream, uint8_t itemType) {
-  JsonValue arr(JsonValue::ARRAY);
-  size_t count = readVarint(stream);
+bool KVBinaryInputStreamSerializer::operator()(std::string& value, Common::StringView name) {
+  const char* data;
+  size_t size;
+  if (!readString(name, data, size)) {
+    return false;
+  }
 
-  while (count--) {
-    arr.pushBack(loadValue(stream, itemType));
+  value.assign(data, size);
+  return true;
+}
+
+bool KVBinaryInputStreamSerializer::binary(void* value, size_t size, Common::StringView name) {
+  const char* data;
+  size_t dataSize;
+  if (!readString(name, data, dataSize)) {
+    return false;
   }
 
-  return arr;
+  if (dataSize != size) {
+    throw std::runtime_error("Binary block size mismatch");
+  }
+
+  memcpy(value, data, size);
+  return true;
 }
 
+bool KVBinaryInputStreamSerializer::binary(std::string& value, Common::StringView name) {
+  return (*this)(value, name); // load as string
+}
 
-JsonValue parseBinary(Common::IInputStream& stream) {
-  auto hdr = readPod<KVBinaryStorageBlockHeader>(stream);
+void KVBinaryInputStreamSerializer::parseRoot(const char* begin) {
+  auto hdr = readPod<KVBinaryStorageBlockHeader>(begin, m_end);
 
   if (
     hdr.m_signature_a != PORTABLE_STORAGE_SIGNATUREA ||
@@ -164,30 +330,90 @@ JsonValue parseBinary(Common::IInputStream& stream) {
     throw std::runtime_error("Unknown binary storage format version");
   }
 
-  return loadSection(stream);
+  pushObject(begin);
 }
 
+// Indexes the entries of the section at position, returns the position after the section
+const char* KVBinaryInputStreamSerializer::pushObject(const char* position) {
+  Level level;
+  level.isArray = false;
+  level.firstEntry = m_entries.size();
+  level.itemType = BIN_KV_SERIALIZE_TYPE_OBJECT;
+  level.itemCount = 0;
+  level.itemIndex = 0;
+  level.position = position;
+
+  size_t count = readVarint(position, m_end);
+  while (count--) {
+    Entry entry;
+    size_t nameSize = readPod<uint8_t>(position, m_end);
+    entry.name = Common::StringView(position, nameSize);
+    skip(position, m_end, nameSize);
+    entry.type = readPod<uint8_t>(position, m_end);
+    entry.value = position;
+
+    if (entry.type & BIN_KV_SERIALIZE_FLAG_ARRAY) {
+      size_t itemCount = readVarint(position, m_end);
+      skipValues(position, m_end, entry.type & ~BIN_KV_SERIALIZE_FLAG_ARRAY, itemCount);
+    } else {
+      skipValues(position, m_end, entry.type, 1);
+    }
+
+    m_entries.push_back(entry);
+  }
+
+  m_stack.push_back(level);
+  return position;
 }
 
-KVBinaryInputStreamSerializer::KVBinaryInputStreamSerializer(Common::IInputStream& strm) : JsonInputValueSerializer(parseBinary(strm)) {
+const KVBinaryInputStreamSerializer::Entry* KVBinaryInputStreamSerializer::findEntry(Common::StringView name) const {
+  auto begin = m_entries.begin() + m_stack.back().firstEntry;
+  auto it = std::find_if(begin, m_entries.end(), [&](const Entry& entry) { return entry.name == name; });
+  return it == m_entries.end() ? nullptr : &*it;
 }
 
-bool KVBinaryInputStreamSerializer::binary(void* value, size_t size, Common::StringView name) {
-  std::string str;
+// Returns the position of the next array item or of the value of the entry with the name, nullptr if there is no such entry
+const char* KVBinaryInputStreamSerializer::nextValue(Common::StringView name, uint8_t& type) {
+  Level& level = m_stack.back();
 
-  if (!(*this)(str, name)) {
-    return false;
+  if (level.isArray) {
+    if (level.itemIndex == level.itemCount) {
+      throw std::runtime_error("Array index out of range");
+    }
+
+    const char* position = level.position;
+    skipValues(level.position, m_end, level.itemType, 1);
+    ++level.itemIndex;
+    type = level.itemType;
+    return position;
   }
 
-  if (str.size() != size) {
-    throw std::runtime_error("Binary block size mismatch");
+  const Entry* entry = findEntry(name);
+  if (entry == nullptr) {
+    return nullptr;
   }
 
-  memcpy(value, str.data(), size);
-  return true;
-}
+  if (entry->type & BIN_KV_SERIALIZE_FLAG_ARRAY) {
+    throw std::runtime_error("Value is an array");
+  }
 
-bool KVBinaryInputStreamSerializer::binary(std::string& value, Common::StringView name) {
-  return (*this)(value, name); // load as string
+  type = entry->type;
+  return entry->value;
 }
 
+bool KVBinaryInputStreamSerializer::readString(Common::StringView name, const char*& data, size_t& size) {
+  uint8_t type;
+  const char* position = nextValue(name, type);
+  if (position == nullptr) {
+    return false;
+  }
+
+  if (type != BIN_KV_SERIALIZE_TYPE_STRING) {
+    throw std::runtime_error("Value is not a string");
+  }
+
+  size = readVarint(position, m_end);
+  data = position;
+  skip(position, m_end, size);
+  return true;
+}
@@ -4,18 +4,81 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include <Common/IInputStream.h>
 #include "ISerializer.h"
-#include "JsonInputValueSerializer.h"
 
 namespace CryptoNote {
 
-class KVBinaryInputStreamSerializer : public JsonInputValueSerializer {
+// Decodes straight from the serialized data. Each object being read gets an index of its keys, so keys may come in
+// any order, and values are read from the data only when asked for, without building a tree of all values first.
+class KVBinaryInputStreamSerializer : public ISerializer {
 public:
+  // Reads the rest of the stream into a buffer of the serializer
   KVBinaryInputStreamSerializer(Common::IInputStream& strm);
+  // Reads from data in place, data must outlive the serializer
+  KVBinaryInputStreamSerializer(Common::StringView data);
+  KVBinaryInputStreamSerializer(const KVBinaryInputStreamSerializer&) = delete;
+  KVBinaryInputStreamSerializer& operator=(const KVBinaryInputStreamSerializer&) = delete;
+
+  virtual SerializerType type() const override;
+
+  virtual bool beginObject(Common::StringView name) override;
+  virtual void endObject() override;
 
+  virtual bool beginArray(size_t& size, Common::StringView name) override;
+  virtual void endArray() override;
+
+  virtual bool operator()(uint8_t& value, Common::StringView name) override;
+  virtual bool operator()(int16_t& value, Common::StringView name) override;
+  virtual bool operator()(uint16_t& value, Common::StringView name) override;
+  virtual bool operator()(int32_t& value, Common::StringView name) override;
+  virtual bool operator()(uint32_t& value, Common::StringView name) override;
+  virtual bool operator()(int64_t& value, Common::StringView name) override;
+  virtual bool operator()(uint64_t& value, Common::StringView name) override;
+  virtual bool operator()(double& value, Common::StringView name) override;
+  virtual bool operator()(bool& value, Common::StringView name) override;
+  virtual bool operator()(std::string& value, Common::StringView name) override;
   virtual bool binary(void* value, size_t size, Common::StringView name) override;
   virtual bool binary(std::string& value, Common::StringView name) override;
+
+  template<typename T>
+  bool operator()(T& value, Common::StringView name) {
+    return ISerializer::operator()(value, name);
+  }
+
+private:
+  struct Entry {
+    Common::StringView name;
+    uint8_t type;
+    const char* value;
+  };
+
+  // An object being read has its entries at the end of m_entries, an array being read is walked item by item
+  struct Level {
+    bool isArray;
+    size_t firstEntry;
+    uint8_t itemType;
+    size_t itemCount;
+    size_t itemIndex;
+    const char* position;
+  };
+
+  std::string m_buffer;
+  const char* m_end;
+  std::vector<Entry> m_entries;
+  std::vector<Level> m_stack;
+
+  void parseRoot(const char* begin);
+  const char* pushObject(const char* position);
+  const Entry* findEntry(Common::StringView name) const;
+  const char* nextValue(Common::StringView name, uint8_t& type);
+  bool readString(Common::StringView name, const char*& data, size_t& size);
+
+  template <typename T>
+  bool readNumber(Common::StringView name, T& value);
 };
 
 }
@@ -5,7 +5,10 @@
 #include "KVBinaryOutputStreamSerializer.h"
 #include "KVBinaryCommon.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
 #include <Common/StreamTools.h>
 
@@ -14,41 +17,30 @@ using namespace CryptoNote;
 
 namespace {
 
-template <typename T>
-void writePod(IOutputStream& s, const T& value) {
-  write(s, &value, sizeof(T));
-}
-
-template<class T>
-size_t packVarint(IOutputStream& s, uint8_t type_or, size_t pv) {
-  T v = static_cast<T>(pv << 2);
-  v |= type_or;
-  write(s, &v, sizeof(T));
-  return sizeof(T);
-}
-
-void writeElementName(IOutputStream& s, Common::StringView name) {
-  if (name.getSize() > std::numeric_limits<uint8_t>::max()) {
-    throw std::runtime_error("Element name is too long");
-  }
-
-  uint8_t len = static_cast<uint8_t>(name.getSize());
-  write(s, &len, sizeof(len));
-  write(s, name.getData(), len);
-}
-
-size_t writeArraySize(IOutputStream& s, size_t val) {
-  if (val <= 63) {
-    return packVarint<uint8_t>(s, PORTABLE_RAW_SIZE_MARK_BYTE, val);
-  } else if (val <= 16383) {
-    return packVarint<uint16_t>(s, PORTABLE_RAW_SIZE_MARK_WORD, val);
-  } else if (val <= 1073741823) {
-    return packVarint<uint32_t>(s, PORTABLE_RAW_SIZE_MARK_DWORD, val);
+const size_t COUNT_PLACEHOLDER_SIZE = 1;
+
+// Writes pv with the size mark to data, returns the number of bytes written, at most 8
+size_t packVarint(uint8_t* data, size_t pv) {
+  if (pv <= 63) {
+    uint8_t v = static_cast<uint8_t>((pv << 2) | PORTABLE_RAW_SIZE_MARK_BYTE);
+    memcpy(data, &v, sizeof(v));
+    return sizeof(v);
+  } else if (pv <= 16383) {
+    uint16_t v = static_cast<uint16_t>((pv << 2) | PORTABLE_RAW_SIZE_MARK_WORD);
+    memcpy(data, &v, sizeof(v));
+    return sizeof(v);
+  } else if (pv <= 1073741823) {
+    uint32_t v = static_cast<uint32_t>((pv << 2) | PORTABLE_RAW_SIZE_MARK_DWORD);
+    memcpy(data, &v, sizeof(v));
+    return sizeof(v);
   } else {
-    if (val > 4611686018427387903) {
+    if (pv > 4611686018427387903) {
       throw std::runtime_error("failed to pack varint - too big amount");
     }
-    return packVarint<uint64_t>(s, PORTABLE_RAW_SIZE_MARK_INT64, val);
+
+    uint64_t v = (static_cast<uint64_t>(pv) << 2) | PORTABLE_RAW_SIZE_MARK_INT64;
+    memcpy(data, &v, sizeof(v));
+    return sizeof(v);
   }
 }
 
@@ -56,137 +48,160 @@ size_t writeArraySize(IOutputStream& s, size_t val) {
 
 namespace CryptoNote {
 
-KVBinaryOutputStreamSerializer::KVBinaryOutputStreamSerializer() {
-  beginObject(std::string());
-}
-
-void KVBinaryOutputStreamSerializer::dump(IOutputStream& target) {
-  assert(m_objectsStack.size() == 1);
-  assert(m_stack.size() == 1);
+KVBinaryOutputStreamSerializer::KVBinaryOutputStreamSerializer(size_t sizeEstimate) {
+  m_buffer.reserve(std::max(sizeEstimate, sizeof(KVBinaryStorageBlockHeader) + COUNT_PLACEHOLDER_SIZE));
 
   KVBinaryStorageBlockHeader hdr;
   hdr.m_signature_a = PORTABLE_STORAGE_SIGNATUREA;
   hdr.m_signature_b = PORTABLE_STORAGE_SIGNATUREB;
   hdr.m_ver = PORTABLE_STORAGE_FORMAT_VER;
+  write(&hdr, sizeof(hdr));
+
+  m_stack.push_back({ State::Object, 0, m_buffer.size() });
+  m_buffer.resize(m_buffer.size() + COUNT_PLACEHOLDER_SIZE);
+}
+
+void KVBinaryOutputStreamSerializer::dump(IOutputStream& target) {
+  assert(m_stack.size() == 1);
+
+  const Level& root = m_stack.front();
+  uint8_t count[8];
+  Common::write(target, m_buffer.data(), root.offset);
+  Common::write(target, count, packVarint(count, root.count));
+  size_t bodyOffset = root.offset + COUNT_PLACEHOLDER_SIZE;
+  Common::write(target, m_buffer.data() + bodyOffset, m_buffer.size() - bodyOffset);
+}
+
+void KVBinaryOutputStreamSerializer::dump(std::vector<uint8_t>& target) {
+  assert(m_stack.size() == 1);
 
-  Common::write(target, &hdr, sizeof(hdr));
-  writeArraySize(target, m_stack.front().count);
-  write(target, stream().data(), stream().size());
+  writeCount(m_stack.front().offset, m_stack.front().count);
+  m_stack.clear();
+  target = std::move(m_buffer);
 }
 
 ISerializer::SerializerType KVBinaryOutputStreamSerializer::type() const {
   return ISerializer::OUTPUT;
 }
 
+template <typename T>
+void KVBinaryOutputStreamSerializer::writePod(uint8_t type, const T& value, Common::StringView name) {
+  writeElementPrefix(type, name);
+  write(&value, sizeof(T));
+}
+
+void KVBinaryOutputStreamSerializer::write(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+}
+
 bool KVBinaryOutputStreamSerializer::beginObject(Common::StringView name) {
-  checkArrayPreamble(BIN_KV_SERIALIZE_TYPE_OBJECT);
- 
-  m_stack.push_back(Level(name));
-  m_objectsStack.push_back(MemoryStream());
+  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_OBJECT, name);
 
+  m_stack.push_back({ State::Object, 0, m_buffer.size() });
+  m_buffer.resize(m_buffer.size() + COUNT_PLACEHOLDER_SIZE);
   return true;
 }
 
 void KVBinaryOutputStreamSerializer::endObject() {
-  assert(m_objectsStack.size());
+  assert(m_stack.size() > 1);
 
-  auto level = std::move(m_stack.back());
+  Level level = m_stack.back();
   m_stack.pop_back();
-
-  auto objStream = std::move(m_objectsStack.back());
-  m_objectsStack.pop_back();
-
-  auto& out = stream();
-
-  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_OBJECT, level.name);
-
-  writeArraySize(out, level.count);
-  write(out, objStream.data(), objStream.size());
+  writeCount(level.offset, level.count);
 }
 
 bool KVBinaryOutputStreamSerializer::beginArray(size_t& size, Common::StringView name) {
-  m_stack.push_back(Level(name, size));
+  if (name.getSize() > std::numeric_limits<uint8_t>::max()) {
+    throw std::runtime_error("Element name is too long");
+  }
+
+  // the item type is filled in by the first item
+  m_stack.push_back({ State::ArrayPrefix, size, m_buffer.size() });
+  uint8_t len = static_cast<uint8_t>(name.getSize());
+  write(&len, sizeof(len));
+  write(name.getData(), len);
+  m_buffer.push_back(0);
+
+  uint8_t count[8];
+  write(count, packVarint(count, size));
   return true;
 }
 
 void KVBinaryOutputStreamSerializer::endArray() {
-  bool validArray = m_stack.back().state == State::Array;
+  Level level = m_stack.back();
   m_stack.pop_back();
 
-  if (m_stack.back().state == State::Object && validArray) {
-    ++m_stack.back().count;
+  if (level.state == State::Array) {
+    if (m_stack.back().state == State::Object) {
+      ++m_stack.back().count;
+    }
+  } else {
+    m_buffer.resize(level.offset);
   }
 }
 
 bool KVBinaryOutputStreamSerializer::operator()(uint8_t& value, Common::StringView name) {
-  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_UINT8, name);
-  writePod(stream(), value);
+  writePod(BIN_KV_SERIALIZE_TYPE_UINT8, value, name);
   return true;
 }
 
 bool KVBinaryOutputStreamSerializer::operator()(uint16_t& value, Common::StringView name) {
-  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_UINT16, name);
-  writePod(stream(), value);
+  writePod(BIN_KV_SERIALIZE_TYPE_UINT16, value, name);
   return true;
 }
 
 bool KVBinaryOutputStreamSerializer::operator()(int16_t& value, Common::StringView name) {
-  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_INT16, name);
-  writePod(stream(), value);
+  writePod(BIN_KV_SERIALIZE_TYPE_INT16, value, name);
   return true;
 }
 
 bool KVBinaryOutputStreamSerializer::operator()(uint32_t& value, Common::StringView name) {
-  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_UINT32, name);
-  writePod(stream(), value);
+  writePod(BIN_KV_SERIALIZE_TYPE_UINT32, value, name);
   return true;
 }
 
 bool KVBinaryOutputStreamSerializer::operator()(int32_t& value, Common::StringView name) {
-  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_INT32, name);
-  writePod(stream(), value);
+  writePod(BIN_KV_SERIALIZE_TYPE_INT32, value, name);
   return true;
 }
 
 bool KVBinaryOutputStreamSerializer::operator()(int64_t& value, Common::StringView name) {
-  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_INT64, name);
-  writePod(stream(), value);
+  writePod(BIN_KV_SERIALIZE_TYPE_INT64, value, name);
   return true;
 }
 
 bool KVBinaryOutputStreamSerializer::operator()(uint64_t& value, Common::StringView name) {
-  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_UINT64, name);
-  writePod(stream(), value);
+  writePod(BIN_KV_SERIALIZE_TYPE_UINT64, value, name);
   return true;
 }
 
 bool KVBinaryOutputStreamSerializer::operator()(bool& value, Common::StringView name) {
-  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_BOOL, name);
-  writePod(stream(), value);
+  writePod(BIN_KV_SERIALIZE_TYPE_BOOL, value, name);
   return true;
 }
 
 bool KVBinaryOutputStreamSerializer::operator()(double& value, Common::StringView name) {
-  writeElementPrefix(BIN_KV_SERIALIZE_TYPE_DOUBLE, name);
-  writePod(stream(), value);
+  writePod(BIN_KV_SERIALIZE_TYPE_DOUBLE, value, name);
   return true;
 }
 
 bool KVBinaryOutputStreamSerializer::operator()(std::string& value, Common::StringView name) {
   writeElementPrefix(BIN_KV_SERIALIZE_TYPE_STRING, name);
 
-  auto& out = stream();
-  writeArraySize(out, value.size());
-  write(out, value.data(), value.size());
+  uint8_t size[8];
+  write(size, packVarint(size, value.size()));
+  write(value.data(), value.size());
   return true;
 }
 
 bool KVBinaryOutputStreamSerializer::binary(void* value, size_t size, Common::StringView name) {
   if (size > 0) {
     writeElementPrefix(BIN_KV_SERIALIZE_TYPE_STRING, name);
-    auto& out = stream();
-    writeArraySize(out, size);
-    write(out, value, size);
+
+    uint8_t packedSize[8];
+    write(packedSize, packVarint(packedSize, size));
+    write(value, size);
   }
   return true;
 }
@@ -195,17 +210,22 @@ bool KVBinaryOutputStreamSerializer::binary(std::string& value, Common::StringVi
   return binary(const_cast<char*>(value.data()), value.size(), name);
 }
 
-void KVBinaryOutputStreamSerializer::writeElementPrefix(uint8_t type, Common::StringView name) {  
+void KVBinaryOutputStreamSerializer::writeElementPrefix(uint8_t type, Common::StringView name) {
   assert(m_stack.size());
 
   checkArrayPreamble(type);
   Level& level = m_stack.back();
-  
+
   if (level.state != State::Array) {
     if (!name.isEmpty()) {
-      auto& s = stream();
-      writeElementName(s, name);
-      write(s, &type, 1);
+      if (name.getSize() > std::numeric_limits<uint8_t>::max()) {
+        throw std::runtime_error("Element name is too long");
+      }
+
+      uint8_t len = static_cast<uint8_t>(name.getSize());
+      write(&len, sizeof(len));
+      write(name.getData(), len);
+      write(&type, 1);
     }
     ++level.count;
   }
@@ -219,19 +239,21 @@ void KVBinaryOutputStreamSerializer::checkArrayPreamble(uint8_t type) {
   Level& level = m_stack.back();
 
   if (level.state == State::ArrayPrefix) {
-    auto& s = stream();
-    writeElementName(s, level.name);
-    char c = BIN_KV_SERIALIZE_FLAG_ARRAY | type;
-    write(s, &c, 1);
-    writeArraySize(s, level.count);
+    size_t typeOffset = level.offset + 1 + m_buffer[level.offset];
+    m_buffer[typeOffset] = BIN_KV_SERIALIZE_FLAG_ARRAY | type;
     level.state = State::Array;
   }
 }
 
+// Replaces the count placeholder at offset, everything after it is moved if the count takes more than the placeholder
+void KVBinaryOutputStreamSerializer::writeCount(size_t offset, size_t count) {
+  uint8_t packedCount[8];
+  size_t size = packVarint(packedCount, count);
+  if (size > COUNT_PLACEHOLDER_SIZE) {
+    m_buffer.insert(m_buffer.begin() + offset + COUNT_PLACEHOLDER_SIZE, size - COUNT_PLACEHOLDER_SIZE, 0);
+  }
 
-MemoryStream& KVBinaryOutputStreamSerializer::stream() {
-  assert(m_objectsStack.size());
-  return m_objectsStack.back();
+  memcpy(&m_buffer[offset], packedCount, size);
 }
 
 }
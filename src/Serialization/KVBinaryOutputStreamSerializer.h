@@ -7,17 +7,21 @@
 #include <vector>
 #include <Common/IOutputStream.h>
 #include "ISerializer.h"
-#include "MemoryStream.h"
 
 namespace CryptoNote {
 
+// Writes everything into one buffer. The counts of object entries are known only when the objects end,
+// so a byte is left for each count and widened in place in the rare case the count does not fit in it.
 class KVBinaryOutputStreamSerializer : public ISerializer {
 public:
 
-  KVBinaryOutputStreamSerializer();
+  // sizeEstimate bytes are reserved for the serialized data up front
+  explicit KVBinaryOutputStreamSerializer(size_t sizeEstimate = 0);
   virtual ~KVBinaryOutputStreamSerializer() {}
 
   void dump(Common::IOutputStream& target);
+  // Moves the serialized data to target without copying it, nothing may be serialized afterwards
+  void dump(std::vector<uint8_t>& target);
 
   virtual ISerializer::SerializerType type() const override;
 
@@ -47,38 +51,27 @@ public:
 
 private:
 
+  template <typename T>
+  void writePod(uint8_t type, const T& value, Common::StringView name);
+  void write(const void* data, size_t size);
   void writeElementPrefix(uint8_t type, Common::StringView name);
   void checkArrayPreamble(uint8_t type);
-  void updateState(uint8_t type);
-  MemoryStream& stream();
+  void writeCount(size_t offset, size_t count);
 
   enum class State {
-    Root,
     Object,
     ArrayPrefix,
     Array
   };
 
+  // For objects offset is of the count, for arrays of the name, so that an array without items can be dropped
   struct Level {
     State state;
-    std::string name;
     size_t count;
-
-    Level(Common::StringView nm) :
-      name(nm), state(State::Object), count(0) {}
-
-    Level(Common::StringView nm, size_t arraySize) :
-      name(nm), state(State::ArrayPrefix), count(arraySize) {}
-
-    Level(Level&& rv) {
-      state = rv.state;
-      name = std::move(rv.name);
-      count = rv.count;
-    }
-
+    size_t offset;
   };
 
-  std::vector<MemoryStream> m_objectsStack;
+  std::vector<uint8_t> m_buffer;
   std::vector<Level> m_stack;
 };
 
@@ -21,62 +21,65 @@ namespace {
 
 using namespace CryptoNote;
 
-void checkOutputKey(
-  const KeyDerivation& derivation,
-  const PublicKey& key,
-  size_t keyIndex,
-  size_t outputIndex,
-  const std::unordered_set<PublicKey>& spendKeys,
-  std::unordered_map<PublicKey, std::vector<uint32_t>>& outputs) {
-
-  PublicKey spendKey;
-  underive_public_key(derivation, keyIndex, key, spendKey);
-
-  if (spendKeys.find(spendKey) != spendKeys.end()) {
-    outputs[spendKey].push_back(static_cast<uint32_t>(outputIndex));
-  }
-
-}
+// Transactions scanned for outputs by a single find_outputs call
+const size_t TRANSACTION_BATCH_SIZE = 64;
 
 void findMyOutputs(
-  const ITransactionReader& tx,
+  const ITransactionReader* const* transactions,
+  size_t count,
   const SecretKey& viewSecretKey,
-  const std::unordered_set<PublicKey>& spendKeys,
-  std::unordered_map<PublicKey, std::vector<uint32_t>>& outputs) {
+  const std::vector<PublicKey>& spendKeys,
+  std::vector<std::unordered_map<PublicKey, std::vector<uint32_t>>>& outputs) {
 
-  auto txPublicKey = tx.getTransactionPublicKey();
-  KeyDerivation derivation;
+  std::vector<PublicKey> txPublicKeys;
+  std::vector<TransactionOutputKey> outputKeys;
+  std::vector<uint32_t> outputIndices;
+  txPublicKeys.reserve(count);
 
-  if (!generate_key_derivation( txPublicKey, viewSecretKey, derivation)) {
-    return;
-  }
+  for (size_t txIndex = 0; txIndex < count; ++txIndex) {
+    const ITransactionReader& tx = *transactions[txIndex];
+    txPublicKeys.push_back(tx.getTransactionPublicKey());
 
-  size_t keyIndex = 0;
-  size_t outputCount = tx.getOutputCount();
+    size_t keyIndex = 0;
+    size_t outputCount = tx.getOutputCount();
 
-  for (size_t idx = 0; idx < outputCount; ++idx) {
+    for (size_t idx = 0; idx < outputCount; ++idx) {
 
-    auto outType = tx.getOutputType(size_t(idx));
+      auto outType = tx.getOutputType(size_t(idx));
 
-    if (outType == TransactionTypes::OutputType::Key) {
+      if (outType == TransactionTypes::OutputType::Key) {
 
-      uint64_t amount;
-      KeyOutput out;
-      tx.getOutput(idx, out, amount);
-      checkOutputKey(derivation, out.key, keyIndex, idx, spendKeys, outputs);
-      ++keyIndex;
+        uint64_t amount;
+        KeyOutput out;
+        tx.getOutput(idx, out, amount);
+        outputKeys.push_back(TransactionOutputKey{ txIndex, keyIndex, out.key });
+        outputIndices.push_back(static_cast<uint32_t>(idx));
+        ++keyIndex;
 
-    } else if (outType == TransactionTypes::OutputType::Multisignature) {
+      } else if (outType == TransactionTypes::OutputType::Multisignature) {
 
-      uint64_t amount;
-      MultisignatureOutput out;
-      tx.getOutput(idx, out, amount);
-      for (const auto& key : out.keys) {
-        checkOutputKey(derivation, key, idx, idx, spendKeys, outputs);
-        ++keyIndex;
+        uint64_t amount;
+        MultisignatureOutput out;
+        tx.getOutput(idx, out, amount);
+        for (const auto& key : out.keys) {
+          outputKeys.push_back(TransactionOutputKey{ txIndex, idx, key });
+          outputIndices.push_back(static_cast<uint32_t>(idx));
+          ++keyIndex;
+        }
       }
     }
   }
+
+  std::vector<OutputKeyMatch> matches;
+  find_outputs(txPublicKeys.data(), txPublicKeys.size(), outputKeys.data(), outputKeys.size(), viewSecretKey,
+    spendKeys.data(), spendKeys.size(), matches);
+
+  outputs.clear();
+  outputs.resize(count);
+  for (const auto& match : matches) {
+    const auto& outputKey = outputKeys[match.output];
+    outputs[outputKey.transaction][spendKeys[match.spendKey]].push_back(outputIndices[match.output]);
+  }
 }
 
 std::vector<Crypto::Hash> getBlockHashes(const CryptoNote::CompleteBlock* blocks, size_t count) {
@@ -192,11 +195,13 @@ bool TransfersConsumer::onNewBlocks(const CompleteBlock* blocks, uint32_t startH
     workers = 2;
   }
 
-  BlockingQueue<Tx> inputQueue(workers * 2);
+  BlockingQueue<std::vector<Tx>> inputQueue(workers * 2);
+  std::vector<PublicKey> spendKeys(m_spendKeys.begin(), m_spendKeys.end());
 
   std::atomic<bool> stopProcessing(false);
 
   auto pushingThread = std::async(std::launch::async, [&] {
+    std::vector<Tx> batch;
     for( uint32_t i = 0; i < count && !stopProcessing; ++i) {
       const auto& block = blocks[i].block;
 
@@ -222,29 +227,49 @@ bool TransfersConsumer::onNewBlocks(const CompleteBlock* blocks, uint32_t startH
         }
 
         Tx item = { blockInfo, tx.get() };
-        inputQueue.push(item);
+        batch.push_back(item);
+        if (batch.size() == TRANSACTION_BATCH_SIZE) {
+          inputQueue.push(std::move(batch));
+          batch.clear();
+        }
+
         ++blockInfo.transactionIndex;
       }
     }
 
+    if (!batch.empty()) {
+      inputQueue.push(std::move(batch));
+    }
+
     inputQueue.close();
   });
 
   auto processingFunction = [&] {
-    Tx item;
+    std::vector<Tx> batch;
+    std::vector<const ITransactionReader*> transactions;
+    std::vector<std::unordered_map<PublicKey, std::vector<uint32_t>>> outputs;
     std::error_code ec;
-    while (!stopProcessing && inputQueue.pop(item)) {
-      PreprocessedTx output;
-      static_cast<Tx&>(output) = item;
-
-      ec = preprocessOutputs(item.blockInfo, *item.tx, output);
-      if (ec) {
-        stopProcessing = true;
-        break;
+    while (!stopProcessing && inputQueue.pop(batch)) {
+      transactions.clear();
+      for (const auto& item : batch) {
+        transactions.push_back(item.tx);
       }
 
-      std::lock_guard<std::mutex> lk(preprocessedTransactionsMutex);
-      preprocessedTransactions.push_back(std::move(output));
+      findMyOutputs(transactions.data(), transactions.size(), m_viewSecret, spendKeys, outputs);
+
+      for (size_t i = 0; i < batch.size(); ++i) {
+        PreprocessedTx output;
+        static_cast<Tx&>(output) = batch[i];
+
+        ec = preprocessOutputs(batch[i].blockInfo, *batch[i].tx, outputs[i], output);
+        if (ec) {
+          stopProcessing = true;
+          return ec;
+        }
+
+        std::lock_guard<std::mutex> lk(preprocessedTransactionsMutex);
+        preprocessedTransactions.push_back(std::move(output));
+      }
     }
     return ec;
   };
@@ -414,10 +439,8 @@ std::error_code createTransfers(
   return std::error_code();
 }
 
-std::error_code TransfersConsumer::preprocessOutputs(const TransactionBlockInfo& blockInfo, const ITransactionReader& tx, PreprocessInfo& info) {
-  std::unordered_map<PublicKey, std::vector<uint32_t>> outputs;
-  findMyOutputs(tx, m_viewSecret, m_spendKeys, outputs);
-
+std::error_code TransfersConsumer::preprocessOutputs(const TransactionBlockInfo& blockInfo, const ITransactionReader& tx,
+  const std::unordered_map<PublicKey, std::vector<uint32_t>>& outputs, PreprocessInfo& info) {
   if (outputs.empty()) {
     return std::error_code();
   }
@@ -446,8 +469,12 @@ std::error_code TransfersConsumer::preprocessOutputs(const TransactionBlockInfo&
 }
 
 std::error_code TransfersConsumer::processTransaction(const TransactionBlockInfo& blockInfo, const ITransactionReader& tx) {
+  std::vector<std::unordered_map<PublicKey, std::vector<uint32_t>>> outputs;
+  const ITransactionReader* transaction = &tx;
+  findMyOutputs(&transaction, 1, m_viewSecret, std::vector<PublicKey>(m_spendKeys.begin(), m_spendKeys.end()), outputs);
+
   PreprocessInfo info;
-  auto ec = preprocessOutputs(blockInfo, tx, info);
+  auto ec = preprocessOutputs(blockInfo, tx, outputs.front(), info);
   if (ec) {
     return ec;
   }
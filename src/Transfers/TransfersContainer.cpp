@@ -748,7 +748,6 @@ std::vector<TransactionSpentOutputInformation> TransfersContainer::getSpentOutpu
     spentOutput.spendingBlockHeight = o.spendingBlock.height;
     spentOutput.timestamp = o.spendingBlock.timestamp;
     spentOutput.spendingTransactionHash = o.spendingTransactionHash;
-    spentOutput.keyImage = o.keyImage;
     spentOutput.inputInTransaction = o.inputInTransaction;
 
     spentOutputs.push_back(spentOutput);
@@ -61,7 +61,6 @@ struct SpentOutputDescriptorHasher {
 };
 
 struct TransactionOutputInformationIn : public TransactionOutputInformation {
-  Crypto::KeyImage keyImage;  //!< \attention Used only for TransactionTypes::OutputType::Key
 };
 
 struct TransactionOutputInformationEx : public TransactionOutputInformationIn {
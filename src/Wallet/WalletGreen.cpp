@@ -1260,7 +1260,7 @@ std::unique_ptr<CryptoNote::ITransaction> WalletGreen::makeTransaction(const std
   tx->appendExtra(Common::asBinaryArray(extra));
 
   for (auto& input: keysInfo) {
-    tx->addInput(makeAccountKeys(*input.walletRecord), input.keyInfo, input.ephKeys);
+    tx->addInput(makeAccountKeys(*input.walletRecord), input.keyInfo, input.keyImage, input.ephKeys);
   }
 
   size_t i = 0;
@@ -1550,6 +1550,7 @@ void WalletGreen::prepareInputs(
     //Important! outputs in selectedTransfers and in keysInfo must have the same order!
     InputInfo inputInfo;
     inputInfo.keyInfo = std::move(keyInfo);
+    inputInfo.keyImage = input.out.keyImage;
     inputInfo.walletRecord = input.wallet;
     keysInfo.push_back(std::move(inputInfo));
     ++i;
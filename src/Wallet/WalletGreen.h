@@ -89,6 +89,7 @@ protected:
 
   struct InputInfo {
     TransactionTypes::InputKeyInfo keyInfo;
+    Crypto::KeyImage keyImage;
     WalletRecord* walletRecord = nullptr;
     KeyPair ephKeys;
   };
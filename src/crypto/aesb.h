@@ -171,6 +171,40 @@ void aesb_pseudo_round(const uint8_t *in, uint8_t *out, uint8_t *expandedKey)
     state_out(out, b0);
 }
 
+#define d_1(t,n,b,e) ALIGN const t n[256] = b(e)
+#define sub_word(x) bytes2word(t_use(s,box)[bval(x,0)], t_use(s,box)[bval(x,1)], t_use(s,box)[bval(x,2)], t_use(s,box)[bval(x,3)])
+
+d_1(uint8_t, t_dec(s,box), sb_data, h0);
+static const uint8_t t_rcon[10] = rc_data(h0);
+
+// Expands a 256-bit key into the 10 round keys used by aesb_pseudo_round
+void aesb_expand_key(const uint8_t *key, uint8_t *expandedKey)
+{
+    uint32_t *kp = (uint32_t *) expandedKey;
+    uint32_t t;
+    int i;
+
+    for (i = 0; i < 8; ++i)
+    {
+        kp[i] = word_in(key, i);
+    }
+
+    for (i = 8; i < 10 * N_COLS; ++i)
+    {
+        t = kp[i - 1];
+        if (i % 8 == 0)
+        {
+            t = sub_word((t >> 8) | (t << 24)) ^ t_rcon[i / 8 - 1];
+        }
+        else if (i % 8 == 4)
+        {
+            t = sub_word(t);
+        }
+
+        kp[i] = kp[i - 8] ^ t;
+    }
+}
+
 
 #if defined(__cplusplus)
 }
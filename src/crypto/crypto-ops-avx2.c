@@ -0,0 +1,527 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <immintrin.h>
+
+#include "crypto-ops.h"
+
+/*
+Four independent points are processed at once: every limb of a field element
+is a vector holding that limb of the four elements, one per 64-bit lane, so
+the ref10 formulas apply unchanged with _mm256_mul_epi32 doing four 32x32->64
+multiplications.
+*/
+
+typedef __m256i fe4[10];
+
+typedef struct {
+  fe4 X;
+  fe4 Y;
+  fe4 Z;
+} ge4_p2;
+
+typedef struct {
+  fe4 X;
+  fe4 Y;
+  fe4 Z;
+  fe4 T;
+} ge4_p3;
+
+typedef struct {
+  fe4 X;
+  fe4 Y;
+  fe4 Z;
+  fe4 T;
+} ge4_p1p1;
+
+typedef struct {
+  fe4 YplusX;
+  fe4 YminusX;
+  fe4 Z;
+  fe4 T2d;
+} ge4_cached;
+
+static void fe4_load(fe4 h, const fe f0, const fe f1, const fe f2, const fe f3) {
+  int i;
+
+  for (i = 0; i < 10; ++i) {
+    h[i] = _mm256_set_epi64x(f3[i], f2[i], f1[i], f0[i]);
+  }
+}
+
+static void fe4_store(fe h0, fe h1, fe h2, fe h3, const fe4 f) {
+  int64_t lanes[4];
+  int i;
+
+  for (i = 0; i < 10; ++i) {
+    _mm256_storeu_si256((__m256i *) lanes, f[i]);
+    h0[i] = (int32_t) lanes[0];
+    h1[i] = (int32_t) lanes[1];
+    h2[i] = (int32_t) lanes[2];
+    h3[i] = (int32_t) lanes[3];
+  }
+}
+
+static void fe4_broadcast(fe4 h, const fe f) {
+  int i;
+
+  for (i = 0; i < 10; ++i) {
+    h[i] = _mm256_set1_epi64x(f[i]);
+  }
+}
+
+static void fe4_0(fe4 h) {
+  int i;
+
+  for (i = 0; i < 10; ++i) {
+    h[i] = _mm256_setzero_si256();
+  }
+}
+
+static void fe4_1(fe4 h) {
+  fe4_0(h);
+  h[0] = _mm256_set1_epi64x(1);
+}
+
+static void fe4_add(fe4 h, const fe4 f, const fe4 g) {
+  int i;
+
+  for (i = 0; i < 10; ++i) {
+    h[i] = _mm256_add_epi64(f[i], g[i]);
+  }
+}
+
+static void fe4_sub(fe4 h, const fe4 f, const fe4 g) {
+  int i;
+
+  for (i = 0; i < 10; ++i) {
+    h[i] = _mm256_sub_epi64(f[i], g[i]);
+  }
+}
+
+static void fe4_neg(fe4 h, const fe4 f) {
+  int i;
+
+  for (i = 0; i < 10; ++i) {
+    h[i] = _mm256_sub_epi64(_mm256_setzero_si256(), f[i]);
+  }
+}
+
+static void fe4_copy(fe4 h, const fe4 f) {
+  int i;
+
+  for (i = 0; i < 10; ++i) {
+    h[i] = f[i];
+  }
+}
+
+/*
+Replace f with g if mask is all ones, keep f if it is zero.
+*/
+
+static void fe4_cmov(fe4 f, const fe4 g, __m256i mask) {
+  int i;
+
+  for (i = 0; i < 10; ++i) {
+    f[i] = _mm256_blendv_epi8(f[i], g[i], mask);
+  }
+}
+
+/*
+(h + 2^25) >> 26 and (h + 2^24) >> 25 for |h| < 2^62.
+AVX2 has no 64-bit arithmetic shift, so h is biased to be nonnegative.
+*/
+
+static __m256i fe4_carry26(__m256i h) {
+  const __m256i bias = _mm256_set1_epi64x(((int64_t) 1 << 62) + ((int64_t) 1 << 25));
+  return _mm256_sub_epi64(_mm256_srli_epi64(_mm256_add_epi64(h, bias), 26), _mm256_set1_epi64x((int64_t) 1 << 36));
+}
+
+static __m256i fe4_carry25(__m256i h) {
+  const __m256i bias = _mm256_set1_epi64x(((int64_t) 1 << 62) + ((int64_t) 1 << 24));
+  return _mm256_sub_epi64(_mm256_srli_epi64(_mm256_add_epi64(h, bias), 25), _mm256_set1_epi64x((int64_t) 1 << 37));
+}
+
+/*
+Carries of fe_mul, bounds are the same.
+*/
+
+static void fe4_carry(fe4 h, fe4 t) {
+  __m256i carry;
+
+  carry = fe4_carry26(t[0]); t[1] = _mm256_add_epi64(t[1], carry); t[0] = _mm256_sub_epi64(t[0], _mm256_slli_epi64(carry, 26));
+  carry = fe4_carry26(t[4]); t[5] = _mm256_add_epi64(t[5], carry); t[4] = _mm256_sub_epi64(t[4], _mm256_slli_epi64(carry, 26));
+  carry = fe4_carry25(t[1]); t[2] = _mm256_add_epi64(t[2], carry); t[1] = _mm256_sub_epi64(t[1], _mm256_slli_epi64(carry, 25));
+  carry = fe4_carry25(t[5]); t[6] = _mm256_add_epi64(t[6], carry); t[5] = _mm256_sub_epi64(t[5], _mm256_slli_epi64(carry, 25));
+  carry = fe4_carry26(t[2]); t[3] = _mm256_add_epi64(t[3], carry); t[2] = _mm256_sub_epi64(t[2], _mm256_slli_epi64(carry, 26));
+  carry = fe4_carry26(t[6]); t[7] = _mm256_add_epi64(t[7], carry); t[6] = _mm256_sub_epi64(t[6], _mm256_slli_epi64(carry, 26));
+  carry = fe4_carry25(t[3]); t[4] = _mm256_add_epi64(t[4], carry); t[3] = _mm256_sub_epi64(t[3], _mm256_slli_epi64(carry, 25));
+  carry = fe4_carry25(t[7]); t[8] = _mm256_add_epi64(t[8], carry); t[7] = _mm256_sub_epi64(t[7], _mm256_slli_epi64(carry, 25));
+  carry = fe4_carry26(t[4]); t[5] = _mm256_add_epi64(t[5], carry); t[4] = _mm256_sub_epi64(t[4], _mm256_slli_epi64(carry, 26));
+  carry = fe4_carry26(t[8]); t[9] = _mm256_add_epi64(t[9], carry); t[8] = _mm256_sub_epi64(t[8], _mm256_slli_epi64(carry, 26));
+  carry = fe4_carry25(t[9]); t[9] = _mm256_sub_epi64(t[9], _mm256_slli_epi64(carry, 25));
+  /* carry does not fit into 32 bits here, so it is multiplied by 19 with shifts */
+  t[0] = _mm256_add_epi64(t[0], _mm256_add_epi64(_mm256_add_epi64(_mm256_slli_epi64(carry, 4), _mm256_slli_epi64(carry, 1)), carry));
+  carry = fe4_carry26(t[0]); t[1] = _mm256_add_epi64(t[1], carry); t[0] = _mm256_sub_epi64(t[0], _mm256_slli_epi64(carry, 26));
+
+  fe4_copy(h, t);
+}
+
+/*
+h = f * g, same pre- and postconditions as fe_mul.
+Can overlap h with f or g.
+*/
+
+static void fe4_mul(fe4 h, const fe4 f, const fe4 g) {
+  __m256i f_2[10];
+  __m256i g_19[10];
+  __m256i t[10];
+  const __m256i nineteen = _mm256_set1_epi64x(19);
+  int i;
+
+  for (i = 1; i < 10; ++i) {
+    f_2[i] = _mm256_add_epi64(f[i], f[i]);
+    g_19[i] = _mm256_mul_epi32(g[i], nineteen);
+  }
+
+  t[0] = _mm256_mul_epi32(f[0], g[0]);
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f_2[1], g_19[9]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f[2], g_19[8]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f_2[3], g_19[7]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f[4], g_19[6]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f_2[5], g_19[5]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f[6], g_19[4]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f_2[7], g_19[3]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f[8], g_19[2]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f_2[9], g_19[1]));
+  t[1] = _mm256_mul_epi32(f[0], g[1]);
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f[1], g[0]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f[2], g_19[9]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f[3], g_19[8]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f[4], g_19[7]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f[5], g_19[6]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f[6], g_19[5]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f[7], g_19[4]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f[8], g_19[3]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f[9], g_19[2]));
+  t[2] = _mm256_mul_epi32(f[0], g[2]);
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f_2[1], g[1]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f[2], g[0]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f_2[3], g_19[9]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f[4], g_19[8]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f_2[5], g_19[7]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f[6], g_19[6]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f_2[7], g_19[5]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f[8], g_19[4]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f_2[9], g_19[3]));
+  t[3] = _mm256_mul_epi32(f[0], g[3]);
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f[1], g[2]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f[2], g[1]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f[3], g[0]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f[4], g_19[9]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f[5], g_19[8]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f[6], g_19[7]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f[7], g_19[6]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f[8], g_19[5]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f[9], g_19[4]));
+  t[4] = _mm256_mul_epi32(f[0], g[4]);
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f_2[1], g[3]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f[2], g[2]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f_2[3], g[1]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f[4], g[0]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f_2[5], g_19[9]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f[6], g_19[8]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f_2[7], g_19[7]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f[8], g_19[6]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f_2[9], g_19[5]));
+  t[5] = _mm256_mul_epi32(f[0], g[5]);
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f[1], g[4]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f[2], g[3]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f[3], g[2]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f[4], g[1]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f[5], g[0]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f[6], g_19[9]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f[7], g_19[8]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f[8], g_19[7]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f[9], g_19[6]));
+  t[6] = _mm256_mul_epi32(f[0], g[6]);
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f_2[1], g[5]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f[2], g[4]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f_2[3], g[3]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f[4], g[2]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f_2[5], g[1]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f[6], g[0]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f_2[7], g_19[9]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f[8], g_19[8]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f_2[9], g_19[7]));
+  t[7] = _mm256_mul_epi32(f[0], g[7]);
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f[1], g[6]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f[2], g[5]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f[3], g[4]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f[4], g[3]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f[5], g[2]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f[6], g[1]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f[7], g[0]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f[8], g_19[9]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f[9], g_19[8]));
+  t[8] = _mm256_mul_epi32(f[0], g[8]);
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f_2[1], g[7]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f[2], g[6]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f_2[3], g[5]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f[4], g[4]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f_2[5], g[3]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f[6], g[2]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f_2[7], g[1]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f[8], g[0]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f_2[9], g_19[9]));
+  t[9] = _mm256_mul_epi32(f[0], g[9]);
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f[1], g[8]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f[2], g[7]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f[3], g[6]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f[4], g[5]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f[5], g[4]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f[6], g[3]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f[7], g[2]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f[8], g[1]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f[9], g[0]));
+
+  fe4_carry(h, t);
+}
+
+/*
+h = 2^shift * f * f, same pre- and postconditions as fe_sq and fe_sq2.
+Can overlap h with f.
+*/
+
+static void fe4_sq_shift(fe4 h, const fe4 f, int shift) {
+  __m256i f_2[10];
+  __m256i f_4[10];
+  __m256i f_19[10];
+  __m256i t[10];
+  const __m256i nineteen = _mm256_set1_epi64x(19);
+  int i;
+
+  for (i = 0; i < 10; ++i) {
+    f_2[i] = _mm256_add_epi64(f[i], f[i]);
+    f_4[i] = _mm256_add_epi64(f_2[i], f_2[i]);
+    f_19[i] = _mm256_mul_epi32(f[i], nineteen);
+  }
+
+  t[0] = _mm256_mul_epi32(f[0], f[0]);
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f_4[1], f_19[9]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f_2[2], f_19[8]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f_4[3], f_19[7]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f_2[4], f_19[6]));
+  t[0] = _mm256_add_epi64(t[0], _mm256_mul_epi32(f_2[5], f_19[5]));
+  t[1] = _mm256_mul_epi32(f_2[0], f[1]);
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f_2[2], f_19[9]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f_2[3], f_19[8]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f_2[4], f_19[7]));
+  t[1] = _mm256_add_epi64(t[1], _mm256_mul_epi32(f_2[5], f_19[6]));
+  t[2] = _mm256_mul_epi32(f_2[0], f[2]);
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f_2[1], f[1]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f_4[3], f_19[9]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f_2[4], f_19[8]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f_4[5], f_19[7]));
+  t[2] = _mm256_add_epi64(t[2], _mm256_mul_epi32(f[6], f_19[6]));
+  t[3] = _mm256_mul_epi32(f_2[0], f[3]);
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f_2[1], f[2]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f_2[4], f_19[9]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f_2[5], f_19[8]));
+  t[3] = _mm256_add_epi64(t[3], _mm256_mul_epi32(f_2[6], f_19[7]));
+  t[4] = _mm256_mul_epi32(f_2[0], f[4]);
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f_4[1], f[3]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f[2], f[2]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f_4[5], f_19[9]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f_2[6], f_19[8]));
+  t[4] = _mm256_add_epi64(t[4], _mm256_mul_epi32(f_2[7], f_19[7]));
+  t[5] = _mm256_mul_epi32(f_2[0], f[5]);
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f_2[1], f[4]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f_2[2], f[3]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f_2[6], f_19[9]));
+  t[5] = _mm256_add_epi64(t[5], _mm256_mul_epi32(f_2[7], f_19[8]));
+  t[6] = _mm256_mul_epi32(f_2[0], f[6]);
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f_4[1], f[5]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f_2[2], f[4]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f_2[3], f[3]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f_4[7], f_19[9]));
+  t[6] = _mm256_add_epi64(t[6], _mm256_mul_epi32(f[8], f_19[8]));
+  t[7] = _mm256_mul_epi32(f_2[0], f[7]);
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f_2[1], f[6]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f_2[2], f[5]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f_2[3], f[4]));
+  t[7] = _mm256_add_epi64(t[7], _mm256_mul_epi32(f_2[8], f_19[9]));
+  t[8] = _mm256_mul_epi32(f_2[0], f[8]);
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f_4[1], f[7]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f_2[2], f[6]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f_4[3], f[5]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f[4], f[4]));
+  t[8] = _mm256_add_epi64(t[8], _mm256_mul_epi32(f_2[9], f_19[9]));
+  t[9] = _mm256_mul_epi32(f_2[0], f[9]);
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f_2[1], f[8]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f_2[2], f[7]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f_2[3], f[6]));
+  t[9] = _mm256_add_epi64(t[9], _mm256_mul_epi32(f_2[4], f[5]));
+
+  for (i = 0; i < 10; ++i) {
+    t[i] = _mm256_slli_epi64(t[i], shift);
+  }
+
+  fe4_carry(h, t);
+}
+
+static void fe4_sq(fe4 h, const fe4 f) {
+  fe4_sq_shift(h, f, 0);
+}
+
+static void fe4_sq2(fe4 h, const fe4 f) {
+  fe4_sq_shift(h, f, 1);
+}
+
+/* Point arithmetic, the same as in crypto-ops.c */
+
+static void ge4_add(ge4_p1p1 *r, const ge4_p3 *p, const ge4_cached *q) {
+  fe4 t0;
+  fe4_add(r->X, p->Y, p->X);
+  fe4_sub(r->Y, p->Y, p->X);
+  fe4_mul(r->Z, r->X, q->YplusX);
+  fe4_mul(r->Y, r->Y, q->YminusX);
+  fe4_mul(r->T, q->T2d, p->T);
+  fe4_mul(r->X, p->Z, q->Z);
+  fe4_add(t0, r->X, r->X);
+  fe4_sub(r->X, r->Z, r->Y);
+  fe4_add(r->Y, r->Z, r->Y);
+  fe4_add(r->Z, t0, r->T);
+  fe4_sub(r->T, t0, r->T);
+}
+
+static void ge4_p1p1_to_p2(ge4_p2 *r, const ge4_p1p1 *p) {
+  fe4_mul(r->X, p->X, p->T);
+  fe4_mul(r->Y, p->Y, p->Z);
+  fe4_mul(r->Z, p->Z, p->T);
+}
+
+static void ge4_p1p1_to_p3(ge4_p3 *r, const ge4_p1p1 *p) {
+  fe4_mul(r->X, p->X, p->T);
+  fe4_mul(r->Y, p->Y, p->Z);
+  fe4_mul(r->Z, p->Z, p->T);
+  fe4_mul(r->T, p->X, p->Y);
+}
+
+static void ge4_p2_dbl(ge4_p1p1 *r, const ge4_p2 *p) {
+  fe4 t0;
+  fe4_sq(r->X, p->X);
+  fe4_sq(r->Z, p->Y);
+  fe4_sq2(r->T, p->Z);
+  fe4_add(r->Y, p->X, p->Y);
+  fe4_sq(t0, r->Y);
+  fe4_add(r->Y, r->Z, r->X);
+  fe4_sub(r->Z, r->Z, r->X);
+  fe4_sub(r->X, t0, r->Y);
+  fe4_sub(r->T, r->T, r->Z);
+}
+
+static void ge4_p3_to_cached(ge4_cached *r, const ge4_p3 *p, const fe4 d2) {
+  fe4_add(r->YplusX, p->Y, p->X);
+  fe4_sub(r->YminusX, p->Y, p->X);
+  fe4_copy(r->Z, p->Z);
+  fe4_mul(r->T2d, p->T, d2);
+}
+
+static void ge4_cached_0(ge4_cached *r) {
+  fe4_1(r->YplusX);
+  fe4_1(r->YminusX);
+  fe4_1(r->Z);
+  fe4_0(r->T2d);
+}
+
+static void ge4_cached_cmov(ge4_cached *t, const ge4_cached *u, unsigned char b) {
+  __m256i mask = _mm256_set1_epi64x(-(int64_t) b);
+  fe4_cmov(t->YplusX, u->YplusX, mask);
+  fe4_cmov(t->YminusX, u->YminusX, mask);
+  fe4_cmov(t->Z, u->Z, mask);
+  fe4_cmov(t->T2d, u->T2d, mask);
+}
+
+static unsigned char equal(signed char b, signed char c) {
+  unsigned char ub = b;
+  unsigned char uc = c;
+  unsigned char x = ub ^ uc; /* 0: yes; 1..255: no */
+  uint32_t y = x; /* 0: yes; 1..255: no */
+  y -= 1; /* 4294967295: yes; 0..254: no */
+  y >>= 31; /* 1: yes; 0: no */
+  return (unsigned char) y;
+}
+
+static unsigned char negative(signed char b) {
+  uint64_t x = b; /* 18446744073709551361..18446744073709551615: yes; 0..255: no */
+  x >>= 63; /* 1: yes; 0: no */
+  return (unsigned char) x;
+}
+
+/* The same as ge_scalarmult_recoded for each of the four points */
+
+void ge_scalarmult_x4(ge_p2 *r, const signed char *e, const ge_p3 *A) {
+  int i;
+  fe4 d2;
+  ge4_cached Ai[8]; /* 1 * A, 2 * A, ..., 8 * A */
+  ge4_p1p1 t;
+  ge4_p3 u;
+  ge4_p3 A4;
+  ge4_p2 r4;
+
+  fe4_broadcast(d2, fe_d2);
+  fe4_load(A4.X, A[0].X, A[1].X, A[2].X, A[3].X);
+  fe4_load(A4.Y, A[0].Y, A[1].Y, A[2].Y, A[3].Y);
+  fe4_load(A4.Z, A[0].Z, A[1].Z, A[2].Z, A[3].Z);
+  fe4_load(A4.T, A[0].T, A[1].T, A[2].T, A[3].T);
+
+  ge4_p3_to_cached(&Ai[0], &A4, d2);
+  for (i = 0; i < 7; i++) {
+    ge4_add(&t, &A4, &Ai[i]);
+    ge4_p1p1_to_p3(&u, &t);
+    ge4_p3_to_cached(&Ai[i + 1], &u, d2);
+  }
+
+  fe4_0(r4.X);
+  fe4_1(r4.Y);
+  fe4_1(r4.Z);
+  for (i = 63; i >= 0; i--) {
+    signed char b = e[i];
+    unsigned char bnegative = negative(b);
+    unsigned char babs = b - (((-bnegative) & b) << 1);
+    ge4_cached cur, minuscur;
+    ge4_p2_dbl(&t, &r4);
+    ge4_p1p1_to_p2(&r4, &t);
+    ge4_p2_dbl(&t, &r4);
+    ge4_p1p1_to_p2(&r4, &t);
+    ge4_p2_dbl(&t, &r4);
+    ge4_p1p1_to_p2(&r4, &t);
+    ge4_p2_dbl(&t, &r4);
+    ge4_p1p1_to_p3(&u, &t);
+    ge4_cached_0(&cur);
+    ge4_cached_cmov(&cur, &Ai[0], equal(babs, 1));
+    ge4_cached_cmov(&cur, &Ai[1], equal(babs, 2));
+    ge4_cached_cmov(&cur, &Ai[2], equal(babs, 3));
+    ge4_cached_cmov(&cur, &Ai[3], equal(babs, 4));
+    ge4_cached_cmov(&cur, &Ai[4], equal(babs, 5));
+    ge4_cached_cmov(&cur, &Ai[5], equal(babs, 6));
+    ge4_cached_cmov(&cur, &Ai[6], equal(babs, 7));
+    ge4_cached_cmov(&cur, &Ai[7], equal(babs, 8));
+    fe4_copy(minuscur.YplusX, cur.YminusX);
+    fe4_copy(minuscur.YminusX, cur.YplusX);
+    fe4_copy(minuscur.Z, cur.Z);
+    fe4_neg(minuscur.T2d, cur.T2d);
+    ge4_cached_cmov(&cur, &minuscur, bnegative);
+    ge4_add(&t, &u, &cur);
+    ge4_p1p1_to_p2(&r4, &t);
+  }
+
+  fe4_store(r[0].X, r[1].X, r[2].X, r[3].X, r4.X);
+  fe4_store(r[0].Y, r[1].Y, r[2].Y, r[3].Y, r4.Y);
+  fe4_store(r[0].Z, r[1].Z, r[2].Z, r[3].Z, r4.Z);
+}
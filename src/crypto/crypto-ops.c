@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "crypto-ops.h"
@@ -38,6 +39,298 @@ static uint64_t load_4(const unsigned char *in)
   return result;
 }
 
+/* Radix 2^51 field arithmetic */
+
+/*
+Where 128-bit integers are available, products and inversions are computed on
+five 51-bit limbs with 25 64x64->128 multiplications instead of 100 32x32->64
+ones. Field elements are kept in the ref10 representation between operations,
+so both backends give the same results. Define CRYPTO_FE_REF10 to build the
+ref10 arithmetic only.
+*/
+
+#if defined(__SIZEOF_INT128__) && !defined(CRYPTO_FE_REF10)
+#define FE_RADIX51
+
+typedef int64_t fe51[5];
+typedef __int128 fe51_wide;
+
+static int fe_radix51 = 1;
+
+/*
+h = f
+
+Preconditions:
+   |f| bounded by 1.65*2^26,1.65*2^25,1.65*2^26,1.65*2^25,etc.
+
+Postconditions:
+   |h| bounded by 1.65*2^51.
+*/
+
+static void fe51_from_fe(fe51 h, const fe f) {
+  h[0] = f[0] + ((int64_t) f[1] << 26);
+  h[1] = f[2] + ((int64_t) f[3] << 26);
+  h[2] = f[4] + ((int64_t) f[5] << 26);
+  h[3] = f[6] + ((int64_t) f[7] << 26);
+  h[4] = f[8] + ((int64_t) f[9] << 26);
+}
+
+/*
+h = f
+
+Preconditions:
+   |f| bounded by 1.01*2^50.
+
+Postconditions:
+   |h| bounded by 2^25,1.01*2^24,2^25,1.01*2^24,etc.
+*/
+
+static void fe51_to_fe(fe h, const fe51 f) {
+  int i;
+
+  for (i = 0; i < 5; ++i) {
+    int64_t carry = (f[i] + (int64_t) (1L << 25)) >> 26;
+    h[2 * i] = (int32_t) (f[i] - (carry << 26));
+    h[2 * i + 1] = (int32_t) carry;
+  }
+}
+
+/*
+h = t0 + 2^51 t1 + 2^102 t2 + 2^153 t3 + 2^204 t4
+
+Preconditions:
+   |t0|, |t1|, |t2|, |t3| bounded by 2^114.
+   |t4| bounded by 1.4*2^109.
+
+Postconditions:
+   |h| bounded by 1.01*2^50.
+*/
+
+static void fe51_carry(fe51 h, fe51_wide t0, fe51_wide t1, fe51_wide t2, fe51_wide t3, fe51_wide t4) {
+  const fe51_wide half = (fe51_wide) 1 << 50;
+  int64_t carry0;
+  int64_t carry1;
+  int64_t carry2;
+  int64_t carry3;
+  int64_t carry4;
+  int64_t h0;
+
+  /* Only the low 64 bits of t are needed once the carry is known */
+
+  carry0 = (int64_t) ((t0 + half) >> 51); t1 += carry0;
+  carry1 = (int64_t) ((t1 + half) >> 51); t2 += carry1;
+  carry2 = (int64_t) ((t2 + half) >> 51); t3 += carry2;
+  carry3 = (int64_t) ((t3 + half) >> 51); t4 += carry3;
+  carry4 = (int64_t) ((t4 + half) >> 51);
+
+  h0 = (int64_t) ((uint64_t) t0 - ((uint64_t) carry0 << 51)) + carry4 * 19;
+  carry0 = (h0 + ((int64_t) 1 << 50)) >> 51;
+  h[0] = h0 - carry0 * ((int64_t) 1 << 51);
+  h[1] = (int64_t) ((uint64_t) t1 - ((uint64_t) carry1 << 51)) + carry0;
+  h[2] = (int64_t) ((uint64_t) t2 - ((uint64_t) carry2 << 51));
+  h[3] = (int64_t) ((uint64_t) t3 - ((uint64_t) carry3 << 51));
+  h[4] = (int64_t) ((uint64_t) t4 - ((uint64_t) carry4 << 51));
+}
+
+/*
+h = f * g
+Can overlap h with f or g.
+
+Preconditions:
+   |f|, |g| bounded by 2^53.
+
+Postconditions:
+   |h| bounded by 1.01*2^50.
+*/
+
+static void fe51_mul(fe51 h, const fe51 f, const fe51 g) {
+  fe51_wide f0 = f[0];
+  fe51_wide f1 = f[1];
+  fe51_wide f2 = f[2];
+  fe51_wide f3 = f[3];
+  fe51_wide f4 = f[4];
+  int64_t g0 = g[0];
+  int64_t g1 = g[1];
+  int64_t g2 = g[2];
+  int64_t g3 = g[3];
+  int64_t g4 = g[4];
+  int64_t g1_19 = 19 * g1; /* 1.2*2^57 */
+  int64_t g2_19 = 19 * g2;
+  int64_t g3_19 = 19 * g3;
+  int64_t g4_19 = 19 * g4;
+
+  fe51_carry(h,
+    f0 * g0 + f1 * g4_19 + f2 * g3_19 + f3 * g2_19 + f4 * g1_19,
+    f0 * g1 + f1 * g0 + f2 * g4_19 + f3 * g3_19 + f4 * g2_19,
+    f0 * g2 + f1 * g1 + f2 * g0 + f3 * g4_19 + f4 * g3_19,
+    f0 * g3 + f1 * g2 + f2 * g1 + f3 * g0 + f4 * g4_19,
+    f0 * g4 + f1 * g3 + f2 * g2 + f3 * g1 + f4 * g0);
+}
+
+/*
+h = 2^shift * f * f
+Can overlap h with f.
+
+Preconditions:
+   |f| bounded by 2^53.
+   shift is 0 or 1.
+
+Postconditions:
+   |h| bounded by 1.01*2^50.
+*/
+
+static void fe51_sq_shift(fe51 h, const fe51 f, int shift) {
+  fe51_wide f0 = f[0];
+  fe51_wide f1 = f[1];
+  fe51_wide f2 = f[2];
+  fe51_wide f3 = f[3];
+  fe51_wide f4 = f[4];
+  int64_t f0_2 = 2 * f[0];
+  int64_t f1_2 = 2 * f[1];
+  int64_t f1_38 = 38 * f[1]; /* 1.2*2^58 */
+  int64_t f2_38 = 38 * f[2];
+  int64_t f3_19 = 19 * f[3];
+  int64_t f3_38 = 38 * f[3];
+  int64_t f4_19 = 19 * f[4];
+
+  fe51_carry(h,
+    (f0 * f0 + f4 * f1_38 + f3 * f2_38) << shift,
+    (f1 * f0_2 + f4 * f2_38 + f3 * f3_19) << shift,
+    (f2 * f0_2 + f1 * f1 + f4 * f3_38) << shift,
+    (f3 * f0_2 + f2 * f1_2 + f4 * f4_19) << shift,
+    (f4 * f0_2 + f3 * f1_2 + f2 * f2) << shift);
+}
+
+static void fe51_sq(fe51 h, const fe51 f) {
+  fe51_sq_shift(h, f, 0);
+}
+
+/*
+h = f^(2^n)
+Can overlap h with f.
+
+Preconditions:
+   n >= 1.
+*/
+
+static void fe51_sqn(fe51 h, const fe51 f, int n) {
+  fe51_sq(h, f);
+  while (--n > 0) {
+    fe51_sq(h, h);
+  }
+}
+
+static void fe51_invert(fe51 out, const fe51 z) {
+  fe51 t0;
+  fe51 t1;
+  fe51 t2;
+  fe51 t3;
+
+  fe51_sq(t0, z);
+  fe51_sqn(t1, t0, 2);
+  fe51_mul(t1, z, t1);
+  fe51_mul(t0, t0, t1);
+  fe51_sq(t2, t0);
+  fe51_mul(t1, t1, t2);
+  fe51_sqn(t2, t1, 5);
+  fe51_mul(t1, t2, t1);
+  fe51_sqn(t2, t1, 10);
+  fe51_mul(t2, t2, t1);
+  fe51_sqn(t3, t2, 20);
+  fe51_mul(t2, t3, t2);
+  fe51_sqn(t2, t2, 10);
+  fe51_mul(t1, t2, t1);
+  fe51_sqn(t2, t1, 50);
+  fe51_mul(t2, t2, t1);
+  fe51_sqn(t3, t2, 100);
+  fe51_mul(t2, t3, t2);
+  fe51_sqn(t2, t2, 50);
+  fe51_mul(t1, t2, t1);
+  fe51_sqn(t1, t1, 5);
+  fe51_mul(out, t1, t0);
+}
+
+/* r = u^(m+1)v^(-(m+1)), see fe_divpowm1 */
+
+static void fe51_divpowm1(fe51 r, const fe51 u, const fe51 v) {
+  fe51 v3, uv7, t0, t1, t2;
+
+  fe51_sq(v3, v);
+  fe51_mul(v3, v3, v); /* v3 = v^3 */
+  fe51_sq(uv7, v3);
+  fe51_mul(uv7, uv7, v);
+  fe51_mul(uv7, uv7, u); /* uv7 = uv^7 */
+
+  fe51_sq(t0, uv7);
+  fe51_sqn(t1, t0, 2);
+  fe51_mul(t1, uv7, t1);
+  fe51_mul(t0, t0, t1);
+  fe51_sq(t0, t0);
+  fe51_mul(t0, t1, t0);
+  fe51_sqn(t1, t0, 5);
+  fe51_mul(t0, t1, t0);
+  fe51_sqn(t1, t0, 10);
+  fe51_mul(t1, t1, t0);
+  fe51_sqn(t2, t1, 20);
+  fe51_mul(t1, t2, t1);
+  fe51_sqn(t1, t1, 10);
+  fe51_mul(t0, t1, t0);
+  fe51_sqn(t1, t0, 50);
+  fe51_mul(t1, t1, t0);
+  fe51_sqn(t2, t1, 100);
+  fe51_mul(t1, t2, t1);
+  fe51_sqn(t1, t1, 50);
+  fe51_mul(t0, t1, t0);
+  fe51_sqn(t0, t0, 2);
+  fe51_mul(t0, t0, uv7); /* t0 = (uv^7)^((q-5)/8) */
+  fe51_mul(t0, t0, v3);
+  fe51_mul(r, t0, u);
+}
+
+/* Entry points of the ref10 functions */
+
+static void fe_mul_51(fe h, const fe f, const fe g) {
+  fe51 f51, g51;
+  fe51_from_fe(f51, f);
+  fe51_from_fe(g51, g);
+  fe51_mul(f51, f51, g51);
+  fe51_to_fe(h, f51);
+}
+
+static void fe_sq_51(fe h, const fe f, int shift) {
+  fe51 f51;
+  fe51_from_fe(f51, f);
+  fe51_sq_shift(f51, f51, shift);
+  fe51_to_fe(h, f51);
+}
+
+static void fe_invert_51(fe out, const fe z) {
+  fe51 z51;
+  fe51_from_fe(z51, z);
+  fe51_invert(z51, z51);
+  fe51_to_fe(out, z51);
+}
+
+static void fe_divpowm1_51(fe r, const fe u, const fe v) {
+  fe51 u51, v51;
+  fe51_from_fe(u51, u);
+  fe51_from_fe(v51, v);
+  fe51_divpowm1(u51, u51, v51);
+  fe51_to_fe(r, u51);
+}
+
+#endif
+
+int fe_use_radix51(int enable) {
+#if defined(FE_RADIX51)
+  fe_radix51 = enable;
+  return fe_radix51;
+#else
+  (void) enable;
+  return 0;
+#endif
+}
+
 /* From fe_0.c */
 
 /*
@@ -229,6 +522,12 @@ static void fe_copy(fe h, const fe f) {
 /* From fe_invert.c */
 
 static void fe_invert(fe out, const fe z) {
+#if defined(FE_RADIX51)
+  if (fe_radix51) {
+    fe_invert_51(out, z);
+    return;
+  }
+#endif
   fe t0;
   fe t1;
   fe t2;
@@ -348,6 +647,12 @@ With tighter constraints on inputs can squeeze carries into int32.
 */
 
 static void fe_mul(fe h, const fe f, const fe g) {
+#if defined(FE_RADIX51)
+  if (fe_radix51) {
+    fe_mul_51(h, f, g);
+    return;
+  }
+#endif
   int32_t f0 = f[0];
   int32_t f1 = f[1];
   int32_t f2 = f[2];
@@ -628,6 +933,12 @@ See fe_mul.c for discussion of implementation strategy.
 */
 
 static void fe_sq(fe h, const fe f) {
+#if defined(FE_RADIX51)
+  if (fe_radix51) {
+    fe_sq_51(h, f, 0);
+    return;
+  }
+#endif
   int32_t f0 = f[0];
   int32_t f1 = f[1];
   int32_t f2 = f[2];
@@ -776,6 +1087,12 @@ See fe_mul.c for discussion of implementation strategy.
 */
 
 static void fe_sq2(fe h, const fe f) {
+#if defined(FE_RADIX51)
+  if (fe_radix51) {
+    fe_sq_51(h, f, 1);
+    return;
+  }
+#endif
   int32_t f0 = f[0];
   int32_t f1 = f[1];
   int32_t f2 = f[2];
@@ -1166,16 +1483,23 @@ B is the Ed25519 base point (x,4/5) with x positive.
 */
 
 void ge_double_scalarmult_base_vartime(ge_p2 *r, const unsigned char *a, const ge_p3 *A, const unsigned char *b) {
+  ge_dsmp Ai; /* A, 3A, 5A, 7A, 9A, 11A, 13A, 15A */
+
+  ge_dsm_precomp(Ai, A);
+  ge_double_scalarmult_base_precomp_vartime(r, a, Ai, b);
+}
+
+/* Same as ge_double_scalarmult_base_vartime, with A given as its precomputed table */
+
+void ge_double_scalarmult_base_precomp_vartime(ge_p2 *r, const unsigned char *a, const ge_dsmp Ai, const unsigned char *b) {
   signed char aslide[256];
   signed char bslide[256];
-  ge_dsmp Ai; /* A, 3A, 5A, 7A, 9A, 11A, 13A, 15A */
   ge_p1p1 t;
   ge_p3 u;
   int i;
 
   slide(aslide, a);
   slide(bslide, b);
-  ge_dsm_precomp(Ai, A);
 
   ge_p2_0(r);
 
@@ -1484,20 +1808,20 @@ static void ge_precomp_cmov(ge_precomp *t, const ge_precomp *u, unsigned char b)
   fe_cmov(t->xy2d, u->xy2d, b);
 }
 
-static void select(ge_precomp *t, int pos, signed char b) {
+static void select(ge_precomp *t, const ge_precomp *row, signed char b) {
   ge_precomp minust;
   unsigned char bnegative = negative(b);
   unsigned char babs = b - (((-bnegative) & b) << 1);
 
   ge_precomp_0(t);
-  ge_precomp_cmov(t, &ge_base[pos][0], equal(babs, 1));
-  ge_precomp_cmov(t, &ge_base[pos][1], equal(babs, 2));
-  ge_precomp_cmov(t, &ge_base[pos][2], equal(babs, 3));
-  ge_precomp_cmov(t, &ge_base[pos][3], equal(babs, 4));
-  ge_precomp_cmov(t, &ge_base[pos][4], equal(babs, 5));
-  ge_precomp_cmov(t, &ge_base[pos][5], equal(babs, 6));
-  ge_precomp_cmov(t, &ge_base[pos][6], equal(babs, 7));
-  ge_precomp_cmov(t, &ge_base[pos][7], equal(babs, 8));
+  ge_precomp_cmov(t, &row[0], equal(babs, 1));
+  ge_precomp_cmov(t, &row[1], equal(babs, 2));
+  ge_precomp_cmov(t, &row[2], equal(babs, 3));
+  ge_precomp_cmov(t, &row[3], equal(babs, 4));
+  ge_precomp_cmov(t, &row[4], equal(babs, 5));
+  ge_precomp_cmov(t, &row[5], equal(babs, 6));
+  ge_precomp_cmov(t, &row[6], equal(babs, 7));
+  ge_precomp_cmov(t, &row[7], equal(babs, 8));
   fe_copy(minust.yplusx, t->yminusx);
   fe_copy(minust.yminusx, t->yplusx);
   fe_neg(minust.xy2d, t->xy2d);
@@ -1516,9 +1840,6 @@ Preconditions:
 void ge_scalarmult_base(ge_p3 *h, const unsigned char *a) {
   signed char e[64];
   signed char carry;
-  ge_p1p1 r;
-  ge_p2 s;
-  ge_precomp t;
   int i;
 
   for (i = 0; i < 32; ++i) {
@@ -1538,10 +1859,25 @@ void ge_scalarmult_base(ge_p3 *h, const unsigned char *a) {
   e[63] += carry;
   /* each e[i] is between -8 and 8 */
 
+  ge_scalarmult_fixed_base(h, e, ge_base);
+}
+
+/*
+h = e * A
+where e is a scalar recoded to 64 digits between -8 and 8, e.g. by ge_scalarmult_recode,
+and t holds the multiples of A computed by ge_fixed_base_precomp.
+*/
+
+void ge_scalarmult_fixed_base(ge_p3 *h, const signed char *e, const ge_fixed_base t) {
+  ge_p1p1 r;
+  ge_p2 s;
+  ge_precomp u;
+  int i;
+
   ge_p3_0(h);
   for (i = 1; i < 64; i += 2) {
-    select(&t, i / 2, e[i]);
-    ge_madd(&r, h, &t); ge_p1p1_to_p3(h, &r);
+    select(&u, t[i / 2], e[i]);
+    ge_madd(&r, h, &u); ge_p1p1_to_p3(h, &r);
   }
 
   ge_p3_dbl(&r, h);  ge_p1p1_to_p2(&s, &r);
@@ -1550,11 +1886,131 @@ void ge_scalarmult_base(ge_p3 *h, const unsigned char *a) {
   ge_p2_dbl(&r, &s); ge_p1p1_to_p3(h, &r);
 
   for (i = 0; i < 64; i += 2) {
-    select(&t, i / 2, e[i]);
-    ge_madd(&r, h, &t); ge_p1p1_to_p3(h, &r);
+    select(&u, t[i / 2], e[i]);
+    ge_madd(&r, h, &u); ge_p1p1_to_p3(h, &r);
   }
 }
 
+static void ge_precomp_store(ge_precomp *r, const ge_p3 *p) {
+  /* projective coordinates, converted to affine by ge_fixed_base_precomp */
+  fe_copy(r->yplusx, p->X);
+  fe_copy(r->yminusx, p->Y);
+  fe_copy(r->xy2d, p->Z);
+}
+
+/*
+t[i][j] = (j + 1) * 256^i * A, the same layout as ge_base for the base point.
+scratch must have room for 256 elements.
+*/
+
+void ge_fixed_base_precomp(ge_fixed_base t, const ge_p3 *A, fe *scratch) {
+  ge_precomp *entries = &t[0][0];
+  ge_p3 row = *A;
+  ge_p3 u;
+  ge_cached c;
+  ge_p1p1 r;
+  ge_p2 s;
+  fe recip;
+  fe zrecip;
+  fe x;
+  fe y;
+  int i, j;
+
+  for (i = 0; i < 32; ++i) {
+    ge_p3_to_cached(&c, &row);
+    ge_precomp_store(&t[i][0], &row);
+    u = row;
+    for (j = 1; j < 8; ++j) {
+      ge_add(&r, &u, &c);
+      ge_p1p1_to_p3(&u, &r);
+      ge_precomp_store(&t[i][j], &u);
+    }
+
+    if (i == 31) {
+      break;
+    }
+
+    ge_p3_dbl(&r, &row);
+    for (j = 1; j < 8; ++j) {
+      ge_p1p1_to_p2(&s, &r);
+      ge_p2_dbl(&r, &s);
+    }
+    ge_p1p1_to_p3(&row, &r);
+  }
+
+  /* a single inversion for all of the entries */
+  fe_copy(scratch[0], entries[0].xy2d);
+  for (i = 1; i < 256; ++i) {
+    fe_mul(scratch[i], scratch[i - 1], entries[i].xy2d);
+  }
+
+  fe_invert(recip, scratch[255]);
+  for (i = 255; i >= 0; --i) {
+    if (i > 0) {
+      fe_mul(zrecip, recip, scratch[i - 1]);
+      fe_mul(recip, recip, entries[i].xy2d);
+    } else {
+      fe_copy(zrecip, recip);
+    }
+
+    fe_mul(x, entries[i].yplusx, zrecip);
+    fe_mul(y, entries[i].yminusx, zrecip);
+    fe_add(entries[i].yplusx, y, x);
+    fe_sub(entries[i].yminusx, y, x);
+    fe_mul(entries[i].xy2d, x, y);
+    fe_mul(entries[i].xy2d, entries[i].xy2d, fe_d2);
+  }
+}
+
+static void ge_fixed_base_add_vartime(ge_p3 *h, const ge_precomp *row, signed char b) {
+  ge_p1p1 r;
+
+  if (b > 0) {
+    ge_madd(&r, h, &row[b - 1]);
+  } else if (b < 0) {
+    ge_msub(&r, h, &row[-b - 1]);
+  } else {
+    return;
+  }
+  ge_p1p1_to_p3(h, &r);
+}
+
+/*
+r = a * A + b * B
+where t holds the multiples of A computed by ge_fixed_base_precomp and B is the Ed25519 base point.
+Assumes that a[31] <= 127 and b[31] <= 127.
+*/
+
+void ge_double_scalarmult_fixed_base_vartime(ge_p2 *r, const unsigned char *a, const ge_fixed_base t, const unsigned char *b) {
+  signed char ae[64];
+  signed char be[64];
+  ge_p3 h;
+  ge_p1p1 u;
+  ge_p2 s;
+  int i;
+
+  ge_scalarmult_recode(ae, a);
+  ge_scalarmult_recode(be, b);
+
+  ge_p3_0(&h);
+  for (i = 1; i < 64; i += 2) {
+    ge_fixed_base_add_vartime(&h, t[i / 2], ae[i]);
+    ge_fixed_base_add_vartime(&h, ge_base[i / 2], be[i]);
+  }
+
+  ge_p3_dbl(&u, &h);  ge_p1p1_to_p2(&s, &u);
+  ge_p2_dbl(&u, &s); ge_p1p1_to_p2(&s, &u);
+  ge_p2_dbl(&u, &s); ge_p1p1_to_p2(&s, &u);
+  ge_p2_dbl(&u, &s); ge_p1p1_to_p3(&h, &u);
+
+  for (i = 0; i < 64; i += 2) {
+    ge_fixed_base_add_vartime(&h, t[i / 2], ae[i]);
+    ge_fixed_base_add_vartime(&h, ge_base[i / 2], be[i]);
+  }
+
+  ge_p3_to_p2(r, &h);
+}
+
 /* From ge_sub.c */
 
 /*
@@ -1590,6 +2046,41 @@ void ge_tobytes(unsigned char *s, const ge_p2 *h) {
   s[31] ^= fe_isnegative(x) << 7;
 }
 
+/* Same as ge_tobytes for count points, sharing a single field inversion.
+   s receives 32 * count bytes, scratch must have room for count elements. */
+
+void ge_tobytes_batch(unsigned char *s, const ge_p2 *h, fe *scratch, size_t count) {
+  fe recip;
+  fe zrecip;
+  fe x;
+  fe y;
+  size_t i;
+
+  if (count == 0) {
+    return;
+  }
+
+  fe_copy(scratch[0], h[0].Z);
+  for (i = 1; i < count; ++i) {
+    fe_mul(scratch[i], scratch[i - 1], h[i].Z);
+  }
+
+  fe_invert(recip, scratch[count - 1]);
+  for (i = count - 1; i > 0; --i) {
+    fe_mul(zrecip, recip, scratch[i - 1]);
+    fe_mul(recip, recip, h[i].Z);
+    fe_mul(x, h[i].X, zrecip);
+    fe_mul(y, h[i].Y, zrecip);
+    fe_tobytes(s + 32 * i, y);
+    s[32 * i + 31] ^= fe_isnegative(x) << 7;
+  }
+
+  fe_mul(x, h[0].X, recip);
+  fe_mul(y, h[0].Y, recip);
+  fe_tobytes(s, y);
+  s[31] ^= fe_isnegative(x) << 7;
+}
+
 /* From sc_reduce.c */
 
 /*
@@ -1834,6 +2325,12 @@ void sc_reduce(unsigned char *s) {
 /* New code */
 
 static void fe_divpowm1(fe r, const fe u, const fe v) {
+#if defined(FE_RADIX51)
+  if (fe_radix51) {
+    fe_divpowm1_51(r, u, v);
+    return;
+  }
+#endif
   fe v3, uv7, t0, t1, t2;
   int i;
 
@@ -1911,13 +2408,9 @@ static void ge_cached_cmov(ge_cached *t, const ge_cached *u, unsigned char b) {
   fe_cmov(t->T2d, u->T2d, b);
 }
 
-/* Assumes that a[31] <= 127 */
-void ge_scalarmult(ge_p2 *r, const unsigned char *a, const ge_p3 *A) {
-  signed char e[64];
+/* Recodes a to 64 digits between -8 and 8, most significant last. Assumes that a[31] <= 127 */
+void ge_scalarmult_recode(signed char *e, const unsigned char *a) {
   int carry, carry2, i;
-  ge_cached Ai[8]; /* 1 * A, 2 * A, ..., 8 * A */
-  ge_p1p1 t;
-  ge_p3 u;
 
   carry = 0; /* 0..1 */
   for (i = 0; i < 31; i++) {
@@ -1931,6 +2424,22 @@ void ge_scalarmult(ge_p2 *r, const unsigned char *a, const ge_p3 *A) {
   carry2 = (carry + 8) >> 4; /* 0..8 */
   e[62] = carry - (carry2 << 4); /* -8..7 */
   e[63] = carry2; /* 0..8 */
+}
+
+/* Assumes that a[31] <= 127 */
+void ge_scalarmult(ge_p2 *r, const unsigned char *a, const ge_p3 *A) {
+  signed char e[64];
+
+  ge_scalarmult_recode(e, a);
+  ge_scalarmult_recoded(r, e, A);
+}
+
+/* The same as ge_scalarmult for a scalar recoded by ge_scalarmult_recode */
+void ge_scalarmult_recoded(ge_p2 *r, const signed char *e, const ge_p3 *A) {
+  int i;
+  ge_cached Ai[8]; /* 1 * A, 2 * A, ..., 8 * A */
+  ge_p1p1 t;
+  ge_p3 u;
 
   ge_p3_to_cached(&Ai[0], A);
   for (i = 0; i < 7; i++) {
@@ -1973,16 +2482,23 @@ void ge_scalarmult(ge_p2 *r, const unsigned char *a, const ge_p3 *A) {
 }
 
 void ge_double_scalarmult_precomp_vartime(ge_p2 *r, const unsigned char *a, const ge_p3 *A, const unsigned char *b, const ge_dsmp Bi) {
+  ge_dsmp Ai; /* A, 3A, 5A, 7A, 9A, 11A, 13A, 15A */
+
+  ge_dsm_precomp(Ai, A);
+  ge_double_scalarmult_precomp2_vartime(r, a, Ai, b, Bi);
+}
+
+/* r = a * A + b * B, with both points given as their precomputed tables */
+
+void ge_double_scalarmult_precomp2_vartime(ge_p2 *r, const unsigned char *a, const ge_dsmp Ai, const unsigned char *b, const ge_dsmp Bi) {
   signed char aslide[256];
   signed char bslide[256];
-  ge_dsmp Ai; /* A, 3A, 5A, 7A, 9A, 11A, 13A, 15A */
   ge_p1p1 t;
   ge_p3 u;
   int i;
 
   slide(aslide, a);
   slide(bslide, b);
-  ge_dsm_precomp(Ai, A);
 
   ge_p2_0(r);
 
@@ -49,6 +49,7 @@ typedef ge_cached ge_dsmp[8];
 extern const ge_precomp ge_Bi[8];
 void ge_dsm_precomp(ge_dsmp r, const ge_p3 *s);
 void ge_double_scalarmult_base_vartime(ge_p2 *, const unsigned char *, const ge_p3 *, const unsigned char *);
+void ge_double_scalarmult_base_precomp_vartime(ge_p2 *, const unsigned char *, const ge_dsmp, const unsigned char *);
 
 /* From ge_frombytes.c, modified */
 
@@ -86,6 +87,13 @@ void ge_p3_tobytes(unsigned char *, const ge_p3 *);
 extern const ge_precomp ge_base[32][8];
 void ge_scalarmult_base(ge_p3 *, const unsigned char *);
 
+/* Fixed point multiplication with a table like ge_base, modified */
+
+typedef ge_precomp ge_fixed_base[32][8];
+void ge_fixed_base_precomp(ge_fixed_base, const ge_p3 *, fe *);
+void ge_scalarmult_fixed_base(ge_p3 *, const signed char *, const ge_fixed_base);
+void ge_double_scalarmult_fixed_base_vartime(ge_p2 *, const unsigned char *, const ge_fixed_base, const unsigned char *);
+
 /* From ge_sub.c */
 
 void ge_sub(ge_p1p1 *, const ge_p3 *, const ge_cached *);
@@ -93,6 +101,7 @@ void ge_sub(ge_p1p1 *, const ge_p3 *, const ge_cached *);
 /* From ge_tobytes.c */
 
 void ge_tobytes(unsigned char *, const ge_p2 *);
+void ge_tobytes_batch(unsigned char *, const ge_p2 *, fe *, size_t);
 
 /* From sc_reduce.c */
 
@@ -101,7 +110,10 @@ void sc_reduce(unsigned char *);
 /* New code */
 
 void ge_scalarmult(ge_p2 *, const unsigned char *, const ge_p3 *);
+void ge_scalarmult_recode(signed char *, const unsigned char *);
+void ge_scalarmult_recoded(ge_p2 *, const signed char *, const ge_p3 *);
 void ge_double_scalarmult_precomp_vartime(ge_p2 *, const unsigned char *, const ge_p3 *, const unsigned char *, const ge_dsmp);
+void ge_double_scalarmult_precomp2_vartime(ge_p2 *, const unsigned char *, const ge_dsmp, const unsigned char *, const ge_dsmp);
 void ge_mul8(ge_p1p1 *, const ge_p2 *);
 extern const fe fe_ma2;
 extern const fe fe_ma;
@@ -117,3 +129,8 @@ void sc_sub(unsigned char *, const unsigned char *, const unsigned char *);
 void sc_mulsub(unsigned char *, const unsigned char *, const unsigned char *, const unsigned char *);
 int sc_check(const unsigned char *);
 int sc_isnonzero(const unsigned char *); /* Doesn't normalize */
+int fe_use_radix51(int); /* Returns whether radix 2^51 arithmetic is used */
+
+/* From crypto-ops-avx2.c, requires AVX2 */
+
+void ge_scalarmult_x4(ge_p2 *, const signed char *, const ge_p3 *); /* Multiplies four points by the same recoded scalar */
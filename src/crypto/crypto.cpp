@@ -3,13 +3,24 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <alloca.h>
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <list>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
 
 #include "Common/Varint.h"
 #include "crypto.h"
@@ -21,6 +32,7 @@ namespace Crypto {
   using std::int32_t;
   using std::lock_guard;
   using std::mutex;
+  using std::unique_lock;
 
   extern "C" {
 #include "crypto-ops.h"
@@ -41,6 +53,39 @@ namespace Crypto {
     sc_reduce32(reinterpret_cast<unsigned char*>(&res));
   }
 
+  // AVX2 can be used only if the OS also saves the YMM registers on context switches
+  static bool detect_avx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+      return false;
+    }
+
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    unsigned int a, b, c, d;
+    if (__get_cpuid_max(0, nullptr) < 7) {
+      return false;
+    }
+
+    __cpuid(1, a, b, c, d);
+    if ((c & bit_OSXSAVE) == 0 || (c & bit_AVX) == 0) {
+      return false;
+    }
+
+    unsigned int xcr0, xcr0High;
+    __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+    __cpuid_count(7, 0, a, b, c, d);
+    return (xcr0 & 6) == 6 && (b & bit_AVX2) != 0;
+#endif
+  }
+
+  static const bool avx2_supported = detect_avx2();
+
   void crypto_ops::generate_keys(PublicKey &pub, SecretKey &sec) {
     lock_guard<mutex> lock(random_lock);
     ge_p3 point;
@@ -79,6 +124,122 @@ namespace Crypto {
     return true;
   }
 
+  PrecomputedSecretKey::PrecomputedSecretKey(const SecretKey &key) {
+    assert(sc_check(reinterpret_cast<const unsigned char*>(&key)) == 0);
+    ge_scalarmult_recode(digits, reinterpret_cast<const unsigned char*>(&key));
+  }
+
+  struct PrecomputedPublicKey::Table {
+    ge_fixed_base multiples;
+  };
+
+  PrecomputedPublicKey::PrecomputedPublicKey() {
+  }
+
+  PrecomputedPublicKey::~PrecomputedPublicKey() {
+  }
+
+  static std::unique_ptr<PrecomputedPublicKey::Table> precompute_table(const ge_p3 &point) {
+    std::unique_ptr<PrecomputedPublicKey::Table> table(new PrecomputedPublicKey::Table);
+    std::vector<int32_t> scratch(10 * 256);
+    ge_fixed_base_precomp(table->multiples, &point, reinterpret_cast<fe *>(scratch.data()));
+    return table;
+  }
+
+  bool crypto_ops::precompute_public_key(const PublicKey &key, PrecomputedPublicKey &precomputed) {
+    ge_p3 point;
+    if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char*>(&key)) != 0) {
+      return false;
+    }
+
+    precomputed.table = precompute_table(point);
+    return true;
+  }
+
+  bool crypto_ops::generate_key_derivation(const PublicKey &key1, const PrecomputedSecretKey &key2, KeyDerivation &derivation) {
+    ge_p3 point;
+    ge_p2 point2;
+    ge_p1p1 point3;
+    if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char*>(&key1)) != 0) {
+      return false;
+    }
+    ge_scalarmult_recoded(&point2, key2.digits, &point);
+    ge_mul8(&point3, &point2);
+    ge_p1p1_to_p2(&point2, &point3);
+    ge_tobytes(reinterpret_cast<unsigned char*>(&derivation), &point2);
+    return true;
+  }
+
+  bool crypto_ops::generate_key_derivation(const PrecomputedPublicKey &key1, const SecretKey &key2, KeyDerivation &derivation) {
+    ge_p3 point;
+    ge_p2 point2;
+    ge_p1p1 point3;
+    if (!key1.table) {
+      return false;
+    }
+    PrecomputedSecretKey digits(key2);
+    ge_scalarmult_fixed_base(&point, digits.digits, key1.table->multiples);
+    ge_p3_to_p2(&point2, &point);
+    ge_mul8(&point3, &point2);
+    ge_p1p1_to_p2(&point2, &point3);
+    ge_tobytes(reinterpret_cast<unsigned char*>(&derivation), &point2);
+    return true;
+  }
+
+  void crypto_ops::generate_key_derivations(const PublicKey *keys, size_t count, const SecretKey &key, KeyDerivation *derivations, bool *results) {
+    generate_key_derivations(keys, count, PrecomputedSecretKey(key), derivations, results);
+  }
+
+  void crypto_ops::generate_key_derivations(const PublicKey *keys, size_t count, const PrecomputedSecretKey &key, KeyDerivation *derivations, bool *results) {
+    if (!avx2_supported) {
+      for (size_t i = 0; i < count; ++i) {
+        results[i] = generate_key_derivation(keys[i], key, derivations[i]);
+      }
+
+      return;
+    }
+
+    for (size_t first = 0; first < count; first += 4) {
+      size_t lanes = std::min<size_t>(4, count - first);
+      size_t validLane = 4;
+      ge_p3 points[4];
+      for (size_t i = 0; i < lanes; ++i) {
+        results[first + i] = ge_frombytes_vartime(&points[i], reinterpret_cast<const unsigned char*>(&keys[first + i])) == 0;
+        if (results[first + i]) {
+          validLane = i;
+        }
+      }
+
+      if (validLane == 4) {
+        continue;
+      }
+
+      // lanes without a valid key compute a copy of a valid one and are discarded
+      for (size_t i = 0; i < 4; ++i) {
+        if (i >= lanes || !results[first + i]) {
+          points[i] = points[validLane];
+        }
+      }
+
+      ge_p2 products[4];
+      ge_p1p1 product8;
+      fe scratch[4];
+      KeyDerivation encoded[4];
+      ge_scalarmult_x4(products, key.digits, points);
+      for (size_t i = 0; i < 4; ++i) {
+        ge_mul8(&product8, &products[i]);
+        ge_p1p1_to_p2(&products[i], &product8);
+      }
+
+      ge_tobytes_batch(reinterpret_cast<unsigned char*>(encoded), products, scratch, 4);
+      for (size_t i = 0; i < lanes; ++i) {
+        if (results[first + i]) {
+          derivations[first + i] = encoded[i];
+        }
+      }
+    }
+  }
+
   static void derivation_to_scalar(const KeyDerivation &derivation, size_t output_index, EllipticCurveScalar &res) {
     struct {
       KeyDerivation derivation;
@@ -223,6 +384,117 @@ namespace Crypto {
     return true;
   }
 
+  // Up to this many spend keys, output keys are derived from every spend key and compared,
+  // which is cheaper than decompressing each output key to underive it
+  static const size_t FIND_OUTPUTS_DERIVE_LIMIT = 8;
+  // Points encoded with a single field inversion
+  static const size_t FIND_OUTPUTS_BATCH_SIZE = 64;
+
+  void crypto_ops::find_outputs(const PublicKey *txKeys, size_t txCount, const TransactionOutputKey *outputs, size_t outputCount,
+    const SecretKey &viewKey, const PublicKey *spendKeys, size_t spendKeyCount, std::vector<OutputKeyMatch> &matches) {
+    matches.clear();
+    if (outputCount == 0 || spendKeyCount == 0) {
+      return;
+    }
+
+    std::vector<KeyDerivation> derivations(txCount);
+    std::unique_ptr<bool[]> validTxKeys(new bool[txCount]);
+    generate_key_derivations(txKeys, txCount, viewKey, derivations.data(), validTxKeys.get());
+
+    bool derive = spendKeyCount <= FIND_OUTPUTS_DERIVE_LIMIT;
+    // deriving uses the decompressed spend keys, underiving looks the results up in the sorted spend keys
+    std::vector<size_t> spendKeyOrder;
+    std::vector<ge_cached> spendPoints;
+    std::vector<std::pair<PublicKey, size_t>> sortedSpendKeys;
+    auto lessKey = [](const std::pair<PublicKey, size_t> &a, const std::pair<PublicKey, size_t> &b) {
+      return std::memcmp(&a.first, &b.first, sizeof(PublicKey)) < 0;
+    };
+    if (derive) {
+      for (size_t i = 0; i < spendKeyCount; ++i) {
+        ge_p3 point;
+        if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char*>(&spendKeys[i])) == 0) {
+          spendPoints.emplace_back();
+          ge_p3_to_cached(&spendPoints.back(), &point);
+          spendKeyOrder.push_back(i);
+        }
+      }
+    } else {
+      for (size_t i = 0; i < spendKeyCount; ++i) {
+        sortedSpendKeys.emplace_back(spendKeys[i], i);
+      }
+
+      std::sort(sortedSpendKeys.begin(), sortedSpendKeys.end(), lessKey);
+    }
+
+    // candidates[i] is the output and, when deriving, the spend key of points[i]
+    std::vector<OutputKeyMatch> candidates;
+    std::vector<ge_p2> points;
+    fe scratch[FIND_OUTPUTS_BATCH_SIZE];
+    PublicKey encoded[FIND_OUTPUTS_BATCH_SIZE];
+    candidates.reserve(FIND_OUTPUTS_BATCH_SIZE);
+    points.reserve(FIND_OUTPUTS_BATCH_SIZE);
+
+    auto flush = [&] {
+      ge_tobytes_batch(reinterpret_cast<unsigned char*>(encoded), points.data(), scratch, points.size());
+      for (size_t i = 0; i < points.size(); ++i) {
+        if (derive) {
+          if (std::memcmp(&encoded[i], &outputs[candidates[i].output].key, sizeof(PublicKey)) == 0) {
+            matches.push_back(candidates[i]);
+          }
+        } else {
+          auto range = std::equal_range(sortedSpendKeys.begin(), sortedSpendKeys.end(), std::make_pair(encoded[i], size_t(0)), lessKey);
+          for (auto it = range.first; it != range.second; ++it) {
+            matches.push_back(OutputKeyMatch{ candidates[i].output, it->second });
+          }
+        }
+      }
+
+      candidates.clear();
+      points.clear();
+    };
+
+    size_t pointsPerOutput = derive ? spendPoints.size() : 1;
+    for (size_t i = 0; i < outputCount; ++i) {
+      const TransactionOutputKey &output = outputs[i];
+      assert(output.transaction < txCount);
+      if (!validTxKeys[output.transaction]) {
+        continue;
+      }
+
+      EllipticCurveScalar scalar;
+      ge_p3 base;
+      ge_p1p1 sum;
+      derivation_to_scalar(derivations[output.transaction], output.keyIndex, scalar);
+      ge_scalarmult_base(&base, reinterpret_cast<unsigned char*>(&scalar));
+      if (derive) {
+        for (size_t j = 0; j < spendPoints.size(); ++j) {
+          ge_add(&sum, &base, &spendPoints[j]);
+          points.emplace_back();
+          ge_p1p1_to_p2(&points.back(), &sum);
+          candidates.push_back(OutputKeyMatch{ i, spendKeyOrder[j] });
+        }
+      } else {
+        ge_p3 key;
+        ge_cached cachedBase;
+        if (ge_frombytes_vartime(&key, reinterpret_cast<const unsigned char*>(&output.key)) != 0) {
+          continue;
+        }
+
+        ge_p3_to_cached(&cachedBase, &base);
+        ge_sub(&sum, &key, &cachedBase);
+        points.emplace_back();
+        ge_p1p1_to_p2(&points.back(), &sum);
+        candidates.push_back(OutputKeyMatch{ i, 0 });
+      }
+
+      if (points.size() + pointsPerOutput > FIND_OUTPUTS_BATCH_SIZE) {
+        flush();
+      }
+    }
+
+    flush();
+  }
+
 
   struct s_comm {
     Hash h;
@@ -427,4 +699,204 @@ namespace Crypto {
     sc_sub(reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&sum));
     return sc_isnonzero(reinterpret_cast<unsigned char*>(&h)) == 0;
   }
+
+  // Ring members used this many times get multiples of the key precomputed, 30 KiB each,
+  // for at most 1/16 of the cache capacity
+  static const uint64_t POPULAR_RING_MEMBER_USES = 8;
+  static const size_t POPULAR_RING_MEMBER_SHARE = 16;
+
+  struct RingMemberTables {
+    ge_dsmp key;
+    ge_dsmp keyHash;
+    std::unique_ptr<PrecomputedPublicKey::Table> keyMultiples;
+  };
+
+  struct RingMemberCache::Impl {
+    struct Entry {
+      PublicKey key;
+      std::shared_ptr<const RingMemberTables> tables;
+      uint64_t uses;
+    };
+
+    typedef std::list<Entry> Entries;
+
+    mutex entriesLock;
+    size_t capacity;
+    Entries entries; // most recently used first
+    std::unordered_map<PublicKey, Entries::iterator> entriesByKey;
+    size_t popularEntries;
+    uint64_t hits;
+    uint64_t misses;
+  };
+
+  RingMemberCache::RingMemberCache(size_t capacity) : impl(new Impl()) {
+    impl->capacity = capacity;
+    impl->popularEntries = 0;
+    impl->hits = 0;
+    impl->misses = 0;
+  }
+
+  RingMemberCache::~RingMemberCache() {
+  }
+
+  uint64_t RingMemberCache::hits() const {
+    lock_guard<mutex> lock(impl->entriesLock);
+    return impl->hits;
+  }
+
+  uint64_t RingMemberCache::misses() const {
+    lock_guard<mutex> lock(impl->entriesLock);
+    return impl->misses;
+  }
+
+  static std::shared_ptr<const RingMemberTables> add_key_multiples(RingMemberCache::Impl &cache, const PublicKey &key,
+    std::shared_ptr<const RingMemberTables> tables) {
+    ge_p3 point;
+    if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char*>(&key)) != 0) {
+      abort();
+    }
+
+    std::shared_ptr<RingMemberTables> popularTables = std::make_shared<RingMemberTables>();
+    memcpy(popularTables->key, tables->key, sizeof(ge_dsmp));
+    memcpy(popularTables->keyHash, tables->keyHash, sizeof(ge_dsmp));
+    popularTables->keyMultiples = precompute_table(point);
+
+    lock_guard<mutex> lock(cache.entriesLock);
+    auto it = cache.entriesByKey.find(key);
+    if (it == cache.entriesByKey.end() || it->second->tables->keyMultiples ||
+      cache.popularEntries >= cache.capacity / POPULAR_RING_MEMBER_SHARE) {
+      return popularTables;
+    }
+
+    it->second->tables = popularTables;
+    ++cache.popularEntries;
+    return popularTables;
+  }
+
+  static std::shared_ptr<const RingMemberTables> get_ring_member_tables(RingMemberCache::Impl &cache, const PublicKey &key) {
+    {
+      unique_lock<mutex> lock(cache.entriesLock);
+      auto it = cache.entriesByKey.find(key);
+      if (it != cache.entriesByKey.end()) {
+        cache.entries.splice(cache.entries.begin(), cache.entries, it->second);
+        ++cache.hits;
+        std::shared_ptr<const RingMemberTables> tables = it->second->tables;
+        if (++it->second->uses != POPULAR_RING_MEMBER_USES || tables->keyMultiples ||
+          cache.popularEntries >= cache.capacity / POPULAR_RING_MEMBER_SHARE) {
+          return tables;
+        }
+
+        lock.unlock();
+        return add_key_multiples(cache, key, tables);
+      }
+
+      ++cache.misses;
+    }
+
+    std::shared_ptr<RingMemberTables> tables = std::make_shared<RingMemberTables>();
+    ge_p3 point;
+    if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char*>(&key)) != 0) {
+      abort();
+    }
+    ge_dsm_precomp(tables->key, &point);
+    hash_to_ec(key, point);
+    ge_dsm_precomp(tables->keyHash, &point);
+
+    lock_guard<mutex> lock(cache.entriesLock);
+    if (cache.capacity == 0 || cache.entriesByKey.count(key) != 0) {
+      return tables;
+    }
+
+    if (cache.entries.size() >= cache.capacity) {
+      if (cache.entries.back().tables->keyMultiples) {
+        --cache.popularEntries;
+      }
+
+      cache.entriesByKey.erase(cache.entries.back().key);
+      cache.entries.pop_back();
+    }
+
+    cache.entries.push_front(RingMemberCache::Impl::Entry{ key, tables, 1 });
+    cache.entriesByKey.emplace(key, cache.entries.begin());
+    return tables;
+  }
+
+  bool crypto_ops::check_ring_signatures(const RingSignatureBatchEntry *entries, size_t count, RingMemberCache *cache) {
+    size_t i, j;
+    size_t totalPubs = 0;
+    size_t maxPubs = 0;
+    for (i = 0; i < count; i++) {
+      totalPubs += entries[i].pubsCount;
+      maxPubs = std::max(maxPubs, entries[i].pubsCount);
+    }
+
+    // without a shared cache keys repeated within the batch are still prepared once
+    std::unique_ptr<RingMemberCache> localCache;
+    if (cache == nullptr) {
+      localCache.reset(new RingMemberCache(totalPubs));
+      cache = localCache.get();
+    }
+
+    // points a and b of every ring member, in the order they are hashed
+    std::vector<ge_p2> points(2 * totalPubs);
+    std::vector<EllipticCurveScalar> sums(count);
+    size_t pointIndex = 0;
+    for (i = 0; i < count; i++) {
+      const RingSignatureBatchEntry &entry = entries[i];
+      ge_p3 image_unp;
+      ge_dsmp image_pre;
+#if !defined(NDEBUG)
+      for (j = 0; j < entry.pubsCount; j++) {
+        assert(check_key(*entry.pubs[j]));
+      }
+#endif
+      if (ge_frombytes_vartime(&image_unp, reinterpret_cast<const unsigned char*>(entry.image)) != 0) {
+        return false;
+      }
+      ge_dsm_precomp(image_pre, &image_unp);
+      sc_0(reinterpret_cast<unsigned char*>(&sums[i]));
+      for (j = 0; j < entry.pubsCount; j++) {
+        const unsigned char *c = reinterpret_cast<const unsigned char*>(&entry.sig[j]);
+        const unsigned char *r = c + 32;
+        if (sc_check(c) != 0 || sc_check(r) != 0) {
+          return false;
+        }
+        std::shared_ptr<const RingMemberTables> tables = get_ring_member_tables(*cache->impl, *entry.pubs[j]);
+        if (tables->keyMultiples) {
+          ge_double_scalarmult_fixed_base_vartime(&points[pointIndex++], c, tables->keyMultiples->multiples, r);
+        } else {
+          ge_double_scalarmult_base_precomp_vartime(&points[pointIndex++], c, tables->key, r);
+        }
+        ge_double_scalarmult_precomp2_vartime(&points[pointIndex++], r, tables->keyHash, c, image_pre);
+        sc_add(reinterpret_cast<unsigned char*>(&sums[i]), reinterpret_cast<unsigned char*>(&sums[i]), c);
+      }
+    }
+
+    std::vector<EllipticCurvePoint> encodedPoints(2 * totalPubs);
+    std::vector<int32_t> scratch(10 * 2 * totalPubs);
+    ge_tobytes_batch(reinterpret_cast<unsigned char*>(encodedPoints.data()), points.data(), reinterpret_cast<fe *>(scratch.data()), points.size());
+
+    rs_comm *const buf = reinterpret_cast<rs_comm *>(alloca(rs_comm_size(maxPubs)));
+    pointIndex = 0;
+    for (i = 0; i < count; i++) {
+      const RingSignatureBatchEntry &entry = entries[i];
+      EllipticCurveScalar h;
+      buf->h = *entry.prefixHash;
+      if (entry.pubsCount != 0) {
+        memcpy(buf->ab, &encodedPoints[pointIndex], 2 * sizeof(EllipticCurvePoint) * entry.pubsCount);
+      }
+      pointIndex += 2 * entry.pubsCount;
+      hash_to_scalar(buf, rs_comm_size(entry.pubsCount), h);
+      sc_sub(reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&sums[i]));
+      if (sc_isnonzero(reinterpret_cast<unsigned char*>(&h)) != 0) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool crypto_ops::use_radix51_field(bool enable) {
+    return fe_use_radix51(enable ? 1 : 0) != 0;
+  }
 }
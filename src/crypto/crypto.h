@@ -5,7 +5,9 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <memory>
 #include <mutex>
 #include <type_traits>
 #include <vector>
@@ -31,6 +33,75 @@ struct EllipticCurveScalar {
   uint8_t data[32];
 };
 
+  struct RingSignatureBatchEntry {
+    const Hash *prefixHash;
+    const KeyImage *image;
+    const PublicKey *const *pubs;
+    size_t pubsCount;
+    const Signature *sig;
+  };
+
+  /* Output key of a transaction scanned by find_outputs.
+   * transaction indexes the transaction public keys, keyIndex is the index the key was derived with.
+   */
+  struct TransactionOutputKey {
+    size_t transaction;
+    size_t keyIndex;
+    PublicKey key;
+  };
+
+  struct OutputKeyMatch {
+    size_t output;
+    size_t spendKey;
+  };
+
+  /* Precomputed tables of public keys used as ring members, shared by check_ring_signatures calls.
+   * Keeps at most capacity keys, least recently used ones are dropped first. Thread safe.
+   */
+  class RingMemberCache {
+  public:
+    explicit RingMemberCache(size_t capacity);
+    RingMemberCache(const RingMemberCache &) = delete;
+    ~RingMemberCache();
+    RingMemberCache &operator=(const RingMemberCache &) = delete;
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+    struct Impl;
+
+  private:
+    friend class crypto_ops;
+    std::unique_ptr<Impl> impl;
+  };
+
+  /* A secret key recoded once for multiplying many points by it, e.g. the "view" key during wallet synchronization.
+   */
+  class PrecomputedSecretKey {
+  public:
+    explicit PrecomputedSecretKey(const SecretKey &key);
+
+  private:
+    friend class crypto_ops;
+    signed char digits[64];
+  };
+
+  /* Multiples of a public key for multiplying it by many secret keys, filled by precompute_public_key. Takes 30 KiB.
+   */
+  class PrecomputedPublicKey {
+  public:
+    PrecomputedPublicKey();
+    PrecomputedPublicKey(const PrecomputedPublicKey &) = delete;
+    ~PrecomputedPublicKey();
+    PrecomputedPublicKey &operator=(const PrecomputedPublicKey &) = delete;
+
+    struct Table;
+
+  private:
+    friend class crypto_ops;
+    std::unique_ptr<Table> table;
+  };
+
   class crypto_ops {
     crypto_ops();
     crypto_ops(const crypto_ops &);
@@ -45,6 +116,16 @@ struct EllipticCurveScalar {
     friend bool secret_key_to_public_key(const SecretKey &, PublicKey &);
     static bool generate_key_derivation(const PublicKey &, const SecretKey &, KeyDerivation &);
     friend bool generate_key_derivation(const PublicKey &, const SecretKey &, KeyDerivation &);
+    static bool generate_key_derivation(const PublicKey &, const PrecomputedSecretKey &, KeyDerivation &);
+    friend bool generate_key_derivation(const PublicKey &, const PrecomputedSecretKey &, KeyDerivation &);
+    static bool generate_key_derivation(const PrecomputedPublicKey &, const SecretKey &, KeyDerivation &);
+    friend bool generate_key_derivation(const PrecomputedPublicKey &, const SecretKey &, KeyDerivation &);
+    static void generate_key_derivations(const PublicKey *, size_t, const SecretKey &, KeyDerivation *, bool *);
+    friend void generate_key_derivations(const PublicKey *, size_t, const SecretKey &, KeyDerivation *, bool *);
+    static void generate_key_derivations(const PublicKey *, size_t, const PrecomputedSecretKey &, KeyDerivation *, bool *);
+    friend void generate_key_derivations(const PublicKey *, size_t, const PrecomputedSecretKey &, KeyDerivation *, bool *);
+    static bool precompute_public_key(const PublicKey &, PrecomputedPublicKey &);
+    friend bool precompute_public_key(const PublicKey &, PrecomputedPublicKey &);
     static bool derive_public_key(const KeyDerivation &, size_t, const PublicKey &, PublicKey &);
     friend bool derive_public_key(const KeyDerivation &, size_t, const PublicKey &, PublicKey &);
     friend bool derive_public_key(const KeyDerivation &, size_t, const PublicKey &, const uint8_t*, size_t, PublicKey &);
@@ -63,6 +144,10 @@ struct EllipticCurveScalar {
     friend bool underive_public_key(const KeyDerivation &, size_t, const PublicKey &, PublicKey &);
     static bool underive_public_key(const KeyDerivation &, size_t, const PublicKey &, const uint8_t*, size_t, PublicKey &);
     friend bool underive_public_key(const KeyDerivation &, size_t, const PublicKey &, const uint8_t*, size_t, PublicKey &);
+    static void find_outputs(const PublicKey *, size_t, const TransactionOutputKey *, size_t, const SecretKey &,
+      const PublicKey *, size_t, std::vector<OutputKeyMatch> &);
+    friend void find_outputs(const PublicKey *, size_t, const TransactionOutputKey *, size_t, const SecretKey &,
+      const PublicKey *, size_t, std::vector<OutputKeyMatch> &);
     static void generate_signature(const Hash &, const PublicKey &, const SecretKey &, Signature &);
     friend void generate_signature(const Hash &, const PublicKey &, const SecretKey &, Signature &);
     static bool check_signature(const Hash &, const PublicKey &, const Signature &);
@@ -79,6 +164,10 @@ struct EllipticCurveScalar {
       const PublicKey *const *, size_t, const Signature *);
     friend bool check_ring_signature(const Hash &, const KeyImage &,
       const PublicKey *const *, size_t, const Signature *);
+    static bool check_ring_signatures(const RingSignatureBatchEntry *, size_t, RingMemberCache *);
+    friend bool check_ring_signatures(const RingSignatureBatchEntry *, size_t, RingMemberCache *);
+    static bool use_radix51_field(bool);
+    friend bool use_radix51_field(bool);
   };
 
   /* Generate a value filled with random bytes.
@@ -148,6 +237,37 @@ struct EllipticCurveScalar {
     return crypto_ops::generate_key_derivation(key1, key2, derivation);
   }
 
+  /* Generates key derivations of many public keys with the same secret key, four at a time where AVX2 is available.
+   * results[i] tells whether keys[i] is valid, derivations[i] is set only if it is.
+   */
+  inline void generate_key_derivations(const PublicKey *keys, size_t count, const SecretKey &key, KeyDerivation *derivations, bool *results) {
+    crypto_ops::generate_key_derivations(keys, count, key, derivations, results);
+  }
+
+  inline void generate_key_derivations(const PublicKey *keys, size_t count, const PrecomputedSecretKey &key, KeyDerivation *derivations, bool *results) {
+    crypto_ops::generate_key_derivations(keys, count, key, derivations, results);
+  }
+
+  /* The same as generate_key_derivation with the secret key recoded in advance.
+   */
+  inline bool generate_key_derivation(const PublicKey &key1, const PrecomputedSecretKey &key2, KeyDerivation &derivation) {
+    return crypto_ops::generate_key_derivation(key1, key2, derivation);
+  }
+
+  /* Prepares a public key for generate_key_derivation with many secret keys, e.g. the "view" key of a frequent receiver.
+   * Returns false if the key is not a valid point.
+   */
+  inline bool precompute_public_key(const PublicKey &key, PrecomputedPublicKey &precomputed) {
+    return crypto_ops::precompute_public_key(key, precomputed);
+  }
+
+  /* The same as generate_key_derivation with a public key prepared by precompute_public_key, about three times faster.
+   * Returns false if the key was not prepared.
+   */
+  inline bool generate_key_derivation(const PrecomputedPublicKey &key1, const SecretKey &key2, KeyDerivation &derivation) {
+    return crypto_ops::generate_key_derivation(key1, key2, derivation);
+  }
+
   inline bool derive_public_key(const KeyDerivation &derivation, size_t output_index,
     const PublicKey &base, const uint8_t* prefix, size_t prefixLength, PublicKey &derived_key) {
     return crypto_ops::derive_public_key(derivation, output_index, base, prefix, prefixLength, derived_key);
@@ -187,6 +307,16 @@ struct EllipticCurveScalar {
     return crypto_ops::underive_public_key(derivation, output_index, derived_key, base);
   }
 
+  /* Finds which of the outputs were sent to the receiver with the given "view" secret key and any of the "spend" keys.
+   * Does the same as generate_key_derivation and underive_public_key for every output, but shares the field inversions
+   * and the view key multiplications between all of them. matches lists the found outputs in ascending order.
+   * With few spend keys the output keys are compared by encoding, so keys which are not canonically encoded never match.
+   */
+  inline void find_outputs(const PublicKey *txKeys, size_t txCount, const TransactionOutputKey *outputs, size_t outputCount,
+    const SecretKey &viewKey, const PublicKey *spendKeys, size_t spendKeyCount, std::vector<OutputKeyMatch> &matches) {
+    crypto_ops::find_outputs(txKeys, txCount, outputs, outputCount, viewKey, spendKeys, spendKeyCount, matches);
+  }
+
   /* Generation and checking of a standard signature.
    */
   inline void generate_signature(const Hash &prefix_hash, const PublicKey &pub, const SecretKey &sec, Signature &sig) {
@@ -222,6 +352,21 @@ struct EllipticCurveScalar {
     return crypto_ops::check_ring_signature(prefix_hash, image, pubs, pubs_count, sig);
   }
 
+  /* Checks several ring signatures at once, the result is the same as of check_ring_signature called for each of them.
+   * Ring members are decoded and prepared once per key, the points of all signatures are encoded with a single field inversion.
+   * Returns false as soon as an invalid signature is found. Cache may be null.
+   */
+  inline bool check_ring_signatures(const RingSignatureBatchEntry *entries, size_t count, RingMemberCache *cache) {
+    return crypto_ops::check_ring_signatures(entries, count, cache);
+  }
+
+  /* Switches the field arithmetic between the radix 2^51 and the ref10 implementations, for tests and benchmarks.
+   * Returns whether radix 2^51 arithmetic is used, which is the default where it is available.
+   */
+  inline bool use_radix51_field(bool enable) {
+    return crypto_ops::use_radix51_field(enable);
+  }
+
   /* Variants with vector<const PublicKey *> parameters.
    */
   inline void generate_ring_signature(const Hash &prefix_hash, const KeyImage &image,
@@ -47,12 +47,30 @@ void hash_process(union hash_state *state, const uint8_t *buf, size_t count);
 enum {
   HASH_SIZE = 32,
   HASH_DATA_AREA = 136,
-  SLOW_HASH_CONTEXT_SIZE = 2097552
+  SLOW_HASH_CONTEXT_SIZE = 2097792,
+  SLOW_HASH_MAX_WAYS = 4
 };
 
 void cn_fast_hash(const void *data, size_t length, char *hash);
+// Hashes count independent messages, up to 8 of them at once when the CPU has AVX2 or AVX-512.
+// The hashes must not overlap the messages.
+void cn_fast_hash_batch(const void *const *data, const size_t *lengths, char (*hashes)[HASH_SIZE], size_t count);
+// Limits the messages hashed at once by cn_fast_hash_batch to 1, 4 or 8, as far as the CPU allows, for tests and benchmarks.
+// Returns the limit in effect.
+size_t cn_fast_hash_select_ways(size_t ways);
+
+#if !defined(__cplusplus)
+// Hash up to 4 (AVX2) or 8 (AVX-512) messages at once, called only when the CPU supports the instructions
+void cn_fast_hash_x4(const void *const *data, const size_t *lengths, char (*hashes)[HASH_SIZE], size_t count);
+void cn_fast_hash_x8(const void *const *data, const size_t *lengths, char (*hashes)[HASH_SIZE], size_t count);
+#endif
 
 void cn_slow_hash_f(void *, const void *, size_t, void *);
+// Hashes count inputs of the same length laid out one after another, interleaving up to SLOW_HASH_MAX_WAYS of them.
+// The context must hold count consecutive slow hash contexts.
+void cn_slow_hash_multi_f(void *context, const void *data, size_t length, void *hashes, size_t count);
+// Switches to the software AES implementation or back to the one detected at startup, for tests and benchmarks
+void cn_slow_hash_use_software_aes(bool enable);
 
 void hash_extra_blake(const void *data, size_t length, char *hash);
 void hash_extra_groestl(const void *data, size_t length, char *hash);
@@ -2,11 +2,19 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
 #include "hash-ops.h"
+#include "initializer.h"
 #include "keccak.h"
 
 void hash_permutation(union hash_state *state) {
@@ -22,3 +30,78 @@ void cn_fast_hash(const void *data, size_t length, char *hash) {
   hash_process(&state, data, length);
   memcpy(hash, &state, HASH_SIZE);
 }
+
+static size_t fast_hash_max_ways = 1;
+static size_t fast_hash_ways = 1;
+
+void cn_fast_hash_batch(const void *const *data, const size_t *lengths, char (*hashes)[HASH_SIZE], size_t count) {
+  while (count > 0) {
+    size_t ways;
+    if (count > 4 && fast_hash_ways >= 8) {
+      ways = count < 8 ? count : 8;
+      cn_fast_hash_x8(data, lengths, hashes, ways);
+    } else if (count > 1 && fast_hash_ways >= 4) {
+      ways = count < 4 ? count : 4;
+      cn_fast_hash_x4(data, lengths, hashes, ways);
+    } else {
+      ways = 1;
+      cn_fast_hash(data[0], lengths[0], hashes[0]);
+    }
+
+    data += ways;
+    lengths += ways;
+    hashes += ways;
+    count -= ways;
+  }
+}
+
+size_t cn_fast_hash_select_ways(size_t ways) {
+  ways = ways >= 8 ? 8 : ways >= 4 ? 4 : 1;
+  fast_hash_ways = ways < fast_hash_max_ways ? ways : fast_hash_max_ways;
+  return fast_hash_ways;
+}
+
+// The vector registers can be used only if the OS also saves them on context switches:
+// YMM for AVX2, YMM and the AVX-512 opmask and ZMM registers for AVX-512F
+INITIALIZER(detect_fast_hash_ways) {
+  uint64_t xcr0;
+  bool avx2, avx512;
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return;
+  }
+
+  __cpuid(info, 1);
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+    return;
+  }
+
+  xcr0 = _xgetbv(0);
+  __cpuidex(info, 7, 0);
+  avx2 = (info[1] & (1 << 5)) != 0;
+  avx512 = (info[1] & (1 << 16)) != 0;
+#else
+  unsigned int a, b, c, d, xcr0Low, xcr0High;
+  if (__get_cpuid_max(0, NULL) < 7) {
+    return;
+  }
+
+  __cpuid(1, a, b, c, d);
+  if ((c & (1 << 27)) == 0 || (c & (1 << 28)) == 0) {
+    return;
+  }
+
+  __asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+  xcr0 = ((uint64_t) xcr0High << 32) | xcr0Low;
+  __cpuid_count(7, 0, a, b, c, d);
+  avx2 = (b & (1 << 5)) != 0;
+  avx512 = (b & (1 << 16)) != 0;
+#endif
+  if (avx2 && (xcr0 & 6) == 6) {
+    fast_hash_max_ways = avx512 && (xcr0 & 0xe6) == 0xe6 ? 8 : 4;
+  }
+
+  fast_hash_ways = fast_hash_max_ways;
+}
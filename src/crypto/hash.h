@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <assert.h>
 #include <stddef.h>
 
 #include <CryptoTypes.h>
@@ -29,26 +30,63 @@ namespace Crypto {
     return h;
   }
 
+  // Hashes count independent messages, several of them at once when the CPU allows
+  inline void cn_fast_hash_batch(const void *const *data, const size_t *lengths, Hash *hashes, size_t count) {
+    cn_fast_hash_batch(data, lengths, reinterpret_cast<char (*)[HASH_SIZE]>(hashes), count);
+  }
+
+  // Pages backing the scratchpads, huge pages save TLB misses on random scratchpad accesses
+  enum class cn_page_mode {
+    HUGE_PAGES,
+    TRANSPARENT_HUGE_PAGES,
+    REGULAR_PAGES
+  };
+
+  const char *cn_page_mode_name(cn_page_mode mode);
+
+  // Holds the scratchpads of up to ways hashes computed at once by cn_slow_hash_multi.
+  // Tries explicit huge pages first, then transparent huge pages, then regular pages.
   class cn_context {
   public:
 
-    cn_context();
+    explicit cn_context(size_t ways = 1);
     ~cn_context();
 #if !defined(_MSC_VER) || _MSC_VER >= 1800
     cn_context(const cn_context &) = delete;
     void operator=(const cn_context &) = delete;
 #endif
 
+    size_t getWays() const {
+      return ways;
+    }
+
+    cn_page_mode getPageMode() const {
+      return pageMode;
+    }
+
   private:
 
     void *data;
+    size_t ways;
+    size_t size;
+    cn_page_mode pageMode;
     friend inline void cn_slow_hash(cn_context &, const void *, size_t, Hash &);
+    friend inline void cn_slow_hash_multi(cn_context &, const void *, size_t, Hash *, size_t);
   };
 
   inline void cn_slow_hash(cn_context &context, const void *data, size_t length, Hash &hash) {
     (*cn_slow_hash_f)(context.data, data, length, reinterpret_cast<void *>(&hash));
   }
 
+  // Hashes count inputs of length bytes laid out one after another in data, count must not exceed the ways of the context
+  inline void cn_slow_hash_multi(cn_context &context, const void *data, size_t length, Hash *hashes, size_t count) {
+    assert(count <= context.ways);
+    cn_slow_hash_multi_f(context.data, data, length, reinterpret_cast<void *>(hashes), count);
+  }
+
+  // Number of hashes a thread should compute at once so that the scratchpads of threadCount threads fit in L3 cache
+  size_t cn_slow_hash_preferred_ways(size_t threadCount);
+
   inline void tree_hash(const Hash *hashes, size_t count, Hash &root_hash) {
     tree_hash(reinterpret_cast<const char (*)[HASH_SIZE]>(hashes), count, reinterpret_cast<char *>(&root_hash));
   }
@@ -0,0 +1,33 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <immintrin.h>
+
+#include "hash-ops.h"
+
+// Four messages at once, one per 64-bit lane of the 256-bit registers
+
+#define KECCAK_LANES 4
+#define KECCAK_MULTI_FN cn_fast_hash_x4
+
+typedef __m256i keccak_vec;
+
+static inline __m256i rol4(__m256i x, int n) {
+  return n == 0 ? x : _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n));
+}
+
+#define VEC_ZERO() _mm256_setzero_si256()
+#define VEC_SET1(x) _mm256_set1_epi64x((long long) (x))
+#define VEC_LOADU(p) _mm256_loadu_si256((const __m256i *) (p))
+#define VEC_STOREU(p, x) _mm256_storeu_si256((__m256i *) (p), x)
+#define VEC_XOR(a, b) _mm256_xor_si256(a, b)
+#define VEC_XOR3(a, b, c) _mm256_xor_si256(_mm256_xor_si256(a, b), c)
+#define VEC_CHI(a, b, c) _mm256_xor_si256(a, _mm256_andnot_si256(b, c))
+#define VEC_ROL(x, n) rol4(x, n)
+
+#include "keccak-multi.inl"
@@ -0,0 +1,30 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <immintrin.h>
+
+#include "hash-ops.h"
+
+// Eight messages at once, one per 64-bit lane of the 512-bit registers.
+// Ternary logic does the three-way xor of theta and the whole chi step in one instruction each.
+
+#define KECCAK_LANES 8
+#define KECCAK_MULTI_FN cn_fast_hash_x8
+
+typedef __m512i keccak_vec;
+
+#define VEC_ZERO() _mm512_setzero_si512()
+#define VEC_SET1(x) _mm512_set1_epi64((long long) (x))
+#define VEC_LOADU(p) _mm512_loadu_si512((const void *) (p))
+#define VEC_STOREU(p, x) _mm512_storeu_si512((void *) (p), x)
+#define VEC_XOR(a, b) _mm512_xor_si512(a, b)
+#define VEC_XOR3(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0x96)
+#define VEC_CHI(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0xD2)
+#define VEC_ROL(x, n) _mm512_rolv_epi64(x, _mm512_set1_epi64(n))
+
+#include "keccak-multi.inl"
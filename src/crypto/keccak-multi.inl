@@ -0,0 +1,139 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/*
+KECCAK_LANES independent messages are hashed at once: every word of the
+Keccak state is a vector holding that word of all the states, one per 64-bit
+lane. Messages of different lengths are absorbed in lockstep, a lane that
+has absorbed its last block is read out right after the permutation and then
+keeps absorbing zero blocks until the longest message is done.
+
+The including file defines the vector type and operations:
+keccak_vec, VEC_ZERO, VEC_SET1, VEC_LOADU, VEC_STOREU, VEC_XOR, VEC_XOR3,
+VEC_CHI(a, b, c) for a ^ (~b & c) and VEC_ROL, as well as KECCAK_MULTI_FN.
+*/
+
+#define RATE_WORDS (HASH_DATA_AREA / 8)
+
+extern const uint64_t keccakf_rndc[24];
+
+static const int rho[25] = {
+   0,  1, 62, 28, 27,
+  36, 44,  6, 55, 20,
+   3, 10, 43, 25, 39,
+  41, 45, 15, 21,  8,
+  18,  2, 61, 56, 14
+};
+
+// position of state word x + 5 * y after the pi step
+static const int pi[25] = {
+   0, 10, 20,  5, 15,
+  16,  1, 11, 21,  6,
+   7, 17,  2, 12, 22,
+  23,  8, 18,  3, 13,
+  14, 24,  9, 19,  4
+};
+
+static void keccakf_multi(keccak_vec st[25]) {
+  keccak_vec b[25], c[5], d;
+  int round, i, x, y;
+
+  for (round = 0; round < 24; round++) {
+    // Theta
+    for (x = 0; x < 5; x++) {
+      c[x] = VEC_XOR(VEC_XOR3(st[x], st[x + 5], st[x + 10]), VEC_XOR(st[x + 15], st[x + 20]));
+    }
+
+    for (x = 0; x < 5; x++) {
+      d = VEC_XOR(c[(x + 4) % 5], VEC_ROL(c[(x + 1) % 5], 1));
+      for (y = 0; y < 25; y += 5) {
+        st[y + x] = VEC_XOR(st[y + x], d);
+      }
+    }
+
+    // Rho Pi
+    for (i = 0; i < 25; i++) {
+      b[pi[i]] = VEC_ROL(st[i], rho[i]);
+    }
+
+    // Chi
+    for (y = 0; y < 25; y += 5) {
+      for (x = 0; x < 5; x++) {
+        st[y + x] = VEC_CHI(b[y + x], b[y + (x + 1) % 5], b[y + (x + 2) % 5]);
+      }
+    }
+
+    // Iota
+    st[0] = VEC_XOR(st[0], VEC_SET1(keccakf_rndc[round]));
+  }
+}
+
+void KECCAK_MULTI_FN(const void *const *data, const size_t *lengths, char (*hashes)[HASH_SIZE], size_t count) {
+  static const uint8_t zeros[HASH_DATA_AREA] = { 0 };
+  uint8_t last[KECCAK_LANES][HASH_DATA_AREA];
+  size_t blocks[KECCAK_LANES];
+  size_t maxBlocks = 0;
+  size_t lane, block;
+  keccak_vec st[25];
+  int i;
+
+  // the last block of every message is padded in a copy, a missing lane gets no blocks at all
+  for (lane = 0; lane < KECCAK_LANES; lane++) {
+    size_t tail;
+    if (lane >= count) {
+      blocks[lane] = 0;
+      continue;
+    }
+
+    blocks[lane] = lengths[lane] / HASH_DATA_AREA + 1;
+    tail = lengths[lane] % HASH_DATA_AREA;
+    if (tail > 0) {
+      memcpy(last[lane], (const uint8_t *) data[lane] + lengths[lane] - tail, tail);
+    }
+
+    memset(last[lane] + tail, 0, HASH_DATA_AREA - tail);
+    last[lane][tail] = 1;
+    last[lane][HASH_DATA_AREA - 1] |= 0x80;
+    if (blocks[lane] > maxBlocks) {
+      maxBlocks = blocks[lane];
+    }
+  }
+
+  for (i = 0; i < 25; i++) {
+    st[i] = VEC_ZERO();
+  }
+
+  for (block = 0; block < maxBlocks; block++) {
+    const uint8_t *input[KECCAK_LANES];
+    for (lane = 0; lane < KECCAK_LANES; lane++) {
+      if (block + 1 < blocks[lane]) {
+        input[lane] = (const uint8_t *) data[lane] + block * HASH_DATA_AREA;
+      } else if (block + 1 == blocks[lane]) {
+        input[lane] = last[lane];
+      } else {
+        input[lane] = zeros;
+      }
+    }
+
+    for (i = 0; i < RATE_WORDS; i++) {
+      uint64_t words[KECCAK_LANES];
+      for (lane = 0; lane < KECCAK_LANES; lane++) {
+        memcpy(&words[lane], input[lane] + 8 * i, 8);
+      }
+
+      st[i] = VEC_XOR(st[i], VEC_LOADU(words));
+    }
+
+    keccakf_multi(st);
+    for (lane = 0; lane < KECCAK_LANES; lane++) {
+      if (block + 1 == blocks[lane]) {
+        for (i = 0; i < HASH_SIZE / 8; i++) {
+          uint64_t words[KECCAK_LANES];
+          VEC_STOREU(words, st[i]);
+          memcpy(hashes[lane] + 8 * i, &words[lane], 8);
+        }
+      }
+    }
+  }
+}
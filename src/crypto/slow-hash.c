@@ -19,9 +19,10 @@
 #include "initializer.h"
 #include "Common/int-util.h"
 #include "hash-ops.h"
-#include "oaes_lib.h"
 
 void (*cn_slow_hash_fp)(void *, const void *, size_t, void *);
+static void (*cn_slow_hash_2_fp)(void *, const void *, size_t, void *);
+static void (*cn_slow_hash_4_fp)(void *, const void *, size_t, void *);
 
 void cn_slow_hash_f(void * a, const void * b, size_t c, void * d){
 (*cn_slow_hash_fp)(a, b, c, d);
@@ -36,6 +37,12 @@ void cn_slow_hash_f(void * a, const void * b, size_t c, void * d){
 #define __attribute__(x)
 #endif
 
+#if defined(_MSC_VER)
+#define FORCE_INLINE __forceinline
+#else
+#define FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
 #if defined(_MSC_VER)
 #define restrict
 #endif
@@ -72,7 +79,7 @@ struct cn_ctx {
   ALIGNED_DECL(uint64_t a[AES_BLOCK_SIZE >> 3], 16);
   ALIGNED_DECL(uint64_t b[AES_BLOCK_SIZE >> 3], 16);
   ALIGNED_DECL(uint8_t c[AES_BLOCK_SIZE], 16);
-  oaes_ctx* aes_ctx;
+  ALIGNED_DECL(uint8_t expanded_key[256], 16);
 };
 
 static_assert(sizeof(struct cn_ctx) == SLOW_HASH_CONTEXT_SIZE, "Invalid structure size");
@@ -166,6 +173,46 @@ static void (*const extra_hashes[4])(const void *, size_t, char *) =
 #define AESNI
 #include "slow-hash.inl"
 
+void cn_slow_hash_multi_f(void *context, const void *data, size_t length, void *hashes, size_t count) {
+  struct cn_ctx *ctx = (struct cn_ctx *) context;
+  const uint8_t *input = (const uint8_t *) data;
+  uint8_t *output = (uint8_t *) hashes;
+
+  for (; count >= 4; count -= 4, ctx += 4, input += 4 * length, output += 4 * HASH_SIZE) {
+    (*cn_slow_hash_4_fp)(ctx, input, length, output);
+  }
+
+  if (count >= 2) {
+    (*cn_slow_hash_2_fp)(ctx, input, length, output);
+    count -= 2;
+    ctx += 2;
+    input += 2 * length;
+    output += 2 * HASH_SIZE;
+  }
+
+  if (count == 1) {
+    (*cn_slow_hash_fp)(ctx, input, length, output);
+  }
+}
+
+static bool aesni_supported;
+
+static void select_implementation(bool aesni) {
+  if (aesni) {
+    cn_slow_hash_fp = &cn_slow_hash_aesni;
+    cn_slow_hash_2_fp = &cn_slow_hash_2_aesni;
+    cn_slow_hash_4_fp = &cn_slow_hash_4_aesni;
+  } else {
+    cn_slow_hash_fp = &cn_slow_hash_noaesni;
+    cn_slow_hash_2_fp = &cn_slow_hash_2_noaesni;
+    cn_slow_hash_4_fp = &cn_slow_hash_4_noaesni;
+  }
+}
+
+void cn_slow_hash_use_software_aes(bool enable) {
+  select_implementation(aesni_supported && !enable);
+}
+
 INITIALIZER(detect_aes) {
   int ecx;
 #if defined(_MSC_VER)
@@ -176,5 +223,6 @@ INITIALIZER(detect_aes) {
   int a, b, d;
   __cpuid(1, a, b, ecx, d);
 #endif
-  cn_slow_hash_fp = (ecx & (1 << 25)) ? &cn_slow_hash_aesni : &cn_slow_hash_noaesni;
+  aesni_supported = (ecx & (1 << 25)) != 0;
+  select_implementation(aesni_supported);
 }
@@ -2,7 +2,12 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <cstdint>
+#include <fstream>
+#include <iterator>
 #include <new>
+#include <string>
+#include <vector>
 
 #include "hash.h"
 
@@ -10,20 +15,182 @@
 #include <Windows.h>
 #else
 #include <sys/mman.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/vm_statistics.h>
+#include <sys/sysctl.h>
+#endif
 #endif
 
 using std::bad_alloc;
 
 namespace Crypto {
 
-  enum {
-    MAP_SIZE = SLOW_HASH_CONTEXT_SIZE + ((-SLOW_HASH_CONTEXT_SIZE) & 0xfff)
-  };
+  namespace {
+
+    // memory of a slow hash that is accessed randomly
+    const size_t SCRATCHPAD_SIZE = 2 * 1024 * 1024;
+    const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    const size_t REGULAR_PAGE_SIZE = 4096;
+
+    size_t roundUp(size_t size, size_t alignment) {
+      return size + ((0 - size) & (alignment - 1));
+    }
+
+    // Total size of L3 cache, 0 if it is unknown
+    size_t getL3CacheSize() {
+#if defined(WIN32)
+      DWORD length = 0;
+      GetLogicalProcessorInformation(nullptr, &length);
+      std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+      if (infos.empty() || !GetLogicalProcessorInformation(infos.data(), &length)) {
+        return 0;
+      }
+
+      size_t size = 0;
+      for (const auto& info : infos) {
+        if (info.Relationship == RelationCache && info.Cache.Level == 3) {
+          size += info.Cache.Size;
+        }
+      }
+
+      return size;
+#elif defined(__APPLE__)
+      uint64_t size = 0;
+      size_t length = sizeof(size);
+      if (sysctlbyname("hw.l3cachesize", &size, &length, nullptr, 0) != 0) {
+        return 0;
+      }
+
+      return static_cast<size_t>(size);
+#elif defined(_SC_LEVEL3_CACHE_SIZE)
+      long size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+      return size > 0 ? static_cast<size_t>(size) : 0;
+#else
+      return 0;
+#endif
+    }
 
 #if defined(WIN32)
 
-  cn_context::cn_context() {
-    data = VirtualAlloc(nullptr, MAP_SIZE, MEM_COMMIT, PAGE_READWRITE);
+    // Large pages can be allocated only by users granted "Lock pages in memory" and only with the privilege enabled
+    bool enableLockMemoryPrivilege() {
+      HANDLE token;
+      if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        return false;
+      }
+
+      TOKEN_PRIVILEGES privileges;
+      privileges.PrivilegeCount = 1;
+      privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+      bool enabled = LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+        AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) && GetLastError() == ERROR_SUCCESS;
+      CloseHandle(token);
+      return enabled;
+    }
+
+    void *allocateHugePages(size_t &size) {
+      size_t largePageSize = GetLargePageMinimum();
+      if (largePageSize == 0 || !enableLockMemoryPrivilege()) {
+        return nullptr;
+      }
+
+      size = roundUp(size, largePageSize);
+      return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+
+#else
+
+    void *allocateHugePages(size_t &size) {
+#if defined(MAP_HUGETLB)
+      size_t hugeSize = roundUp(size, HUGE_PAGE_SIZE);
+      void *data = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+#elif defined(__APPLE__)
+      size_t hugeSize = roundUp(size, HUGE_PAGE_SIZE);
+      void *data = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, VM_FLAGS_SUPERPAGE_SIZE_2MB, 0);
+#else
+      size_t hugeSize = size;
+      void *data = MAP_FAILED;
+#endif
+      if (data == MAP_FAILED) {
+        return nullptr;
+      }
+
+      size = hugeSize;
+      return data;
+    }
+
+#if defined(MADV_HUGEPAGE)
+
+    bool transparentHugePagesEnabled() {
+      // the current mode is the one in brackets, e.g. "always [madvise] never"
+      std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+      std::string modes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+      return file.good() && modes.find("[never]") == std::string::npos;
+    }
+
+    void *allocateTransparentHugePages(size_t &size) {
+      if (!transparentHugePagesEnabled()) {
+        return nullptr;
+      }
+
+      // the kernel backs only huge page aligned ranges with huge pages, so the mapping is aligned by hand
+      size_t hugeSize = roundUp(size, HUGE_PAGE_SIZE);
+      void *region = mmap(nullptr, hugeSize + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (region == MAP_FAILED) {
+        return nullptr;
+      }
+
+      uint8_t *data = reinterpret_cast<uint8_t *>(roundUp(reinterpret_cast<uintptr_t>(region), HUGE_PAGE_SIZE));
+      size_t head = data - static_cast<uint8_t *>(region);
+      if (head != 0) {
+        munmap(region, head);
+      }
+
+      munmap(data + hugeSize, HUGE_PAGE_SIZE - head);
+      if (madvise(data, hugeSize, MADV_HUGEPAGE) != 0) {
+        munmap(data, hugeSize);
+        return nullptr;
+      }
+
+      size = hugeSize;
+      return data;
+    }
+
+#else
+
+    void *allocateTransparentHugePages(size_t &) {
+      return nullptr;
+    }
+
+#endif
+
+#endif
+
+  }
+
+  const char *cn_page_mode_name(cn_page_mode mode) {
+    switch (mode) {
+    case cn_page_mode::HUGE_PAGES:
+      return "huge pages";
+    case cn_page_mode::TRANSPARENT_HUGE_PAGES:
+      return "transparent huge pages";
+    default:
+      return "regular pages";
+    }
+  }
+
+#if defined(WIN32)
+
+  cn_context::cn_context(size_t ways) : ways(ways), size(ways * SLOW_HASH_CONTEXT_SIZE), pageMode(cn_page_mode::HUGE_PAGES) {
+    data = allocateHugePages(size);
+    if (data != nullptr) {
+      return;
+    }
+
+    size = roundUp(ways * SLOW_HASH_CONTEXT_SIZE, REGULAR_PAGE_SIZE);
+    pageMode = cn_page_mode::REGULAR_PAGES;
+    data = VirtualAlloc(nullptr, size, MEM_COMMIT, PAGE_READWRITE);
     if (data == nullptr) {
       throw bad_alloc();
     }
@@ -37,24 +204,45 @@ namespace Crypto {
 
 #else
 
-  cn_context::cn_context() {
+  cn_context::cn_context(size_t ways) : ways(ways), size(ways * SLOW_HASH_CONTEXT_SIZE), pageMode(cn_page_mode::HUGE_PAGES) {
+    data = allocateHugePages(size);
+    if (data == nullptr) {
+      pageMode = cn_page_mode::TRANSPARENT_HUGE_PAGES;
+      data = allocateTransparentHugePages(size);
+    }
+
+    if (data == nullptr) {
+      size = roundUp(ways * SLOW_HASH_CONTEXT_SIZE, REGULAR_PAGE_SIZE);
+      pageMode = cn_page_mode::REGULAR_PAGES;
 #if !defined(__APPLE__)
-    data = mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+      data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
 #else
-    data = mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+      data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
 #endif
-    if (data == MAP_FAILED) {
-      throw bad_alloc();
+      if (data == MAP_FAILED) {
+        throw bad_alloc();
+      }
     }
-    mlock(data, MAP_SIZE);
+
+    mlock(data, size);
   }
 
   cn_context::~cn_context() {
-    if (munmap(data, MAP_SIZE) != 0) {
+    if (munmap(data, size) != 0) {
       throw bad_alloc();
     }
   }
 
 #endif
 
+  size_t cn_slow_hash_preferred_ways(size_t threadCount) {
+    size_t cachePerThread = getL3CacheSize() / (threadCount > 0 ? threadCount : 1);
+    size_t ways = SLOW_HASH_MAX_WAYS;
+    while (ways > 1 && ways * SCRATCHPAD_SIZE > cachePerThread) {
+      ways /= 2;
+    }
+
+    return ways;
+  }
+
 }
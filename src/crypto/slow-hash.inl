@@ -2,33 +2,29 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
-static void
 #if defined(AESNI)
-cn_slow_hash_aesni
+#define CN_SLOW_HASH_FN(name) name##_aesni
 #else
-cn_slow_hash_noaesni
+#define CN_SLOW_HASH_FN(name) name##_noaesni
 #endif
-(void *restrict context, const void *restrict data, size_t length, void *restrict hash)
+
+// Absorbs the input and fills the scratchpad, leaves the initial a and b of the main loop in the context
+static void CN_SLOW_HASH_FN(cn_explode_scratchpad)(struct cn_ctx *restrict ctx, const void *restrict data, size_t length)
 {
-#define ctx ((struct cn_ctx *) context)
-  ALIGNED_DECL(uint8_t ExpandedKey[256], 16);
   size_t i;
-  __m128i *longoutput, *expkey, *xmminput, b_x;
-  ALIGNED_DECL(uint64_t a[2], 16);
+  __m128i *longoutput, *expkey, *xmminput;
   hash_process(&ctx->state.hs, (const uint8_t*) data, length);
 
   memcpy(ctx->text, ctx->state.init, INIT_SIZE_BYTE);
 #if defined(AESNI)
-  memcpy(ExpandedKey, ctx->state.hs.b, AES_KEY_SIZE);
-  ExpandAESKey256(ExpandedKey);
+  memcpy(ctx->expanded_key, ctx->state.hs.b, AES_KEY_SIZE);
+  ExpandAESKey256(ctx->expanded_key);
 #else
-  ctx->aes_ctx = oaes_alloc();
-  oaes_key_import_data(ctx->aes_ctx, ctx->state.hs.b, AES_KEY_SIZE);
-  memcpy(ExpandedKey, ctx->aes_ctx->key->exp_data, ctx->aes_ctx->key->exp_data_len);
+  aesb_expand_key(ctx->state.hs.b, ctx->expanded_key);
 #endif
 
   longoutput = (__m128i *) ctx->long_state;
-  expkey = (__m128i *) ExpandedKey;
+  expkey = (__m128i *) ctx->expanded_key;
   xmminput = (__m128i *) ctx->text;
 
   //for (i = 0; likely(i < MEMORY); i += INIT_SIZE_BYTE)
@@ -73,72 +69,88 @@ cn_slow_hash_noaesni
     ctx->a[i] = ((uint64_t *)ctx->state.k)[i] ^  ((uint64_t *)ctx->state.k)[i+4];
     ctx->b[i] = ((uint64_t *)ctx->state.k)[i+2] ^  ((uint64_t *)ctx->state.k)[i+6];
   }
+}
 
-  b_x = _mm_load_si128((__m128i *)ctx->b);
-  a[0] = ctx->a[0];
-  a[1] = ctx->a[1];
-
-  for(i = 0; likely(i < 0x80000); i++)
-  {
-    __m128i c_x = _mm_load_si128((__m128i *)&ctx->long_state[a[0] & 0x1FFFF0]);
-    __m128i a_x = _mm_load_si128((__m128i *)a);
-    ALIGNED_DECL(uint64_t c[2], 16);
-    ALIGNED_DECL(uint64_t b[2], 16);
-    uint64_t *nextblock, *dst;
+// One iteration of the memory-hard loop. The iterations of independent hashes don't depend on each other,
+// so calling it for several contexts in a row lets the CPU overlap their AES rounds and scratchpad reads.
+static FORCE_INLINE void CN_SLOW_HASH_FN(cn_mix_round)(uint8_t *restrict long_state, uint64_t *restrict a, __m128i *restrict b_x)
+{
+  __m128i c_x = _mm_load_si128((__m128i *)&long_state[a[0] & 0x1FFFF0]);
+  __m128i a_x = _mm_load_si128((__m128i *)a);
+  ALIGNED_DECL(uint64_t c[2], 16);
+  ALIGNED_DECL(uint64_t b[2], 16);
+  uint64_t *nextblock, *dst;
 
 #if defined(AESNI)
-    c_x = _mm_aesenc_si128(c_x, a_x);
+  c_x = _mm_aesenc_si128(c_x, a_x);
 #else
-    aesb_single_round((uint8_t *) &c_x, (uint8_t *) &c_x, (uint8_t *) &a_x);
+  {
+    // the table code accesses the blocks as words, going through word arrays keeps it clear of strict aliasing
+    ALIGNED_DECL(uint32_t block[4], 16);
+    ALIGNED_DECL(uint32_t key[4], 16);
+    _mm_store_si128((__m128i *)block, c_x);
+    _mm_store_si128((__m128i *)key, a_x);
+    aesb_single_round((uint8_t *) block, (uint8_t *) block, (uint8_t *) key);
+    c_x = _mm_load_si128((__m128i *)block);
+  }
 #endif
 
-    _mm_store_si128((__m128i *)c, c_x);
-    //__builtin_prefetch(&ctx->long_state[c[0] & 0x1FFFF0], 0, 1);
+  _mm_store_si128((__m128i *)c, c_x);
+  //__builtin_prefetch(&long_state[c[0] & 0x1FFFF0], 0, 1);
 
-    b_x = _mm_xor_si128(b_x, c_x);
-    _mm_store_si128((__m128i *)&ctx->long_state[a[0] & 0x1FFFF0], b_x);
+  *b_x = _mm_xor_si128(*b_x, c_x);
+  _mm_store_si128((__m128i *)&long_state[a[0] & 0x1FFFF0], *b_x);
 
-    nextblock = (uint64_t *)&ctx->long_state[c[0] & 0x1FFFF0];
-    b[0] = nextblock[0];
-    b[1] = nextblock[1];
+  nextblock = (uint64_t *)&long_state[c[0] & 0x1FFFF0];
+  b[0] = nextblock[0];
+  b[1] = nextblock[1];
 
-    {
-      uint64_t hi, lo;
-      // hi,lo = 64bit x 64bit multiply of c[0] and b[0]
+  {
+    uint64_t hi, lo;
+    // hi,lo = 64bit x 64bit multiply of c[0] and b[0]
 
 #if defined(__GNUC__) && defined(__x86_64__)
-      __asm__("mulq %3\n\t"
-        : "=d" (hi),
-        "=a" (lo)
-        : "%a" (c[0]),
-        "rm" (b[0])
-        : "cc" );
+    __asm__("mulq %3\n\t"
+      : "=d" (hi),
+      "=a" (lo)
+      : "%a" (c[0]),
+      "rm" (b[0])
+      : "cc" );
 #else
-      lo = mul128(c[0], b[0], &hi);
+    lo = mul128(c[0], b[0], &hi);
 #endif
 
-      a[0] += hi;
-      a[1] += lo;
-    }
-    dst = (uint64_t *) &ctx->long_state[c[0] & 0x1FFFF0];
-    dst[0] = a[0];
-    dst[1] = a[1];
-
-    a[0] ^= b[0];
-    a[1] ^= b[1];
-    b_x = c_x;
-    //__builtin_prefetch(&ctx->long_state[a[0] & 0x1FFFF0], 0, 3);
+    a[0] += hi;
+    a[1] += lo;
   }
+  dst = (uint64_t *) &long_state[c[0] & 0x1FFFF0];
+  dst[0] = a[0];
+  dst[1] = a[1];
+
+  a[0] ^= b[0];
+  a[1] ^= b[1];
+  *b_x = c_x;
+  //__builtin_prefetch(&long_state[a[0] & 0x1FFFF0], 0, 3);
+}
+
+// Folds the scratchpad back into the state and produces the final hash
+static void CN_SLOW_HASH_FN(cn_implode_scratchpad)(struct cn_ctx *restrict ctx, void *restrict hash)
+{
+  size_t i;
+  __m128i *longoutput, *expkey, *xmminput;
 
   memcpy(ctx->text, ctx->state.init, INIT_SIZE_BYTE);
 #if defined(AESNI)
-  memcpy(ExpandedKey, &ctx->state.hs.b[32], AES_KEY_SIZE);
-  ExpandAESKey256(ExpandedKey);
+  memcpy(ctx->expanded_key, &ctx->state.hs.b[32], AES_KEY_SIZE);
+  ExpandAESKey256(ctx->expanded_key);
 #else
-  oaes_key_import_data(ctx->aes_ctx, &ctx->state.hs.b[32], AES_KEY_SIZE);
-  memcpy(ExpandedKey, ctx->aes_ctx->key->exp_data, ctx->aes_ctx->key->exp_data_len);
+  aesb_expand_key(&ctx->state.hs.b[32], ctx->expanded_key);
 #endif
 
+  longoutput = (__m128i *) ctx->long_state;
+  expkey = (__m128i *) ctx->expanded_key;
+  xmminput = (__m128i *) ctx->text;
+
   //for (i = 0; likely(i < MEMORY); i += INIT_SIZE_BYTE)
   //    aesni_parallel_xor(&ctx->text, ExpandedKey, &ctx->long_state[i]);
 
@@ -178,11 +190,87 @@ cn_slow_hash_noaesni
 
   }
 
-#if !defined(AESNI)
-  oaes_free((OAES_CTX **) &ctx->aes_ctx);
-#endif
-
   memcpy(ctx->state.init, ctx->text, INIT_SIZE_BYTE);
   hash_permutation(&ctx->state.hs);
   extra_hashes[ctx->state.hs.b[0] & 3](&ctx->state, 200, hash);
 }
+
+static void CN_SLOW_HASH_FN(cn_slow_hash)(void *restrict context, const void *restrict data, size_t length, void *restrict hash)
+{
+  struct cn_ctx *ctx = (struct cn_ctx *) context;
+  ALIGNED_DECL(uint64_t a[2], 16);
+  __m128i b_x;
+  size_t i;
+
+  CN_SLOW_HASH_FN(cn_explode_scratchpad)(ctx, data, length);
+  a[0] = ctx->a[0];
+  a[1] = ctx->a[1];
+  b_x = _mm_load_si128((__m128i *)ctx->b);
+
+  for(i = 0; likely(i < 0x80000); i++)
+  {
+    CN_SLOW_HASH_FN(cn_mix_round)(ctx->long_state, a, &b_x);
+  }
+
+  CN_SLOW_HASH_FN(cn_implode_scratchpad)(ctx, hash);
+}
+
+// Hashes 2 inputs of the same length laid out one after another, context holds a scratchpad for each of them
+static void CN_SLOW_HASH_FN(cn_slow_hash_2)(void *restrict context, const void *restrict data, size_t length, void *restrict hashes)
+{
+  struct cn_ctx *ctx = (struct cn_ctx *) context;
+  ALIGNED_DECL(uint64_t a[2][2], 16);
+  __m128i b_x[2];
+  size_t i;
+
+  for (i = 0; i < 2; i++)
+  {
+    CN_SLOW_HASH_FN(cn_explode_scratchpad)(&ctx[i], (const uint8_t *) data + i * length, length);
+    a[i][0] = ctx[i].a[0];
+    a[i][1] = ctx[i].a[1];
+    b_x[i] = _mm_load_si128((__m128i *)ctx[i].b);
+  }
+
+  for(i = 0; likely(i < 0x80000); i++)
+  {
+    CN_SLOW_HASH_FN(cn_mix_round)(ctx[0].long_state, a[0], &b_x[0]);
+    CN_SLOW_HASH_FN(cn_mix_round)(ctx[1].long_state, a[1], &b_x[1]);
+  }
+
+  for (i = 0; i < 2; i++)
+  {
+    CN_SLOW_HASH_FN(cn_implode_scratchpad)(&ctx[i], (uint8_t *) hashes + i * HASH_SIZE);
+  }
+}
+
+// Same as cn_slow_hash_2 for 4 inputs
+static void CN_SLOW_HASH_FN(cn_slow_hash_4)(void *restrict context, const void *restrict data, size_t length, void *restrict hashes)
+{
+  struct cn_ctx *ctx = (struct cn_ctx *) context;
+  ALIGNED_DECL(uint64_t a[4][2], 16);
+  __m128i b_x[4];
+  size_t i;
+
+  for (i = 0; i < 4; i++)
+  {
+    CN_SLOW_HASH_FN(cn_explode_scratchpad)(&ctx[i], (const uint8_t *) data + i * length, length);
+    a[i][0] = ctx[i].a[0];
+    a[i][1] = ctx[i].a[1];
+    b_x[i] = _mm_load_si128((__m128i *)ctx[i].b);
+  }
+
+  for(i = 0; likely(i < 0x80000); i++)
+  {
+    CN_SLOW_HASH_FN(cn_mix_round)(ctx[0].long_state, a[0], &b_x[0]);
+    CN_SLOW_HASH_FN(cn_mix_round)(ctx[1].long_state, a[1], &b_x[1]);
+    CN_SLOW_HASH_FN(cn_mix_round)(ctx[2].long_state, a[2], &b_x[2]);
+    CN_SLOW_HASH_FN(cn_mix_round)(ctx[3].long_state, a[3], &b_x[3]);
+  }
+
+  for (i = 0; i < 4; i++)
+  {
+    CN_SLOW_HASH_FN(cn_implode_scratchpad)(&ctx[i], (uint8_t *) hashes + i * HASH_SIZE);
+  }
+}
+
+#undef CN_SLOW_HASH_FN
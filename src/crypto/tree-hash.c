@@ -9,6 +9,28 @@
 
 #include "hash-ops.h"
 
+enum {
+  TREE_HASH_BATCH = 8
+};
+
+// Hashes count pairs of adjacent hashes a level at a time. The results go through a local buffer,
+// so a level can be written over itself: pair j never starts below hash j.
+static void hash_pairs(const char (*pairs)[HASH_SIZE], size_t count, char (*hashes)[HASH_SIZE]) {
+  const void *data[TREE_HASH_BATCH];
+  size_t lengths[TREE_HASH_BATCH];
+  char results[TREE_HASH_BATCH][HASH_SIZE];
+  size_t i, j;
+  for (i = 0; i < count; i += TREE_HASH_BATCH) {
+    size_t batch = count - i < TREE_HASH_BATCH ? count - i : TREE_HASH_BATCH;
+    for (j = 0; j < batch; ++j) {
+      data[j] = pairs[2 * (i + j)];
+      lengths[j] = 2 * HASH_SIZE;
+    }
+    cn_fast_hash_batch(data, lengths, results, batch);
+    memcpy(hashes[i], results, batch * HASH_SIZE);
+  }
+}
+
 void tree_hash(const char (*hashes)[HASH_SIZE], size_t count, char *root_hash) {
   assert(count > 0);
   if (count == 1) {
@@ -16,7 +38,7 @@ void tree_hash(const char (*hashes)[HASH_SIZE], size_t count, char *root_hash) {
   } else if (count == 2) {
     cn_fast_hash(hashes, 2 * HASH_SIZE, root_hash);
   } else {
-    size_t i, j;
+    size_t i;
     size_t cnt = count - 1;
     char (*ints)[HASH_SIZE];
     for (i = 1; i < 8 * sizeof(size_t); i <<= 1) {
@@ -25,15 +47,10 @@ void tree_hash(const char (*hashes)[HASH_SIZE], size_t count, char *root_hash) {
     cnt &= ~(cnt >> 1);
     ints = alloca(cnt * HASH_SIZE);
     memcpy(ints, hashes, (2 * cnt - count) * HASH_SIZE);
-    for (i = 2 * cnt - count, j = 2 * cnt - count; j < cnt; i += 2, ++j) {
-      cn_fast_hash(hashes[i], 2 * HASH_SIZE, ints[j]);
-    }
-    assert(i == count);
+    hash_pairs(hashes + 2 * cnt - count, count - cnt, ints + 2 * cnt - count);
     while (cnt > 2) {
       cnt >>= 1;
-      for (i = 0, j = 0; j < cnt; i += 2, ++j) {
-        cn_fast_hash(ints[i], 2 * HASH_SIZE, ints[j]);
-      }
+      hash_pairs((const char (*)[HASH_SIZE]) ints, cnt, ints);
     }
     cn_fast_hash(ints[0], 2 * HASH_SIZE, root_hash);
   }
@@ -53,7 +70,7 @@ size_t tree_depth(size_t count) {
 }
 
 void tree_branch(const char (*hashes)[HASH_SIZE], size_t count, char (*branch)[HASH_SIZE]) {
-  size_t i, j;
+  size_t i;
   size_t cnt = 1;
   size_t depth = 0;
   char (*ints)[HASH_SIZE];
@@ -68,18 +85,13 @@ void tree_branch(const char (*hashes)[HASH_SIZE], size_t count, char (*branch)[H
   assert(depth == tree_depth(count));
   ints = alloca((cnt - 1) * HASH_SIZE);
   memcpy(ints, hashes + 1, (2 * cnt - count - 1) * HASH_SIZE);
-  for (i = 2 * cnt - count, j = 2 * cnt - count - 1; j < cnt - 1; i += 2, ++j) {
-    cn_fast_hash(hashes[i], 2 * HASH_SIZE, ints[j]);
-  }
-  assert(i == count);
+  hash_pairs(hashes + 2 * cnt - count, count - cnt, ints + 2 * cnt - count - 1);
   while (depth > 0) {
     assert(cnt == 1ULL << depth);
     cnt >>= 1;
     --depth;
     memcpy(branch[depth], ints[0], HASH_SIZE);
-    for (i = 1, j = 0; j < cnt - 1; i += 2, ++j) {
-      cn_fast_hash(ints[i], 2 * HASH_SIZE, ints[j]);
-    }
+    hash_pairs((const char (*)[HASH_SIZE]) ints + 1, cnt - 1, ints);
   }
 }
 
@@ -3,10 +3,12 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <cstddef>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <ios>
 #include <string>
+#include <vector>
 
 #include "crypto/hash.h"
 #include "../Io.h"
@@ -28,16 +30,56 @@ extern "C" {
     Crypto::tree_hash((const char (*)[32]) data, length >> 5, hash);
   }
 
+  static void fast_hash_batch(const void *data, size_t length, char *hash) {
+    // the input is hashed along with its prefixes, so the messages hashed at once differ in length
+    const size_t count = 9;
+    const void *messages[count];
+    size_t lengths[count];
+    chash results[count];
+    for (size_t i = 0; i < count; i++) {
+      messages[i] = data;
+      lengths[i] = length * (count - 1 - i) / (count - 1);
+    }
+    Crypto::cn_fast_hash_batch(messages, lengths, results, count);
+    for (size_t i = 1; i < count; i++) {
+      if (results[i] != Crypto::cn_fast_hash(data, lengths[i])) {
+        throw ios_base::failure("Batched fast hashes differ");
+      }
+    }
+    memcpy(hash, &results[0], sizeof(chash));
+  }
+
   static void slow_hash(const void *data, size_t length, char *hash) {
     cn_slow_hash(*context, data, length, *reinterpret_cast<chash *>(hash));
   }
+
+  static void slow_hash_software(const void *data, size_t length, char *hash) {
+    cn_slow_hash(*context, data, length, *reinterpret_cast<chash *>(hash));
+  }
+
+  static void slow_hash_multi(const void *data, size_t length, char *hash) {
+    // every way hashes the same input, 4 ways are interleaved first, then 2 ways and a single one
+    vector<char> inputs;
+    for (size_t i = 0; i < Crypto::SLOW_HASH_MAX_WAYS; i++) {
+      inputs.insert(inputs.end(), static_cast<const char *>(data), static_cast<const char *>(data) + length);
+    }
+    chash results[2 * Crypto::SLOW_HASH_MAX_WAYS - 1];
+    Crypto::cn_slow_hash_multi(*context, inputs.data(), length, results, Crypto::SLOW_HASH_MAX_WAYS);
+    Crypto::cn_slow_hash_multi(*context, inputs.data(), length, results + Crypto::SLOW_HASH_MAX_WAYS, Crypto::SLOW_HASH_MAX_WAYS - 1);
+    for (size_t i = 1; i < sizeof(results) / sizeof(chash); i++) {
+      if (results[i] != results[0]) {
+        throw ios_base::failure("Interleaved slow hashes differ");
+      }
+    }
+    memcpy(hash, &results[0], sizeof(chash));
+  }
 }
 
 extern "C" typedef void hash_f(const void *, size_t, char *);
 struct hash_func {
   const string name;
   hash_f &f;
-} hashes[] = {{"fast", Crypto::cn_fast_hash}, {"slow", slow_hash}, {"tree", hash_tree},
+} hashes[] = {{"fast", Crypto::cn_fast_hash}, {"fast-batch", fast_hash_batch}, {"slow", slow_hash}, {"slow-multi", slow_hash_multi}, {"slow-software", slow_hash_software}, {"tree", hash_tree},
   {"extra-blake", Crypto::hash_extra_blake}, {"extra-groestl", Crypto::hash_extra_groestl},
   {"extra-jh", Crypto::hash_extra_jh}, {"extra-skein", Crypto::hash_extra_skein}};
 
@@ -66,6 +108,13 @@ int main(int argc, char *argv[]) {
   if (f == slow_hash) {
     context = new Crypto::cn_context();
   }
+  if (f == slow_hash_multi) {
+    context = new Crypto::cn_context(Crypto::SLOW_HASH_MAX_WAYS);
+  }
+  if (f == slow_hash_software) {
+    Crypto::cn_slow_hash_use_software_aes(true);
+    context = new Crypto::cn_context();
+  }
   input.open(argv[2], ios_base::in);
   for (;;) {
     ++test;
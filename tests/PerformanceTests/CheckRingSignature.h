@@ -56,3 +56,60 @@ private:
   CryptoNote::Transaction m_tx;
   Crypto::Hash m_tx_prefix_hash;
 };
+
+// Verifies batch_size signatures over the same ring with one check_ring_signatures call.
+// loop_count is chosen so that the elapsed time covers as many signatures as test_check_ring_signature does.
+template<size_t a_ring_size, size_t a_batch_size>
+class test_check_ring_signatures : private multi_tx_test_base<a_ring_size>
+{
+  static_assert(0 < a_batch_size, "batch_size must be greater than 0");
+
+public:
+  static const size_t loop_count = (a_ring_size < 100 ? 100 : 10) / a_batch_size;
+  static const size_t ring_size = a_ring_size;
+  static const size_t batch_size = a_batch_size;
+
+  typedef multi_tx_test_base<a_ring_size> base_class;
+
+  test_check_ring_signatures() : m_cache(ring_size)
+  {
+  }
+
+  bool init()
+  {
+    using namespace CryptoNote;
+
+    if (!base_class::init())
+      return false;
+
+    m_alice.generate();
+
+    std::vector<TransactionDestinationEntry> destinations;
+    destinations.push_back(TransactionDestinationEntry(this->m_source_amount, m_alice.getAccountKeys().address));
+
+    for (size_t i = 0; i < batch_size; ++i)
+    {
+      if (!constructTransaction(this->m_miners[this->real_source_idx].getAccountKeys(), this->m_sources, destinations, std::vector<uint8_t>(), m_txs[i], 0, this->m_logger))
+        return false;
+
+      getObjectHash(*static_cast<TransactionPrefix*>(&m_txs[i]), m_tx_prefix_hashes[i]);
+
+      const KeyInput& txin = boost::get<KeyInput>(m_txs[i].inputs[0]);
+      m_entries[i] = { &m_tx_prefix_hashes[i], &txin.keyImage, this->m_public_key_ptrs, ring_size, m_txs[i].signatures[0].data() };
+    }
+
+    return true;
+  }
+
+  bool test()
+  {
+    return Crypto::check_ring_signatures(m_entries, batch_size, &m_cache);
+  }
+
+private:
+  CryptoNote::AccountBase m_alice;
+  CryptoNote::Transaction m_txs[batch_size];
+  Crypto::Hash m_tx_prefix_hashes[batch_size];
+  Crypto::RingSignatureBatchEntry m_entries[batch_size];
+  Crypto::RingMemberCache m_cache;
+};
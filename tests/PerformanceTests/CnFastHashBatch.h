@@ -0,0 +1,54 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "crypto/hash.h"
+
+// Hashes MESSAGE_COUNT messages of Length bytes per call, at most Ways of them at once.
+// Ways 1 is plain cn_fast_hash, the time per call and throughput of different Ways are comparable.
+template <size_t Ways, size_t Length>
+class test_cn_fast_hash_batch {
+public:
+  static const size_t loop_count = 2000;
+  static const size_t MESSAGE_COUNT = 64;
+  static const size_t bytes_per_call = MESSAGE_COUNT * Length;
+
+  ~test_cn_fast_hash_batch() {
+    Crypto::cn_fast_hash_select_ways(8);
+  }
+
+  bool init() {
+    m_data.resize(MESSAGE_COUNT * Length);
+    for (size_t i = 0; i < m_data.size(); ++i) {
+      m_data[i] = static_cast<uint8_t>(i * 131 + i / Length);
+    }
+
+    for (size_t i = 0; i < MESSAGE_COUNT; ++i) {
+      m_messages.push_back(&m_data[i * Length]);
+      m_lengths.push_back(Length);
+      m_expectedHashes.push_back(Crypto::cn_fast_hash(m_messages.back(), Length));
+    }
+
+    m_hashes.resize(MESSAGE_COUNT);
+    std::cout << "Hashing up to " << Crypto::cn_fast_hash_select_ways(Ways) << " messages at once" << std::endl;
+    return true;
+  }
+
+  bool test() {
+    Crypto::cn_fast_hash_batch(m_messages.data(), m_lengths.data(), m_hashes.data(), MESSAGE_COUNT);
+    return std::equal(m_hashes.begin(), m_hashes.end(), m_expectedHashes.begin());
+  }
+
+private:
+  std::vector<uint8_t> m_data;
+  std::vector<const void*> m_messages;
+  std::vector<size_t> m_lengths;
+  std::vector<Crypto::Hash> m_hashes;
+  std::vector<Crypto::Hash> m_expectedHashes;
+};
@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
 #include "Common/StringTools.h"
 #include "crypto/crypto.h"
 #include "CryptoNoteCore/CryptoNoteBasic.h"
@@ -30,6 +34,7 @@ public:
       return false;
     }
 
+    std::cout << "Scratchpad uses " << Crypto::cn_page_mode_name(m_context.getPageMode()) << std::endl;
     return true;
   }
 
@@ -44,3 +49,63 @@ private:
   Crypto::Hash m_expected_hash;
   Crypto::cn_context m_context;
 };
+
+// Same as test_cn_slow_hash with the table based AES used on CPUs without AES-NI
+class test_cn_slow_hash_software : public test_cn_slow_hash {
+public:
+  ~test_cn_slow_hash_software() {
+    Crypto::cn_slow_hash_use_software_aes(false);
+  }
+
+  bool init() {
+    Crypto::cn_slow_hash_use_software_aes(true);
+    return test_cn_slow_hash::init();
+  }
+};
+
+// Computes SLOW_HASH_MAX_WAYS hashes per call, Ways of them at once, so the time per call of different Ways is comparable
+template <size_t Ways>
+class test_cn_slow_hash_multi {
+public:
+  static const size_t loop_count = 10;
+
+  test_cn_slow_hash_multi() : m_context(Ways) {
+  }
+
+  bool init() {
+    size_t size;
+    m_data.resize(Crypto::SLOW_HASH_MAX_WAYS * DATA_SIZE);
+    for (size_t i = 0; i < Crypto::SLOW_HASH_MAX_WAYS; ++i) {
+      if (!Common::fromHex("63617665617420656d70746f72", &m_data[i * DATA_SIZE], DATA_SIZE, size) || size != DATA_SIZE) {
+        return false;
+      }
+
+      m_data[i * DATA_SIZE] += static_cast<char>(i);
+    }
+
+    // the interleaved hashes must match the ones computed one by one
+    Crypto::cn_context context;
+    for (size_t i = 0; i < Crypto::SLOW_HASH_MAX_WAYS; ++i) {
+      Crypto::cn_slow_hash(context, &m_data[i * DATA_SIZE], DATA_SIZE, m_expected_hashes[i]);
+    }
+
+    std::cout << "Scratchpads use " << Crypto::cn_page_mode_name(m_context.getPageMode()) << std::endl;
+    return true;
+  }
+
+  bool test() {
+    Crypto::Hash hashes[Crypto::SLOW_HASH_MAX_WAYS];
+    for (size_t i = 0; i < Crypto::SLOW_HASH_MAX_WAYS; i += Ways) {
+      Crypto::cn_slow_hash_multi(m_context, &m_data[i * DATA_SIZE], DATA_SIZE, hashes + i, Ways);
+    }
+
+    return std::equal(hashes, hashes + Crypto::SLOW_HASH_MAX_WAYS, m_expected_hashes);
+  }
+
+private:
+  static const size_t DATA_SIZE = 13;
+
+  std::vector<char> m_data;
+  Crypto::Hash m_expected_hashes[Crypto::SLOW_HASH_MAX_WAYS];
+  Crypto::cn_context m_context;
+};
@@ -0,0 +1,66 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <vector>
+
+#include "crypto/crypto.h"
+#include "CryptoNoteCore/CryptoNoteBasic.h"
+
+#include "SingleTransactionTestBase.h"
+
+// Scans 100 transactions with two outputs each for SpendKeyCount addresses sharing the view key,
+// compare with test_is_out_to_acc multiplied by 200
+template <size_t SpendKeyCount>
+class test_find_outputs : public single_tx_test_base
+{
+public:
+  static const size_t loop_count = 10;
+  static const size_t tx_count = 100;
+
+  bool init()
+  {
+    if (!single_tx_test_base::init())
+      return false;
+
+    const auto& keys = m_bob.getAccountKeys();
+    m_spendKeys.push_back(keys.address.spendPublicKey);
+    while (m_spendKeys.size() < SpendKeyCount) {
+      Crypto::SecretKey secretKey;
+      m_spendKeys.emplace_back();
+      Crypto::generate_keys(m_spendKeys.back(), secretKey);
+    }
+
+    for (size_t i = 0; i < tx_count; ++i) {
+      Crypto::PublicKey txPublicKey;
+      Crypto::SecretKey txSecretKey;
+      Crypto::KeyDerivation derivation;
+      Crypto::generate_keys(txPublicKey, txSecretKey);
+      Crypto::generate_key_derivation(keys.address.viewPublicKey, txSecretKey, derivation);
+      m_txPublicKeys.push_back(txPublicKey);
+
+      for (size_t j = 0; j < 2; ++j) {
+        Crypto::TransactionOutputKey output = { i, j };
+        Crypto::derive_public_key(derivation, j, m_spendKeys[(i + j) % SpendKeyCount], output.key);
+        m_outputs.push_back(output);
+      }
+    }
+
+    return true;
+  }
+
+  bool test()
+  {
+    Crypto::find_outputs(m_txPublicKeys.data(), m_txPublicKeys.size(), m_outputs.data(), m_outputs.size(),
+      m_bob.getAccountKeys().viewSecretKey, m_spendKeys.data(), m_spendKeys.size(), m_matches);
+    return m_matches.size() == m_outputs.size();
+  }
+
+private:
+  std::vector<Crypto::PublicKey> m_spendKeys;
+  std::vector<Crypto::PublicKey> m_txPublicKeys;
+  std::vector<Crypto::TransactionOutputKey> m_outputs;
+  std::vector<Crypto::OutputKeyMatch> m_matches;
+};
@@ -0,0 +1,37 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "crypto/crypto.h"
+#include "CryptoNoteCore/CryptoNoteBasic.h"
+
+#include "SingleTransactionTestBase.h"
+
+// Sender side derivation to a public key prepared once, compare with test_generate_key_derivation
+class test_generate_key_derivation_precomputed : public single_tx_test_base
+{
+public:
+  static const size_t loop_count = 1000;
+
+  bool init()
+  {
+    if (!single_tx_test_base::init())
+      return false;
+
+    Crypto::PublicKey txPublicKey;
+    Crypto::generate_keys(txPublicKey, m_txSecretKey);
+    return Crypto::precompute_public_key(m_bob.getAccountKeys().address.viewPublicKey, m_viewPublicKey);
+  }
+
+  bool test()
+  {
+    Crypto::KeyDerivation derivation;
+    return Crypto::generate_key_derivation(m_viewPublicKey, m_txSecretKey, derivation);
+  }
+
+private:
+  Crypto::PrecomputedPublicKey m_viewPublicKey;
+  Crypto::SecretKey m_txSecretKey;
+};
@@ -0,0 +1,48 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "crypto/crypto.h"
+#include "CryptoNoteCore/CryptoNoteBasic.h"
+
+#include "SingleTransactionTestBase.h"
+
+// Derives Count keys per call, compare with test_generate_key_derivation multiplied by Count
+template <size_t Count>
+class test_generate_key_derivations : public single_tx_test_base
+{
+public:
+  static const size_t loop_count = 1000 / Count;
+
+  test_generate_key_derivations() : m_txPublicKeys(Count), m_derivations(Count), m_results(new bool[Count]) {
+  }
+
+  bool init()
+  {
+    if (!single_tx_test_base::init())
+      return false;
+
+    for (auto& key : m_txPublicKeys) {
+      Crypto::SecretKey secretKey;
+      Crypto::generate_keys(key, secretKey);
+    }
+
+    return true;
+  }
+
+  bool test()
+  {
+    Crypto::generate_key_derivations(m_txPublicKeys.data(), Count, m_bob.getAccountKeys().viewSecretKey, m_derivations.data(), m_results.get());
+    return m_results[0];
+  }
+
+private:
+  std::vector<Crypto::PublicKey> m_txPublicKeys;
+  std::vector<Crypto::KeyDerivation> m_derivations;
+  std::unique_ptr<bool[]> m_results;
+};
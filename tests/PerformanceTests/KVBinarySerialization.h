@@ -0,0 +1,80 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <iostream>
+
+#include "CryptoNoteProtocol/CryptoNoteProtocolDefinitions.h"
+#include "P2p/LevinProtocol.h"
+
+// A NOTIFY_RESPONSE_GET_OBJECTS with BlockCount blocks of TransactionsPerBlock transactions each,
+// sized like the blocks and transactions of a sync
+template<size_t BlockCount, size_t TransactionsPerBlock>
+class kv_binary_test_base
+{
+public:
+  static const size_t BLOCK_SIZE = 300;
+  static const size_t TRANSACTION_SIZE = 900;
+
+  bool init()
+  {
+    m_request.current_blockchain_height = 1000000;
+    for (size_t i = 0; i < BlockCount; ++i)
+    {
+      CryptoNote::block_complete_entry block;
+      block.block = makeBlob(BLOCK_SIZE, i);
+      for (size_t j = 0; j < TransactionsPerBlock; ++j)
+      {
+        block.txs.push_back(makeBlob(TRANSACTION_SIZE, i * TransactionsPerBlock + j));
+      }
+
+      m_request.blocks.push_back(std::move(block));
+    }
+
+    m_buffer = CryptoNote::LevinProtocol::encode(m_request);
+    std::cout << "Payload of " << m_buffer.size() << " bytes" << std::endl;
+    return true;
+  }
+
+protected:
+  static std::string makeBlob(size_t size, size_t seed)
+  {
+    std::string blob(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+    {
+      blob[i] = static_cast<char>(i * 131 + seed);
+    }
+
+    return blob;
+  }
+
+  CryptoNote::NOTIFY_RESPONSE_GET_OBJECTS::request m_request;
+  CryptoNote::BinaryArray m_buffer;
+};
+
+template<size_t BlockCount, size_t TransactionsPerBlock>
+class test_kv_binary_serialization : public kv_binary_test_base<BlockCount, TransactionsPerBlock>
+{
+public:
+  static const size_t loop_count = 100;
+
+  bool test()
+  {
+    return CryptoNote::LevinProtocol::encode(this->m_request).size() == this->m_buffer.size();
+  }
+};
+
+template<size_t BlockCount, size_t TransactionsPerBlock>
+class test_kv_binary_deserialization : public kv_binary_test_base<BlockCount, TransactionsPerBlock>
+{
+public:
+  static const size_t loop_count = 100;
+
+  bool test()
+  {
+    CryptoNote::NOTIFY_RESPONSE_GET_OBJECTS::request request;
+    return CryptoNote::LevinProtocol::decode(this->m_buffer, request) && request.blocks.size() == BlockCount;
+  }
+};
@@ -6,6 +6,7 @@
 
 #include <iostream>
 #include <stdint.h>
+#include <type_traits>
 
 #include <boost/chrono.hpp>
 
@@ -95,6 +96,33 @@ private:
   int m_elapsed;
 };
 
+/**
+ * Tests that process a fixed amount of data per call declare it as bytes_per_call to get the throughput reported
+ */
+template <typename T>
+class has_bytes_per_call
+{
+  template <typename U> static char check(decltype(&U::bytes_per_call));
+  template <typename U> static long check(...);
+
+public:
+  static const bool value = sizeof(check<T>(nullptr)) == 1;
+};
+
+template <typename T>
+void print_throughput(const test_runner<T>& runner, std::true_type)
+{
+  if (runner.elapsed_time() > 0)
+  {
+    std::cout << "  throughput:    " << static_cast<double>(T::bytes_per_call) * T::loop_count / (runner.elapsed_time() * 1000.0) << " MB/s\n";
+  }
+}
+
+template <typename T>
+void print_throughput(const test_runner<T>&, std::false_type)
+{
+}
+
 template <typename T>
 void run_test(const char* test_name)
 {
@@ -104,7 +132,9 @@ void run_test(const char* test_name)
     std::cout << test_name << " - OK:\n";
     std::cout << "  loop count:    " << T::loop_count << '\n';
     std::cout << "  elapsed:       " << runner.elapsed_time() << " ms\n";
-    std::cout << "  time per call: " << runner.time_per_call() << " ms/call\n" << std::endl;
+    std::cout << "  time per call: " << runner.time_per_call() << " ms/call\n";
+    print_throughput(runner, std::integral_constant<bool, has_bytes_per_call<T>::value>());
+    std::cout << std::endl;
   }
   else
   {
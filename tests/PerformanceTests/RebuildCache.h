@@ -0,0 +1,143 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "Common/StringTools.h"
+#include "CryptoNoteCore/Account.h"
+#include "CryptoNoteCore/Checkpoints.h"
+#include "CryptoNoteCore/Core.h"
+#include "CryptoNoteCore/CoreConfig.h"
+#include "CryptoNoteCore/CryptoNoteFormatUtils.h"
+#include "CryptoNoteCore/CryptoNoteTools.h"
+#include "CryptoNoteCore/Currency.h"
+#include "CryptoNoteCore/MinerConfig.h"
+#include "Logging/ConsoleLogger.h"
+
+#include "../TestGenerator/TestGenerator.h"
+
+// Data directory with a generated chain, shared by all test_rebuild_cache instances
+class rebuild_cache_chain {
+public:
+  static const size_t block_count = 10000;
+
+  static const rebuild_cache_chain& instance() {
+    static rebuild_cache_chain chain;
+    return chain;
+  }
+
+  ~rebuild_cache_chain() {
+    boost::system::error_code ignoredErrorCode;
+    boost::filesystem::remove_all(m_dataDir, ignoredErrorCode);
+  }
+
+  const CryptoNote::Currency& currency() const { return m_currency; }
+  const std::string& data_dir() const { return m_dataDir; }
+  bool generated() const { return m_generated; }
+
+private:
+  rebuild_cache_chain() : m_logger(Logging::ERROR), m_currency(CryptoNote::CurrencyBuilder(m_logger).currency()), m_generated(false) {
+    m_dataDir = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("rebuild_cache_%%%%%%%%")).string();
+    boost::filesystem::create_directories(m_dataDir);
+    m_generated = generate();
+  }
+
+  bool generate() {
+    test_generator generator(m_currency);
+    CryptoNote::AccountBase miner;
+    miner.generate();
+
+    std::vector<size_t> blockSizes;
+    generator.addBlock(m_currency.genesisBlock(), 0, 0, blockSizes, 0);
+
+    std::vector<CryptoNote::Block> blocks;
+    blocks.reserve(block_count);
+    CryptoNote::Block previousBlock = m_currency.genesisBlock();
+    for (size_t i = 0; i < block_count; ++i) {
+      CryptoNote::Block block;
+      if (!generator.constructBlockManually(block, previousBlock, miner)) {
+        return false;
+      }
+
+      blocks.push_back(block);
+      previousBlock = block;
+    }
+
+    // blocks are generated without proof of work, let them pass as checkpointed ones
+    CryptoNote::Checkpoints checkpoints(m_logger);
+    checkpoints.add_checkpoint(static_cast<uint32_t>(block_count), Common::podToHex(CryptoNote::get_block_hash(blocks.back())));
+
+    CryptoNote::core core(m_currency, nullptr, m_logger);
+    core.set_checkpoints(std::move(checkpoints));
+
+    CryptoNote::CoreConfig config;
+    config.configFolder = m_dataDir;
+    if (!core.init(config, CryptoNote::MinerConfig(), true)) {
+      return false;
+    }
+
+    for (const auto& block : blocks) {
+      CryptoNote::block_verification_context bvc = boost::value_initialized<CryptoNote::block_verification_context>();
+      core.handle_incoming_block_blob(CryptoNote::toBinaryArray(block), bvc, false, false);
+      if (!bvc.m_added_to_main_chain) {
+        core.deinit();
+        return false;
+      }
+    }
+
+    core.deinit();
+    return true;
+  }
+
+  Logging::ConsoleLogger m_logger;
+  CryptoNote::Currency m_currency;
+  std::string m_dataDir;
+  bool m_generated;
+};
+
+// Rebuilds blockchain cache from scratch, without both blockscache.dat and the index journal
+template<uint32_t rebuild_threads>
+class test_rebuild_cache {
+public:
+  static const size_t loop_count = 3;
+
+  test_rebuild_cache() : m_logger(Logging::ERROR) {
+  }
+
+  bool init() {
+    return rebuild_cache_chain::instance().generated();
+  }
+
+  bool test() {
+    const rebuild_cache_chain& chain = rebuild_cache_chain::instance();
+    removeCache(chain);
+
+    CryptoNote::core core(chain.currency(), nullptr, m_logger);
+    CryptoNote::CoreConfig config;
+    config.configFolder = chain.data_dir();
+    config.rebuildThreads = rebuild_threads;
+    if (!core.init(config, CryptoNote::MinerConfig(), true)) {
+      return false;
+    }
+
+    bool result = core.get_current_blockchain_height() == rebuild_cache_chain::block_count + 1;
+    core.deinit();
+    return result;
+  }
+
+private:
+  void removeCache(const rebuild_cache_chain& chain) {
+    boost::filesystem::path dataDir(chain.data_dir());
+    boost::filesystem::remove(dataDir / chain.currency().blocksCacheFileName());
+    boost::filesystem::remove(dataDir / chain.currency().blocksCacheJournalFileName());
+    boost::filesystem::remove(dataDir / chain.currency().blocksCacheJournalIndexesFileName());
+  }
+
+  Logging::ConsoleLogger m_logger;
+};
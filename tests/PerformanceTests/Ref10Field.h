@@ -0,0 +1,21 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "crypto/crypto.h"
+
+// Runs a test with the ref10 field arithmetic to compare it with the default radix 2^51 one
+template <typename Test>
+class test_ref10_field : public Test {
+public:
+  ~test_ref10_field() {
+    Crypto::use_radix51_field(true);
+  }
+
+  bool init() {
+    Crypto::use_radix51_field(false);
+    return Test::init();
+  }
+};
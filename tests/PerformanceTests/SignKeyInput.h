@@ -0,0 +1,50 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "CryptoNoteCore/TransactionApi.h"
+
+#include "SingleTransactionTestBase.h"
+
+// Adds and signs one key input of a new transaction, with or without the key image kept when the output was received
+template<bool StoredKeyImage>
+class test_sign_key_input : public single_tx_test_base
+{
+public:
+  static const size_t loop_count = 1000;
+
+  bool init()
+  {
+    using namespace CryptoNote;
+
+    if (!single_tx_test_base::init())
+      return false;
+
+    TransactionTypes::GlobalOutput output = { boost::get<KeyOutput>(m_tx.outputs[0].target).key, 0 };
+    m_info.amount = m_tx.outputs[0].amount;
+    m_info.outputs.push_back(output);
+    m_info.realOutput.transactionPublicKey = m_tx_pub_key;
+    m_info.realOutput.transactionIndex = 0;
+    m_info.realOutput.outputInTransaction = 0;
+
+    KeyPair ephKeys;
+    return generate_key_image_helper(m_bob.getAccountKeys(), m_tx_pub_key, 0, ephKeys, m_keyImage);
+  }
+
+  bool test()
+  {
+    std::unique_ptr<CryptoNote::ITransaction> tx = CryptoNote::createTransaction();
+    CryptoNote::KeyPair ephKeys;
+    size_t index = StoredKeyImage ?
+      tx->addInput(m_bob.getAccountKeys(), m_info, m_keyImage, ephKeys) :
+      tx->addInput(m_bob.getAccountKeys(), m_info, ephKeys);
+    tx->signInputKey(index, m_info, ephKeys);
+    return true;
+  }
+
+private:
+  CryptoNote::TransactionTypes::InputKeyInfo m_info;
+  Crypto::KeyImage m_keyImage;
+};
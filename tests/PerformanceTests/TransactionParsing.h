@@ -0,0 +1,62 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <type_traits>
+
+#include "crypto/crypto.h"
+#include "CryptoNoteConfig.h"
+#include "CryptoNoteCore/CryptoNoteTools.h"
+#include "CryptoNoteCore/FlatTransaction.h"
+
+// Parses a transaction with key inputs of a ring of several outputs into a Transaction or a FlatTransaction
+template<bool Flat>
+class test_transaction_parsing
+{
+public:
+  static const size_t loop_count = 10000;
+  static const size_t INPUT_COUNT = 4;
+  static const size_t RING_SIZE = 5;
+
+  bool init()
+  {
+    CryptoNote::Transaction transaction;
+    transaction.version = CryptoNote::CURRENT_TRANSACTION_VERSION;
+    transaction.unlockTime = 0;
+    for (size_t i = 0; i < INPUT_COUNT; ++i)
+    {
+      CryptoNote::KeyInput input;
+      input.amount = 1000000 + i;
+      for (size_t j = 0; j < RING_SIZE; ++j)
+      {
+        input.outputIndexes.push_back(static_cast<uint32_t>(1000 * j + i));
+      }
+
+      input.keyImage = Crypto::rand<Crypto::KeyImage>();
+      transaction.inputs.push_back(input);
+      transaction.signatures.push_back(std::vector<Crypto::Signature>(RING_SIZE, Crypto::rand<Crypto::Signature>()));
+    }
+
+    for (size_t i = 0; i < 2 * INPUT_COUNT; ++i)
+    {
+      CryptoNote::KeyOutput output;
+      output.key = Crypto::rand<Crypto::PublicKey>();
+      transaction.outputs.push_back({ 500000 + i, output });
+    }
+
+    transaction.extra.resize(33, 1);
+    m_blob = CryptoNote::toBinaryArray(transaction);
+    return true;
+  }
+
+  bool test()
+  {
+    typename std::conditional<Flat, CryptoNote::FlatTransaction, CryptoNote::Transaction>::type transaction;
+    return CryptoNote::fromBinaryArray(transaction, m_blob);
+  }
+
+private:
+  CryptoNote::BinaryArray m_blob;
+};
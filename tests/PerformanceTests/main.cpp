@@ -8,16 +8,31 @@
 // tests
 #include "ConstructTransaction.h"
 #include "CheckRingSignature.h"
+#include "CnFastHashBatch.h"
 #include "CryptoNoteSlowHash.h"
 #include "DerivePublicKey.h"
 #include "DeriveSecretKey.h"
+#include "FindOutputs.h"
 #include "GenerateKeyDerivation.h"
+#include "GenerateKeyDerivationPrecomputed.h"
+#include "GenerateKeyDerivations.h"
 #include "GenerateKeyImage.h"
 #include "GenerateKeyImageHelper.h"
 #include "IsOutToAccount.h"
+#include "KVBinarySerialization.h"
+#include "RebuildCache.h"
+#include "Ref10Field.h"
+#include "SignKeyInput.h"
+#include "TransactionParsing.h"
 
 int main(int argc, char** argv)
 {
+  // multithreaded tests go first, the affinity set below is inherited by all threads started afterwards
+  TEST_PERFORMANCE1(test_rebuild_cache, 1);
+  TEST_PERFORMANCE1(test_rebuild_cache, 2);
+  TEST_PERFORMANCE1(test_rebuild_cache, 4);
+  TEST_PERFORMANCE1(test_rebuild_cache, 8);
+
   set_process_affinity(1);
   set_thread_high_priority();
 
@@ -47,17 +62,62 @@ int main(int argc, char** argv)
 
   TEST_PERFORMANCE1(test_check_ring_signature, 1);
   TEST_PERFORMANCE1(test_check_ring_signature, 2);
+  TEST_PERFORMANCE1(test_check_ring_signature, 5);
   TEST_PERFORMANCE1(test_check_ring_signature, 10);
+  TEST_PERFORMANCE1(test_check_ring_signature, 20);
+  TEST_PERFORMANCE1(test_check_ring_signature, 50);
   TEST_PERFORMANCE1(test_check_ring_signature, 100);
 
+  TEST_PERFORMANCE2(test_check_ring_signatures, 1, 1);
+  TEST_PERFORMANCE2(test_check_ring_signatures, 1, 10);
+  TEST_PERFORMANCE2(test_check_ring_signatures, 2, 10);
+  TEST_PERFORMANCE2(test_check_ring_signatures, 5, 10);
+  TEST_PERFORMANCE2(test_check_ring_signatures, 10, 1);
+  TEST_PERFORMANCE2(test_check_ring_signatures, 10, 10);
+  TEST_PERFORMANCE2(test_check_ring_signatures, 20, 10);
+  TEST_PERFORMANCE2(test_check_ring_signatures, 50, 10);
+  TEST_PERFORMANCE2(test_check_ring_signatures, 100, 1);
+  TEST_PERFORMANCE2(test_check_ring_signatures, 100, 10);
+
+  TEST_PERFORMANCE2(test_kv_binary_serialization, 200, 0);
+  TEST_PERFORMANCE2(test_kv_binary_serialization, 200, 10);
+  TEST_PERFORMANCE2(test_kv_binary_deserialization, 200, 0);
+  TEST_PERFORMANCE2(test_kv_binary_deserialization, 200, 10);
+
+  TEST_PERFORMANCE1(test_transaction_parsing, false);
+  TEST_PERFORMANCE1(test_transaction_parsing, true);
+
   TEST_PERFORMANCE0(test_is_out_to_acc);
+  TEST_PERFORMANCE1(test_find_outputs, 1);
+  TEST_PERFORMANCE1(test_find_outputs, 16);
   TEST_PERFORMANCE0(test_generate_key_image_helper);
   TEST_PERFORMANCE0(test_generate_key_derivation);
+  TEST_PERFORMANCE0(test_generate_key_derivation_precomputed);
+  TEST_PERFORMANCE1(test_generate_key_derivations, 4);
+  TEST_PERFORMANCE1(test_generate_key_derivations, 100);
   TEST_PERFORMANCE0(test_generate_key_image);
   TEST_PERFORMANCE0(test_derive_public_key);
   TEST_PERFORMANCE0(test_derive_secret_key);
+  TEST_PERFORMANCE1(test_sign_key_input, false);
+  TEST_PERFORMANCE1(test_sign_key_input, true);
+
+  TEST_PERFORMANCE1(test_ref10_field, test_check_ring_signature<10>);
+  TEST_PERFORMANCE1(test_ref10_field, test_generate_key_derivation);
+  TEST_PERFORMANCE1(test_ref10_field, test_generate_key_image);
+  TEST_PERFORMANCE1(test_ref10_field, test_derive_public_key);
+
+  TEST_PERFORMANCE2(test_cn_fast_hash_batch, 1, 64);
+  TEST_PERFORMANCE2(test_cn_fast_hash_batch, 4, 64);
+  TEST_PERFORMANCE2(test_cn_fast_hash_batch, 8, 64);
+  TEST_PERFORMANCE2(test_cn_fast_hash_batch, 1, 1024);
+  TEST_PERFORMANCE2(test_cn_fast_hash_batch, 4, 1024);
+  TEST_PERFORMANCE2(test_cn_fast_hash_batch, 8, 1024);
 
   TEST_PERFORMANCE0(test_cn_slow_hash);
+  TEST_PERFORMANCE0(test_cn_slow_hash_software);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 1);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 2);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 4);
 
   std::cout << "Tests finished. Elapsed time: " << timer.elapsed_ms() / 1000 << " sec" << std::endl;
 
@@ -12,6 +12,8 @@
 #include "Serialization/SerializationTools.h"
 
 #include <array>
+#include <Common/MemoryInputStream.h>
+#include <Common/StringTools.h>
 
 using namespace CryptoNote;
 
@@ -68,6 +70,40 @@ struct TestStruct {
 
 };
 
+struct ManyKeysTestStruct {
+  std::vector<uint32_t> values;
+
+  void serialize(ISerializer& s) {
+    for (size_t i = 0; i < values.size(); ++i) {
+      s(values[i], "value" + std::to_string(i));
+    }
+  }
+};
+
+struct NestedManyKeysTestStruct {
+  ManyKeysTestStruct inner;
+  uint8_t after;
+
+  void serialize(ISerializer& s) {
+    s(inner, "inner");
+    s(after, "after");
+  }
+};
+
+struct ReorderedTestStruct {
+  uint64_t u64;
+  TestElement root;
+  uint8_t u8;
+  std::vector<TestElement> vec2;
+
+  void serialize(ISerializer& s) {
+    s(u64, "u64");
+    s(root, "root");
+    s(u8, "u8");
+    s(vec2, "vec2");
+  }
+};
+
 }
 
 
@@ -121,3 +157,104 @@ TEST(KVSerialize, BigCollection) {
   ASSERT_TRUE(CryptoNote::loadFromBinaryKeyValue(ts2, buf));
   EXPECT_EQ(ts1, ts2);
 }
+
+TEST(KVSerialize, KeysInAnyOrder) {
+  TestStruct ts1;
+  ts1.u8 = 100;
+  ts1.u32 = 0xff0000;
+  ts1.u64 = 1ULL << 60;
+  ts1.root.name = "hello";
+  ts1.root.u32array.resize(3, 7);
+
+  TestElement sample;
+  sample.name = "sample";
+  sample.nonce = 101;
+  ts1.vec1.resize(10, sample);
+  ts1.vec2.resize(3, ts1.root);
+
+  // vec1 and u32 are skipped
+  ReorderedTestStruct ts2;
+  std::string buf = CryptoNote::storeToBinaryKeyValue(ts1);
+  ASSERT_TRUE(CryptoNote::loadFromBinaryKeyValue(ts2, buf));
+  EXPECT_EQ(ts1.u64, ts2.u64);
+  EXPECT_EQ(ts1.root, ts2.root);
+  EXPECT_EQ(ts1.u8, ts2.u8);
+  EXPECT_EQ(ts1.vec2, ts2.vec2);
+}
+
+TEST(KVSerialize, StreamAndBufferReadTheSame) {
+  TestElement testData1;
+  testData1.name = "hello";
+  testData1.nonce = 12345;
+  testData1.u32array.resize(5000, 3);
+
+  std::string buf = CryptoNote::storeToBinaryKeyValue(testData1);
+  Common::MemoryInputStream stream(buf.data(), buf.size());
+  KVBinaryInputStreamSerializer serializer(stream);
+
+  TestElement testData2;
+  serialize(testData2, serializer);
+  EXPECT_EQ(testData1, testData2);
+}
+
+TEST(KVSerialize, TruncatedDataFails) {
+  TestStruct ts1;
+  ts1.u8 = 100;
+  ts1.u32 = 0xff0000;
+  ts1.u64 = 1ULL << 60;
+  ts1.root.name = "hello";
+  ts1.vec1.resize(2, ts1.root);
+
+  std::string buf = CryptoNote::storeToBinaryKeyValue(ts1);
+  for (size_t size = 0; size < buf.size(); ++size) {
+    TestStruct ts2;
+    ASSERT_FALSE(CryptoNote::loadFromBinaryKeyValue(ts2, buf.substr(0, size))) << "size " << size;
+  }
+}
+
+TEST(KVSerialize, Format) {
+  TestElement testData;
+  testData.name = "hi";
+  testData.nonce = 0x01020304;
+  testData.blob.fill(0xab);
+  testData.u32array.resize(1, 5);
+
+  TestStruct ts;
+  ts.u8 = 1;
+  ts.u32 = 2;
+  ts.u64 = 3;
+  ts.root = testData;
+  ts.vec1.resize(2, testData);
+  std::string buf = CryptoNote::storeToBinaryKeyValue(ts);
+  ASSERT_EQ(
+    "0111010101010201011404726f6f740c10046e616d650a086869056e6f6e6365060403020104626c6f620a40abababababababababababababababab"
+    "0875333261727261790a100500000004766563318c0810046e616d650a086869056e6f6e6365060403020104626c6f620a40abababababababababab"
+    "abababababab0875333261727261790a100500000010046e616d650a086869056e6f6e6365060403020104626c6f620a40ababababababababababab"
+    "ababababab0875333261727261790a1005000000027538080103753332060200000003753634050300000000000000",
+    Common::toHex(buf.data(), buf.size()));
+}
+
+TEST(KVSerialize, ObjectsWithManyKeys) {
+  for (size_t count : { 63, 64, 16383, 16384 }) {
+    ManyKeysTestStruct ts1;
+    for (size_t i = 0; i < count; ++i) {
+      ts1.values.push_back(static_cast<uint32_t>(i * 7));
+    }
+
+    ManyKeysTestStruct ts2;
+    ts2.values.resize(count);
+    std::string buf = CryptoNote::storeToBinaryKeyValue(ts1);
+    ASSERT_TRUE(CryptoNote::loadFromBinaryKeyValue(ts2, buf));
+    ASSERT_EQ(ts1.values, ts2.values) << "count " << count;
+
+    NestedManyKeysTestStruct nested1;
+    nested1.inner = ts1;
+    nested1.after = 42;
+    NestedManyKeysTestStruct nested2;
+    nested2.inner.values.resize(count);
+    buf = CryptoNote::storeToBinaryKeyValue(nested1);
+    ASSERT_TRUE(CryptoNote::loadFromBinaryKeyValue(nested2, buf));
+    ASSERT_EQ(nested1.inner.values, nested2.inner.values) << "count " << count;
+    ASSERT_EQ(42, nested2.after);
+  }
+}
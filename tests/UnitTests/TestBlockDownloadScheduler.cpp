@@ -0,0 +1,157 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "CryptoNoteProtocol/BlockDownloadScheduler.h"
+#include "crypto/hash.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+typedef BlockDownloadScheduler::Clock Clock;
+typedef BlockDownloadScheduler::ConnectionId ConnectionId;
+
+const Clock::duration STALL_TIMEOUT = std::chrono::seconds(30);
+
+ConnectionId makeConnection(uint8_t value) {
+  ConnectionId connection = ConnectionId();
+  connection.data[0] = value;
+  return connection;
+}
+
+std::vector<Crypto::Hash> makeBlockIds(uint8_t first, size_t count) {
+  std::vector<Crypto::Hash> blockIds(count);
+  for (size_t i = 0; i < count; ++i) {
+    blockIds[i].data[0] = static_cast<uint8_t>(first + i);
+  }
+
+  return blockIds;
+}
+
+std::vector<PreparedBlock> makeBlocks(const std::vector<Crypto::Hash>& blockIds) {
+  std::vector<PreparedBlock> blocks(blockIds.size());
+  for (size_t i = 0; i < blockIds.size(); ++i) {
+    blocks[i].hash = blockIds[i];
+    blocks[i].parsed = true;
+  }
+
+  return blocks;
+}
+
+}
+
+TEST(BlockDownloadScheduler, spansAreDownloadedInParallelAndProcessedInHeightOrder) {
+  BlockDownloadScheduler scheduler(2, 16, STALL_TIMEOUT);
+  ConnectionId first = makeConnection(1);
+  ConnectionId second = makeConnection(2);
+  Clock::time_point now = Clock::now();
+  ASSERT_TRUE(scheduler.addBlockIds(first, 10, makeBlockIds(10, 4)));
+  ASSERT_TRUE(scheduler.addBlockIds(second, 10, makeBlockIds(10, 4)));
+
+  std::vector<Crypto::Hash> firstSpan;
+  std::vector<Crypto::Hash> secondSpan;
+  ASSERT_TRUE(scheduler.takeSpan(first, now, firstSpan));
+  ASSERT_FALSE(scheduler.takeSpan(first, now, secondSpan));
+  ASSERT_TRUE(scheduler.takeSpan(second, now, secondSpan));
+  ASSERT_EQ(makeBlockIds(10, 2), firstSpan);
+  ASSERT_EQ(makeBlockIds(12, 2), secondSpan);
+
+  std::vector<PreparedBlock> blocks;
+  ConnectionId source;
+  ASSERT_TRUE(scheduler.completeSpan(second, makeBlocks(secondSpan)));
+  ASSERT_FALSE(scheduler.popReadySpan(blocks, source));
+
+  // blocks are put in the order of heights
+  std::vector<PreparedBlock> response = makeBlocks(firstSpan);
+  std::swap(response[0], response[1]);
+  ASSERT_TRUE(scheduler.completeSpan(first, std::move(response)));
+  ASSERT_TRUE(scheduler.popReadySpan(blocks, source));
+  ASSERT_EQ(first, source);
+  ASSERT_EQ(2, blocks.size());
+  ASSERT_EQ(firstSpan[0], blocks[0].hash);
+  ASSERT_EQ(firstSpan[1], blocks[1].hash);
+  ASSERT_TRUE(scheduler.popReadySpan(blocks, source));
+  ASSERT_EQ(second, source);
+  ASSERT_EQ(secondSpan[0], blocks[0].hash);
+  ASSERT_TRUE(scheduler.empty());
+}
+
+TEST(BlockDownloadScheduler, stalledSpanIsRequestedFromAnotherConnection) {
+  BlockDownloadScheduler scheduler(2, 1, STALL_TIMEOUT);
+  ConnectionId slow = makeConnection(1);
+  ConnectionId fast = makeConnection(2);
+  Clock::time_point now = Clock::now();
+  ASSERT_TRUE(scheduler.addBlockIds(slow, 10, makeBlockIds(10, 4)));
+  ASSERT_TRUE(scheduler.addBlockIds(fast, 10, makeBlockIds(10, 4)));
+
+  std::vector<Crypto::Hash> slowSpan;
+  std::vector<Crypto::Hash> fastSpan;
+  ASSERT_TRUE(scheduler.takeSpan(slow, now, slowSpan));
+  ASSERT_FALSE(scheduler.takeSpan(fast, now + STALL_TIMEOUT / 2, fastSpan));
+  ASSERT_TRUE(scheduler.takeSpan(fast, now + STALL_TIMEOUT, fastSpan));
+  ASSERT_EQ(slowSpan, fastSpan);
+
+  ASSERT_TRUE(scheduler.completeSpan(fast, makeBlocks(fastSpan)));
+  ASSERT_FALSE(scheduler.completeSpan(slow, makeBlocks(slowSpan)));
+
+  std::vector<PreparedBlock> blocks;
+  ConnectionId source;
+  ASSERT_TRUE(scheduler.popReadySpan(blocks, source));
+  ASSERT_EQ(fast, source);
+}
+
+TEST(BlockDownloadScheduler, spanOfClosedConnectionIsHandedOut) {
+  BlockDownloadScheduler scheduler(2, 16, STALL_TIMEOUT);
+  ConnectionId closed = makeConnection(1);
+  ConnectionId other = makeConnection(2);
+  Clock::time_point now = Clock::now();
+  ASSERT_TRUE(scheduler.addBlockIds(closed, 10, makeBlockIds(10, 4)));
+  ASSERT_TRUE(scheduler.addBlockIds(other, 10, makeBlockIds(10, 4)));
+
+  std::vector<Crypto::Hash> closedSpan;
+  std::vector<Crypto::Hash> otherSpan;
+  ASSERT_TRUE(scheduler.takeSpan(closed, now, closedSpan));
+  scheduler.removeConnection(closed);
+  ASSERT_FALSE(scheduler.hasConnection(closed));
+  ASSERT_TRUE(scheduler.takeSpan(other, now, otherSpan));
+  ASSERT_EQ(closedSpan, otherSpan);
+}
+
+TEST(BlockDownloadScheduler, spansDoNotExceedBlocksAnnouncedByConnection) {
+  BlockDownloadScheduler scheduler(3, 16, STALL_TIMEOUT);
+  ConnectionId shortChain = makeConnection(1);
+  ConnectionId longChain = makeConnection(2);
+  Clock::time_point now = Clock::now();
+  ASSERT_TRUE(scheduler.addBlockIds(longChain, 10, makeBlockIds(10, 6)));
+  ASSERT_TRUE(scheduler.addBlockIds(shortChain, 10, makeBlockIds(10, 2)));
+
+  std::vector<Crypto::Hash> blockIds;
+  ASSERT_TRUE(scheduler.takeSpan(shortChain, now, blockIds));
+  ASSERT_EQ(makeBlockIds(10, 2), blockIds);
+  ASSERT_TRUE(scheduler.needsBlockIds(shortChain));
+  ASSERT_FALSE(scheduler.needsBlockIds(longChain));
+
+  ASSERT_TRUE(scheduler.takeSpan(longChain, now, blockIds));
+  ASSERT_EQ(makeBlockIds(12, 3), blockIds);
+}
+
+TEST(BlockDownloadScheduler, rejectsContradictingBlockIds) {
+  BlockDownloadScheduler scheduler(2, 16, STALL_TIMEOUT);
+  ConnectionId first = makeConnection(1);
+  ConnectionId second = makeConnection(2);
+  ASSERT_TRUE(scheduler.addBlockIds(first, 10, makeBlockIds(10, 4)));
+
+  std::vector<Crypto::Hash> blockIds = makeBlockIds(12, 4);
+  blockIds[1].data[1] = 1;
+  ASSERT_FALSE(scheduler.addBlockIds(second, 12, blockIds));
+  ASSERT_FALSE(scheduler.addBlockIds(second, 15, makeBlockIds(15, 2)));
+  ASSERT_FALSE(scheduler.hasConnection(second));
+
+  ASSERT_TRUE(scheduler.addBlockIds(second, 12, makeBlockIds(12, 4)));
+  ASSERT_TRUE(scheduler.hasConnection(second));
+}
@@ -0,0 +1,134 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include "crypto/crypto.h"
+#include "CryptoNoteConfig.h"
+#include "CryptoNoteCore/CachedBlock.h"
+#include "CryptoNoteCore/CachedTransaction.h"
+#include "CryptoNoteCore/CryptoNoteFormatUtils.h"
+#include "CryptoNoteCore/CryptoNoteTools.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+Transaction createTransaction() {
+  Transaction transaction;
+  transaction.version = CURRENT_TRANSACTION_VERSION;
+  transaction.unlockTime = 10;
+
+  KeyInput keyInput;
+  keyInput.amount = 1000;
+  keyInput.outputIndexes = { 1, 5, 9 };
+  keyInput.keyImage = Crypto::rand<Crypto::KeyImage>();
+  transaction.inputs.push_back(keyInput);
+
+  MultisignatureInput multisignatureInput;
+  multisignatureInput.amount = 2000;
+  multisignatureInput.signatureCount = 2;
+  multisignatureInput.outputIndex = 3;
+  transaction.inputs.push_back(multisignatureInput);
+
+  KeyOutput keyOutput;
+  keyOutput.key = Crypto::rand<Crypto::PublicKey>();
+  transaction.outputs.push_back({ 2900, keyOutput });
+  transaction.extra = { 1, 2, 3 };
+
+  // one signature per output index of the key input and as many as required by the multisignature input
+  for (size_t signatureCount : { keyInput.outputIndexes.size(), static_cast<size_t>(multisignatureInput.signatureCount) }) {
+    std::vector<Crypto::Signature> signatures(signatureCount);
+    for (auto& signature : signatures) {
+      signature = Crypto::rand<Crypto::Signature>();
+    }
+
+    transaction.signatures.push_back(signatures);
+  }
+
+  return transaction;
+}
+
+Transaction createBaseTransaction() {
+  Transaction transaction;
+  transaction.version = CURRENT_TRANSACTION_VERSION;
+  transaction.unlockTime = 70;
+
+  BaseInput baseInput;
+  baseInput.blockIndex = 10;
+  transaction.inputs.push_back(baseInput);
+
+  KeyOutput keyOutput;
+  keyOutput.key = Crypto::rand<Crypto::PublicKey>();
+  transaction.outputs.push_back({ 5000, keyOutput });
+  return transaction;
+}
+
+}
+
+TEST(CachedTransaction, matchesSerializedTransaction) {
+  Transaction transaction = createTransaction();
+  CachedTransaction cachedTransaction(transaction);
+
+  ASSERT_EQ(toBinaryArray(transaction), cachedTransaction.getTransactionBinaryArray());
+  ASSERT_EQ(getObjectHash(transaction), cachedTransaction.getTransactionHash());
+  ASSERT_EQ(getObjectHash(*static_cast<const TransactionPrefix*>(&transaction)), cachedTransaction.getTransactionPrefixHash());
+  ASSERT_EQ(getObjectBinarySize(transaction), cachedTransaction.getTransactionBinarySize());
+}
+
+TEST(CachedTransaction, parsesBinaryArray) {
+  Transaction transaction = createTransaction();
+  BinaryArray binaryArray = toBinaryArray(transaction);
+  CachedTransaction cachedTransaction(binaryArray);
+
+  ASSERT_EQ(binaryArray, toBinaryArray(cachedTransaction.getTransaction()));
+  ASSERT_EQ(getObjectHash(transaction), cachedTransaction.getTransactionHash());
+  ASSERT_EQ(getObjectHash(*static_cast<const TransactionPrefix*>(&transaction)), cachedTransaction.getTransactionPrefixHash());
+  ASSERT_EQ(binaryArray.size(), cachedTransaction.getTransactionBinarySize());
+}
+
+TEST(CachedTransaction, throwsOnInvalidBinaryArray) {
+  BinaryArray binaryArray = toBinaryArray(createTransaction());
+  binaryArray.pop_back();
+
+  ASSERT_ANY_THROW(CachedTransaction cachedTransaction(binaryArray));
+}
+
+TEST(CachedTransaction, keepsGivenHashAndSize) {
+  Transaction transaction = createTransaction();
+  Crypto::Hash hash = Crypto::rand<Crypto::Hash>();
+  CachedTransaction cachedTransaction(transaction, hash, 7);
+
+  ASSERT_EQ(hash, cachedTransaction.getTransactionHash());
+  ASSERT_EQ(7, cachedTransaction.getTransactionBinarySize());
+  ASSERT_EQ(getObjectHash(*static_cast<const TransactionPrefix*>(&transaction)), cachedTransaction.getTransactionPrefixHash());
+}
+
+TEST(CachedTransaction, prefixHashOfTransactionWithoutSignatures) {
+  Transaction transaction = createBaseTransaction();
+  CachedTransaction cachedTransaction(transaction);
+
+  ASSERT_EQ(getObjectHash(*static_cast<const TransactionPrefix*>(&transaction)), cachedTransaction.getTransactionPrefixHash());
+  ASSERT_EQ(getObjectHash(transaction), cachedTransaction.getTransactionHash());
+}
+
+TEST(CachedBlock, matchesBlockHash) {
+  Block block;
+  block.majorVersion = BLOCK_MAJOR_VERSION_1;
+  block.minorVersion = BLOCK_MINOR_VERSION_0;
+  block.timestamp = 1000;
+  block.previousBlockHash = Crypto::rand<Crypto::Hash>();
+  block.nonce = 12;
+  block.baseTransaction = createBaseTransaction();
+  block.transactionHashes = { Crypto::rand<Crypto::Hash>(), Crypto::rand<Crypto::Hash>() };
+
+  CachedBlock cachedBlock(block);
+  BinaryArray hashingBlob;
+  ASSERT_TRUE(get_block_hashing_blob(block, hashingBlob));
+
+  ASSERT_EQ(get_block_hash(block), cachedBlock.getBlockHash());
+  ASSERT_EQ(hashingBlob, cachedBlock.getBlockHashingBinaryArray());
+  ASSERT_EQ(getObjectHash(block.baseTransaction), cachedBlock.getBaseTransactionHash());
+  ASSERT_EQ(getObjectBinarySize(block.baseTransaction), cachedBlock.getBaseTransactionBinarySize());
+}
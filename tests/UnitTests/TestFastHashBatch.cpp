@@ -0,0 +1,116 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "crypto/crypto.h"
+#include "crypto/hash.h"
+#include "CryptoNoteCore/CryptoNoteFormatUtils.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+const size_t WAYS[] = { 1, 4, 8 };
+
+class FastHashBatchTest : public ::testing::Test {
+protected:
+  void TearDown() override {
+    Crypto::cn_fast_hash_select_ways(8);
+  }
+};
+
+}
+
+TEST_F(FastHashBatchTest, matchesSingleHashes) {
+  std::vector<uint8_t> data(600);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = Crypto::rand<uint8_t>();
+  }
+
+  for (size_t ways : WAYS) {
+    Crypto::cn_fast_hash_select_ways(ways);
+    for (size_t count = 0; count <= 20; ++count) {
+      // lengths around the rate, so that the messages hashed at once take different numbers of blocks
+      std::vector<const void*> messages;
+      std::vector<size_t> lengths;
+      for (size_t i = 0; i < count; ++i) {
+        lengths.push_back(Crypto::rand<size_t>() % (data.size() - count));
+        messages.push_back(data.data() + i);
+      }
+
+      std::vector<Crypto::Hash> hashes(count);
+      Crypto::cn_fast_hash_batch(messages.data(), lengths.data(), hashes.data(), count);
+      for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(Crypto::cn_fast_hash(messages[i], lengths[i]), hashes[i]) << "ways " << ways << ", message " << i << " of " << count;
+      }
+    }
+  }
+}
+
+TEST_F(FastHashBatchTest, handlesBlockBoundaries) {
+  std::vector<uint8_t> data(3 * Crypto::HASH_DATA_AREA + 1, 0x5a);
+  std::vector<const void*> messages;
+  std::vector<size_t> lengths;
+  for (size_t length : { 0, 1, 135, 136, 137, 271, 272, 409 }) {
+    messages.push_back(data.data());
+    lengths.push_back(length);
+  }
+
+  for (size_t ways : WAYS) {
+    Crypto::cn_fast_hash_select_ways(ways);
+    std::vector<Crypto::Hash> hashes(messages.size());
+    Crypto::cn_fast_hash_batch(messages.data(), lengths.data(), hashes.data(), messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+      ASSERT_EQ(Crypto::cn_fast_hash(messages[i], lengths[i]), hashes[i]) << "ways " << ways << ", length " << lengths[i];
+    }
+  }
+}
+
+TEST_F(FastHashBatchTest, treeBranchesMatchTreeHash) {
+  std::vector<Crypto::Hash> leaves;
+  for (size_t i = 0; i < 40; ++i) {
+    leaves.push_back(Crypto::rand<Crypto::Hash>());
+  }
+
+  for (size_t ways : WAYS) {
+    Crypto::cn_fast_hash_select_ways(ways);
+    for (size_t count = 1; count <= leaves.size(); ++count) {
+      Crypto::Hash root;
+      Crypto::tree_hash(leaves.data(), count, root);
+
+      std::vector<Crypto::Hash> branch(Crypto::tree_depth(count));
+      Crypto::tree_branch(leaves.data(), count, branch.data());
+      Crypto::Hash rootFromBranch;
+      Crypto::tree_hash_from_branch(branch.data(), branch.size(), leaves[0], nullptr, rootFromBranch);
+      ASSERT_EQ(root, rootFromBranch) << "ways " << ways << ", count " << count;
+    }
+  }
+}
+
+TEST_F(FastHashBatchTest, blockHashesMatchSingleBlockHashes) {
+  std::vector<Block> blocks(11);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    blocks[i].nonce = static_cast<uint32_t>(i);
+    blocks[i].baseTransaction.unlockTime = i;
+    blocks[i].transactionHashes.resize(i);
+    for (Crypto::Hash& transactionHash : blocks[i].transactionHashes) {
+      transactionHash = Crypto::rand<Crypto::Hash>();
+    }
+  }
+
+  std::vector<const Block*> blockPointers;
+  for (const Block& block : blocks) {
+    blockPointers.push_back(&block);
+  }
+
+  std::vector<Crypto::Hash> hashes;
+  ASSERT_TRUE(get_block_hashes(blockPointers, hashes));
+  ASSERT_EQ(blocks.size(), hashes.size());
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    ASSERT_EQ(get_block_hash(blocks[i]), hashes[i]);
+  }
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "crypto/crypto.h"
+
+namespace {
+
+const size_t TX_COUNT = 20;
+const size_t OUTPUTS_PER_TX = 5;
+
+typedef std::vector<std::pair<size_t, size_t>> Matches;
+
+Matches toPairs(const std::vector<Crypto::OutputKeyMatch>& matches) {
+  Matches pairs;
+  for (const auto& match : matches) {
+    pairs.emplace_back(match.output, match.spendKey);
+  }
+
+  return pairs;
+}
+
+Crypto::PublicKey makeInvalidKey() {
+  // about half of y values are not on the curve
+  Crypto::PublicKey key = Crypto::PublicKey();
+  do {
+    ++key.data[0];
+  } while (Crypto::check_key(key));
+
+  return key;
+}
+
+class FindOutputsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Crypto::generate_keys(m_viewPublicKey, m_viewSecretKey);
+  }
+
+  void generateSpendKeys(size_t count) {
+    m_spendKeys.resize(count);
+    for (auto& key : m_spendKeys) {
+      Crypto::SecretKey secretKey;
+      Crypto::generate_keys(key, secretKey);
+    }
+  }
+
+  // every third output is sent to one of the spend keys, the others to random addresses
+  void generateTransactions() {
+    for (size_t i = 0; i < TX_COUNT; ++i) {
+      Crypto::PublicKey txPublicKey;
+      Crypto::SecretKey txSecretKey;
+      Crypto::generate_keys(txPublicKey, txSecretKey);
+      m_txPublicKeys.push_back(txPublicKey);
+
+      Crypto::KeyDerivation derivation;
+      ASSERT_TRUE(Crypto::generate_key_derivation(m_viewPublicKey, txSecretKey, derivation));
+      for (size_t j = 0; j < OUTPUTS_PER_TX; ++j) {
+        Crypto::TransactionOutputKey output = { i, j };
+        if (m_outputs.size() % 3 == 0) {
+          ASSERT_TRUE(Crypto::derive_public_key(derivation, j, m_spendKeys[m_outputs.size() % m_spendKeys.size()], output.key));
+        } else {
+          Crypto::SecretKey secretKey;
+          Crypto::generate_keys(output.key, secretKey);
+        }
+
+        m_outputs.push_back(output);
+      }
+    }
+  }
+
+  std::vector<Crypto::OutputKeyMatch> findOutputs() {
+    std::vector<Crypto::OutputKeyMatch> matches;
+    Crypto::find_outputs(m_txPublicKeys.data(), m_txPublicKeys.size(), m_outputs.data(), m_outputs.size(),
+      m_viewSecretKey, m_spendKeys.data(), m_spendKeys.size(), matches);
+    return matches;
+  }
+
+  // the same scan done with underive_public_key
+  std::vector<Crypto::OutputKeyMatch> underiveOutputs() {
+    std::vector<Crypto::OutputKeyMatch> matches;
+    for (size_t i = 0; i < m_outputs.size(); ++i) {
+      Crypto::KeyDerivation derivation;
+      Crypto::PublicKey spendKey;
+      if (!Crypto::generate_key_derivation(m_txPublicKeys[m_outputs[i].transaction], m_viewSecretKey, derivation) ||
+        !Crypto::underive_public_key(derivation, m_outputs[i].keyIndex, m_outputs[i].key, spendKey)) {
+        continue;
+      }
+
+      for (size_t j = 0; j < m_spendKeys.size(); ++j) {
+        if (m_spendKeys[j] == spendKey) {
+          matches.push_back(Crypto::OutputKeyMatch{ i, j });
+        }
+      }
+    }
+
+    return matches;
+  }
+
+  void checkMatchesUnderivedOutputs() {
+    Matches matches = toPairs(findOutputs());
+    Matches expected = toPairs(underiveOutputs());
+    ASSERT_FALSE(expected.empty());
+    ASSERT_TRUE(std::is_sorted(matches.begin(), matches.end()));
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(expected, matches);
+  }
+
+  Crypto::PublicKey m_viewPublicKey;
+  Crypto::SecretKey m_viewSecretKey;
+  std::vector<Crypto::PublicKey> m_spendKeys;
+  std::vector<Crypto::PublicKey> m_txPublicKeys;
+  std::vector<Crypto::TransactionOutputKey> m_outputs;
+};
+
+}
+
+TEST_F(FindOutputsTest, matchesUnderivedOutputsForSingleSpendKey) {
+  generateSpendKeys(1);
+  generateTransactions();
+  checkMatchesUnderivedOutputs();
+}
+
+TEST_F(FindOutputsTest, matchesUnderivedOutputsForFewSpendKeys) {
+  generateSpendKeys(3);
+  generateTransactions();
+  checkMatchesUnderivedOutputs();
+}
+
+TEST_F(FindOutputsTest, matchesUnderivedOutputsForManySpendKeys) {
+  generateSpendKeys(30);
+  generateTransactions();
+  checkMatchesUnderivedOutputs();
+}
+
+TEST_F(FindOutputsTest, invalidKeysAreSkipped) {
+  for (size_t spendKeyCount : { 2, 20 }) {
+    m_txPublicKeys.clear();
+    m_outputs.clear();
+    generateSpendKeys(spendKeyCount);
+    generateTransactions();
+    m_spendKeys[1] = makeInvalidKey();
+    m_txPublicKeys[0] = makeInvalidKey();
+    m_outputs.back().key = makeInvalidKey();
+    checkMatchesUnderivedOutputs();
+  }
+}
+
+TEST_F(FindOutputsTest, emptyInputs) {
+  generateSpendKeys(1);
+  ASSERT_TRUE(findOutputs().empty());
+
+  generateTransactions();
+  m_spendKeys.clear();
+  ASSERT_TRUE(findOutputs().empty());
+}
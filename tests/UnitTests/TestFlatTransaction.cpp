@@ -0,0 +1,150 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include "crypto/crypto.h"
+#include "CryptoNoteConfig.h"
+#include "CryptoNoteCore/CryptoNoteFormatUtils.h"
+#include "CryptoNoteCore/CryptoNoteTools.h"
+#include "CryptoNoteCore/FlatTransaction.h"
+#include "Serialization/SerializationTools.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+Transaction createTransaction() {
+  Transaction transaction;
+  transaction.version = CURRENT_TRANSACTION_VERSION;
+  transaction.unlockTime = 10;
+
+  KeyInput keyInput;
+  keyInput.amount = 1000;
+  keyInput.outputIndexes = { 1, 5, 9 };
+  keyInput.keyImage = Crypto::rand<Crypto::KeyImage>();
+  transaction.inputs.push_back(keyInput);
+
+  MultisignatureInput multisignatureInput;
+  multisignatureInput.amount = 2000;
+  multisignatureInput.signatureCount = 2;
+  multisignatureInput.outputIndex = 3;
+  transaction.inputs.push_back(multisignatureInput);
+
+  KeyOutput keyOutput;
+  keyOutput.key = Crypto::rand<Crypto::PublicKey>();
+  transaction.outputs.push_back({ 1900, keyOutput });
+
+  MultisignatureOutput multisignatureOutput;
+  multisignatureOutput.keys = { Crypto::rand<Crypto::PublicKey>(), Crypto::rand<Crypto::PublicKey>(), Crypto::rand<Crypto::PublicKey>() };
+  multisignatureOutput.requiredSignatureCount = 2;
+  transaction.outputs.push_back({ 1000, multisignatureOutput });
+  transaction.extra = { 1, 2, 3 };
+
+  for (size_t signatureCount : { keyInput.outputIndexes.size(), static_cast<size_t>(multisignatureInput.signatureCount) }) {
+    std::vector<Crypto::Signature> signatures(signatureCount);
+    for (auto& signature : signatures) {
+      signature = Crypto::rand<Crypto::Signature>();
+    }
+
+    transaction.signatures.push_back(signatures);
+  }
+
+  return transaction;
+}
+
+Transaction createBaseTransaction() {
+  Transaction transaction;
+  transaction.version = CURRENT_TRANSACTION_VERSION;
+  transaction.unlockTime = 70;
+
+  BaseInput baseInput;
+  baseInput.blockIndex = 10;
+  transaction.inputs.push_back(baseInput);
+
+  KeyOutput keyOutput;
+  keyOutput.key = Crypto::rand<Crypto::PublicKey>();
+  transaction.outputs.push_back({ 5000, keyOutput });
+  return transaction;
+}
+
+}
+
+TEST(FlatTransaction, serializesLikeTransaction) {
+  Transaction transaction = createTransaction();
+  FlatTransaction flatTransaction(transaction);
+
+  ASSERT_EQ(toBinaryArray(transaction), toBinaryArray(flatTransaction));
+  ASSERT_EQ(getObjectHash(transaction), getObjectHash(flatTransaction));
+  ASSERT_EQ(storeToJson(transaction), storeToJson(flatTransaction));
+  ASSERT_EQ(toBinaryArray(transaction), toBinaryArray(flatTransaction.getTransaction()));
+}
+
+TEST(FlatTransaction, parsesSerializedTransaction) {
+  Transaction transaction = createTransaction();
+  BinaryArray binaryArray = toBinaryArray(transaction);
+
+  FlatTransaction flatTransaction;
+  ASSERT_TRUE(fromBinaryArray(flatTransaction, binaryArray));
+  ASSERT_EQ(binaryArray, toBinaryArray(flatTransaction));
+  ASSERT_EQ(binaryArray, toBinaryArray(flatTransaction.getTransaction()));
+}
+
+TEST(FlatTransaction, providesTransactionFields) {
+  Transaction transaction = createTransaction();
+  FlatTransaction flatTransaction;
+  ASSERT_TRUE(fromBinaryArray(flatTransaction, toBinaryArray(transaction)));
+
+  ASSERT_EQ(transaction.version, flatTransaction.getVersion());
+  ASSERT_EQ(transaction.unlockTime, flatTransaction.getUnlockTime());
+  ASSERT_EQ(transaction.extra, std::vector<uint8_t>(flatTransaction.getExtra().begin(), flatTransaction.getExtra().end()));
+
+  const KeyInput& keyInput = boost::get<KeyInput>(transaction.inputs[0]);
+  ASSERT_EQ(2, flatTransaction.getInputCount());
+  ASSERT_EQ(TransactionTypes::InputType::Key, flatTransaction.getInputType(0));
+  ASSERT_EQ(keyInput.amount, flatTransaction.getInputAmount(0));
+  ASSERT_EQ(keyInput.keyImage, flatTransaction.getKeyImage(0));
+  ASSERT_EQ(keyInput.outputIndexes, std::vector<uint32_t>(flatTransaction.getOutputIndexes(0).begin(), flatTransaction.getOutputIndexes(0).end()));
+  ASSERT_EQ(TransactionTypes::InputType::Multisignature, flatTransaction.getInputType(1));
+  ASSERT_EQ(2000, flatTransaction.getInputAmount(1));
+
+  ASSERT_EQ(transaction.signatures[1].size(), flatTransaction.getSignatures(1).getSize());
+  ASSERT_EQ(transaction.signatures[1][1], flatTransaction.getSignatures(1)[1]);
+
+  const MultisignatureOutput& multisignatureOutput = boost::get<MultisignatureOutput>(transaction.outputs[1].target);
+  ASSERT_EQ(2, flatTransaction.getOutputCount());
+  ASSERT_EQ(TransactionTypes::OutputType::Key, flatTransaction.getOutputType(0));
+  ASSERT_EQ(boost::get<KeyOutput>(transaction.outputs[0].target).key, flatTransaction.getOutputKey(0));
+  ASSERT_EQ(TransactionTypes::OutputType::Multisignature, flatTransaction.getOutputType(1));
+  ASSERT_EQ(1000, flatTransaction.getOutputAmount(1));
+  ASSERT_EQ(multisignatureOutput.keys, std::vector<Crypto::PublicKey>(flatTransaction.getOutputKeys(1).begin(), flatTransaction.getOutputKeys(1).end()));
+  ASSERT_EQ(multisignatureOutput.requiredSignatureCount, flatTransaction.getRequiredSignatureCount(1));
+}
+
+TEST(FlatTransaction, keepsTransactionWithoutSignatures) {
+  Transaction transaction = createBaseTransaction();
+  FlatTransaction flatTransaction(transaction);
+
+  ASSERT_EQ(TransactionTypes::InputType::Generating, flatTransaction.getInputType(0));
+  ASSERT_EQ(toBinaryArray(transaction), toBinaryArray(flatTransaction));
+  ASSERT_TRUE(flatTransaction.getTransaction().signatures.empty());
+}
+
+TEST(FlatTransaction, failsOnSignaturesNotExpected) {
+  Transaction transaction = createTransaction();
+  transaction.signatures.clear();
+  FlatTransaction flatTransaction(transaction);
+
+  BinaryArray binaryArray;
+  ASSERT_FALSE(toBinaryArray(flatTransaction, binaryArray));
+}
+
+TEST(FlatTransaction, failsOnUnknownInputType) {
+  BinaryArray binaryArray = toBinaryArray(createTransaction());
+  // version, unlock time and input count take a byte each
+  binaryArray[3] = 0x7;
+
+  FlatTransaction flatTransaction;
+  ASSERT_FALSE(fromBinaryArray(flatTransaction, binaryArray));
+}
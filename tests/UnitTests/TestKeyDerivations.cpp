@@ -0,0 +1,65 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "crypto/crypto.h"
+
+namespace {
+
+std::vector<Crypto::PublicKey> generatePublicKeys(size_t count) {
+  std::vector<Crypto::PublicKey> keys(count);
+  for (auto& key : keys) {
+    Crypto::SecretKey secretKey;
+    Crypto::generate_keys(key, secretKey);
+  }
+
+  return keys;
+}
+
+void checkMatchesSingleDerivations(const std::vector<Crypto::PublicKey>& keys, const Crypto::SecretKey& secretKey) {
+  std::vector<Crypto::KeyDerivation> derivations(keys.size());
+  std::unique_ptr<bool[]> results(new bool[keys.size() + 1]);
+  Crypto::generate_key_derivations(keys.data(), keys.size(), secretKey, derivations.data(), results.get());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    Crypto::KeyDerivation expected;
+    ASSERT_EQ(Crypto::generate_key_derivation(keys[i], secretKey, expected), results[i]) << i;
+    if (results[i]) {
+      ASSERT_EQ(0, std::memcmp(&expected, &derivations[i], sizeof(expected))) << i;
+    }
+  }
+}
+
+}
+
+TEST(KeyDerivations, matchSingleDerivationsForAnyCount) {
+  Crypto::PublicKey publicKey;
+  Crypto::SecretKey secretKey;
+  Crypto::generate_keys(publicKey, secretKey);
+  for (size_t count = 0; count <= 9; ++count) {
+    checkMatchesSingleDerivations(generatePublicKeys(count), secretKey);
+  }
+}
+
+TEST(KeyDerivations, invalidKeysDoNotAffectOthers) {
+  Crypto::PublicKey publicKey;
+  Crypto::SecretKey secretKey;
+  Crypto::generate_keys(publicKey, secretKey);
+
+  std::vector<Crypto::PublicKey> keys = generatePublicKeys(12);
+  // about half of y values are not on the curve
+  Crypto::PublicKey invalidKey = Crypto::PublicKey();
+  do {
+    ++invalidKey.data[0];
+  } while (Crypto::check_key(invalidKey));
+
+  keys[1] = invalidKey;
+  keys[4] = keys[5] = keys[6] = keys[7] = invalidKey;
+  keys[11] = invalidKey;
+  checkMatchesSingleDerivations(keys, secretKey);
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <boost/filesystem.hpp>
+
+#include "CryptoNoteCore/MappedVector.h"
+#include "CryptoNoteCore/SwappedVector.h"
+
+namespace {
+
+struct TestItem {
+  uint64_t number;
+  std::string text;
+
+  void serialize(CryptoNote::ISerializer& s) {
+    s(number, "number");
+    s(text, "text");
+  }
+};
+
+TestItem makeItem(uint64_t number) {
+  return TestItem{ number, std::string(static_cast<size_t>(number % 97), 'a' + static_cast<char>(number % 26)) };
+}
+
+class MappedVectorTest : public ::testing::Test {
+protected:
+  virtual void SetUp() override {
+    m_dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("test_data_%%%%%%%%%%%%");
+    boost::filesystem::create_directories(m_dir);
+    m_itemsFile = (m_dir / "items.dat").string();
+    m_indexesFile = (m_dir / "indexes.dat").string();
+  }
+
+  virtual void TearDown() override {
+    boost::system::error_code ignoredErrorCode;
+    boost::filesystem::remove_all(m_dir, ignoredErrorCode);
+  }
+
+  boost::filesystem::path m_dir;
+  std::string m_itemsFile;
+  std::string m_indexesFile;
+};
+
+}
+
+TEST_F(MappedVectorTest, pushReadAndReopen) {
+  {
+    MappedVector<TestItem> items;
+    ASSERT_TRUE(items.open(m_itemsFile, m_indexesFile, 4));
+    ASSERT_TRUE(items.empty());
+    for (uint64_t i = 0; i < 1000; ++i) {
+      items.push_back(makeItem(i));
+    }
+
+    ASSERT_EQ(1000, items.size());
+    ASSERT_EQ(makeItem(500).text, items[500].text);
+  }
+
+  MappedVector<TestItem> items;
+  ASSERT_TRUE(items.open(m_itemsFile, m_indexesFile, 4));
+  ASSERT_EQ(1000, items.size());
+  for (uint64_t i = 0; i < 1000; i += 7) {
+    ASSERT_EQ(i, items[i].number);
+    ASSERT_EQ(makeItem(i).text, items[i].text);
+  }
+
+  ASSERT_EQ(999, items.back().number);
+}
+
+TEST_F(MappedVectorTest, popBackTruncates) {
+  MappedVector<TestItem> items;
+  ASSERT_TRUE(items.open(m_itemsFile, m_indexesFile, 16));
+  for (uint64_t i = 0; i < 10; ++i) {
+    items.push_back(makeItem(i));
+  }
+
+  items.pop_back();
+  items.pop_back();
+  items.push_back(makeItem(100));
+  ASSERT_EQ(9, items.size());
+  ASSERT_EQ(100, items.back().number);
+
+  items.close();
+  ASSERT_TRUE(items.open(m_itemsFile, m_indexesFile, 16));
+  ASSERT_EQ(9, items.size());
+  ASSERT_EQ(7, items[7].number);
+  ASSERT_EQ(100, items[8].number);
+}
+
+TEST_F(MappedVectorTest, interruptedAppendIsDiscarded) {
+  {
+    MappedVector<TestItem> items;
+    ASSERT_TRUE(items.open(m_itemsFile, m_indexesFile, 16));
+    for (uint64_t i = 0; i < 10; ++i) {
+      items.push_back(makeItem(i + 1));
+    }
+  }
+
+  // count claims an item whose data never reached the items file
+  boost::filesystem::resize_file(m_itemsFile, boost::filesystem::file_size(m_itemsFile) - 1);
+
+  MappedVector<TestItem> items;
+  ASSERT_TRUE(items.open(m_itemsFile, m_indexesFile, 16));
+  ASSERT_EQ(9, items.size());
+  ASSERT_EQ(9, items.back().number);
+}
+
+TEST_F(MappedVectorTest, readsSwappedVectorFiles) {
+  {
+    SwappedVector<TestItem> items;
+    ASSERT_TRUE(items.open(m_itemsFile, m_indexesFile, 16));
+    for (uint64_t i = 0; i < 100; ++i) {
+      items.push_back(makeItem(i));
+    }
+
+    items.pop_back();
+  }
+
+  MappedVector<TestItem> items;
+  ASSERT_TRUE(items.open(m_itemsFile, m_indexesFile, 16));
+  ASSERT_EQ(99, items.size());
+  for (uint64_t i = 0; i < 99; ++i) {
+    ASSERT_EQ(makeItem(i).text, items[i].text);
+  }
+}
+
+TEST_F(MappedVectorTest, clear) {
+  MappedVector<TestItem> items;
+  ASSERT_TRUE(items.open(m_itemsFile, m_indexesFile, 16));
+  items.push_back(makeItem(1));
+  items.clear();
+  ASSERT_TRUE(items.empty());
+
+  items.close();
+  ASSERT_TRUE(items.open(m_itemsFile, m_indexesFile, 16));
+  ASSERT_TRUE(items.empty());
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+#include "crypto/crypto.h"
+
+namespace {
+
+const size_t KEY_COUNT = 16;
+
+Crypto::PublicKey makeInvalidKey() {
+  // about half of y values are not on the curve
+  Crypto::PublicKey key = Crypto::PublicKey();
+  do {
+    ++key.data[0];
+  } while (Crypto::check_key(key));
+
+  return key;
+}
+
+bool equal(const Crypto::KeyDerivation& left, const Crypto::KeyDerivation& right) {
+  return std::memcmp(&left, &right, sizeof(left)) == 0;
+}
+
+}
+
+TEST(PrecomputedKeys, secretKeyDerivationsMatch) {
+  Crypto::PublicKey publicKey;
+  Crypto::SecretKey secretKey;
+  Crypto::generate_keys(publicKey, secretKey);
+  Crypto::PrecomputedSecretKey precomputed(secretKey);
+
+  for (size_t i = 0; i < KEY_COUNT; ++i) {
+    Crypto::KeyDerivation expected;
+    Crypto::KeyDerivation derivation;
+    Crypto::PublicKey otherKey;
+    Crypto::SecretKey otherSecretKey;
+    Crypto::generate_keys(otherKey, otherSecretKey);
+    ASSERT_TRUE(Crypto::generate_key_derivation(otherKey, secretKey, expected));
+    ASSERT_TRUE(Crypto::generate_key_derivation(otherKey, precomputed, derivation));
+    ASSERT_TRUE(equal(expected, derivation));
+  }
+
+  Crypto::KeyDerivation derivation;
+  ASSERT_FALSE(Crypto::generate_key_derivation(makeInvalidKey(), precomputed, derivation));
+}
+
+TEST(PrecomputedKeys, publicKeyDerivationsMatch) {
+  Crypto::PublicKey publicKey;
+  Crypto::SecretKey secretKey;
+  Crypto::generate_keys(publicKey, secretKey);
+  Crypto::PrecomputedPublicKey precomputed;
+  ASSERT_TRUE(Crypto::precompute_public_key(publicKey, precomputed));
+
+  for (size_t i = 0; i < KEY_COUNT; ++i) {
+    Crypto::KeyDerivation expected;
+    Crypto::KeyDerivation derivation;
+    Crypto::PublicKey otherKey;
+    Crypto::SecretKey otherSecretKey;
+    Crypto::generate_keys(otherKey, otherSecretKey);
+    ASSERT_TRUE(Crypto::generate_key_derivation(publicKey, otherSecretKey, expected));
+    ASSERT_TRUE(Crypto::generate_key_derivation(precomputed, otherSecretKey, derivation));
+    ASSERT_TRUE(equal(expected, derivation));
+  }
+}
+
+TEST(PrecomputedKeys, invalidPublicKeyIsNotPrecomputed) {
+  Crypto::PrecomputedPublicKey precomputed;
+  Crypto::KeyDerivation derivation;
+  Crypto::PublicKey publicKey;
+  Crypto::SecretKey secretKey;
+  Crypto::generate_keys(publicKey, secretKey);
+  ASSERT_FALSE(Crypto::generate_key_derivation(precomputed, secretKey, derivation));
+  ASSERT_FALSE(Crypto::precompute_public_key(makeInvalidKey(), precomputed));
+  ASSERT_FALSE(Crypto::generate_key_derivation(precomputed, secretKey, derivation));
+}
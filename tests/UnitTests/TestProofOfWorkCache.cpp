@@ -0,0 +1,56 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include "CryptoNoteCore/ProofOfWorkCache.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+Crypto::Hash makeHash(uint8_t value) {
+  Crypto::Hash hash = Crypto::Hash();
+  hash.data[0] = value;
+  return hash;
+}
+
+}
+
+TEST(ProofOfWorkCache, entryIsTakenOnce) {
+  ProofOfWorkCache cache(10);
+  cache.add(makeHash(1), makeHash(101));
+
+  Crypto::Hash proofOfWork;
+  ASSERT_TRUE(cache.take(makeHash(1), proofOfWork));
+  ASSERT_EQ(makeHash(101), proofOfWork);
+  ASSERT_FALSE(cache.take(makeHash(1), proofOfWork));
+
+  ProofOfWorkCacheStatistics statistics = cache.getStatistics();
+  ASSERT_EQ(1, statistics.hits);
+  ASSERT_EQ(1, statistics.misses);
+  ASSERT_EQ(0, statistics.size);
+}
+
+TEST(ProofOfWorkCache, dropsOldestEntries) {
+  ProofOfWorkCache cache(2);
+  cache.add(makeHash(1), makeHash(101));
+  cache.add(makeHash(2), makeHash(102));
+  cache.add(makeHash(3), makeHash(103));
+
+  Crypto::Hash proofOfWork;
+  ASSERT_FALSE(cache.take(makeHash(1), proofOfWork));
+  ASSERT_TRUE(cache.take(makeHash(2), proofOfWork));
+  ASSERT_EQ(makeHash(102), proofOfWork);
+  ASSERT_TRUE(cache.take(makeHash(3), proofOfWork));
+  ASSERT_EQ(makeHash(103), proofOfWork);
+}
+
+TEST(ProofOfWorkCache, zeroCapacityKeepsNothing) {
+  ProofOfWorkCache cache(0);
+  cache.add(makeHash(1), makeHash(101));
+
+  Crypto::Hash proofOfWork;
+  ASSERT_FALSE(cache.take(makeHash(1), proofOfWork));
+}
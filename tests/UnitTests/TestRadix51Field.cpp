@@ -0,0 +1,126 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+#include "crypto/crypto.h"
+
+namespace {
+
+const size_t KEY_COUNT = 64;
+
+struct Results {
+  std::vector<bool> validKeys;
+  std::vector<Crypto::PublicKey> publicKeys;
+  std::vector<Crypto::KeyDerivation> derivations;
+  std::vector<Crypto::PublicKey> derivedKeys;
+  std::vector<Crypto::KeyImage> keyImages;
+  std::vector<Crypto::PublicKey> hashedPoints;
+};
+
+template <typename T>
+bool equal(const std::vector<T>& left, const std::vector<T>& right) {
+  return left.size() == right.size() && std::memcmp(left.data(), right.data(), left.size() * sizeof(T)) == 0;
+}
+
+class Radix51FieldTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+      Crypto::PublicKey publicKey;
+      Crypto::SecretKey secretKey;
+      Crypto::generate_keys(publicKey, secretKey);
+      m_publicKeys.push_back(publicKey);
+      m_secretKeys.push_back(secretKey);
+      // about half of random keys do not decode to a point
+      m_randomKeys.push_back(Crypto::rand<Crypto::PublicKey>());
+    }
+  }
+
+  void TearDown() override {
+    Crypto::use_radix51_field(true);
+  }
+
+  Results compute(bool radix51) {
+    Crypto::use_radix51_field(radix51);
+
+    Results results;
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+      results.validKeys.push_back(Crypto::check_key(m_randomKeys[i]));
+
+      Crypto::PublicKey publicKey;
+      Crypto::secret_key_to_public_key(m_secretKeys[i], publicKey);
+      results.publicKeys.push_back(publicKey);
+
+      Crypto::KeyDerivation derivation;
+      if (!Crypto::generate_key_derivation(m_publicKeys[(i + 1) % KEY_COUNT], m_secretKeys[i], derivation)) {
+        ADD_FAILURE();
+      }
+      results.derivations.push_back(derivation);
+
+      Crypto::PublicKey derivedKey;
+      Crypto::derive_public_key(derivation, i, m_publicKeys[i], derivedKey);
+      results.derivedKeys.push_back(derivedKey);
+
+      Crypto::KeyImage keyImage;
+      Crypto::generate_key_image(m_publicKeys[i], m_secretKeys[i], keyImage);
+      results.keyImages.push_back(keyImage);
+
+      Crypto::PublicKey hashedPoint;
+      Crypto::hash_data_to_ec(reinterpret_cast<const uint8_t*>(&m_randomKeys[i]), sizeof(Crypto::PublicKey), hashedPoint);
+      results.hashedPoints.push_back(hashedPoint);
+    }
+
+    return results;
+  }
+
+  std::vector<Crypto::PublicKey> m_publicKeys;
+  std::vector<Crypto::SecretKey> m_secretKeys;
+  std::vector<Crypto::PublicKey> m_randomKeys;
+};
+
+}
+
+TEST_F(Radix51FieldTest, resultsMatchRef10) {
+  if (!Crypto::use_radix51_field(true)) {
+    return;
+  }
+
+  Results ref10 = compute(false);
+  Results radix51 = compute(true);
+  ASSERT_EQ(ref10.validKeys, radix51.validKeys);
+  ASSERT_TRUE(equal(ref10.publicKeys, radix51.publicKeys));
+  ASSERT_TRUE(equal(ref10.derivations, radix51.derivations));
+  ASSERT_TRUE(equal(ref10.derivedKeys, radix51.derivedKeys));
+  ASSERT_TRUE(equal(ref10.keyImages, radix51.keyImages));
+  ASSERT_TRUE(equal(ref10.hashedPoints, radix51.hashedPoints));
+}
+
+TEST_F(Radix51FieldTest, ringSignaturesAreInterchangeable) {
+  const size_t ringSize = 4;
+  const size_t realIndex = 2;
+  Crypto::Hash prefixHash = Crypto::rand<Crypto::Hash>();
+  std::vector<const Crypto::PublicKey*> ring;
+  for (size_t i = 0; i < ringSize; ++i) {
+    ring.push_back(&m_publicKeys[i]);
+  }
+
+  Crypto::KeyImage image;
+  Crypto::generate_key_image(m_publicKeys[realIndex], m_secretKeys[realIndex], image);
+  for (bool signRadix51 : { false, true }) {
+    Crypto::use_radix51_field(signRadix51);
+    std::vector<Crypto::Signature> signatures(ringSize);
+    Crypto::generate_ring_signature(prefixHash, image, ring, m_secretKeys[realIndex], realIndex, signatures.data());
+
+    for (bool checkRadix51 : { false, true }) {
+      Crypto::use_radix51_field(checkRadix51);
+      ASSERT_TRUE(Crypto::check_ring_signature(prefixHash, image, ring, signatures.data()));
+      Crypto::Hash otherHash = Crypto::rand<Crypto::Hash>();
+      ASSERT_FALSE(Crypto::check_ring_signature(otherHash, image, ring, signatures.data()));
+    }
+  }
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+
+#include "Common/ReadWriteLock.h"
+
+using namespace Common;
+
+TEST(ReadWriteLock, readersDoNotBlockEachOther) {
+  ReadWriteLock lock;
+  SharedLockGuard guard(lock);
+
+  auto reader = std::async(std::launch::async, [&lock] {
+    SharedLockGuard otherGuard(lock);
+    return true;
+  });
+
+  ASSERT_EQ(std::future_status::ready, reader.wait_for(std::chrono::seconds(10)));
+  ASSERT_EQ(0, lock.getStatistics().contendedSharedLocks);
+}
+
+TEST(ReadWriteLock, writerWaitsForReaders) {
+  ReadWriteLock lock;
+  std::atomic<bool> writerEntered(false);
+  std::future<void> writer;
+  {
+    SharedLockGuard guard(lock);
+    writer = std::async(std::launch::async, [&] {
+      std::lock_guard<ReadWriteLock> exclusiveGuard(lock);
+      writerEntered = true;
+    });
+
+    ASSERT_EQ(std::future_status::timeout, writer.wait_for(std::chrono::milliseconds(50)));
+    ASSERT_FALSE(writerEntered);
+  }
+
+  writer.get();
+  ASSERT_TRUE(writerEntered);
+  ASSERT_EQ(1, lock.getStatistics().contendedExclusiveLocks);
+}
+
+TEST(ReadWriteLock, isRecursive) {
+  ReadWriteLock lock;
+  {
+    std::lock_guard<ReadWriteLock> guard(lock);
+    std::lock_guard<ReadWriteLock> nestedGuard(lock);
+    SharedLockGuard sharedGuard(lock);
+  }
+
+  {
+    SharedLockGuard guard(lock);
+    SharedLockGuard nestedGuard(lock);
+    ASSERT_THROW(lock.lock(), std::logic_error);
+  }
+
+  auto writer = std::async(std::launch::async, [&lock] {
+    std::lock_guard<ReadWriteLock> guard(lock);
+  });
+
+  ASSERT_EQ(std::future_status::ready, writer.wait_for(std::chrono::seconds(10)));
+  ReadWriteLockStatistics statistics = lock.getStatistics();
+  ASSERT_EQ(3, statistics.sharedLocks);
+  ASSERT_EQ(3, statistics.exclusiveLocks);
+}
+
+TEST(ReadWriteLock, exclusiveLockHandlerIsCalledOnce) {
+  ReadWriteLock lock;
+  size_t calls = 0;
+  lock.setExclusiveLockHandler([&calls] { ++calls; });
+
+  std::lock_guard<ReadWriteLock> guard(lock);
+  std::lock_guard<ReadWriteLock> nestedGuard(lock);
+  ASSERT_EQ(1, calls);
+}
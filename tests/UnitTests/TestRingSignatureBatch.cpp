@@ -0,0 +1,114 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "crypto/crypto.h"
+
+namespace {
+
+struct RingSignature {
+  Crypto::Hash prefixHash;
+  Crypto::KeyImage image;
+  std::vector<Crypto::PublicKey> keys;
+  std::vector<const Crypto::PublicKey*> keyPointers;
+  std::vector<Crypto::Signature> signatures;
+
+  Crypto::RingSignatureBatchEntry entry() const {
+    return { &prefixHash, &image, keyPointers.data(), keyPointers.size(), signatures.data() };
+  }
+};
+
+class RingSignatureBatchTest : public ::testing::Test {
+protected:
+  // rings share their members, so some keys are found in the cache
+  void makeSignatures(size_t count, size_t ringSize) {
+    std::vector<Crypto::PublicKey> publicKeys(ringSize);
+    std::vector<Crypto::SecretKey> secretKeys(ringSize);
+    for (size_t i = 0; i < ringSize; ++i) {
+      Crypto::generate_keys(publicKeys[i], secretKeys[i]);
+    }
+
+    m_signatures.clear();
+    m_signatures.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      RingSignature& signature = m_signatures[i];
+      size_t realIndex = i % ringSize;
+      signature.prefixHash = Crypto::rand<Crypto::Hash>();
+      signature.keys = publicKeys;
+      for (const auto& key : signature.keys) {
+        signature.keyPointers.push_back(&key);
+      }
+
+      Crypto::generate_key_image(publicKeys[realIndex], secretKeys[realIndex], signature.image);
+      signature.signatures.resize(ringSize);
+      Crypto::generate_ring_signature(signature.prefixHash, signature.image, signature.keyPointers, secretKeys[realIndex], realIndex, signature.signatures.data());
+    }
+  }
+
+  std::vector<Crypto::RingSignatureBatchEntry> entries() const {
+    std::vector<Crypto::RingSignatureBatchEntry> result;
+    for (const auto& signature : m_signatures) {
+      result.push_back(signature.entry());
+    }
+
+    return result;
+  }
+
+  std::vector<RingSignature> m_signatures;
+};
+
+}
+
+TEST_F(RingSignatureBatchTest, acceptsValidSignatures) {
+  for (size_t ringSize : { 1, 2, 5, 16 }) {
+    makeSignatures(6, ringSize);
+    auto batch = entries();
+    ASSERT_TRUE(Crypto::check_ring_signatures(batch.data(), batch.size(), nullptr));
+
+    Crypto::RingMemberCache cache(100);
+    ASSERT_TRUE(Crypto::check_ring_signatures(batch.data(), batch.size(), &cache));
+    ASSERT_TRUE(Crypto::check_ring_signatures(batch.data(), batch.size(), &cache));
+    ASSERT_EQ(ringSize, cache.misses());
+    ASSERT_EQ(2 * batch.size() * ringSize - ringSize, cache.hits());
+  }
+}
+
+TEST_F(RingSignatureBatchTest, rejectsInvalidSignature) {
+  makeSignatures(5, 3);
+  Crypto::RingMemberCache cache(2);
+  for (size_t corrupted = 0; corrupted < m_signatures.size(); ++corrupted) {
+    m_signatures[corrupted].prefixHash.data[0] ^= 1;
+    auto batch = entries();
+    ASSERT_FALSE(Crypto::check_ring_signature(*batch[corrupted].prefixHash, *batch[corrupted].image, batch[corrupted].pubs, batch[corrupted].pubsCount, batch[corrupted].sig));
+    ASSERT_FALSE(Crypto::check_ring_signatures(batch.data(), batch.size(), &cache));
+    m_signatures[corrupted].prefixHash.data[0] ^= 1;
+  }
+
+  m_signatures[2].signatures[1].data[40] ^= 1;
+  auto batch = entries();
+  ASSERT_FALSE(Crypto::check_ring_signatures(batch.data(), batch.size(), nullptr));
+}
+
+TEST_F(RingSignatureBatchTest, popularRingMembersAreChecked) {
+  makeSignatures(8, 4);
+  Crypto::RingMemberCache cache(64);
+  auto batch = entries();
+  ASSERT_TRUE(Crypto::check_ring_signatures(batch.data(), batch.size(), &cache));
+  // members are used eight times by the first batch and checked with precomputed multiples afterwards
+  ASSERT_TRUE(Crypto::check_ring_signatures(batch.data(), batch.size(), &cache));
+
+  for (size_t corrupted = 0; corrupted < m_signatures.size(); ++corrupted) {
+    m_signatures[corrupted].signatures[corrupted % 4].data[0] ^= 1;
+    batch = entries();
+    ASSERT_FALSE(Crypto::check_ring_signatures(batch.data(), batch.size(), &cache));
+    m_signatures[corrupted].signatures[corrupted % 4].data[0] ^= 1;
+  }
+}
+
+TEST_F(RingSignatureBatchTest, emptyBatchIsValid) {
+  ASSERT_TRUE(Crypto::check_ring_signatures(nullptr, 0, nullptr));
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "CryptoNoteCore/SignatureCache.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+Crypto::Hash makeKey(uint8_t value) {
+  Crypto::Hash key = Crypto::Hash();
+  key.data[0] = value;
+  return key;
+}
+
+}
+
+TEST(SignatureCache, countsHitsAndMisses) {
+  SignatureCache cache(10);
+  ASSERT_FALSE(cache.contains(makeKey(1)));
+  cache.add(makeKey(1), 5);
+  ASSERT_TRUE(cache.contains(makeKey(1)));
+  ASSERT_TRUE(cache.contains(makeKey(1)));
+
+  SignatureCacheStatistics statistics = cache.getStatistics();
+  ASSERT_EQ(2, statistics.hits);
+  ASSERT_EQ(1, statistics.misses);
+  ASSERT_EQ(1, statistics.size);
+}
+
+TEST(SignatureCache, evictsLeastRecentlyUsed) {
+  SignatureCache cache(2);
+  cache.add(makeKey(1), 0);
+  cache.add(makeKey(2), 0);
+  ASSERT_TRUE(cache.contains(makeKey(1)));
+  cache.add(makeKey(3), 0);
+
+  ASSERT_TRUE(cache.contains(makeKey(1)));
+  ASSERT_FALSE(cache.contains(makeKey(2)));
+  ASSERT_TRUE(cache.contains(makeKey(3)));
+  ASSERT_EQ(2, cache.getStatistics().size);
+}
+
+TEST(SignatureCache, removeFromHeightDropsEntriesWithNewerRingMembers) {
+  SignatureCache cache(10);
+  cache.add(makeKey(1), 9);
+  cache.add(makeKey(2), 10);
+  cache.add(makeKey(3), 11);
+
+  cache.removeFromHeight(10);
+  ASSERT_TRUE(cache.contains(makeKey(1)));
+  ASSERT_FALSE(cache.contains(makeKey(2)));
+  ASSERT_FALSE(cache.contains(makeKey(3)));
+}
+
+TEST(SignatureCache, keyDependsOnSignatures) {
+  Crypto::Hash prefixHash = makeKey(1);
+  Crypto::KeyImage keyImage = Crypto::KeyImage();
+  std::vector<Crypto::PublicKey> keys(2);
+  std::vector<const Crypto::PublicKey*> keyPointers = { &keys[0], &keys[1] };
+  std::vector<Crypto::Signature> signatures(2);
+
+  Crypto::Hash key = SignatureCache::getKey(prefixHash, keyImage, keyPointers, signatures.data());
+  signatures[1].data[63] = 1;
+  ASSERT_NE(key, SignatureCache::getKey(prefixHash, keyImage, keyPointers, signatures.data()));
+  signatures[1].data[63] = 0;
+  keys[0].data[0] = 1;
+  ASSERT_NE(key, SignatureCache::getKey(prefixHash, keyImage, keyPointers, signatures.data()));
+  keys[0].data[0] = 0;
+  ASSERT_EQ(key, SignatureCache::getKey(prefixHash, keyImage, keyPointers, signatures.data()));
+}
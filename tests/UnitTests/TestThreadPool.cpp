@@ -0,0 +1,59 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "Common/ThreadPool.h"
+
+using namespace Common;
+
+TEST(ThreadPool, runsEveryIterationOnce) {
+  for (size_t workers : { 0, 1, 3 }) {
+    ThreadPool pool(workers);
+    for (int run = 0; run < 3; ++run) {
+      std::vector<std::atomic<int>> calls(1000);
+      for (auto& count : calls) {
+        count = 0;
+      }
+
+      ASSERT_TRUE(pool.runAll(calls.size(), [&calls](size_t index) {
+        ++calls[index];
+        return true;
+      }));
+
+      for (auto& count : calls) {
+        ASSERT_EQ(1, count);
+      }
+    }
+  }
+}
+
+TEST(ThreadPool, stopsAfterFailure) {
+  ThreadPool pool(2);
+  std::atomic<size_t> calls(0);
+  ASSERT_FALSE(pool.runAll(100000, [&calls](size_t index) {
+    ++calls;
+    return index != 10;
+  }));
+
+  ASSERT_LT(calls, 100000);
+  ASSERT_TRUE(pool.runAll(10, [](size_t) { return true; }));
+}
+
+TEST(ThreadPool, rethrowsException) {
+  ThreadPool pool(2);
+  ASSERT_THROW(pool.runAll(100, [](size_t index) -> bool {
+    if (index == 50) {
+      throw std::runtime_error("failure");
+    }
+
+    return true;
+  }), std::runtime_error);
+
+  ASSERT_TRUE(pool.runAll(0, [](size_t) { return false; }));
+}
@@ -137,6 +137,26 @@ TEST_F(TransactionApi, addAndSignInput) {
   EXPECT_NO_FATAL_FAILURE(checkHashChanged());
 }
 
+TEST_F(TransactionApi, addAndSignInputWithStoredKeyImage) {
+  TransactionTypes::InputKeyInfo info = createInputInfo(1000);
+  KeyPair expectedEphKeys;
+  KeyImage keyImage;
+  ASSERT_TRUE(generate_key_image_helper(sender, info.realOutput.transactionPublicKey, info.realOutput.outputInTransaction, expectedEphKeys, keyImage));
+
+  KeyPair ephKeys;
+  size_t index = tx->addInput(sender, info, keyImage, ephKeys);
+  ASSERT_EQ(expectedEphKeys.publicKey, ephKeys.publicKey);
+  ASSERT_EQ(expectedEphKeys.secretKey, ephKeys.secretKey);
+
+  KeyInput input;
+  tx->getInput(index, input);
+  ASSERT_EQ(keyImage, input.keyImage);
+  ASSERT_EQ(1000, input.amount);
+
+  tx->signInputKey(index, info, ephKeys);
+  ASSERT_TRUE(tx->validateSignatures());
+}
+
 TEST_F(TransactionApi, addAndSignInputMsig) {
 
   MultisignatureInput inputMsig;
@@ -39,6 +39,10 @@ class TransactionValidator : public CryptoNote::ITransactionValidator {
   virtual bool checkTransactionSize(size_t blobSize) override {
     return true;
   }
+
+  virtual bool isInTrustedCheckpointZone() override {
+    return false;
+  }
 };
 
 class FakeTimeProvider : public ITimeProvider {
@@ -531,6 +535,43 @@ TEST_F(tx_pool, RecentlyDeletedTransactionCanBeAddedToTxPoolIfItIsReceivedInBloc
   ASSERT_EQ(1, pool.get_transactions_count());
 }
 
+namespace {
+  class TrustedCheckpointZoneValidator : public TransactionValidator {
+  public:
+    size_t inputChecks = 0;
+
+    virtual bool checkTransactionInputs(const CryptoNote::Transaction& tx, BlockInfo& maxUsedBlock) override {
+      ++inputChecks;
+      return true;
+    }
+
+    virtual bool isInTrustedCheckpointZone() override {
+      return true;
+    }
+  };
+}
+
+TEST_F(tx_pool, InputsOfTransactionFromBlockBelowTrustedCheckpointAreNotChecked) {
+  TestPool<TrustedCheckpointZoneValidator, FakeTimeProvider> pool(currency, logger);
+
+  Transaction tx;
+  GenerateTransaction(currency, tx, currency.minimumFee(), 1);
+
+  tx_verification_context tvc = boost::value_initialized<tx_verification_context>();
+  ASSERT_TRUE(pool.add_tx(tx, tvc, true));
+  ASSERT_TRUE(tvc.m_added_to_pool);
+  ASSERT_FALSE(tvc.m_verifivation_failed);
+  ASSERT_FALSE(tvc.m_verifivation_impossible);
+  ASSERT_EQ(0, pool.validator.inputChecks);
+
+  // transactions received from peers are checked as usual
+  Transaction relayedTx;
+  GenerateTransaction(currency, relayedTx, currency.minimumFee(), 1);
+  tvc = boost::value_initialized<tx_verification_context>();
+  ASSERT_TRUE(pool.add_tx(relayedTx, tvc, false));
+  ASSERT_EQ(1, pool.validator.inputChecks);
+}
+
 TEST_F(tx_pool, OldTransactionIsDeletedDuringTxPoolInitialization) {
   TransactionValidator validator;
   FakeTimeProvider timeProvider;
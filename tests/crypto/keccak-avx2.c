@@ -2,4 +2,4 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
-#include "MemoryStream.h"
+#include "crypto/keccak-avx2.c"
@@ -34,11 +34,13 @@ int main(int argc, char *argv[]) {
   size_t test = 0;
   bool error = false;
   setup_random();
-  if (argc != 2) {
+  if (argc == 3 && string(argv[1]) == "ref10") {
+    Crypto::use_radix51_field(false);
+  } else if (argc != 2) {
     cerr << "invalid arguments" << endl;
     return 1;
   }
-  input.open(argv[1], ios_base::in);
+  input.open(argv[argc - 1], ios_base::in);
   for (;;) {
     ++test;
     input.exceptions(ios_base::badbit);